@@ -0,0 +1,178 @@
+/**
+ * @file audio_backend.cc
+ * @brief Implementation of the shared PortAudio backend
+ */
+
+#include "audio_backend.h"
+#include <portaudio.h>
+#include <iostream>
+
+namespace koelingo {
+namespace audio {
+
+// Get the process-wide backend
+std::shared_ptr<AudioBackend> AudioBackend::acquire() {
+    static std::mutex registry_mutex;
+    // Held until exit so PortAudio is not torn down between captures
+    static std::shared_ptr<AudioBackend> registry;
+
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    if (!registry || !registry->is_initialized()) {
+        registry.reset(new AudioBackend());
+    }
+    return registry;
+}
+
+// AudioBackend constructor
+AudioBackend::AudioBackend()
+    : initialized_(false),
+      stale_(false),
+      open_streams_(0),
+      devices_(std::make_shared<const std::vector<DeviceInfo>>()) {
+    PaError err = Pa_Initialize();
+    if (err != paNoError) {
+        std::cerr << "PortAudio initialization error: " << Pa_GetErrorText(err) << std::endl;
+        return;
+    }
+    initialized_ = true;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    scan_devices();
+}
+
+// AudioBackend destructor
+AudioBackend::~AudioBackend() {
+    if (initialized_) {
+        Pa_Terminate();
+    }
+}
+
+// Enumerate input devices into the cache (mutex held)
+void AudioBackend::scan_devices() {
+    auto devices = std::make_shared<std::vector<DeviceInfo>>();
+    if (initialized_) {
+        PaDeviceIndex default_input = Pa_GetDefaultInputDevice();
+        int count = Pa_GetDeviceCount();
+        for (int i = 0; i < count; i++) {
+            const PaDeviceInfo* info = Pa_GetDeviceInfo(i);
+            if (!info || info->maxInputChannels <= 0) {
+                continue;
+            }
+            const PaHostApiInfo* host = Pa_GetHostApiInfo(info->hostApi);
+
+            DeviceInfo device;
+            device.index = i;
+            device.name = info->name ? info->name : "";
+            device.host_api = host && host->name ? host->name : "";
+            device.max_input_channels = info->maxInputChannels;
+            device.default_sample_rate = info->defaultSampleRate;
+            device.default_low_latency = info->defaultLowInputLatency;
+            device.default_high_latency = info->defaultHighInputLatency;
+            device.is_default = i == default_input;
+            devices->push_back(std::move(device));
+        }
+    }
+
+    devices_ = std::move(devices);
+    format_cache_.clear();
+    stale_ = false;
+}
+
+// Re-initialize PortAudio so it rescans devices (mutex held, no open streams)
+bool AudioBackend::rescan() {
+    if (initialized_) {
+        Pa_Terminate();
+        initialized_ = false;
+    }
+    PaError err = Pa_Initialize();
+    if (err != paNoError) {
+        std::cerr << "PortAudio initialization error: " << Pa_GetErrorText(err) << std::endl;
+        scan_devices();
+        return false;
+    }
+    initialized_ = true;
+    scan_devices();
+    return true;
+}
+
+// Get the cached input devices
+std::shared_ptr<const std::vector<DeviceInfo>> AudioBackend::devices() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stale_ && open_streams_ == 0) {
+        rescan();
+    }
+    return devices_;
+}
+
+// Find a cached input device
+std::shared_ptr<const DeviceInfo> AudioBackend::find_device(int index) {
+    std::shared_ptr<const std::vector<DeviceInfo>> list = devices();
+    for (const DeviceInfo& device : *list) {
+        if (index == -1 ? device.is_default : device.index == index) {
+            // Shares ownership of the whole snapshot
+            return std::shared_ptr<const DeviceInfo>(list, &device);
+        }
+    }
+    return nullptr;
+}
+
+// Rescan devices if stale and nothing is open
+bool AudioBackend::refresh_if_stale() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!stale_) {
+        return true;
+    }
+    if (open_streams_ > 0) {
+        return false;
+    }
+    return rescan();
+}
+
+// Force a rescan
+bool AudioBackend::refresh_devices() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (open_streams_ > 0) {
+        stale_ = true;
+        return false;
+    }
+    return rescan();
+}
+
+// Check a stream format, caching the answer per device
+bool AudioBackend::is_format_supported(int device, int channels, int sample_format,
+                                       double sample_rate, double suggested_latency) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto key = std::make_tuple(device, channels, sample_format, sample_rate);
+    auto it = format_cache_.find(key);
+    if (it != format_cache_.end()) {
+        return it->second;
+    }
+
+    PaStreamParameters params;
+    params.device = device;
+    params.channelCount = channels;
+    params.sampleFormat = static_cast<PaSampleFormat>(sample_format);
+    params.suggestedLatency = suggested_latency;
+    params.hostApiSpecificStreamInfo = nullptr;
+    bool supported = initialized_ && Pa_IsFormatSupported(&params, nullptr, sample_rate) == paFormatIsSupported;
+
+    format_cache_.emplace(key, supported);
+    return supported;
+}
+
+// Count a stream as open
+void AudioBackend::begin_stream() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    open_streams_++;
+}
+
+// Count a stream as closed
+void AudioBackend::end_stream() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (open_streams_ > 0) {
+        open_streams_--;
+    }
+}
+
+} // namespace audio
+} // namespace koelingo
@@ -0,0 +1,146 @@
+/**
+ * @file audio_backend.h
+ * @brief Process-wide PortAudio lifetime and cached device list
+ */
+
+#ifndef KOELINGO_AUDIO_BACKEND_H
+#define KOELINGO_AUDIO_BACKEND_H
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace koelingo {
+namespace audio {
+
+/**
+ * @struct DeviceInfo
+ * @brief Snapshot of one PortAudio input device
+ */
+struct DeviceInfo {
+    int index = -1;                    ///< PortAudio device index
+    std::string name;                  ///< Device name
+    std::string host_api;              ///< Host API name (e.g. "Core Audio", "ALSA")
+    int max_input_channels = 0;        ///< Number of input channels
+    double default_sample_rate = 0.0;  ///< Native sample rate in Hz
+    double default_low_latency = 0.0;  ///< Suggested input latency in seconds
+    double default_high_latency = 0.0; ///< Suggested input latency for non-interactive use
+    bool is_default = false;           ///< True for the system default input
+};
+
+/**
+ * @class AudioBackend
+ * @brief Shared PortAudio instance used by every AudioCapture
+ *
+ * PortAudio is initialized by the first acquire() and stays initialized
+ * while any handle exists; the registry keeps one handle itself, so
+ * captures can be created and destroyed repeatedly without paying for
+ * Pa_Initialize()/Pa_Terminate() (and a full device scan) each time.
+ *
+ * Input devices are enumerated once and cached. PortAudio only rescans
+ * devices when it is re-initialized, which is not allowed while streams
+ * are open, so a refresh is deferred until the last stream closes: call
+ * notify_devices_changed() from a hotplug notification, and the next
+ * devices() or refresh_if_stale() call with no open stream rescans. A
+ * stream that fails to open on a missing device marks the list stale too.
+ */
+class AudioBackend {
+public:
+    /**
+     * @brief Get the process-wide backend, initializing PortAudio if needed
+     * @return Shared handle; retries initialization if it failed before
+     */
+    static std::shared_ptr<AudioBackend> acquire();
+
+    ~AudioBackend();
+
+    AudioBackend(const AudioBackend&) = delete;
+    AudioBackend& operator=(const AudioBackend&) = delete;
+
+    /**
+     * @brief Check whether PortAudio initialized successfully
+     */
+    bool is_initialized() const { return initialized_; }
+
+    /**
+     * @brief Get the cached input devices
+     * @return Immutable snapshot; rescanned first if stale and no stream is open
+     */
+    std::shared_ptr<const std::vector<DeviceInfo>> devices();
+
+    /**
+     * @brief Find a cached input device by PortAudio index
+     * @param index Device index, or -1 for the system default
+     * @return The device, or nullptr if it is not an input device
+     */
+    std::shared_ptr<const DeviceInfo> find_device(int index);
+
+    /**
+     * @brief Mark the device list as outdated (e.g. after a hotplug event)
+     *
+     * Safe to call from any thread, including OS notification callbacks.
+     */
+    void notify_devices_changed() { stale_ = true; }
+
+    /**
+     * @brief Rescan devices now if they are stale and no stream is open
+     * @return True if the device list is current
+     */
+    bool refresh_if_stale();
+
+    /**
+     * @brief Force a rescan of the devices
+     * @return False if a stream is open (the list is marked stale instead)
+     */
+    bool refresh_devices();
+
+    /**
+     * @brief Check a stream format, remembering the answer per device
+     * @param device Device index
+     * @param channels Input channel count
+     * @param sample_format PortAudio sample format
+     * @param sample_rate Sample rate in Hz
+     * @param suggested_latency Latency passed to PortAudio
+     * @return True if the device supports the format
+     *
+     * Probing can open the device (hundreds of milliseconds on some host
+     * APIs), so results are cached until the next rescan.
+     */
+    bool is_format_supported(int device, int channels, int sample_format, double sample_rate,
+                             double suggested_latency);
+
+    /**
+     * @brief Note that a stream is about to be opened; blocks rescans
+     *
+     * Must be paired with end_stream().
+     */
+    void begin_stream();
+
+    /**
+     * @brief Note that a stream was closed (or failed to open)
+     */
+    void end_stream();
+
+private:
+    AudioBackend();
+
+    std::atomic<bool> initialized_;
+    std::atomic<bool> stale_;
+
+    mutable std::mutex mutex_;
+    int open_streams_;
+    std::shared_ptr<const std::vector<DeviceInfo>> devices_;
+    std::map<std::tuple<int, int, int, double>, bool> format_cache_;
+
+    void scan_devices();
+    bool rescan();
+};
+
+} // namespace audio
+} // namespace koelingo
+
+#endif // KOELINGO_AUDIO_BACKEND_H
@@ -4,91 +4,323 @@
  */
 
 #include "audio_capture.h"
+#include "sample_format.h"
 #include <portaudio.h>
+#include <cctype>
 #include <cmath>
 #include <iostream>
-#include <fstream>
+#include <cstdio>
+#include <cstring>
 #include <chrono>
 #include <algorithm>
 
 namespace koelingo {
 namespace audio {
 
+namespace {
+
+// Current steady_clock time in nanoseconds
+int64_t steady_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Record a stage time, rounded to the nearest microsecond
+void record_stage_time(LatencyHistogram& histogram, int64_t ns) {
+    histogram.record(static_cast<uint64_t>(std::max<int64_t>(0, ns) + 500) / 1000);
+}
+
+} // namespace
+
 // AudioCapture constructor
 AudioCapture::AudioCapture(int sample_rate, int chunk_size, int channels, int format_type)
     : sample_rate_(sample_rate),
       chunk_size_(chunk_size),
       channels_(channels),
       format_type_(format_type),
-      pa_(nullptr),
+      backend_(AudioBackend::acquire()),
       stream_(nullptr),
       is_recording_(false),
       audio_level_callback_(nullptr),
-      recording_thread_(nullptr) {
-
-    // Initialize PortAudio
-    PaError err = Pa_Initialize();
-    if (err != paNoError) {
-        std::cerr << "PortAudio initialization error: " << Pa_GetErrorText(err) << std::endl;
-        return;
-    }
-
-    pa_ = reinterpret_cast<void*>(1); // Mark as initialized
+      notifier_thread_(nullptr),
+      stop_notifier_(false),
+      device_rate_(sample_rate),
+      device_channels_(channels),
+      period_frames_(chunk_size),
+      host_latency_(0.0),
+      requested_period_(0),
+      period_changes_(0),
+      device_failures_(0),
+      device_lost_(false),
+      stop_retune_(false),
+      frame_bytes_(static_cast<size_t>(channels) * bytes_per_sample(format_type)),
+      utterance_queue_(32),
+      dropped_utterances_(0),
+      onset_frame_(0),
+      speech_onsets_(0),
+      onsets_seen_(0),
+      dropped_chunks_(0),
+      pool_signal_(nullptr),
+      worker_cursor_(0),
+      callbacks_(0),
+      input_overflows_(0),
+      input_underflows_(0),
+      dropped_frames_(0),
+      peak_backlog_(0),
+      period_stamps_(256) {
 
-    // Calculate max buffer size (30 seconds of audio)
-    max_buffer_size_ = static_cast<int>(buffer_seconds_ * sample_rate_ / chunk_size_);
+    // Preallocate the ring buffer (30 seconds of audio) so the callback never allocates
+    ring_buffer_.resize(static_cast<size_t>(buffer_seconds_) * sample_rate_ * frame_bytes_);
 }
 
 // AudioCapture destructor
 AudioCapture::~AudioCapture() {
     // Stop recording if active
     stop_recording();
-
-    // Terminate PortAudio
-    if (pa_) {
-        Pa_Terminate();
-        pa_ = nullptr;
-    }
 }
 
 // Start recording audio
-bool AudioCapture::start_recording(std::function<void(float)> audio_level_callback) {
+bool AudioCapture::start_recording(std::function<void(float)> audio_level_callback,
+                                   std::function<void(const AudioLevels&)> levels_callback) {
     if (is_recording_) {
         return true;
     }
 
-    if (!pa_) {
+    // Finish tearing down a recording that lost its device
+    if (device_lost_) {
+        stop_recording();
+    }
+
+    // Input sources do not need PortAudio
+    if (!input_source_ && !backend_->is_initialized()) {
         std::cerr << "PortAudio not initialized" << std::endl;
         return false;
     }
 
     audio_level_callback_ = audio_level_callback;
+    levels_callback_ = levels_callback;
 
     // Clear the audio buffer
+    ring_buffer_.reset();
+
+    // Prepare the VAD up front so the callback never allocates
+    utterance_queue_.clear();
+    speech_onsets_ = 0;
+    onsets_seen_ = 0;
+    drain_chunk_queue();
+    dropped_chunks_ = 0;
+    if (vad_config_.enabled) {
+        VadConfig config = vad_config_;
+
+        // Utterances are read back from the ring buffer, so they must fit in it
+        config.max_utterance_ms = std::min(config.max_utterance_ms, (buffer_seconds_ - 1) * 1000);
+        vad_.configure(config, sample_rate_, speech_detector_);
+        vad_.set_segment_callback([this](const UtteranceSegment& segment) {
+            if (!utterance_queue_.push(segment)) {
+                dropped_utterances_++;
+                return;
+            }
+            utterance_signal_.notify();
+            if (event_bus_ && event_bus_->wants(EventType::kUtterance)) {
+                Event event;
+                event.type = EventType::kUtterance;
+                event.source = event_source_;
+                event.start_frame = segment.start_frame;
+                event.end_frame = segment.end_frame;
+                event.truncated = segment.truncated;
+                event_bus_->publish(event);
+            }
+        });
+        vad_.set_onset_callback([this](uint64_t frame) {
+            onset_frame_ = frame;
+            speech_onsets_++;
+            onset_signal_.notify();
+            if (event_bus_ && event_bus_->wants(EventType::kSpeechOnset)) {
+                Event event;
+                event.type = EventType::kSpeechOnset;
+                event.source = event_source_;
+                event.start_frame = frame;
+                event_bus_->publish(event);
+            }
+        });
+    }
+    // Staging buffers must hold the longest utterance of this VAD configuration
+    if (staging_pool_ && staging_pool_->chunk_bytes() < staging_frames_needed() * channels_ * sizeof(float)) {
+        std::cerr << "VAD utterances outgrew the staging buffers; reallocating them" << std::endl;
+        create_staging_pool();
+    }
+    if (mel_config_.enabled && !mel_.configure(mel_config_, sample_rate_)) {
+        return false;
+    }
+    if (vad_config_.enabled || mel_config_.enabled) {
+        mono_scratch_.assign(static_cast<size_t>(chunk_size_), 0.0f);
+    }
+
+    // Denoise and gain control only matter to the stages after them; the
+    // processed ring mirrors the capture ring, so it holds mono frames only
+    preprocessing_ = (noise_config_.enabled || gain_config_.enabled) &&
+                     (vad_config_.enabled || mel_config_.enabled);
+    if (preprocessing_ && channels_ != 1) {
+        std::cerr << "Noise suppression and gain control need mono capture; skipping them" << std::endl;
+        preprocessing_ = false;
+    }
+    if (preprocessing_) {
+        denoiser_.configure(noise_config_, sample_rate_);
+        agc_.configure(gain_config_, sample_rate_);
+        if (processed_buffer_.capacity() != ring_buffer_.capacity()) {
+            processed_buffer_.resize(ring_buffer_.capacity());
+        }
+        processed_buffer_.reset();
+        // The suppressor can emit up to one hop more than it was given
+        processed_scratch_.assign(static_cast<size_t>(chunk_size_) + denoiser_.hop(), 0.0f);
+        processed_bytes_.assign(processed_scratch_.size() * frame_bytes_, 0);
+    }
+    worker_block_.assign(static_cast<size_t>(chunk_size_) * frame_bytes_, 0);
+    level_scratch_.assign(static_cast<size_t>(channels_), ChannelLevel());
+    level_mailbox_.clear();
+    next_level_event_ns_ = 0;
+    worker_cursor_ = 0;
+    stop_notifier_ = false;
+
+    // Statistics describe one recording
+    callbacks_ = 0;
+    input_overflows_ = 0;
+    input_underflows_ = 0;
+    dropped_frames_ = 0;
+    peak_backlog_ = 0;
+    callback_duration_.reset();
+    input_latency_.reset();
+    processing_latency_.reset();
+    level_time_.reset();
+    denoise_time_.reset();
+    agc_time_.reset();
+    vad_time_.reset();
+    mel_time_.reset();
+    period_stamps_.clear();
+    has_pending_stamp_ = false;
+
+    // A recording armed while stopped starts at the first frame
+    if (recording_armed_) {
+        recording_armed_ = false;
+        if (!recorder_.start(recorder_config_, ring_buffer_, data_signal_, 0,
+                             sample_rate_, channels_, format_type_)) {
+            return false;
+        }
+    }
+
+    // Device period and processing wake cadence
+    period_frames_ = latency_config_.period_frames > 0 ? latency_config_.period_frames : chunk_size_;
+    period_changes_ = 0;
+    device_failures_ = 0;
+    periods_since_wake_ = 0;
+    requested_period_ = 0;
+    host_latency_ = 0.0;
+
+    // Analysis runs on the shared pool, or on a private thread
+    active_pool_ = processing_pool_ ? processing_pool_
+                                    : std::make_shared<WorkerPool>(1, processing_policy_);
+    pool_signal_ = &active_pool_->signal();
+
+    // Report the scheduling and memory locking this recording gets
     {
-        std::lock_guard<std::mutex> lock(buffer_mutex_);
-        audio_buffer_.clear();
+        std::lock_guard<std::mutex> lock(realtime_mutex_);
+        realtime_report_ = RealtimeReport();
+        realtime_report_.processing = active_pool_->policy_result();
+    }
+    lock_buffers();
+    capture_policy_pending_ = capture_policy_.realtime || !capture_policy_.cpus.empty();
+
+    // Missing privileges are reported once per instance, not on every start
+    RealtimeReport report = get_realtime_report();
+    std::string reason = !report.processing.error.empty() ? report.processing.error : report.memory_error;
+    if (!reason.empty() && !realtime_warned_) {
+        realtime_warned_ = true;
+        std::cerr << "Real-time settings not fully applied: " << reason << std::endl;
+    }
+
+    // Open the device, or start the configured input source instead
+    active_source_ = input_source_;
+    LatencyConfig controller_config = latency_config_;
+    controller_config.adaptive = latency_config_.adaptive && !active_source_;
+    period_controller_.configure(controller_config, sample_rate_, period_frames_);
+    if (!(active_source_ ? open_source() : open_device())) {
+        pool_signal_ = nullptr;
+        active_pool_.reset();
+        unlock_buffers();
+        active_source_.reset();
+        recorder_.stop();
+        return false;
     }
 
+    is_recording_ = true;
+
+    // Start servicing the stream
+    active_pool_->add(this);
+
+    // Period changes reopen the device off the callback thread
+    if (controller_config.adaptive) {
+        stop_retune_ = false;
+        retune_thread_ = std::make_unique<std::thread>(&AudioCapture::retune_loop, this);
+    }
+
+    // Level callbacks (which may need the Python GIL) get their own thread
+    if (audio_level_callback_ || levels_callback_) {
+        notifier_thread_ = std::make_unique<std::thread>(&AudioCapture::deliver_levels, this);
+    }
+
+    return true;
+}
+
+// Open and start the PortAudio stream for the selected device
+bool AudioCapture::open_device() {
+    // Pick up hotplugged devices, then hold off rescans while the stream is open
+    backend_->refresh_if_stale();
+    backend_->begin_stream();
+
     // Open a PortAudio stream
     PaStreamParameters inputParams;
-    inputParams.device = Pa_GetDefaultInputDevice();
-    if (inputParams.device == paNoDevice) {
-        std::cerr << "No default input device" << std::endl;
+    inputParams.device = resolve_input_device();
+    std::shared_ptr<const DeviceInfo> device_info = backend_->find_device(inputParams.device);
+    if (inputParams.device == paNoDevice || !device_info) {
+        std::cerr << "No matching input device" << std::endl;
+        backend_->end_stream();
         return false;
     }
+    if (!device_name_.empty()) {
+        device_index_ = inputParams.device;
+    }
 
     inputParams.channelCount = channels_;
     inputParams.sampleFormat = format_type_;
-    inputParams.suggestedLatency = Pa_GetDeviceInfo(inputParams.device)->defaultLowInputLatency;
+    inputParams.suggestedLatency = latency_config_.suggested_latency > 0.0
+        ? latency_config_.suggested_latency
+        : latency_config_.high_latency ? device_info->default_high_latency
+                                       : device_info->default_low_latency;
     inputParams.hostApiSpecificStreamInfo = nullptr;
 
+    // Prefer the device's own rate and layout over host API conversion
+    device_rate_ = sample_rate_;
+    device_channels_ = channels_;
+    if (native_rate_capture_ && channels_ == 1 && device_info->default_sample_rate > 0) {
+        device_rate_ = static_cast<int>(device_info->default_sample_rate);
+
+        // Some devices do not offer mono; capture every channel and downmix
+        if (!backend_->is_format_supported(inputParams.device, channels_, format_type_, device_rate_,
+                                           inputParams.suggestedLatency) &&
+            device_info->max_input_channels > 1) {
+            device_channels_ = device_info->max_input_channels;
+        }
+    }
+
+    unsigned long device_chunk = configure_conversion(true);
+    inputParams.channelCount = device_channels_;
+
     PaError err = Pa_OpenStream(
         reinterpret_cast<PaStream**>(&stream_),
         &inputParams,
         nullptr,  // No output
-        sample_rate_,
-        chunk_size_,
+        device_rate_,
+        device_chunk,
         paClipOff,
         reinterpret_cast<PaStreamCallback*>(&AudioCapture::audio_callback),
         this
@@ -96,6 +328,12 @@ bool AudioCapture::start_recording(std::function<void(float)> audio_level_callba
 
     if (err != paNoError) {
         std::cerr << "Error opening PortAudio stream: " << Pa_GetErrorText(err) << std::endl;
+
+        // The device may have been unplugged since the last scan
+        if (err == paInvalidDevice || err == paDeviceUnavailable) {
+            backend_->notify_devices_changed();
+        }
+        backend_->end_stream();
         return false;
     }
 
@@ -105,59 +343,804 @@ bool AudioCapture::start_recording(std::function<void(float)> audio_level_callba
         std::cerr << "Error starting PortAudio stream: " << Pa_GetErrorText(err) << std::endl;
         Pa_CloseStream(reinterpret_cast<PaStream*>(stream_));
         stream_ = nullptr;
+        backend_->end_stream();
         return false;
     }
 
-    is_recording_ = true;
-
-    // Start background processing thread
-    recording_thread_ = std::make_unique<std::thread>(&AudioCapture::process_audio, this);
+    // Host APIs may round the suggested latency; report what they chose
+    const PaStreamInfo* stream_info = Pa_GetStreamInfo(reinterpret_cast<PaStream*>(stream_));
+    host_latency_ = stream_info ? stream_info->inputLatency : 0.0;
 
     return true;
 }
 
+// Close the PortAudio stream
+void AudioCapture::close_device() {
+    if (stream_) {
+        Pa_StopStream(reinterpret_cast<PaStream*>(stream_));
+        Pa_CloseStream(reinterpret_cast<PaStream*>(stream_));
+        stream_ = nullptr;
+        backend_->end_stream();
+    }
+}
+
+// Reopen the device with the periods the controller asks for
+void AudioCapture::retune_loop() {
+    while (true) {
+        uint32_t seen = retune_signal_.sequence();
+        if (stop_retune_) {
+            return;
+        }
+        int period = requested_period_.exchange(0);
+        if (period <= 0) {
+            retune_signal_.wait(seen, std::chrono::milliseconds(500));
+            continue;
+        }
+
+        // No callbacks run between close and open, so the controller can be
+        // reset; the new stream has a new callback thread to configure
+        int previous = period_frames_;
+        close_device();
+        period_frames_ = period;
+        period_controller_.set_period(period);
+        capture_policy_pending_ = capture_policy_.realtime || !capture_policy_.cpus.empty();
+        bool opened = open_device();
+        if (!opened) {
+            device_failures_++;
+            std::cerr << "Could not reopen the device with " << period
+                      << "-frame periods; keeping " << previous << std::endl;
+            period_frames_ = previous;
+            period_controller_.set_period(previous);
+            opened = open_device();
+        }
+        if (!opened) {
+            device_failures_++;
+            std::cerr << "Lost the input device while changing its period" << std::endl;
+
+            // End the recording so readers stop waiting for frames that will
+            // never come; stop_recording() still joins this thread and drains
+            device_lost_ = true;
+            is_recording_ = false;
+            data_signal_.notify();
+            utterance_signal_.notify();
+            onset_signal_.notify();
+            chunk_signal_.notify();
+            return;
+        }
+        if (period_frames_ != previous) {
+            period_changes_++;
+        }
+    }
+}
+
+// Start the configured input source
+bool AudioCapture::open_source() {
+    // Sources deliver their own rate and layout, which only mono captures can convert
+    device_rate_ = active_source_->sample_rate();
+    device_channels_ = active_source_->channels();
+    if ((device_rate_ != sample_rate_ || device_channels_ != channels_) && channels_ != 1) {
+        std::cerr << "Input source must match the capture rate and channels" << std::endl;
+        return false;
+    }
+    unsigned long period_frames = configure_conversion(false);
+    if (period_frames == 0) {
+        return false;
+    }
+    return active_source_->start(this, period_frames, format_type_);
+}
+
+// Set up conversion from the device format to the capture format
+unsigned long AudioCapture::configure_conversion(bool fallback_to_capture_rate) {
+    // Keep the device period as long as the configured period
+    const int period_frames = period_frames_;
+    unsigned long device_chunk = std::max<unsigned long>(
+        1, static_cast<unsigned long>(period_frames) * device_rate_ / sample_rate_);
+
+    resampling_ = device_rate_ != sample_rate_ || device_channels_ != channels_;
+    if (resampling_ && !resampler_.configure(device_rate_, sample_rate_, device_channels_,
+                                             format_type_, device_chunk)) {
+        if (!fallback_to_capture_rate) {
+            return 0;
+        }
+        std::cerr << "Falling back to opening the device at " << sample_rate_ << " Hz" << std::endl;
+        resampling_ = false;
+        device_rate_ = sample_rate_;
+        device_channels_ = channels_;
+        device_chunk = period_frames;
+    }
+    if (resampling_) {
+        resample_output_.assign(resampler_.max_output_frames(device_chunk), 0.0f);
+        resample_bytes_.assign(resample_output_.size() * frame_bytes_, 0);
+    }
+    return device_chunk;
+}
+
 // Stop recording audio
 void AudioCapture::stop_recording() {
-    if (!is_recording_) {
+    if (!is_recording_ && !device_lost_) {
         return;
     }
 
-    is_recording_ = false;
+    // Finish a period change in progress, then close the PortAudio stream
+    if (retune_thread_) {
+        stop_retune_ = true;
+        retune_signal_.notify();
+        if (retune_thread_->joinable()) {
+            retune_thread_->join();
+        }
+        retune_thread_.reset();
+    }
+    close_device();
+    if (active_source_) {
+        active_source_->stop();
+    }
 
-    // Close the PortAudio stream
-    if (stream_) {
-        Pa_StopStream(reinterpret_cast<PaStream*>(stream_));
-        Pa_CloseStream(reinterpret_cast<PaStream*>(stream_));
-        stream_ = nullptr;
+    // No more callbacks: take the stream off the pool and drain what is left
+    if (active_pool_) {
+        active_pool_->remove(this);
+        run_pending();
+        pool_signal_ = nullptr;
+        active_pool_.reset();
     }
 
-    // Wait for the processing thread to finish
-    if (recording_thread_ && recording_thread_->joinable()) {
-        recording_thread_->join();
-        recording_thread_.reset();
+    // Emit the utterance in progress now that the stream has ended
+    if (vad_config_.enabled) {
+        vad_.flush();
     }
+
+    // Every captured frame is in the ring now; finish the file
+    recorder_.stop();
+    unlock_buffers();
+
+    // The notifier delivers the final levels before it exits
+    stop_notifier_ = true;
+    level_signal_.notify();
+    if (notifier_thread_ && notifier_thread_->joinable()) {
+        notifier_thread_->join();
+        notifier_thread_.reset();
+    }
+
+    // Only report that recording has stopped once the last utterance has
+    // been queued, so consumers cannot miss it
+    is_recording_ = false;
+    device_lost_ = false;
+
+    // Release anyone blocked in wait_for_frames(), wait_for_utterance(),
+    // wait_for_speech_onset() or wait_for_chunk()
+    data_signal_.notify();
+    utterance_signal_.notify();
+    onset_signal_.notify();
+    chunk_signal_.notify();
 }
 
 // Get the current audio buffer
 std::vector<char> AudioCapture::get_buffer() const {
-    std::lock_guard<std::mutex> lock(buffer_mutex_);
+    uint64_t end = ring_buffer_.write_position();
+    uint64_t start = end > ring_buffer_.capacity() ? end - ring_buffer_.capacity() : 0;
 
-    // Calculate total size
-    size_t totalSize = 0;
-    for (const auto& chunk : audio_buffer_) {
-        totalSize += chunk.size();
+    std::vector<char> buffer(static_cast<size_t>(end - start));
+    if (buffer.empty()) {
+        return buffer;
     }
 
-    // Concatenate all chunks
-    std::vector<char> buffer;
-    buffer.reserve(totalSize);
-    for (const auto& chunk : audio_buffer_) {
-        buffer.insert(buffer.end(), chunk.begin(), chunk.end());
-    }
+    // Drop any leading bytes the capture thread overwrote during the copy
+    start = ring_buffer_.copy(start, end, buffer.data());
+    buffer.resize(static_cast<size_t>(end - start));
 
     return buffer;
 }
 
+// Get the current audio buffer as normalized float32 samples
+std::vector<float> AudioCapture::get_buffer_float32() const {
+    const size_t sample_bytes = frame_bytes_ / channels_;
+    std::vector<float> samples;
+
+    while (true) {
+        RingBufferSpans spans = ring_buffer_.read_spans(0, ring_buffer_.write_position());
+
+        // Convert straight out of the ring; frames never straddle the wrap point
+        size_t first_count = spans.first_size / sample_bytes;
+        samples.resize(first_count + spans.second_size / sample_bytes);
+        convert_to_float32(spans.first, first_count, format_type_, samples.data());
+        convert_to_float32(spans.second, samples.size() - first_count, format_type_,
+                           samples.data() + first_count);
+
+        // Retry if the capture thread lapped us while converting
+        if (ring_buffer_.is_intact(spans.start)) {
+            return samples;
+        }
+    }
+}
+
+// Read only the frames captured since a cursor
+AudioReadResult AudioCapture::read_new(uint64_t cursor, size_t max_frames) const {
+    return read_ring(ring_buffer_, cursor, max_frames);
+}
+
+// Read frames after a cursor from the capture ring or the processed ring
+AudioReadResult AudioCapture::read_ring(const RingBuffer& ring, uint64_t cursor, size_t max_frames) const {
+    AudioReadResult result;
+
+    uint64_t end = ring.write_position();
+    uint64_t from = std::min(cursor * frame_bytes_, end);
+    if (max_frames > 0) {
+        end = std::min<uint64_t>(end, from + max_frames * frame_bytes_);
+    }
+
+    result.data.resize(static_cast<size_t>(end - from));
+    uint64_t start = from;
+    if (!result.data.empty()) {
+        // Skips anything the capture thread already overwrote
+        start = ring.copy(from, end, result.data.data());
+        result.data.resize(static_cast<size_t>(end - start));
+    }
+
+    result.start_frame = start / frame_bytes_;
+    result.next_cursor = end / frame_bytes_;
+    result.dropped_frames = result.start_frame > cursor ? result.start_frame - cursor : 0;
+    return result;
+}
+
+// Block until enough frames are available after a cursor
+bool AudioCapture::wait_for_frames(uint64_t cursor, size_t frames, int timeout_ms) const {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+
+    while (true) {
+        // Read the sequence first so a write landing after the check wakes us
+        uint32_t seen = data_signal_.sequence();
+        if (frames_written() >= cursor + frames) {
+            return true;
+        }
+        if (!is_recording_) {
+            return false;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            return false;
+        }
+        data_signal_.wait(seen, std::chrono::duration_cast<std::chrono::microseconds>(deadline - now));
+    }
+}
+
+// Choose whether mono capture runs at the device's native rate
+bool AudioCapture::set_native_rate_capture(bool enabled) {
+    if (is_recording_) {
+        std::cerr << "Cannot change the capture rate mode while recording" << std::endl;
+        return false;
+    }
+    native_rate_capture_ = enabled;
+    return true;
+}
+
+// Select the input device by index
+bool AudioCapture::set_input_device(int index) {
+    if (is_recording_) {
+        std::cerr << "Cannot change input device while recording" << std::endl;
+        return false;
+    }
+    if (index != -1) {
+        if (index < 0 || !backend_->find_device(index)) {
+            std::cerr << "Invalid input device index: " << index << std::endl;
+            return false;
+        }
+    }
+    device_index_ = index;
+    device_name_.clear();
+    return true;
+}
+
+// Select the input device by name
+bool AudioCapture::set_input_device(const std::string& name) {
+    if (is_recording_) {
+        std::cerr << "Cannot change input device while recording" << std::endl;
+        return false;
+    }
+
+    std::string previous = device_name_;
+    device_name_ = name;
+    if (!name.empty() && resolve_input_device() == paNoDevice) {
+        std::cerr << "No input device matches: " << name << std::endl;
+        device_name_ = previous;
+        return false;
+    }
+    device_index_ = name.empty() ? -1 : resolve_input_device();
+    return true;
+}
+
+// Find the PortAudio index of the selected input device
+int AudioCapture::resolve_input_device() const {
+    if (!backend_->is_initialized()) {
+        return paNoDevice;
+    }
+    if (device_name_.empty()) {
+        if (device_index_ >= 0) {
+            return device_index_;
+        }
+        std::shared_ptr<const DeviceInfo> fallback = backend_->find_device(-1);
+        return fallback ? fallback->index : paNoDevice;
+    }
+
+    auto lower = [](std::string text) {
+        std::transform(text.begin(), text.end(), text.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return text;
+    };
+    const std::string wanted = lower(device_name_);
+
+    // An exact name wins over a partial match
+    int partial = paNoDevice;
+    for (const DeviceInfo& device : *backend_->devices()) {
+        if (device_name_ == device.name) {
+            return device.index;
+        }
+        if (partial == paNoDevice && lower(device.name).find(wanted) != std::string::npos) {
+            partial = device.index;
+        }
+    }
+    return partial;
+}
+
+// Use a shared processing pool
+bool AudioCapture::set_processing_pool(std::shared_ptr<WorkerPool> pool) {
+    if (is_recording_) {
+        std::cerr << "Cannot change processing pool while recording" << std::endl;
+        return false;
+    }
+    processing_pool_ = std::move(pool);
+    return true;
+}
+
+// Set the scheduling of the private processing thread
+bool AudioCapture::set_processing_policy(const ThreadPolicy& policy) {
+    if (is_recording_) {
+        std::cerr << "Cannot change the processing policy while recording" << std::endl;
+        return false;
+    }
+    processing_policy_ = policy;
+    return true;
+}
+
+// Set the scheduling of the thread delivering periods
+bool AudioCapture::set_capture_policy(const ThreadPolicy& policy) {
+    if (is_recording_) {
+        std::cerr << "Cannot change the capture policy while recording" << std::endl;
+        return false;
+    }
+    capture_policy_ = policy;
+    return true;
+}
+
+// Choose whether capture buffers are locked in RAM
+bool AudioCapture::set_lock_memory(bool enabled) {
+    if (is_recording_) {
+        std::cerr << "Cannot change memory locking while recording" << std::endl;
+        return false;
+    }
+    lock_memory_ = enabled;
+    return true;
+}
+
+// Get the scheduling and memory locking of the current (or last) recording
+RealtimeReport AudioCapture::get_realtime_report() const {
+    std::lock_guard<std::mutex> lock(realtime_mutex_);
+    return realtime_report_;
+}
+
+// Fault in and lock the ring buffer and chunk pool
+void AudioCapture::lock_buffers() {
+    if (!lock_memory_) {
+        return;
+    }
+    std::vector<std::pair<void*, size_t>> regions = {{ring_buffer_.storage(), ring_buffer_.capacity()}};
+    if (chunk_pool_) {
+        regions.emplace_back(chunk_pool_->arena(), chunk_pool_->arena_bytes());
+    }
+    if (staging_pool_) {
+        regions.emplace_back(staging_pool_->arena(), staging_pool_->arena_bytes());
+    }
+    if (preprocessing_) {
+        regions.emplace_back(processed_buffer_.storage(), processed_buffer_.capacity());
+    }
+
+    bool locked = true;
+    std::string error;
+    for (const auto& region : regions) {
+        if (lock_memory(region.first, region.second, &error)) {
+            locked_regions_.push_back(region);
+        } else {
+            locked = false;
+            break;
+        }
+    }
+    if (!locked) {
+        unlock_buffers();
+    }
+
+    std::lock_guard<std::mutex> lock(realtime_mutex_);
+    realtime_report_.memory_locked = locked;
+    realtime_report_.memory_error = error;
+}
+
+// Undo lock_buffers()
+void AudioCapture::unlock_buffers() {
+    for (const auto& region : locked_regions_) {
+        unlock_memory(region.first, region.second);
+    }
+    locked_regions_.clear();
+}
+
+// Set the maximum level callback rate
+bool AudioCapture::set_level_update_rate(int hz) {
+    if (is_recording_) {
+        std::cerr << "Cannot change level update rate while recording" << std::endl;
+        return false;
+    }
+    if (hz < 0) {
+        std::cerr << "Level update rate must not be negative" << std::endl;
+        return false;
+    }
+    level_update_hz_ = hz;
+    return true;
+}
+
+// Publish pipeline events on a bus
+bool AudioCapture::set_event_bus(std::shared_ptr<EventBus> bus, uint32_t source) {
+    if (is_recording_) {
+        std::cerr << "Cannot change event bus while recording" << std::endl;
+        return false;
+    }
+    event_bus_ = std::move(bus);
+    event_source_ = source;
+    return true;
+}
+
+// Configure the voice activity detector
+bool AudioCapture::set_vad_config(const VadConfig& config) {
+    if (is_recording_) {
+        std::cerr << "Cannot change VAD configuration while recording" << std::endl;
+        return false;
+    }
+    vad_config_ = config;
+    return true;
+}
+
+// Configure the log-mel front end
+bool AudioCapture::set_mel_config(const MelConfig& config) {
+    if (is_recording_) {
+        std::cerr << "Cannot change mel configuration while recording" << std::endl;
+        return false;
+    }
+    mel_config_ = config;
+    return true;
+}
+
+// Configure noise suppression
+bool AudioCapture::set_noise_suppression_config(const NoiseSuppressionConfig& config) {
+    if (is_recording_) {
+        std::cerr << "Cannot change noise suppression while recording" << std::endl;
+        return false;
+    }
+    noise_config_ = config;
+    return true;
+}
+
+// Configure automatic gain control
+bool AudioCapture::set_gain_control_config(const GainControlConfig& config) {
+    if (is_recording_) {
+        std::cerr << "Cannot change gain control while recording" << std::endl;
+        return false;
+    }
+    gain_config_ = config;
+    return true;
+}
+
+// Replace the speech detector used by the VAD
+bool AudioCapture::set_speech_detector(std::shared_ptr<SpeechDetector> detector) {
+    if (is_recording_) {
+        std::cerr << "Cannot change speech detector while recording" << std::endl;
+        return false;
+    }
+    speech_detector_ = std::move(detector);
+    return true;
+}
+
+// Block until the VAD has a complete utterance
+bool AudioCapture::wait_for_utterance(Utterance& utterance, int timeout_ms) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+
+    while (true) {
+        uint32_t seen = utterance_signal_.sequence();
+
+        // Sample the state before popping: once recording is seen as stopped,
+        // the final flushed utterance is guaranteed to be visible
+        bool recording = is_recording_;
+
+        UtteranceSegment segment;
+        if (utterance_queue_.pop(segment)) {
+            AudioReadResult audio = read_ring(utterance_ring(), segment.start_frame,
+                                              segment.end_frame - segment.start_frame);
+            utterance.data = std::move(audio.data);
+            utterance.start_frame = audio.start_frame;
+            utterance.end_frame = audio.next_cursor;
+            utterance.truncated = segment.truncated;
+            return true;
+        }
+        if (!recording) {
+            return false;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            return false;
+        }
+        utterance_signal_.wait(seen, std::chrono::duration_cast<std::chrono::microseconds>(deadline - now));
+    }
+}
+
+// Hand utterances out in float32 staging buffers
+bool AudioCapture::set_utterance_staging(size_t buffers, size_t max_frames) {
+    if (is_recording_) {
+        std::cerr << "Cannot change utterance staging while recording" << std::endl;
+        return false;
+    }
+    staging_buffers_ = buffers;
+    staging_frames_ = max_frames;
+    create_staging_pool();
+    return true;
+}
+
+// Frames a staging buffer needs for the longest utterance
+size_t AudioCapture::staging_frames_needed() const {
+    if (staging_frames_ > 0) {
+        return staging_frames_;
+    }
+    // Utterances are split at max_utterance_ms, at most one analysis window late
+    int ms = std::min(vad_config_.max_utterance_ms, (buffer_seconds_ - 1) * 1000) + vad_config_.frame_ms;
+    return static_cast<size_t>(ms) * static_cast<size_t>(sample_rate_) / 1000 + 1;
+}
+
+// (Re)allocate the staging pool
+void AudioCapture::create_staging_pool() {
+    staging_pool_.reset(); // Buffers still held elsewhere keep the old pool alive
+    if (staging_buffers_ == 0) {
+        return;
+    }
+    // Page-aligned buffers let a GPU runtime pin the arena without copying
+    staging_signal_ = std::make_shared<DataSignal>();
+    staging_pool_ = ChunkPool::create(staging_buffers_,
+                                      staging_frames_needed() * channels_ * sizeof(float),
+                                      memory_page_size());
+    staging_pool_->set_release_signal(staging_signal_);
+}
+
+// Block until the VAD has a complete utterance and stage it
+bool AudioCapture::wait_for_staged_utterance(StagedUtterance& utterance, int timeout_ms) {
+    if (!staging_pool_) {
+        return false;
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+
+    // Take the buffer first so an utterance is only dequeued once it has somewhere to go
+    PooledChunk buffer;
+    while (true) {
+        uint32_t seen = utterance_signal_.sequence();
+        uint32_t released = staging_signal_->sequence();
+        bool recording = is_recording_;
+
+        if (!buffer) {
+            buffer = staging_pool_->acquire();
+        }
+        UtteranceSegment segment;
+        if (buffer && utterance_queue_.pop(segment)) {
+            stage_segment(segment, buffer, utterance);
+            return true;
+        }
+        // Queued utterances are still waited for after stop while every buffer is held
+        if (buffer && !recording) {
+            return false;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            return false;
+        }
+        auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(deadline - now);
+        if (buffer) {
+            utterance_signal_.wait(seen, remaining);
+        } else {
+            staging_signal_->wait(released, remaining);
+        }
+    }
+}
+
+// Convert an utterance straight from the ring buffer into a staging buffer
+void AudioCapture::stage_segment(const UtteranceSegment& segment, PooledChunk& buffer,
+                                 StagedUtterance& utterance) {
+    const RingBuffer& ring = utterance_ring();
+    const size_t sample_bytes = frame_bytes_ / channels_;
+    const uint64_t capacity_frames = buffer.capacity() / (sizeof(float) * channels_);
+    const uint64_t end_frame = std::min(segment.end_frame, segment.start_frame + capacity_frames);
+    float* samples = reinterpret_cast<float*>(buffer.data());
+
+    while (true) {
+        RingBufferSpans spans = ring.read_spans(segment.start_frame * frame_bytes_,
+                                                end_frame * frame_bytes_);
+
+        size_t first_count = spans.first_size / sample_bytes;
+        size_t count = first_count + spans.second_size / sample_bytes;
+        convert_to_float32(spans.first, first_count, format_type_, samples);
+        convert_to_float32(spans.second, count - first_count, format_type_, samples + first_count);
+
+        // Retry from the new oldest frame if the capture thread lapped us
+        if (ring.is_intact(spans.start)) {
+            uint64_t start_frame = spans.start / frame_bytes_;
+            buffer.set_contents(count * sizeof(float), start_frame);
+            utterance.start_frame = start_frame;
+            utterance.end_frame = start_frame + count / channels_;
+            utterance.truncated = segment.truncated || end_frame < segment.end_frame;
+            utterance.samples = std::move(buffer);
+            return;
+        }
+    }
+}
+
+// Choose how the device clocks the stream
+bool AudioCapture::set_latency_config(const LatencyConfig& config) {
+    if (is_recording_) {
+        std::cerr << "Cannot change latency settings while recording" << std::endl;
+        return false;
+    }
+    if (config.period_frames < 0 || config.suggested_latency < 0.0 || config.wake_periods < 1) {
+        std::cerr << "Invalid latency settings" << std::endl;
+        return false;
+    }
+    latency_config_ = config;
+    return true;
+}
+
+// Get the latency the stream actually runs with
+EffectiveLatency AudioCapture::get_effective_latency() const {
+    EffectiveLatency latency;
+    latency.period_frames = period_frames_;
+    latency.period_ms = 1000.0 * latency.period_frames / sample_rate_;
+    latency.host_latency_ms = 1000.0 * host_latency_;
+    latency.wake_periods = latency_config_.wake_periods;
+    latency.total_ms = latency.host_latency_ms + latency.period_ms * latency.wake_periods;
+    latency.period_changes = period_changes_;
+    return latency;
+}
+
+// Enable or disable the pooled chunk queue
+bool AudioCapture::set_chunk_queue(size_t chunks) {
+    if (is_recording_) {
+        std::cerr << "Cannot change the chunk queue while recording" << std::endl;
+        return false;
+    }
+    drain_chunk_queue();
+    chunk_queue_.reset();
+    chunk_pool_.reset(); // Chunks still held elsewhere keep the old pool alive
+    if (chunks > 0) {
+        chunk_pool_ = ChunkPool::create(chunks, static_cast<size_t>(chunk_size_) * frame_bytes_);
+        chunk_queue_ = std::make_unique<SpscQueue<uint32_t>>(chunks);
+    }
+    return true;
+}
+
+// Wait for the next pooled chunk
+bool AudioCapture::wait_for_chunk(PooledChunk& chunk, int timeout_ms) {
+    if (!chunk_queue_) {
+        return false;
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+
+    while (true) {
+        uint32_t seen = chunk_signal_.sequence();
+        bool recording = is_recording_;
+
+        uint32_t index;
+        if (chunk_queue_->pop(index)) {
+            chunk = chunk_pool_->adopt(index);
+            return true;
+        }
+        if (!recording) {
+            return false;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            return false;
+        }
+        chunk_signal_.wait(seen, std::chrono::duration_cast<std::chrono::microseconds>(deadline - now));
+    }
+}
+
+// Wait for the next speech onset
+bool AudioCapture::wait_for_speech_onset(uint64_t& frame, int timeout_ms) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+
+    while (true) {
+        uint32_t seen = onset_signal_.sequence();
+        bool recording = is_recording_;
+
+        // The frame is stored before the count, so it belongs to this onset or a newer one
+        uint64_t onsets = speech_onsets_;
+        if (onsets != onsets_seen_) {
+            onsets_seen_ = onsets;
+            frame = onset_frame_;
+            return true;
+        }
+        if (!recording) {
+            return false;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            return false;
+        }
+        onset_signal_.wait(seen, std::chrono::duration_cast<std::chrono::microseconds>(deadline - now));
+    }
+}
+
+// Feed captured frames to the mono analysis stages (VAD and mel front end)
+void AudioCapture::run_analysis(const char* audio_data, size_t frames) {
+    // Convert in scratch-sized blocks; the scratch buffers are preallocated
+    while (frames > 0) {
+        size_t block = std::min(frames, mono_scratch_.size());
+        convert_to_mono_float32(audio_data, block, channels_, format_type_, mono_scratch_.data());
+
+        const float* samples = mono_scratch_.data();
+        size_t count = block;
+        if (preprocessing_) {
+            count = preprocess(mono_scratch_.data(), block);
+            samples = processed_scratch_.data();
+        }
+
+        if (vad_config_.enabled) {
+            int64_t started = steady_ns();
+            vad_.process(samples, count);
+            stage_times_.vad_ns += steady_ns() - started;
+        }
+        if (mel_config_.enabled) {
+            int64_t started = steady_ns();
+            mel_.process(samples, count);
+            stage_times_.mel_ns += steady_ns() - started;
+        }
+        audio_data += block * frame_bytes_;
+        frames -= block;
+    }
+}
+
+// Denoise and normalize one mono block and publish it for utterance readers
+size_t AudioCapture::preprocess(const float* samples, size_t count) {
+    float* output = processed_scratch_.data();
+
+    int64_t started = steady_ns();
+    if (noise_config_.enabled) {
+        // Lags the input by the suppressor's latency, but keeps its frame indices
+        count = denoiser_.process(samples, count, output);
+    } else {
+        std::memcpy(output, samples, count * sizeof(float));
+    }
+    int64_t denoised = steady_ns();
+    if (gain_config_.enabled) {
+        agc_.process(output, count);
+    }
+    stage_times_.denoise_ns += denoised - started;
+    stage_times_.agc_ns += steady_ns() - denoised;
+
+    // Written before the VAD sees it, so every segment it emits is readable
+    convert_from_float32(output, count, format_type_, processed_bytes_.data());
+    processed_buffer_.write(processed_bytes_.data(), count * frame_bytes_);
+    return count;
+}
+
+// Get zero-copy views over the current audio buffer
+RingBufferSpans AudioCapture::get_buffer_spans() const {
+    // read_spans() clamps the start to the oldest retained byte
+    return ring_buffer_.read_spans(0, ring_buffer_.write_position());
+}
+
 // Save the audio buffer to a WAV file
 bool AudioCapture::save_buffer_to_file(const std::string& filename) const {
     std::vector<char> buffer = get_buffer();
@@ -166,89 +1149,268 @@ bool AudioCapture::save_buffer_to_file(const std::string& filename) const {
         return false;
     }
 
-    std::ofstream file(filename, std::ios::binary);
+    std::FILE* file = std::fopen(filename.c_str(), "wb");
     if (!file) {
         std::cerr << "Failed to open file: " << filename << std::endl;
         return false;
     }
 
-    // WAV file header
-    struct WAVHeader {
-        char riff[4] = {'R', 'I', 'F', 'F'};
-        uint32_t fileSize = 0; // Will be set later
-        char wave[4] = {'W', 'A', 'V', 'E'};
-        char fmt[4] = {'f', 'm', 't', ' '};
-        uint32_t fmtChunkSize = 16;
-        uint16_t audioFormat = 1; // PCM
-        uint16_t numChannels = 0; // Will be set
-        uint32_t sampleRate = 0; // Will be set
-        uint32_t byteRate = 0; // Will be set
-        uint16_t blockAlign = 0; // Will be set
-        uint16_t bitsPerSample = 0; // Will be set
-        char data[4] = {'d', 'a', 't', 'a'};
-        uint32_t dataSize = 0; // Will be set later
-    } header;
+    // The header describes the actual capture format
+    bool ok = write_wav_header(file, sample_rate_, channels_, format_type_, buffer.size()) > 0;
+    if (format_type_ == paInt8) {
+        // 8-bit WAV is unsigned
+        for (char& byte : buffer) {
+            byte = static_cast<char>(static_cast<unsigned char>(byte) ^ 0x80);
+        }
+    }
+    ok = ok && std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+    if (buffer.size() & 1) {
+        ok = ok && std::fputc(0, file) != EOF; // Chunks are word aligned
+    }
+    ok = std::fclose(file) == 0 && ok;
 
-    // Set header values
-    header.numChannels = static_cast<uint16_t>(channels_);
-    header.sampleRate = static_cast<uint32_t>(sample_rate_);
+    return ok;
+}
 
-    // Assuming format_type is paInt16, which is 16-bit PCM
-    header.bitsPerSample = 16;
-    header.blockAlign = header.numChannels * (header.bitsPerSample / 8);
-    header.byteRate = header.sampleRate * header.blockAlign;
+// Start streaming the capture to a file
+bool AudioCapture::start_file_recording(const RecorderConfig& config) {
+    if (is_file_recording()) {
+        std::cerr << "File recording is already active" << std::endl;
+        return false;
+    }
+    if (!AudioRecorder::format_supported(config.format)) {
+        std::cerr << "Recording format not available in this build" << std::endl;
+        return false;
+    }
 
-    header.dataSize = static_cast<uint32_t>(buffer.size());
-    header.fileSize = 36 + header.dataSize;
+    if (!is_recording_) {
+        // The ring is reset when recording starts, so wait for that
+        recorder_config_ = config;
+        recording_armed_ = true;
+        return true;
+    }
+    return recorder_.start(config, ring_buffer_, data_signal_, frames_written(),
+                           sample_rate_, channels_, format_type_);
+}
+
+// Finish the file recording
+void AudioCapture::stop_file_recording() {
+    recording_armed_ = false;
+    recorder_.stop();
+}
+
+// Calculate per-channel and overall audio levels from raw data
+AudioLevels AudioCapture::calculate_audio_levels(const char* audio_data, size_t frames) {
+    AudioLevels levels;
+    if (frames == 0 || level_scratch_.empty()) {
+        return levels;
+    }
 
-    // Write header
-    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    // All channels are measured; only the first kMaxLevelChannels are reported
+    measure_levels(audio_data, frames, channels_, format_type_, level_scratch_.data());
 
-    // Write audio data
-    file.write(buffer.data(), buffer.size());
+    // The overall level is the RMS across every channel
+    float mean_square = 0.0f;
+    for (const ChannelLevel& channel : level_scratch_) {
+        mean_square += channel.rms * channel.rms;
+    }
+    levels.level = rms_to_meter_level(sqrtf(mean_square / channels_));
+    levels.channel_count = std::min(channels_, kMaxLevelChannels);
+    std::copy(level_scratch_.begin(), level_scratch_.begin() + levels.channel_count,
+              levels.channels.begin());
+    return levels;
+}
 
-    return file.good();
+// Check whether captured frames are waiting to be processed
+bool AudioCapture::has_work() const {
+    return ring_buffer_.write_position() > worker_cursor_.load(std::memory_order_acquire) * frame_bytes_;
 }
 
-// Calculate audio level from raw data
-float AudioCapture::calculate_audio_level(const std::vector<char>& audio_data) const {
-    if (audio_data.empty()) {
-        return 0.0f;
+// Process every frame captured since the last run (on a pool thread)
+void AudioCapture::run_pending() {
+    const size_t block_frames = worker_block_.size() / frame_bytes_;
+    uint64_t end = ring_buffer_.write_position();
+    uint64_t from = worker_cursor_.load(std::memory_order_relaxed) * frame_bytes_;
+
+    uint64_t backlog = end > from ? (end - from) / frame_bytes_ : 0;
+    if (backlog > peak_backlog_.load(std::memory_order_relaxed)) {
+        peak_backlog_.store(backlog, std::memory_order_relaxed);
+    }
+
+    // Work through everything that arrived, one period at a time
+    while (from < end) {
+        uint64_t to = std::min<uint64_t>(end, from + block_frames * frame_bytes_);
+        uint64_t start = ring_buffer_.copy(from, to, worker_block_.data());
+        if (start > from) {
+            // We fell a whole buffer behind; keep the analysis timelines aligned
+            uint64_t lost = (start - from) / frame_bytes_;
+            dropped_frames_.fetch_add(lost, std::memory_order_relaxed);
+            if (preprocessing_) {
+                // Input buffered in the suppressor is lost with the gap; the
+                // processed ring gets silence in place of both
+                if (noise_config_.enabled) {
+                    lost = denoiser_.skip(lost);
+                }
+                processed_buffer_.fill(format_type_ == paUInt8 ? 0x80 : 0, lost * frame_bytes_);
+            }
+            if (vad_config_.enabled) {
+                vad_.skip(lost);
+            }
+            if (mel_config_.enabled) {
+                mel_.skip(lost);
+            }
+        }
+        size_t frames = static_cast<size_t>((to - start) / frame_bytes_);
+        if (frames > 0) {
+            process_block(worker_block_.data(), frames);
+            if (chunk_queue_) {
+                publish_chunk(worker_block_.data(), frames, start / frame_bytes_);
+            }
+        }
+        from = to;
     }
+    worker_cursor_.store(end / frame_bytes_, std::memory_order_release);
 
-    // Convert bytes to 16-bit samples
-    const int16_t* samples = reinterpret_cast<const int16_t*>(audio_data.data());
-    size_t sample_count = audio_data.size() / sizeof(int16_t);
+    // Every period up to end has been through the stages now
+    int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    while (has_pending_stamp_ || period_stamps_.pop(pending_stamp_)) {
+        if (pending_stamp_.end_byte > end) {
+            has_pending_stamp_ = true;
+            break;
+        }
+        has_pending_stamp_ = false;
+        processing_latency_.record(static_cast<uint64_t>(
+            std::max<int64_t>(0, now_ns - pending_stamp_.captured_ns) / 1000));
+    }
+}
+
+// Run the processing chain on one block of captured frames
+void AudioCapture::process_block(const char* audio_data, size_t frames) {
+    stage_times_ = StageTimes();
+
+    // Measure levels if anyone is listening; the notifier thread delivers
+    // callbacks, level events go straight onto the bus at the same rate
+    bool level_callbacks = audio_level_callback_ || levels_callback_;
+    bool level_events = event_bus_ && event_bus_->wants(EventType::kLevel);
+    if (level_callbacks || level_events) {
+        int64_t started = steady_ns();
+        AudioLevels levels = calculate_audio_levels(audio_data, frames);
+        if (level_callbacks) {
+            level_mailbox_.publish(levels);
+            level_signal_.notify();
+        }
+        if (level_events && started >= next_level_event_ns_) {
+            Event event;
+            event.type = EventType::kLevel;
+            event.source = event_source_;
+            event.value = levels.level;
+            event.timestamp_ns = started;
+            event_bus_->publish(event);
+            next_level_event_ns_ = started + (level_update_hz_ > 0 ? 1000000000LL / level_update_hz_ : 0);
+        }
+        record_stage_time(level_time_, steady_ns() - started);
+    }
 
-    // Calculate RMS
-    float sum = 0.0f;
-    for (size_t i = 0; i < sample_count; i++) {
-        float sample = samples[i] / 32768.0f; // Normalize to [-1.0, 1.0]
-        sum += sample * sample;
+    // Denoise, segment utterances (queued as frame ranges only) and compute mel frames
+    if (vad_config_.enabled || mel_config_.enabled) {
+        run_analysis(audio_data, frames);
+        if (preprocessing_ && noise_config_.enabled) {
+            record_stage_time(denoise_time_, stage_times_.denoise_ns);
+        }
+        if (preprocessing_ && gain_config_.enabled) {
+            record_stage_time(agc_time_, stage_times_.agc_ns);
+        }
+        if (vad_config_.enabled) {
+            record_stage_time(vad_time_, stage_times_.vad_ns);
+        }
+        if (mel_config_.enabled) {
+            record_stage_time(mel_time_, stage_times_.mel_ns);
+        }
     }
+}
 
-    float rms = sqrtf(sum / sample_count);
+// Copy a processed block into a pooled chunk and queue it
+void AudioCapture::publish_chunk(const char* audio_data, size_t frames, uint64_t start_frame) {
+    PooledChunk chunk = chunk_pool_->acquire();
+    if (!chunk) {
+        dropped_chunks_++;
+        return;
+    }
+    size_t bytes = std::min(frames * frame_bytes_, chunk.capacity());
+    std::memcpy(chunk.data(), audio_data, bytes);
+    chunk.set_contents(bytes, start_frame);
 
-    // Convert to dB
-    float db = 20.0f * log10f(std::max(rms, 0.0000001f)); // Avoid log(0)
+    // The queued index carries the reference until wait_for_chunk() adopts it
+    uint32_t index = chunk_pool_->detach(chunk);
+    if (!chunk_queue_->push(index)) {
+        chunk_pool_->adopt(index).reset();
+        dropped_chunks_++;
+        return;
+    }
+    chunk_signal_.notify();
+}
 
-    // Normalize to [0.0, 1.0] range, assuming -60dB is silence
-    float normalized = std::max(0.0f, (db + 60.0f) / 60.0f);
-    return std::min(normalized, 1.0f);
+// Release chunks nobody consumed
+void AudioCapture::drain_chunk_queue() {
+    uint32_t index;
+    while (chunk_queue_ && chunk_queue_->pop(index)) {
+        chunk_pool_->adopt(index).reset();
+    }
 }
 
-// Audio processing thread
-void AudioCapture::process_audio() {
-    while (is_recording_) {
-        // Sleep to avoid busy waiting
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+// Level notifier thread
+void AudioCapture::deliver_levels() {
+    using clock = std::chrono::steady_clock;
+    const auto interval = level_update_hz_ > 0
+        ? std::chrono::duration_cast<clock::duration>(std::chrono::seconds(1)) / level_update_hz_
+        : clock::duration::zero();
+    auto next_delivery = clock::now();
+
+    while (true) {
+        uint32_t seen = level_signal_.sequence();
+        bool stopping = stop_notifier_;
+
+        auto now = clock::now();
+        AudioLevels levels;
+        if ((now >= next_delivery || stopping) && level_mailbox_.take(levels)) {
+            // Only the newest update is delivered; older ones were coalesced
+            if (audio_level_callback_) {
+                audio_level_callback_(levels.level);
+            }
+            if (levels_callback_) {
+                levels_callback_(levels);
+            }
+            next_delivery = now + interval;
+            continue;
+        }
+
+        if (stopping) {
+            break;
+        }
+
+        // Sleep until the next update arrives, or until the rate limit
+        // allows delivering the one that is already pending
+        auto timeout = level_mailbox_.has_update()
+            ? std::chrono::duration_cast<std::chrono::microseconds>(next_delivery - now)
+            : std::chrono::microseconds(std::chrono::milliseconds(500));
+        level_signal_.wait(seen, timeout);
     }
 }
 
+// Convert device frames to the capture rate and format and store them
+void AudioCapture::write_resampled(const char* input, size_t frames) {
+    // Buffers are sized for one device period in start_recording()
+    size_t count = resampler_.process(input, frames, resample_output_.data(),
+                                      resample_output_.size());
+    convert_from_float32(resample_output_.data(), count, format_type_, resample_bytes_.data());
+    ring_buffer_.write(resample_bytes_.data(), count * frame_bytes_);
+}
+
 // Static callback for PortAudio
 int AudioCapture::audio_callback(const void* input_buffer, void* output_buffer [[maybe_unused]],
                               unsigned long frames_per_buffer,
-                              const PaStreamCallbackTimeInfo* time_info [[maybe_unused]], PaStreamCallbackFlags status_flags [[maybe_unused]],
+                              const PaStreamCallbackTimeInfo* time_info, PaStreamCallbackFlags status_flags,
                               void* user_data) {
     AudioCapture* self = static_cast<AudioCapture*>(user_data);
 
@@ -256,51 +1418,154 @@ int AudioCapture::audio_callback(const void* input_buffer, void* output_buffer [
         return paContinue;
     }
 
-    // Calculate buffer size in bytes
-    size_t buffer_size = frames_per_buffer * self->channels_ * (self->format_type_ == paInt16 ? 2 : 4);
+    InputPeriod period;
+    period.data = static_cast<const char*>(input_buffer);
+    period.frames = frames_per_buffer;
+    period.overflow = (status_flags & paInputOverflow) != 0;
+    period.underflow = (status_flags & paInputUnderflow) != 0;
 
-    // Create a new buffer for this chunk
-    std::vector<char> buffer(static_cast<const char*>(input_buffer),
-                           static_cast<const char*>(input_buffer) + buffer_size);
-
-    // Calculate audio level if callback is set
-    if (self->audio_level_callback_) {
-        float level = self->calculate_audio_level(buffer);
-        self->audio_level_callback_(level);
+    // Not every host API reports ADC times; zero means unknown
+    if (time_info && time_info->inputBufferAdcTime > 0 &&
+        time_info->currentTime >= time_info->inputBufferAdcTime) {
+        period.adc_latency = time_info->currentTime - time_info->inputBufferAdcTime;
     }
 
-    // Add buffer to the queue
-    {
-        std::lock_guard<std::mutex> lock(self->buffer_mutex_);
-        self->audio_buffer_.push_back(std::move(buffer));
+    self->on_input(period);
+    return paContinue;
+}
+
+// Store one period from the device or input source (on its delivery thread)
+void AudioCapture::on_input(const InputPeriod& period) {
+    using clock = std::chrono::steady_clock;
 
-        // Limit buffer size
-        while (static_cast<int>(self->audio_buffer_.size()) > self->max_buffer_size_) {
-            self->audio_buffer_.pop_front();
+    // A source replaying faster than real time can outrun processing; wait
+    // for it rather than overwrite frames it has not reached
+    if (active_source_) {
+        const uint64_t limit = ring_buffer_.capacity() / 2;
+        while (ring_buffer_.write_position() -
+                   worker_cursor_.load(std::memory_order_acquire) * frame_bytes_ > limit) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
         }
     }
 
-    return paContinue;
+    // The delivery thread of a new stream takes on the capture policy
+    // before it starts its real-time work
+    if (capture_policy_pending_) {
+        capture_policy_pending_ = false;
+        ThreadPolicyResult result = apply_thread_policy(capture_policy_);
+        std::lock_guard<std::mutex> lock(realtime_mutex_);
+        realtime_report_.capture = result;
+    }
+
+    const clock::time_point entered = clock::now();
+    callbacks_.fetch_add(1, std::memory_order_relaxed);
+    if (period.overflow) {
+        input_overflows_.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (period.underflow) {
+        input_underflows_.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (period.adc_latency >= 0.0) {
+        input_latency_.record(static_cast<uint64_t>(period.adc_latency * 1e6));
+    }
+
+    // Only copy the samples and wake the processing thread; level metering
+    // and VAD run there, off the real-time thread
+    if (resampling_) {
+        write_resampled(period.data, period.frames);
+    } else {
+        ring_buffer_.write(period.data, period.frames * frame_bytes_);
+    }
+
+    // A full queue only costs latency samples
+    PeriodStamp stamp;
+    stamp.end_byte = ring_buffer_.write_position();
+    stamp.captured_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        entered.time_since_epoch()).count();
+    period_stamps_.push(stamp);
+
+    // Batched wake-ups let the processing thread sleep through several periods
+    data_signal_.notify();
+    if (pool_signal_ && ++periods_since_wake_ >= latency_config_.wake_periods) {
+        periods_since_wake_ = 0;
+        pool_signal_->notify();
+    }
+
+    // Adaptive streams ask the retune thread for a longer or shorter period
+    int request = period_controller_.on_period(
+        period.frames * static_cast<size_t>(sample_rate_) / static_cast<size_t>(device_rate_),
+        period.overflow);
+    if (request > 0) {
+        requested_period_ = request;
+        retune_signal_.notify();
+    }
+
+    callback_duration_.record(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - entered).count()));
+}
+
+// Note that the input source ran out of audio
+void AudioCapture::on_input_end() {
+    // Wake readers so they can check input_finished()
+    data_signal_.notify();
+    utterance_signal_.notify();
+}
+
+// Capture from an input source instead of the device
+bool AudioCapture::set_input_source(std::shared_ptr<InputSource> source) {
+    if (is_recording_) {
+        std::cerr << "Cannot change the input source while recording" << std::endl;
+        return false;
+    }
+    input_source_ = std::move(source);
+    return true;
+}
+
+// Get pipeline counters and latency histograms
+CaptureStats AudioCapture::get_stats() const {
+    CaptureStats stats;
+    stats.callbacks = callbacks_.load(std::memory_order_relaxed);
+    stats.frames_captured = frames_written();
+    stats.input_overflows = input_overflows_.load(std::memory_order_relaxed);
+    stats.input_underflows = input_underflows_.load(std::memory_order_relaxed);
+    stats.dropped_frames = dropped_frames_.load(std::memory_order_relaxed);
+    stats.dropped_utterances = dropped_utterances_;
+    stats.dropped_chunks = dropped_chunks_;
+    stats.device_failures = device_failures_.load(std::memory_order_relaxed);
+    stats.recording_dropped_frames = recorder_.dropped_frames();
+
+    uint64_t processed = worker_cursor_.load(std::memory_order_acquire);
+    stats.ring_capacity_frames = ring_buffer_.capacity() / frame_bytes_;
+    stats.ring_backlog_frames = stats.frames_captured > processed ? stats.frames_captured - processed : 0;
+    stats.ring_peak_backlog_frames = peak_backlog_.load(std::memory_order_relaxed);
+
+    stats.callback_duration = callback_duration_.snapshot();
+    stats.input_latency = input_latency_.snapshot();
+    stats.processing_latency = processing_latency_.snapshot();
+    stats.level_time = level_time_.snapshot();
+    stats.denoise_time = denoise_time_.snapshot();
+    stats.agc_time = agc_time_.snapshot();
+    stats.vad_time = vad_time_.snapshot();
+    stats.mel_time = mel_time_.snapshot();
+    return stats;
 }
 
 // Get available audio devices
 std::vector<std::map<std::string, std::variant<int, std::string>>> AudioCapture::get_available_devices() const {
     std::vector<std::map<std::string, std::variant<int, std::string>>> devices;
 
-    if (!pa_) {
+    if (!backend_->is_initialized()) {
         return devices;
     }
 
-    int numDevices = Pa_GetDeviceCount();
-    for (int i = 0; i < numDevices; i++) {
-        const PaDeviceInfo* deviceInfo = Pa_GetDeviceInfo(i);
-        if (deviceInfo && deviceInfo->maxInputChannels > 0) {
-            std::map<std::string, std::variant<int, std::string>> device;
-            device["index"] = i;
-            device["name"] = std::string(deviceInfo->name);
-            device["channels"] = deviceInfo->maxInputChannels;
-            devices.push_back(device);
-        }
+    // Served from the backend's cache rather than querying PortAudio
+    for (const DeviceInfo& info : *backend_->devices()) {
+        std::map<std::string, std::variant<int, std::string>> device;
+        device["index"] = info.index;
+        device["name"] = info.name;
+        device["channels"] = info.max_input_channels;
+        device["sample_rate"] = static_cast<int>(info.default_sample_rate);
+        devices.push_back(device);
     }
 
     return devices;
@@ -13,9 +13,27 @@
 #include <atomic>
 #include <thread>
 #include <mutex>
-#include <deque>
 #include <map>
 #include <variant>
+#include "audio_backend.h"
+#include "audio_recorder.h"
+#include "capture_stats.h"
+#include "chunk_pool.h"
+#include "data_signal.h"
+#include "event_bus.h"
+#include "gain_control.h"
+#include "input_source.h"
+#include "latency_profile.h"
+#include "latest_value.h"
+#include "level_meter.h"
+#include "mel_spectrogram.h"
+#include "noise_suppressor.h"
+#include "resampler.h"
+#include "ring_buffer.h"
+#include "spsc_queue.h"
+#include "thread_priority.h"
+#include "vad.h"
+#include "worker_pool.h"
 
 // Forward declarations for PortAudio types to avoid including the header
 struct PaStreamCallbackTimeInfo;
@@ -24,15 +42,63 @@ typedef unsigned long PaStreamCallbackFlags;
 namespace koelingo {
 namespace audio {
 
+/**
+ * @struct AudioReadResult
+ * @brief Frames returned by an incremental AudioCapture::read_new() call
+ */
+struct AudioReadResult {
+    std::vector<char> data;      ///< Interleaved frames in the capture sample format
+    uint64_t start_frame = 0;    ///< Stream frame index of the first frame in data
+    uint64_t next_cursor = 0;    ///< Cursor to pass to the next read_new() call
+    uint64_t dropped_frames = 0; ///< Frames overwritten before they could be read
+
+    /**
+     * @brief Number of frames returned
+     */
+    uint64_t frame_count() const { return next_cursor - start_frame; }
+};
+
+/**
+ * @struct Utterance
+ * @brief One complete utterance detected by the voice activity detector
+ */
+struct Utterance {
+    std::vector<char> data;   ///< Interleaved frames in the capture sample format
+    uint64_t start_frame = 0; ///< Stream frame index of the first frame in data
+    uint64_t end_frame = 0;   ///< Stream frame index one past the last frame
+    bool truncated = false;   ///< True if the utterance was split at max_utterance_ms
+};
+
+/**
+ * @struct StagedUtterance
+ * @brief An utterance converted to float32 in a reusable staging buffer
+ *
+ * The buffer is page-aligned and comes from a pool that lives as long as
+ * the capture, so a GPU runtime can register the pool as pinned memory
+ * once and copy utterances to the device asynchronously.
+ */
+struct StagedUtterance {
+    PooledChunk samples;      ///< Interleaved float32 samples; samples.size() bytes are valid
+    uint64_t start_frame = 0; ///< Stream frame index of the first frame
+    uint64_t end_frame = 0;   ///< Stream frame index one past the last frame
+    bool truncated = false;   ///< True if split at max_utterance_ms (or cut to the buffer size)
+};
+
 /**
  * @class AudioCapture
  * @brief Audio capture and processing class for real-time audio input
  *
  * This class provides audio capture functionality using PortAudio.
  * It can be used to record audio from the microphone, calculate audio levels,
- * and retrieve the audio buffer.
+ * and retrieve the audio buffer. An InputSource (such as a ReplaySource)
+ * can stand in for the microphone, feeding the same pipeline without
+ * audio hardware.
+ *
+ * Each instance captures one input device with its own ring buffer, VAD
+ * and mel front end, so several instances can record different devices
+ * at once. Analysis runs on a WorkerPool, which instances may share.
  */
-class AudioCapture {
+class AudioCapture : private ProcessingTask, private InputSink {
 public:
     /**
      * @brief Constructor
@@ -49,14 +115,21 @@ public:
     /**
      * @brief Destructor
      */
-    ~AudioCapture();
+    ~AudioCapture() override;
 
     /**
      * @brief Start recording audio from the microphone
      * @param audio_level_callback Optional callback function to receive audio level updates
+     * @param levels_callback Optional callback receiving per-channel RMS, peak and
+     *        clip counts
      * @return True if recording started successfully, false otherwise
+     *
+     * Level callbacks run on a dedicated notifier thread at no more than
+     * level_update_rate() calls per second; intermediate updates are
+     * coalesced so a slow callback never holds up capture or processing.
      */
-    bool start_recording(std::function<void(float)> audio_level_callback = nullptr);
+    bool start_recording(std::function<void(float)> audio_level_callback = nullptr,
+                         std::function<void(const AudioLevels&)> levels_callback = nullptr);
 
     /**
      * @brief Stop recording audio
@@ -69,25 +142,499 @@ public:
      */
     std::vector<char> get_buffer() const;
 
+    /**
+     * @brief Get the current audio buffer as normalized float32 samples
+     * @return Interleaved samples in the range [-1.0, 1.0]
+     *
+     * The conversion is done while copying out of the ring buffer, so callers
+     * such as Whisper can use the result without any further processing.
+     */
+    std::vector<float> get_buffer_float32() const;
+
+    /**
+     * @brief Read only the frames captured since a cursor
+     * @param cursor Frame index returned by the previous call (0 to start)
+     * @param max_frames Maximum number of frames to return (0 for no limit)
+     * @return New frames together with the cursor for the next call
+     *
+     * Frame indices increase monotonically from the start of recording, so
+     * the cost of a call depends only on how much new audio there is. If the
+     * cursor has fallen out of the buffer, reading resumes at the oldest
+     * retained frame and the gap is reported in dropped_frames.
+     */
+    AudioReadResult read_new(uint64_t cursor, size_t max_frames = 0) const;
+
+    /**
+     * @brief Block until enough frames are available after a cursor
+     * @param cursor Frame index to count from
+     * @param frames Number of frames to wait for
+     * @param timeout_ms Maximum time to wait in milliseconds
+     * @return True if the frames are available, false on timeout or when
+     *         recording stops
+     */
+    bool wait_for_frames(uint64_t cursor, size_t frames, int timeout_ms) const;
+
+    /**
+     * @brief Get the total number of frames captured since recording started
+     * @return Monotonic frame count
+     */
+    uint64_t frames_written() const { return ring_buffer_.write_position() / frame_bytes_; }
+
+    /**
+     * @brief Get zero-copy views over the current audio buffer
+     * @return One or two spans covering the retained audio (two if it wraps)
+     *
+     * The spans point into the live ring buffer. Call
+     * get_ring_buffer().is_intact(spans.start) after consuming them to check
+     * that the capture thread did not overwrite the data in the meantime.
+     */
+    RingBufferSpans get_buffer_spans() const;
+
+    /**
+     * @brief Get the underlying capture ring buffer
+     * @return Read-only reference to the ring buffer
+     */
+    const RingBuffer& get_ring_buffer() const { return ring_buffer_; }
+
+    /**
+     * @brief Get the size of one frame (all channels) in bytes
+     * @return Bytes per frame for the configured format and channel count
+     */
+    size_t bytes_per_frame() const { return frame_bytes_; }
+
+    /**
+     * @brief Get the PortAudio sample format used for capture
+     * @return Format type (e.g. 8 for paInt16, 1 for paFloat32)
+     */
+    int format_type() const { return format_type_; }
+
+    /**
+     * @brief Get the capture sample rate in Hz
+     */
+    int sample_rate() const { return sample_rate_; }
+
+    /**
+     * @brief Get the number of captured channels
+     */
+    int channels() const { return channels_; }
+
     /**
      * @brief Save the current audio buffer to a WAV file
      * @param filename Name of the file to save
      * @return True if saved successfully, false otherwise
+     *
+     * Only the audio still in the ring buffer (the last 30 seconds) is
+     * saved; use start_file_recording() to archive a whole session.
      */
     bool save_buffer_to_file(const std::string& filename) const;
 
+    /**
+     * @brief Stream the capture to a file on a background I/O thread
+     * @param config Output path, container format and rotation limits
+     * @return False if a file recording is already active or the first
+     *         file could not be created (when armed while stopped, the
+     *         file is created by start_recording(), which fails instead)
+     *
+     * When called while recording, the file starts at the current frame;
+     * otherwise it starts with the next start_recording(). The file is
+     * finalized by stop_file_recording() or stop_recording().
+     */
+    bool start_file_recording(const RecorderConfig& config);
+
+    /**
+     * @brief Write out the remaining audio and close the recording file
+     */
+    void stop_file_recording();
+
+    /**
+     * @brief Check whether a file recording is active or waiting to start
+     */
+    bool is_file_recording() const { return recording_armed_ || recorder_.is_active(); }
+
+    /**
+     * @brief Get the file recorder, e.g. for its frame and drop counters
+     */
+    const AudioRecorder& get_recorder() const { return recorder_; }
+
     /**
      * @brief Get a list of available audio input devices
      * @return List of device information (index, name, channels)
      */
     std::vector<std::map<std::string, std::variant<int, std::string>>> get_available_devices() const;
 
+    /**
+     * @brief Select the input device by PortAudio index
+     * @param index Device index from get_available_devices(), or -1 for
+     *        the system default
+     * @return False if recording is active or the device has no inputs
+     */
+    bool set_input_device(int index);
+
+    /**
+     * @brief Select the input device by name
+     * @param name Exact device name, or a case-insensitive part of it
+     *        (empty for the system default)
+     * @return False if recording is active or no input device matches
+     *
+     * The name is resolved again on every start_recording(), so the
+     * selection survives devices being renumbered.
+     */
+    bool set_input_device(const std::string& name);
+
+    /**
+     * @brief Get the PortAudio index of the device used by the current (or
+     *        last) recording, or of the selected device before that
+     * @return Device index, or -1 for the system default
+     */
+    int input_device() const { return device_index_; }
+
+    /**
+     * @brief Share processing threads with other capture instances
+     * @param pool Pool to run VAD, levels and mel on, or nullptr for a
+     *        private single-thread pool
+     * @return False if recording is active (the pool is unchanged)
+     */
+    bool set_processing_pool(std::shared_ptr<WorkerPool> pool);
+
+    /**
+     * @brief Set the scheduling of the private processing thread
+     * @param policy Real-time scheduling and CPUs for the thread running
+     *        VAD, levels and mel
+     * @return False if recording is active (the policy is unchanged)
+     *
+     * A pool set with set_processing_pool() keeps the policy it was
+     * created with; get_realtime_report() shows what it achieved.
+     */
+    bool set_processing_policy(const ThreadPolicy& policy);
+
+    /**
+     * @brief Set the scheduling of the thread delivering periods
+     * @param policy Real-time scheduling and CPUs for the PortAudio
+     *        callback thread (or the input source thread)
+     * @return False if recording is active (the policy is unchanged)
+     *
+     * Applied from the first period of each stream, so the result is only
+     * reported once audio flows. Host APIs that already run their callback
+     * with real-time priority may refuse a change without it mattering.
+     */
+    bool set_capture_policy(const ThreadPolicy& policy);
+
+    /**
+     * @brief Choose whether capture buffers are locked in RAM while recording
+     * @param enabled If true, the ring buffer and the chunk pool are faulted
+     *        in and locked at start_recording() and unlocked when it stops
+     * @return False if recording is active (the setting is unchanged)
+     */
+    bool set_lock_memory(bool enabled);
+
+    /**
+     * @brief Get the scheduling and memory locking of the current (or last) recording
+     *
+     * Settings the process lacks the privileges for are not fatal; the
+     * report says which ones did not take effect and why.
+     */
+    RealtimeReport get_realtime_report() const;
+
     /**
      * @brief Check if recording is active
      * @return True if recording, false otherwise
+     *
+     * Also turns false when an adaptive stream cannot reopen the device
+     * after a period change (see CaptureStats::device_failures); call
+     * stop_recording() to release the stream before starting again.
      */
     bool is_recording() const { return is_recording_; }
 
+    /**
+     * @brief Choose whether mono capture opens the device at its native rate
+     * @param enabled If true (the default), the stream runs at the device's
+     *        default sample rate and channel layout, and is resampled and
+     *        downmixed to sample_rate/mono inside the engine
+     * @return False if recording is active (the setting is unchanged)
+     *
+     * Only applies when capturing one channel. Everything that reads the
+     * capture (buffers, cursors, VAD) always sees the requested rate.
+     */
+    bool set_native_rate_capture(bool enabled);
+
+    /**
+     * @brief Choose how the device clocks the stream
+     * @param config Period, host API latency and processing wake cadence;
+     *        see latency_profile_config() for the predefined profiles
+     * @return False if recording is active or the config is invalid
+     *
+     * An adaptive device stream reopens itself with a longer period after
+     * repeated input overflows, and with a shorter one again once it has
+     * run without overflows for idle_ms. The ring buffer and analysis carry
+     * on across the change; only the callbacks of the reopen gap are lost.
+     */
+    bool set_latency_config(const LatencyConfig& config);
+
+    /**
+     * @brief Get the latency settings
+     */
+    LatencyConfig get_latency_config() const { return latency_config_; }
+
+    /**
+     * @brief Get the latency the stream actually runs with
+     * @return Settings of the current (or last) recording, including
+     *         adaptive changes and the host API's reported input latency
+     */
+    EffectiveLatency get_effective_latency() const;
+
+    /**
+     * @brief Get the sample rate the device stream actually runs at
+     * @return Device rate of the current (or last) recording
+     */
+    int device_sample_rate() const { return device_rate_; }
+
+    /**
+     * @brief Get the fixed delay added by in-engine resampling
+     * @return Latency in frames at the capture rate (0 when not resampling)
+     */
+    size_t resampler_latency_frames() const { return resampling_ ? resampler_.latency_frames() : 0; }
+
+    /**
+     * @brief Set the maximum rate at which level callbacks are invoked
+     * @param hz Updates per second, or 0 to deliver every processed block
+     * @return False if recording is active or hz is negative
+     */
+    bool set_level_update_rate(int hz);
+
+    /**
+     * @brief Get the maximum level callback rate in updates per second
+     */
+    int level_update_rate() const { return level_update_hz_; }
+
+    /**
+     * @brief Publish level, speech onset and utterance events on a bus
+     * @param bus Bus to publish on, or nullptr to stop publishing
+     * @param source Value of Event::source for this capture's events
+     * @return False if recording is active (the bus is unchanged)
+     *
+     * Events are published from the processing thread, without the level
+     * callbacks' notifier thread; level events follow level_update_rate().
+     * Utterance events announce what wait_for_utterance() will return.
+     */
+    bool set_event_bus(std::shared_ptr<EventBus> bus, uint32_t source = 0);
+
+    /**
+     * @brief Configure the voice activity detector
+     * @param config VAD parameters; set config.enabled to segment utterances
+     * @return False if recording is active (the configuration is unchanged)
+     */
+    bool set_vad_config(const VadConfig& config);
+
+    /**
+     * @brief Get the current voice activity detector configuration
+     */
+    const VadConfig& get_vad_config() const { return vad_config_; }
+
+    /**
+     * @brief Replace the default energy/zero-crossing speech detector
+     * @param detector Model-based detector, or nullptr for the default
+     * @return False if recording is active (the detector is unchanged)
+     */
+    bool set_speech_detector(std::shared_ptr<SpeechDetector> detector);
+
+    /**
+     * @brief Block until the VAD has a complete utterance
+     * @param utterance Receives the utterance audio, including padding
+     * @param timeout_ms Maximum time to wait in milliseconds
+     * @return True if an utterance was returned, false on timeout or when
+     *         recording has stopped and every utterance has been consumed
+     *
+     * Only one thread may consume utterances at a time.
+     */
+    bool wait_for_utterance(Utterance& utterance, int timeout_ms);
+
+    /**
+     * @brief Hand utterances out in float32 staging buffers from a fixed pool
+     * @param buffers Number of staging buffers (0 to disable)
+     * @param max_frames Frames each buffer holds (0 = the longest utterance
+     *        the current VAD configuration produces)
+     * @return False if recording is active (the staging pool is unchanged)
+     *
+     * The pool is allocated here, page-aligned, and kept until staging is
+     * reconfigured, so its arena (see staging_pool()) can be registered
+     * with a GPU runtime as page-locked memory. If a later VAD
+     * configuration needs longer buffers, start_recording() replaces the
+     * pool. While memory locking is enabled the pool is locked with the
+     * other capture buffers.
+     */
+    bool set_utterance_staging(size_t buffers, size_t max_frames = 0);
+
+    /**
+     * @brief Get the staging pool
+     * @return The pool, or nullptr when staging is disabled
+     */
+    std::shared_ptr<ChunkPool> staging_pool() const { return staging_pool_; }
+
+    /**
+     * @brief Block until the VAD has a complete utterance and stage it
+     * @param utterance Receives the utterance, converted to float32 straight
+     *        from the ring buffer into a staging buffer
+     * @param timeout_ms Maximum time to wait in milliseconds
+     * @return True if an utterance was returned, false on timeout, when
+     *         staging is disabled, or when recording has stopped and every
+     *         utterance has been consumed
+     *
+     * When every staging buffer is still held, this waits for one to be
+     * released; utterances queue up meanwhile and are eventually counted
+     * in dropped_utterances(). Shares the queue with wait_for_utterance(),
+     * so only one thread may consume utterances through either call.
+     */
+    bool wait_for_staged_utterance(StagedUtterance& utterance, int timeout_ms);
+
+    /**
+     * @brief Block until the VAD reports speech after warmup_idle_ms of silence
+     * @param frame Receives the first frame of the speech
+     * @param timeout_ms Maximum time to wait in milliseconds
+     * @return True if an onset arrived since the previous call, false on
+     *         timeout or when recording has stopped
+     *
+     * Onsets arrive well before the utterance is complete, so a recognizer
+     * can warm up in the meantime. Onsets that arrive while nobody waits
+     * are coalesced. Only one thread may wait at a time.
+     */
+    bool wait_for_speech_onset(uint64_t& frame, int timeout_ms);
+
+    /**
+     * @brief Get the number of speech onsets in the current recording
+     */
+    uint64_t speech_onsets() const { return speech_onsets_; }
+
+    /**
+     * @brief Configure the incremental log-mel front end
+     * @param config Mel parameters; set config.enabled to compute frames
+     * @return False if recording is active (the configuration is unchanged)
+     */
+    bool set_mel_config(const MelConfig& config);
+
+    /**
+     * @brief Get the current log-mel configuration
+     */
+    const MelConfig& get_mel_config() const { return mel_config_; }
+
+    /**
+     * @brief Get the log-mel frames computed from the capture
+     * @return Read-only access to the mel frame buffer
+     *
+     * Mel frame t is centred on capture frame t * hop_length.
+     */
+    const MelSpectrogram& get_mel_spectrogram() const { return mel_; }
+
+    /**
+     * @brief Configure noise suppression ahead of the VAD and mel stages
+     * @param config Suppressor parameters; set config.enabled to denoise
+     * @return False if recording is active (the configuration is unchanged)
+     *
+     * Denoising and gain control run on the processing thread, between the
+     * level meter and the VAD. Their output feeds the VAD and mel front end
+     * and is what wait_for_utterance() and wait_for_staged_utterance()
+     * return; levels, chunks, read_new() and file recordings keep the raw
+     * capture. Both stages need mono capture and are skipped otherwise.
+     */
+    bool set_noise_suppression_config(const NoiseSuppressionConfig& config);
+
+    /**
+     * @brief Get the current noise suppression configuration
+     */
+    const NoiseSuppressionConfig& get_noise_suppression_config() const { return noise_config_; }
+
+    /**
+     * @brief Configure automatic gain control ahead of the VAD and mel stages
+     * @param config Gain control parameters; set config.enabled to normalize
+     * @return False if recording is active (the configuration is unchanged)
+     *
+     * Runs after noise suppression; see set_noise_suppression_config().
+     */
+    bool set_gain_control_config(const GainControlConfig& config);
+
+    /**
+     * @brief Get the current gain control configuration
+     */
+    const GainControlConfig& get_gain_control_config() const { return gain_config_; }
+
+    /**
+     * @brief Get the delay the noise suppressor adds before frames reach the VAD
+     * @return Frames (0 unless it runs in the current or last recording)
+     *
+     * Frame indices are unaffected: utterance frame i is still capture frame i.
+     */
+    size_t preprocessing_latency_frames() const {
+        return preprocessing_ && noise_config_.enabled ? denoiser_.latency_frames() : 0;
+    }
+
+    /**
+     * @brief Get the number of utterances dropped because nobody consumed them
+     */
+    uint64_t dropped_utterances() const { return dropped_utterances_; }
+
+    /**
+     * @brief Hand every processed period to a consumer as a pooled chunk
+     * @param chunks Number of chunk buffers (0 to disable)
+     * @return False if recording is active (the queue is unchanged)
+     *
+     * Each buffer holds up to chunk_size frames and comes from one
+     * preallocated pool, so publishing a chunk never allocates. While every
+     * buffer is queued or still held by the consumer, new periods are
+     * counted in dropped_chunks() instead.
+     */
+    bool set_chunk_queue(size_t chunks);
+
+    /**
+     * @brief Block until the next chunk is available
+     * @param chunk Receives the chunk; release it promptly so the buffer can be reused
+     * @param timeout_ms Maximum time to wait in milliseconds
+     * @return True if a chunk was returned, false on timeout, when the chunk
+     *         queue is disabled, or when recording has stopped and every
+     *         chunk has been consumed
+     *
+     * Only one thread may consume chunks at a time.
+     */
+    bool wait_for_chunk(PooledChunk& chunk, int timeout_ms);
+
+    /**
+     * @brief Get the number of periods not published because no chunk buffer was free
+     */
+    uint64_t dropped_chunks() const { return dropped_chunks_; }
+
+    /**
+     * @brief Get pipeline counters and latency histograms
+     * @return Snapshot of the current (or last) recording; cheap enough to
+     *         poll from a metrics exporter
+     */
+    CaptureStats get_stats() const;
+
+    /**
+     * @brief Capture from an input source instead of a device
+     * @param source Source to use from the next start_recording(), or
+     *        nullptr to go back to the selected device
+     * @return False while recording
+     *
+     * The source must produce the capture's sample rate and channel count;
+     * a mono capture also accepts other rates and channel counts and
+     * converts them like device audio. Periods are as long as device
+     * periods (see set_latency_config()).
+     */
+    bool set_input_source(std::shared_ptr<InputSource> source);
+
+    /**
+     * @brief Get the configured input source
+     * @return The source, or nullptr when capturing from a device
+     */
+    std::shared_ptr<InputSource> input_source() const { return input_source_; }
+
+    /**
+     * @brief Check whether the input source has delivered all of its audio
+     * @return True once the source finished; always false for devices
+     *
+     * Recording stays active until stop_recording(), so the remaining
+     * utterances can still be read.
+     */
+    bool input_finished() const { return active_source_ && active_source_->finished(); }
+
 private:
     // Audio parameters
     int sample_rate_;
@@ -96,32 +643,199 @@ private:
     int format_type_;
 
     // PortAudio objects
-    void* pa_; // PortAudio instance (void* to avoid including PortAudio header)
+    std::shared_ptr<AudioBackend> backend_; // Shared PortAudio instance
     void* stream_; // PortAudio stream
 
+    // Input source replacing the device; active_source_ is the one in use
+    std::shared_ptr<InputSource> input_source_;
+    std::shared_ptr<InputSource> active_source_;
+
     // Recording state
     std::atomic<bool> is_recording_;
     std::function<void(float)> audio_level_callback_;
+    std::function<void(const AudioLevels&)> levels_callback_;
+
+    // Level delivery: the processing thread publishes, a notifier thread
+    // invokes the callbacks at up to level_update_hz_
+    int level_update_hz_ = 30;
+    LatestValue<AudioLevels> level_mailbox_;
+    DataSignal level_signal_;
+    std::unique_ptr<std::thread> notifier_thread_;
+    std::atomic<bool> stop_notifier_;
+
+    // Selected input device: a name takes precedence and is resolved on start
+    int device_index_ = -1;
+    std::string device_name_;
+
+    // Device stream format; differs from the above when resampling
+    bool native_rate_capture_ = true;
+    int device_rate_;
+    int device_channels_;
+    bool resampling_ = false;
+    Resampler resampler_;
+    std::vector<float> resample_output_;
+    std::vector<char> resample_bytes_;
+
+    // Device period and host latency; an adaptive stream is reopened with
+    // the period on_input() requests, by the retune thread
+    LatencyConfig latency_config_;
+    std::atomic<int> period_frames_;     // Device period at the capture rate
+    std::atomic<double> host_latency_;   // Input latency reported by PortAudio
+    PeriodController period_controller_; // Fed by the callback
+    std::atomic<int> requested_period_;
+    std::atomic<uint64_t> period_changes_;
+    std::atomic<uint64_t> device_failures_; // Reopens that failed after a period change
+    std::atomic<bool> device_lost_;         // Recording ended by the retune thread, not yet torn down
+    std::unique_ptr<std::thread> retune_thread_;
+    std::atomic<bool> stop_retune_;
+    DataSignal retune_signal_;
+    int periods_since_wake_ = 0;         // Callback side of wake_periods
+
+    // Thread scheduling and memory locking; the capture policy is applied
+    // by the first on_input() of every stream, once, under realtime_mutex_
+    ThreadPolicy processing_policy_;
+    ThreadPolicy capture_policy_;
+    bool lock_memory_ = false;
+    bool capture_policy_pending_ = false; // Callback side
+    bool realtime_warned_ = false;
+    std::vector<std::pair<void*, size_t>> locked_regions_;
+    mutable std::mutex realtime_mutex_;
+    RealtimeReport realtime_report_;
 
     // Audio buffer
     int buffer_seconds_ = 30;
-    int max_buffer_size_;
-    mutable std::mutex buffer_mutex_;
-    std::deque<std::vector<char>> audio_buffer_;
+    size_t frame_bytes_;
+    RingBuffer ring_buffer_;
+    mutable DataSignal data_signal_;
+
+    // Voice activity detection
+    VadConfig vad_config_;
+    std::shared_ptr<SpeechDetector> speech_detector_;
+    VoiceActivityDetector vad_;
+    SpscQueue<UtteranceSegment> utterance_queue_;
+    DataSignal utterance_signal_;
+    std::atomic<uint64_t> dropped_utterances_;
+    std::atomic<uint64_t> onset_frame_;
+    std::atomic<uint64_t> speech_onsets_;
+    uint64_t onsets_seen_; // Consumer side of wait_for_speech_onset()
+    DataSignal onset_signal_;
+
+    // Pooled chunk hand-off to consumers of discrete periods
+    std::shared_ptr<ChunkPool> chunk_pool_;
+    std::unique_ptr<SpscQueue<uint32_t>> chunk_queue_; // Detached chunk indices
+    DataSignal chunk_signal_;
+    std::atomic<uint64_t> dropped_chunks_;
+
+    // Float32 staging buffers for utterances; the signal is raised when the
+    // consumer releases one
+    std::shared_ptr<ChunkPool> staging_pool_;
+    std::shared_ptr<DataSignal> staging_signal_;
+    size_t staging_buffers_ = 0;
+    size_t staging_frames_ = 0; // Requested buffer length (0 = from the VAD configuration)
+
+    // Log-mel front end
+    MelConfig mel_config_;
+    MelSpectrogram mel_;
+
+    // Event publication from the processing thread
+    std::shared_ptr<EventBus> event_bus_;
+    uint32_t event_source_ = 0;
+    int64_t next_level_event_ns_ = 0;
+
+    // Denoise and gain control ahead of the VAD and mel stages; their output
+    // has its own ring on the capture timeline, read back for utterances
+    NoiseSuppressionConfig noise_config_;
+    GainControlConfig gain_config_;
+    NoiseSuppressor denoiser_;
+    AutomaticGainControl agc_;
+    bool preprocessing_ = false;           // Either stage runs in this recording
+    RingBuffer processed_buffer_;
+    std::vector<float> processed_scratch_; // Stage output for one scratch block
+    std::vector<char> processed_bytes_;    // The same in the capture format
+
+    // Streaming file recording; armed until the next start_recording()
+    // when requested while stopped
+    AudioRecorder recorder_;
+    RecorderConfig recorder_config_;
+    bool recording_armed_ = false;
+
+    // Processing runs on a pool thread, woken through pool_signal_ every
+    // wake_periods periods; active_pool_ is the shared pool or a private one
+    std::shared_ptr<WorkerPool> processing_pool_;
+    std::shared_ptr<WorkerPool> active_pool_;
+    DataSignal* pool_signal_;
+    std::atomic<uint64_t> worker_cursor_; // Next frame to process
+    std::vector<char> worker_block_;
+    std::vector<float> mono_scratch_; // Mono float input shared by VAD and mel
+    std::vector<ChannelLevel> level_scratch_;
+
+    // Pipeline statistics; the callback stamps every period so the
+    // processing stage can measure how long its frames waited
+    struct PeriodStamp {
+        uint64_t end_byte = 0;   // Ring position after the period was written
+        int64_t captured_ns = 0; // steady_clock time of the callback
+    };
+    std::atomic<uint64_t> callbacks_;
+    std::atomic<uint64_t> input_overflows_;
+    std::atomic<uint64_t> input_underflows_;
+    std::atomic<uint64_t> dropped_frames_;
+    std::atomic<uint64_t> peak_backlog_;
+    LatencyHistogram callback_duration_;
+    LatencyHistogram input_latency_;
+    LatencyHistogram processing_latency_;
+    SpscQueue<PeriodStamp> period_stamps_;
+    PeriodStamp pending_stamp_; // Popped but not processed yet (processing stage only)
+    bool has_pending_stamp_ = false;
 
-    // Background processing thread
-    std::unique_ptr<std::thread> recording_thread_;
+    // Time each stage spent on the block being processed, recorded into the
+    // per-stage histograms once the block is done (processing stage only)
+    struct StageTimes {
+        int64_t level_ns = 0;
+        int64_t denoise_ns = 0;
+        int64_t agc_ns = 0;
+        int64_t vad_ns = 0;
+        int64_t mel_ns = 0;
+    };
+    StageTimes stage_times_;
+    LatencyHistogram level_time_;
+    LatencyHistogram denoise_time_;
+    LatencyHistogram agc_time_;
+    LatencyHistogram vad_time_;
+    LatencyHistogram mel_time_;
 
     // Internal methods
-    void process_audio();
-    float calculate_audio_level(const std::vector<char>& audio_data) const;
+    bool has_work() const override;
+    void run_pending() override;
+    int resolve_input_device() const;
+    bool open_device();
+    bool open_source();
+    void close_device();
+    void retune_loop();
+    void lock_buffers();
+    void unlock_buffers();
+    unsigned long configure_conversion(bool fallback_to_capture_rate);
+    void on_input(const InputPeriod& period) override;
+    void on_input_end() override;
+    void process_block(const char* audio_data, size_t frames);
+    void deliver_levels();
+    void write_resampled(const char* input, size_t frames);
+    AudioLevels calculate_audio_levels(const char* audio_data, size_t frames);
+    void run_analysis(const char* audio_data, size_t frames);
+    size_t preprocess(const float* samples, size_t count);
+    const RingBuffer& utterance_ring() const { return preprocessing_ ? processed_buffer_ : ring_buffer_; }
+    AudioReadResult read_ring(const RingBuffer& ring, uint64_t cursor, size_t max_frames) const;
+    void publish_chunk(const char* audio_data, size_t frames, uint64_t start_frame);
+    void drain_chunk_queue();
+    size_t staging_frames_needed() const;
+    void create_staging_pool();
+    void stage_segment(const UtteranceSegment& segment, PooledChunk& buffer, StagedUtterance& utterance);
 
     // Static PortAudio callback
     static int audio_callback(const void* input_buffer,
                              void* output_buffer [[maybe_unused]],
                              unsigned long frames_per_buffer,
-                             const PaStreamCallbackTimeInfo* time_info [[maybe_unused]],
-                             PaStreamCallbackFlags status_flags [[maybe_unused]],
+                             const PaStreamCallbackTimeInfo* time_info,
+                             PaStreamCallbackFlags status_flags,
                              void* user_data);
 };
 
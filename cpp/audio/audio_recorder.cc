@@ -0,0 +1,729 @@
+/**
+ * @file audio_recorder.cc
+ * @brief Implementation of the streaming file recorder
+ */
+
+#include "audio_recorder.h"
+#include "sample_format.h"
+#include <portaudio.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+#if defined(KOELINGO_HAVE_FLAC)
+#include <FLAC/stream_encoder.h>
+#endif
+
+#if defined(KOELINGO_HAVE_OPUS)
+#include <opusenc.h>
+#endif
+
+namespace koelingo {
+namespace audio {
+
+namespace {
+
+// Alignment of the staging block handed to the file system
+constexpr size_t kStagingAlignment = 4096;
+
+// RIFF sizes are 32-bit
+constexpr uint64_t kMaxRiffBytes = std::numeric_limits<uint32_t>::max();
+
+// Little-endian field writers for the WAV header
+void put_u16(std::vector<unsigned char>& out, uint32_t value) {
+    out.push_back(static_cast<unsigned char>(value & 0xFF));
+    out.push_back(static_cast<unsigned char>((value >> 8) & 0xFF));
+}
+
+void put_u32(std::vector<unsigned char>& out, uint64_t value) {
+    uint32_t clamped = static_cast<uint32_t>(std::min(value, kMaxRiffBytes));
+    put_u16(out, clamped & 0xFFFF);
+    put_u16(out, clamped >> 16);
+}
+
+void put_tag(std::vector<unsigned char>& out, const char* tag) {
+    out.insert(out.end(), tag, tag + 4);
+}
+
+} // namespace
+
+// Write a WAV header for a PortAudio sample format
+size_t write_wav_header(std::FILE* file, int sample_rate, int channels, int format_type,
+                        uint64_t data_bytes) {
+    const uint32_t bits = static_cast<uint32_t>(bytes_per_sample(format_type) * 8);
+    const uint32_t block_align = static_cast<uint32_t>(bytes_per_sample(format_type) * channels);
+    const bool is_float = format_type == paFloat32;
+    const bool extensible = channels > 2 || bits > 16;
+
+    // Plain PCM has a 16-byte fmt chunk; float needs cbSize, extensible 22 more bytes
+    const uint32_t format_tag = extensible ? 0xFFFE : (is_float ? 3 : 1);
+    const uint32_t fmt_bytes = extensible ? 40 : (is_float ? 18 : 16);
+    const bool has_fact = is_float; // Required for every non-PCM format
+    const uint64_t pad = data_bytes & 1;
+
+    std::vector<unsigned char> header;
+    put_tag(header, "RIFF");
+    put_u32(header, 4 + (8 + fmt_bytes) + (has_fact ? 12 : 0) + 8 + data_bytes + pad);
+    put_tag(header, "WAVE");
+
+    put_tag(header, "fmt ");
+    put_u32(header, fmt_bytes);
+    put_u16(header, format_tag);
+    put_u16(header, static_cast<uint32_t>(channels));
+    put_u32(header, static_cast<uint32_t>(sample_rate));
+    put_u32(header, static_cast<uint64_t>(sample_rate) * block_align);
+    put_u16(header, block_align);
+    put_u16(header, bits);
+    if (extensible) {
+        put_u16(header, 22);
+        put_u16(header, bits); // Valid bits per sample
+        uint32_t channel_mask = channels == 1 ? 0x4 : (channels == 2 ? 0x3 : 0);
+        put_u32(header, channel_mask);
+
+        // KSDATAFORMAT_SUBTYPE_PCM / _IEEE_FLOAT
+        static const unsigned char kSubformatTail[14] = {
+            0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71};
+        put_u16(header, is_float ? 3 : 1);
+        header.insert(header.end(), kSubformatTail, kSubformatTail + sizeof(kSubformatTail));
+    } else if (is_float) {
+        put_u16(header, 0);
+    }
+
+    if (has_fact) {
+        put_tag(header, "fact");
+        put_u32(header, 4);
+        put_u32(header, block_align > 0 ? data_bytes / block_align : 0);
+    }
+
+    put_tag(header, "data");
+    put_u32(header, data_bytes);
+
+    if (std::fwrite(header.data(), 1, header.size(), file) != header.size()) {
+        return 0;
+    }
+    return header.size();
+}
+
+/**
+ * @class FileEncoder
+ * @brief One output file of a recording
+ */
+class FileEncoder {
+public:
+    virtual ~FileEncoder() = default;
+
+    // Create the file and write any header
+    virtual bool open(const std::string& path) = 0;
+
+    // Append interleaved frames; the encoder may modify them in place
+    virtual bool write(char* frames, size_t count) = 0;
+
+    // Finalize the header and close the file
+    virtual bool close() = 0;
+
+    // Bytes in the file so far
+    virtual uint64_t bytes_written() const = 0;
+
+    // Frames that still fit below max_bytes (0 = container limit only);
+    // encoders that cannot predict their output report no limit
+    virtual uint64_t frames_until(uint64_t max_bytes [[maybe_unused]]) const {
+        return std::numeric_limits<uint64_t>::max();
+    }
+};
+
+namespace {
+
+/**
+ * @class WavEncoder
+ * @brief Writes frames unchanged into a RIFF/WAVE file
+ */
+class WavEncoder : public FileEncoder {
+public:
+    WavEncoder(int sample_rate, int channels, int format_type)
+        : sample_rate_(sample_rate),
+          channels_(channels),
+          format_type_(format_type),
+          frame_bytes_(bytes_per_sample(format_type) * channels),
+          file_(nullptr),
+          header_bytes_(0),
+          data_bytes_(0) {
+    }
+
+    ~WavEncoder() override {
+        if (file_) {
+            close();
+        }
+    }
+
+    bool open(const std::string& path) override {
+        file_ = std::fopen(path.c_str(), "wb");
+        if (!file_) {
+            return false;
+        }
+
+        // Blocks are already large; write them straight through
+        std::setvbuf(file_, nullptr, _IONBF, 0);
+        data_bytes_ = 0;
+        header_bytes_ = write_wav_header(file_, sample_rate_, channels_, format_type_, 0);
+        return header_bytes_ > 0;
+    }
+
+    bool write(char* frames, size_t count) override {
+        size_t bytes = count * frame_bytes_;
+        if (format_type_ == paInt8) {
+            // 8-bit WAV is unsigned
+            for (size_t i = 0; i < bytes; i++) {
+                frames[i] = static_cast<char>(static_cast<unsigned char>(frames[i]) ^ 0x80);
+            }
+        }
+        if (std::fwrite(frames, 1, bytes, file_) != bytes) {
+            return false;
+        }
+        data_bytes_ += bytes;
+        return true;
+    }
+
+    bool close() override {
+        // Chunks are word aligned, then the sizes are patched at the start
+        bool ok = true;
+        if (data_bytes_ & 1) {
+            ok = std::fputc(0, file_) != EOF;
+        }
+        ok = ok && std::fseek(file_, 0, SEEK_SET) == 0 &&
+             write_wav_header(file_, sample_rate_, channels_, format_type_, data_bytes_) > 0;
+        ok = std::fclose(file_) == 0 && ok;
+        file_ = nullptr;
+        return ok;
+    }
+
+    uint64_t bytes_written() const override { return header_bytes_ + data_bytes_; }
+
+    uint64_t frames_until(uint64_t max_bytes) const override {
+        uint64_t limit = kMaxRiffBytes - 1; // Leave room for the pad byte
+        if (max_bytes > 0) {
+            limit = std::min(limit, max_bytes);
+        }
+        uint64_t used = bytes_written();
+        return limit > used ? (limit - used) / frame_bytes_ : 0;
+    }
+
+private:
+    int sample_rate_;
+    int channels_;
+    int format_type_;
+    size_t frame_bytes_;
+    std::FILE* file_;
+    size_t header_bytes_;
+    uint64_t data_bytes_;
+};
+
+#if defined(KOELINGO_HAVE_FLAC)
+
+/**
+ * @class FlacEncoder
+ * @brief Lossless FLAC at 8, 16 or 24 bits
+ */
+class FlacEncoder : public FileEncoder {
+public:
+    FlacEncoder(int sample_rate, int channels, int format_type, int compression_level)
+        : sample_rate_(sample_rate),
+          channels_(channels),
+          format_type_(format_type),
+          compression_level_(compression_level),
+          encoder_(nullptr),
+          file_(nullptr) {
+        // Float and 32-bit input is stored at 24 bits, the most libFLAC encodes
+        size_t bytes = bytes_per_sample(format_type);
+        bits_ = bytes == 1 ? 8 : (bytes == 2 ? 16 : 24);
+    }
+
+    ~FlacEncoder() override {
+        if (encoder_) {
+            close();
+        }
+    }
+
+    bool open(const std::string& path) override {
+        // The encoder rewrites STREAMINFO at the end, so the file must be seekable
+        file_ = std::fopen(path.c_str(), "w+b");
+        if (!file_) {
+            return false;
+        }
+        encoder_ = FLAC__stream_encoder_new();
+        if (!encoder_) {
+            std::fclose(file_);
+            file_ = nullptr;
+            return false;
+        }
+        FLAC__stream_encoder_set_channels(encoder_, static_cast<unsigned>(channels_));
+        FLAC__stream_encoder_set_bits_per_sample(encoder_, static_cast<unsigned>(bits_));
+        FLAC__stream_encoder_set_sample_rate(encoder_, static_cast<unsigned>(sample_rate_));
+        FLAC__stream_encoder_set_compression_level(encoder_, static_cast<unsigned>(compression_level_));
+
+        // On success the encoder owns the file and closes it in finish()
+        if (FLAC__stream_encoder_init_FILE(encoder_, file_, nullptr, nullptr) !=
+            FLAC__STREAM_ENCODER_INIT_STATUS_OK) {
+            FLAC__stream_encoder_delete(encoder_);
+            encoder_ = nullptr;
+            std::fclose(file_);
+            file_ = nullptr;
+            return false;
+        }
+        return true;
+    }
+
+    bool write(char* frames, size_t count) override {
+        size_t samples = count * channels_;
+        if (floats_.size() < samples) {
+            floats_.resize(samples);
+            ints_.resize(samples);
+        }
+
+        convert_to_float32(frames, samples, format_type_, floats_.data());
+        const float scale = static_cast<float>(1 << (bits_ - 1));
+        const long top = (1L << (bits_ - 1)) - 1;
+        for (size_t i = 0; i < samples; i++) {
+            ints_[i] = static_cast<FLAC__int32>(
+                std::clamp(std::lround(floats_[i] * scale), -top - 1, top));
+        }
+        return FLAC__stream_encoder_process_interleaved(encoder_, ints_.data(),
+                                                        static_cast<unsigned>(count));
+    }
+
+    bool close() override {
+        bool ok = FLAC__stream_encoder_finish(encoder_);
+        FLAC__stream_encoder_delete(encoder_);
+        encoder_ = nullptr;
+        file_ = nullptr;
+        return ok;
+    }
+
+    uint64_t bytes_written() const override {
+        long position = file_ ? std::ftell(file_) : 0;
+        return position > 0 ? static_cast<uint64_t>(position) : 0;
+    }
+
+private:
+    int sample_rate_;
+    int channels_;
+    int format_type_;
+    int compression_level_;
+    int bits_;
+    FLAC__StreamEncoder* encoder_;
+    std::FILE* file_;
+    std::vector<float> floats_;
+    std::vector<FLAC__int32> ints_;
+};
+
+#endif // KOELINGO_HAVE_FLAC
+
+#if defined(KOELINGO_HAVE_OPUS)
+
+/**
+ * @class OpusFileEncoder
+ * @brief Ogg Opus through libopusenc, which resamples to 48 kHz itself
+ */
+class OpusFileEncoder : public FileEncoder {
+public:
+    OpusFileEncoder(int sample_rate, int channels, int format_type, int bitrate)
+        : sample_rate_(sample_rate),
+          channels_(channels),
+          format_type_(format_type),
+          bitrate_(bitrate),
+          comments_(nullptr),
+          encoder_(nullptr),
+          file_(nullptr),
+          bytes_(0) {
+    }
+
+    ~OpusFileEncoder() override {
+        if (encoder_) {
+            close();
+        }
+    }
+
+    bool open(const std::string& path) override {
+        file_ = std::fopen(path.c_str(), "wb");
+        if (!file_) {
+            return false;
+        }
+        bytes_ = 0;
+
+        // Pages go through our callback so the file size is known exactly
+        OpusEncCallbacks callbacks = {&OpusFileEncoder::write_page, &OpusFileEncoder::close_stream};
+        comments_ = ope_comments_create();
+        int error = OPE_OK;
+        encoder_ = ope_encoder_create_callbacks(&callbacks, this, comments_, sample_rate_, channels_,
+                                                channels_ > 2 ? 1 : 0, &error);
+        if (!encoder_ || error != OPE_OK) {
+            std::cerr << "Opus encoder error: " << ope_strerror(error) << std::endl;
+            ope_comments_destroy(comments_);
+            comments_ = nullptr;
+            encoder_ = nullptr;
+            std::fclose(file_);
+            file_ = nullptr;
+            return false;
+        }
+        ope_encoder_ctl(encoder_, OPUS_SET_BITRATE(bitrate_));
+        return true;
+    }
+
+    bool write(char* frames, size_t count) override {
+        size_t samples = count * channels_;
+        if (floats_.size() < samples) {
+            floats_.resize(samples);
+        }
+        convert_to_float32(frames, samples, format_type_, floats_.data());
+        return ope_encoder_write_float(encoder_, floats_.data(), static_cast<int>(count)) == OPE_OK;
+    }
+
+    bool close() override {
+        bool ok = ope_encoder_drain(encoder_) == OPE_OK;
+        ope_encoder_destroy(encoder_);
+        ope_comments_destroy(comments_);
+        encoder_ = nullptr;
+        comments_ = nullptr;
+        ok = std::fclose(file_) == 0 && ok;
+        file_ = nullptr;
+        return ok;
+    }
+
+    uint64_t bytes_written() const override { return bytes_; }
+
+private:
+    int sample_rate_;
+    int channels_;
+    int format_type_;
+    int bitrate_;
+    OggOpusComments* comments_;
+    OggOpusEnc* encoder_;
+    std::FILE* file_;
+    uint64_t bytes_;
+    std::vector<float> floats_;
+
+    static int write_page(void* user_data, const unsigned char* data, opus_int32 length) {
+        auto* self = static_cast<OpusFileEncoder*>(user_data);
+        size_t size = static_cast<size_t>(length);
+        if (std::fwrite(data, 1, size, self->file_) != size) {
+            return 1;
+        }
+        self->bytes_ += size;
+        return 0;
+    }
+
+    // The file is closed in close() instead
+    static int close_stream(void* user_data [[maybe_unused]]) {
+        return 0;
+    }
+};
+
+#endif // KOELINGO_HAVE_OPUS
+
+} // namespace
+
+// AudioRecorder constructor
+AudioRecorder::AudioRecorder()
+    : ring_(nullptr),
+      signal_(nullptr),
+      sample_rate_(0),
+      channels_(0),
+      format_type_(0),
+      frame_bytes_(0),
+      cursor_(0),
+      staging_(nullptr),
+      staging_bytes_(0),
+      file_index_(0),
+      file_frames_(0),
+      max_file_frames_(0),
+      thread_(nullptr),
+      stop_(false),
+      active_(false),
+      frames_recorded_(0),
+      dropped_frames_(0),
+      files_completed_(0) {
+}
+
+// AudioRecorder destructor
+AudioRecorder::~AudioRecorder() {
+    stop();
+}
+
+// Check whether a format was compiled in
+bool AudioRecorder::format_supported(RecordingFormat format) {
+    switch (format) {
+        case RecordingFormat::kWav:
+            return true;
+        case RecordingFormat::kFlac:
+#if defined(KOELINGO_HAVE_FLAC)
+            return true;
+#else
+            return false;
+#endif
+        case RecordingFormat::kOpus:
+#if defined(KOELINGO_HAVE_OPUS)
+            return true;
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+// Open the first file and start the I/O thread
+bool AudioRecorder::start(const RecorderConfig& config, const RingBuffer& ring, DataSignal& signal,
+                          uint64_t start_frame, int sample_rate, int channels, int format_type) {
+    if (thread_) {
+        std::cerr << "File recording is already active" << std::endl;
+        return false;
+    }
+    if (config.path.empty() || sample_rate <= 0 || channels <= 0) {
+        std::cerr << "Invalid file recording configuration" << std::endl;
+        return false;
+    }
+    if (!format_supported(config.format)) {
+        std::cerr << "Recording format not available in this build" << std::endl;
+        return false;
+    }
+
+    config_ = config;
+    ring_ = &ring;
+    signal_ = &signal;
+    sample_rate_ = sample_rate;
+    channels_ = channels;
+    format_type_ = format_type;
+    frame_bytes_ = bytes_per_sample(format_type) * channels;
+    cursor_ = start_frame * frame_bytes_;
+
+    // Whole frames, and never more than the ring can hold
+    size_t block_frames = std::max<size_t>(1, std::min(config.buffer_bytes, ring.capacity()) / frame_bytes_);
+    staging_bytes_ = block_frames * frame_bytes_;
+    staging_storage_.assign(staging_bytes_ + kStagingAlignment, 0);
+    void* aligned = staging_storage_.data();
+    size_t space = staging_storage_.size();
+    staging_ = static_cast<char*>(std::align(kStagingAlignment, staging_bytes_, aligned, space));
+
+    file_index_ = 0;
+    file_frames_ = 0;
+    max_file_frames_ = config.max_file_seconds > 0.0
+        ? std::max<uint64_t>(1, static_cast<uint64_t>(std::llround(config.max_file_seconds * sample_rate)))
+        : 0;
+    frames_recorded_ = 0;
+    dropped_frames_ = 0;
+    files_completed_ = 0;
+
+    // Open the first file here so errors are reported to the caller
+    if (!open_file()) {
+        return false;
+    }
+
+    stop_ = false;
+    active_ = true;
+    thread_ = std::make_unique<std::thread>(&AudioRecorder::run, this);
+    return true;
+}
+
+// Drain, finalize and stop
+void AudioRecorder::stop() {
+    if (!thread_) {
+        return;
+    }
+    stop_ = true;
+    signal_->notify();
+    if (thread_->joinable()) {
+        thread_->join();
+    }
+    thread_.reset();
+}
+
+// Get the path of the current file
+std::string AudioRecorder::current_file() const {
+    std::lock_guard<std::mutex> lock(path_mutex_);
+    return current_path_;
+}
+
+// Name of the index-th file of the recording
+std::string AudioRecorder::file_path(uint64_t index) const {
+    if (config_.max_file_bytes == 0 && config_.max_file_seconds <= 0.0) {
+        return config_.path;
+    }
+
+    // Number every file when rotating: session.wav -> session_000.wav, ...
+    size_t slash = config_.path.find_last_of("/\\");
+    size_t dot = config_.path.find_last_of('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        dot = config_.path.size();
+    }
+    char number[24];
+    std::snprintf(number, sizeof(number), "_%03llu", static_cast<unsigned long long>(index));
+    return config_.path.substr(0, dot) + number + config_.path.substr(dot);
+}
+
+// Create the next output file
+bool AudioRecorder::open_file() {
+    switch (config_.format) {
+        case RecordingFormat::kWav:
+            encoder_ = std::make_unique<WavEncoder>(sample_rate_, channels_, format_type_);
+            break;
+#if defined(KOELINGO_HAVE_FLAC)
+        case RecordingFormat::kFlac:
+            encoder_ = std::make_unique<FlacEncoder>(sample_rate_, channels_, format_type_,
+                                                     config_.flac_compression_level);
+            break;
+#endif
+#if defined(KOELINGO_HAVE_OPUS)
+        case RecordingFormat::kOpus:
+            encoder_ = std::make_unique<OpusFileEncoder>(sample_rate_, channels_, format_type_,
+                                                         config_.opus_bitrate);
+            break;
+#endif
+        default:
+            return false;
+    }
+
+    std::string path = file_path(file_index_);
+    if (!encoder_->open(path)) {
+        std::cerr << "Failed to open recording file: " << path << std::endl;
+        encoder_.reset();
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(path_mutex_);
+    current_path_ = path;
+    file_frames_ = 0;
+    return true;
+}
+
+// Finalize the current output file
+bool AudioRecorder::close_file() {
+    bool ok = encoder_->close();
+    encoder_.reset();
+    if (!ok) {
+        std::cerr << "Failed to finalize recording file: " << current_file() << std::endl;
+        return false;
+    }
+    files_completed_++;
+    file_index_++;
+    return true;
+}
+
+// Write frames, starting new files at the rotation limits
+bool AudioRecorder::write_frames(char* frames, size_t count) {
+    while (count > 0) {
+        // The next file is only created once there is audio for it
+        if (!encoder_ && !open_file()) {
+            return false;
+        }
+
+        uint64_t room = encoder_->frames_until(config_.max_file_bytes);
+        if (max_file_frames_ > 0) {
+            room = std::min(room, max_file_frames_ - file_frames_);
+        }
+        if (room == 0) {
+            if (file_frames_ == 0) {
+                room = 1; // Limit smaller than the header; still make progress
+            } else if (!close_file()) {
+                return false;
+            } else {
+                continue;
+            }
+        }
+
+        size_t block = static_cast<size_t>(std::min<uint64_t>(count, room));
+        if (!encoder_->write(frames, block)) {
+            std::cerr << "Failed to write recording file: " << current_file() << std::endl;
+            return false;
+        }
+        file_frames_ += block;
+        frames_recorded_ += block;
+        frames += block * frame_bytes_;
+        count -= block;
+
+        // Compressed sizes are only known after the fact
+        bool full = (max_file_frames_ > 0 && file_frames_ >= max_file_frames_) ||
+                    (config_.max_file_bytes > 0 && encoder_->bytes_written() >= config_.max_file_bytes);
+        if (full && !close_file()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Write silence in place of frames lost from the ring
+bool AudioRecorder::write_silence(uint64_t count) {
+    const size_t block_frames = staging_bytes_ / frame_bytes_;
+    const char silence = format_type_ == paUInt8 ? static_cast<char>(0x80) : 0;
+
+    while (count > 0) {
+        size_t block = static_cast<size_t>(std::min<uint64_t>(count, block_frames));
+        // Refilled every time: encoders may modify the block in place
+        std::fill(staging_, staging_ + block * frame_bytes_, silence);
+        if (!write_frames(staging_, block)) {
+            return false;
+        }
+        count -= block;
+    }
+    return true;
+}
+
+// I/O thread
+void AudioRecorder::run() {
+    using clock = std::chrono::steady_clock;
+    const uint64_t block_frames = staging_bytes_ / frame_bytes_;
+    const auto flush_interval = std::chrono::milliseconds(std::max(1, config_.flush_interval_ms));
+    auto flush_deadline = clock::now() + flush_interval;
+    bool ok = true;
+
+    while (ok) {
+        // Sample the sequence first so a write landing after the check wakes us
+        uint32_t seen = signal_->sequence();
+        bool stopping = stop_;
+
+        uint64_t end = ring_->write_position();
+        uint64_t pending = end > cursor_ ? (end - cursor_) / frame_bytes_ : 0;
+        auto now = clock::now();
+
+        // Write whole blocks; partial ones only when they have waited long enough
+        if (pending >= block_frames || (pending > 0 && (stopping || now >= flush_deadline))) {
+            uint64_t to = cursor_ + std::min(pending, block_frames) * frame_bytes_;
+            uint64_t start = ring_->copy(cursor_, to, staging_);
+            if (start > cursor_) {
+                // The disk fell a whole ring behind; keep the file timeline
+                // intact and copy again from the oldest retained frame
+                uint64_t lost = (start - cursor_) / frame_bytes_;
+                dropped_frames_ += lost;
+                ok = write_silence(lost);
+                cursor_ = start;
+                continue;
+            }
+            ok = write_frames(staging_, static_cast<size_t>((to - start) / frame_bytes_));
+            cursor_ = to;
+            flush_deadline = now + flush_interval;
+            continue;
+        }
+
+        if (stopping) {
+            break;
+        }
+
+        if (pending == 0) {
+            flush_deadline = now + flush_interval;
+        }
+        auto timeout = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::min<clock::duration>(flush_deadline - now, std::chrono::milliseconds(500)));
+        signal_->wait(seen, timeout);
+    }
+
+    if (encoder_) {
+        close_file();
+    }
+    if (!ok) {
+        std::cerr << "File recording stopped after an I/O error" << std::endl;
+    }
+    active_ = false;
+}
+
+} // namespace audio
+} // namespace koelingo
@@ -0,0 +1,184 @@
+/**
+ * @file audio_recorder.h
+ * @brief Streaming recorder that archives the capture to WAV, FLAC or Opus files
+ */
+
+#ifndef KOELINGO_AUDIO_RECORDER_H
+#define KOELINGO_AUDIO_RECORDER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "data_signal.h"
+#include "ring_buffer.h"
+
+namespace koelingo {
+namespace audio {
+
+/**
+ * @brief Container format written by AudioRecorder
+ */
+enum class RecordingFormat {
+    kWav,  ///< Uncompressed RIFF/WAVE in the capture sample format
+    kFlac, ///< Lossless FLAC (needs a build with KOELINGO_WITH_FLAC)
+    kOpus, ///< Ogg Opus (needs a build with KOELINGO_WITH_OPUS)
+};
+
+/**
+ * @struct RecorderConfig
+ * @brief Parameters of a file recording
+ */
+struct RecorderConfig {
+    std::string path;                            ///< Output file; numbered when rotating
+    RecordingFormat format = RecordingFormat::kWav;
+    uint64_t max_file_bytes = 0;                 ///< Start a new file past this size (0 = no limit)
+    double max_file_seconds = 0.0;               ///< Start a new file past this duration (0 = no limit)
+    size_t buffer_bytes = 1 << 20;               ///< Size of each write to disk
+    int flush_interval_ms = 1000;                ///< Longest time audio waits in memory
+    int flac_compression_level = 5;              ///< FLAC level 0 (fastest) to 8 (smallest)
+    int opus_bitrate = 32000;                    ///< Opus bitrate in bits per second
+};
+
+/**
+ * @brief Write a WAV header describing a PortAudio sample format
+ * @param file File positioned at its start
+ * @param sample_rate Sample rate in Hz
+ * @param channels Number of interleaved channels
+ * @param format_type PortAudio sample format of the data that follows
+ * @param data_bytes Size of the data chunk
+ * @return Size of the header in bytes, or 0 if it could not be written
+ *
+ * Float samples are tagged as IEEE float, and WAVE_FORMAT_EXTENSIBLE is used
+ * for more than two channels or more than 16 bits. Writing the header again
+ * at offset 0 with the final size patches it in place.
+ */
+size_t write_wav_header(std::FILE* file, int sample_rate, int channels, int format_type,
+                        uint64_t data_bytes);
+
+// Container writer, defined in audio_recorder.cc
+class FileEncoder;
+
+/**
+ * @class AudioRecorder
+ * @brief Background writer that streams a capture ring buffer to disk
+ *
+ * The recorder follows the ring buffer with its own cursor on a dedicated
+ * I/O thread, so neither the PortAudio callback nor the processing thread
+ * ever touches the file system. Audio is copied out of the ring in large
+ * aligned blocks and written (or encoded) one block at a time, so memory
+ * use is fixed when recording starts no matter how long it runs.
+ *
+ * If the disk stalls for longer than the ring buffer holds, the frames that
+ * were overwritten are replaced with silence so file time stays aligned with
+ * capture time; dropped_frames() counts them.
+ */
+class AudioRecorder {
+public:
+    AudioRecorder();
+    ~AudioRecorder();
+
+    AudioRecorder(const AudioRecorder&) = delete;
+    AudioRecorder& operator=(const AudioRecorder&) = delete;
+
+    /**
+     * @brief Open the first file and start the I/O thread
+     * @param config Output path, format and rotation limits
+     * @param ring Ring buffer holding the capture
+     * @param signal Signal raised whenever the ring buffer is written
+     * @param start_frame Stream frame index of the first frame to record
+     * @param sample_rate Sample rate of the frames in the ring
+     * @param channels Number of interleaved channels in the ring
+     * @param format_type PortAudio sample format of the ring's frames
+     * @return False if already recording, the format is not available or
+     *         the file could not be created
+     */
+    bool start(const RecorderConfig& config, const RingBuffer& ring, DataSignal& signal,
+               uint64_t start_frame, int sample_rate, int channels, int format_type);
+
+    /**
+     * @brief Write everything captured so far, finalize the file and stop
+     *
+     * The caller should stop writing to the ring first if the recording is
+     * to include every captured frame.
+     */
+    void stop();
+
+    /**
+     * @brief Check whether the I/O thread is recording
+     */
+    bool is_active() const { return active_; }
+
+    /**
+     * @brief Check whether a format was compiled into this build
+     */
+    static bool format_supported(RecordingFormat format);
+
+    /**
+     * @brief Get the number of frames written to files since start()
+     */
+    uint64_t frames_recorded() const { return frames_recorded_; }
+
+    /**
+     * @brief Get the number of frames replaced with silence because the
+     *        ring buffer overwrote them before they reached the disk
+     */
+    uint64_t dropped_frames() const { return dropped_frames_; }
+
+    /**
+     * @brief Get the number of files that have been finalized
+     */
+    uint64_t files_completed() const { return files_completed_; }
+
+    /**
+     * @brief Get the path of the file being written (or the last one)
+     */
+    std::string current_file() const;
+
+private:
+    RecorderConfig config_;
+    const RingBuffer* ring_;
+    DataSignal* signal_;
+    int sample_rate_;
+    int channels_;
+    int format_type_;
+    size_t frame_bytes_;
+    uint64_t cursor_; // Byte position in the ring of the next frame to record
+
+    // Aligned staging block; storage is over-allocated by the alignment
+    std::vector<char> staging_storage_;
+    char* staging_;
+    size_t staging_bytes_;
+
+    std::unique_ptr<FileEncoder> encoder_;
+    uint64_t file_index_;
+    uint64_t file_frames_;
+    uint64_t max_file_frames_;
+
+    mutable std::mutex path_mutex_;
+    std::string current_path_;
+
+    std::unique_ptr<std::thread> thread_;
+    std::atomic<bool> stop_;
+    std::atomic<bool> active_;
+    std::atomic<uint64_t> frames_recorded_;
+    std::atomic<uint64_t> dropped_frames_;
+    std::atomic<uint64_t> files_completed_;
+
+    void run();
+    bool open_file();
+    bool close_file();
+    bool write_frames(char* frames, size_t count);
+    bool write_silence(uint64_t count);
+    std::string file_path(uint64_t index) const;
+};
+
+} // namespace audio
+} // namespace koelingo
+
+#endif // KOELINGO_AUDIO_RECORDER_H
@@ -0,0 +1,71 @@
+/**
+ * @file capture_stats.cc
+ * @brief Implementation of the capture latency histograms
+ */
+
+#include "capture_stats.h"
+#include <algorithm>
+#include <cmath>
+
+namespace koelingo {
+namespace audio {
+
+// Estimate a percentile from the buckets
+uint64_t HistogramSnapshot::percentile_us(double quantile) const {
+    if (count == 0) {
+        return 0;
+    }
+
+    quantile = std::min(1.0, std::max(0.0, quantile));
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(quantile * count)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kHistogramBuckets; i++) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return std::min(bucket_bound_us(i), max_us);
+        }
+    }
+    return max_us;
+}
+
+// Record one duration
+void LatencyHistogram::record(uint64_t micros) {
+    // Bucket by bit width: [2^(i-1), 2^i)
+    size_t bucket = 0;
+    for (uint64_t v = micros; v != 0 && bucket + 1 < kHistogramBuckets; v >>= 1) {
+        bucket++;
+    }
+    buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+    sum_us_.fetch_add(micros, std::memory_order_relaxed);
+
+    uint64_t longest = max_us_.load(std::memory_order_relaxed);
+    while (micros > longest &&
+           !max_us_.compare_exchange_weak(longest, micros, std::memory_order_relaxed)) {
+    }
+}
+
+// Clear every bucket
+void LatencyHistogram::reset() {
+    for (std::atomic<uint64_t>& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    sum_us_.store(0, std::memory_order_relaxed);
+    max_us_.store(0, std::memory_order_relaxed);
+}
+
+// Copy the current contents
+HistogramSnapshot LatencyHistogram::snapshot() const {
+    HistogramSnapshot snapshot;
+
+    // The count is derived from the buckets so percentiles stay consistent
+    for (size_t i = 0; i < kHistogramBuckets; i++) {
+        snapshot.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+        snapshot.count += snapshot.buckets[i];
+    }
+    snapshot.sum_us = sum_us_.load(std::memory_order_relaxed);
+    snapshot.max_us = max_us_.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+} // namespace audio
+} // namespace koelingo
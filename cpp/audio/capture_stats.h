@@ -0,0 +1,133 @@
+/**
+ * @file capture_stats.h
+ * @brief Counters and latency histograms for the capture pipeline
+ */
+
+#ifndef KOELINGO_CAPTURE_STATS_H
+#define KOELINGO_CAPTURE_STATS_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace koelingo {
+namespace audio {
+
+/**
+ * @brief Number of power-of-two buckets in a LatencyHistogram
+ *
+ * Bucket i counts durations below 2^i microseconds (and at least 2^(i-1)),
+ * so the last bucket starts at about 18 minutes.
+ */
+constexpr size_t kHistogramBuckets = 32;
+
+/**
+ * @struct HistogramSnapshot
+ * @brief Copy of a LatencyHistogram taken by get_stats()
+ */
+struct HistogramSnapshot {
+    uint64_t count = 0;   ///< Number of recorded durations
+    uint64_t sum_us = 0;  ///< Sum of all durations in microseconds
+    uint64_t max_us = 0;  ///< Longest duration in microseconds
+    std::array<uint64_t, kHistogramBuckets> buckets{}; ///< Per-bucket (non-cumulative) counts
+
+    /**
+     * @brief Get the exclusive upper bound of a bucket
+     * @param bucket Bucket index
+     * @return Bound in microseconds
+     */
+    static uint64_t bucket_bound_us(size_t bucket) { return uint64_t(1) << bucket; }
+
+    /**
+     * @brief Get the mean duration
+     * @return Mean in microseconds, or 0 if nothing was recorded
+     */
+    double mean_us() const { return count > 0 ? static_cast<double>(sum_us) / count : 0.0; }
+
+    /**
+     * @brief Estimate a percentile from the buckets
+     * @param quantile Quantile in [0.0, 1.0], e.g. 0.99
+     * @return Upper bound of the bucket holding the quantile, capped at max_us
+     */
+    uint64_t percentile_us(double quantile) const;
+};
+
+/**
+ * @class LatencyHistogram
+ * @brief Lock-free histogram of durations in microseconds
+ *
+ * record() is wait-free and allocation-free, so it can be called from the
+ * PortAudio callback. A snapshot taken concurrently may be off by the
+ * values recorded while it was being copied.
+ */
+class LatencyHistogram {
+public:
+    LatencyHistogram() { reset(); }
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    /**
+     * @brief Record one duration
+     * @param micros Duration in microseconds
+     */
+    void record(uint64_t micros);
+
+    /**
+     * @brief Clear every bucket
+     */
+    void reset();
+
+    /**
+     * @brief Copy the current contents
+     */
+    HistogramSnapshot snapshot() const;
+
+private:
+    std::array<std::atomic<uint64_t>, kHistogramBuckets> buckets_;
+    std::atomic<uint64_t> sum_us_;
+    std::atomic<uint64_t> max_us_;
+};
+
+/**
+ * @struct CaptureStats
+ * @brief Point-in-time view of the capture pipeline returned by AudioCapture::get_stats()
+ *
+ * Counters cover the current (or last) recording and are reset by
+ * start_recording(). Latencies add up end to end: input_latency is the
+ * time from the ADC to the PortAudio callback, processing_latency the time
+ * from the callback until the level/VAD/mel stages have seen the frames.
+ * The *_time histograms record how long each processing stage spent on
+ * each block it processed, so the cost of the chain can be attributed.
+ */
+struct CaptureStats {
+    uint64_t callbacks = 0;               ///< PortAudio callbacks received
+    uint64_t frames_captured = 0;         ///< Frames written to the ring buffer
+    uint64_t input_overflows = 0;         ///< Callbacks flagged paInputOverflow (xruns)
+    uint64_t input_underflows = 0;        ///< Callbacks flagged paInputUnderflow
+    uint64_t dropped_frames = 0;          ///< Frames overwritten before processing reached them
+    uint64_t dropped_utterances = 0;      ///< Utterances dropped because nobody consumed them
+    uint64_t dropped_chunks = 0;          ///< Periods not queued because every pooled chunk was in use
+    uint64_t recording_dropped_frames = 0; ///< Frames the file recorder wrote as silence
+    uint64_t device_failures = 0;         ///< Device reopens that failed after a period change
+
+    uint64_t ring_capacity_frames = 0;     ///< Ring buffer size
+    uint64_t ring_backlog_frames = 0;      ///< Captured frames not yet processed
+    uint64_t ring_peak_backlog_frames = 0; ///< Largest backlog seen by the processing stage
+
+    HistogramSnapshot callback_duration;  ///< Time spent inside the PortAudio callback
+    HistogramSnapshot input_latency;      ///< inputBufferAdcTime to callback (when the host API reports it)
+    HistogramSnapshot processing_latency; ///< Callback to processed by the analysis stages
+
+    HistogramSnapshot level_time;   ///< Level metering, per block
+    HistogramSnapshot denoise_time; ///< Noise suppression, per block
+    HistogramSnapshot agc_time;     ///< Automatic gain control, per block
+    HistogramSnapshot vad_time;     ///< Voice activity detection, per block
+    HistogramSnapshot mel_time;     ///< Log-mel front end, per block
+};
+
+} // namespace audio
+} // namespace koelingo
+
+#endif // KOELINGO_CAPTURE_STATS_H
@@ -0,0 +1,176 @@
+/**
+ * @file chunk_pool.cc
+ * @brief Implementation of the pooled chunk buffers
+ */
+
+#include "chunk_pool.h"
+
+namespace koelingo {
+namespace audio {
+
+namespace {
+
+constexpr uint32_t kNoSlot = UINT32_MAX;
+
+uint64_t pack(uint32_t index, uint32_t tag) {
+    return (static_cast<uint64_t>(tag) << 32) | index;
+}
+
+uint32_t index_of(uint64_t head) {
+    return static_cast<uint32_t>(head);
+}
+
+uint32_t tag_of(uint64_t head) {
+    return static_cast<uint32_t>(head >> 32);
+}
+
+} // namespace
+
+// PooledChunk copy constructor
+PooledChunk::PooledChunk(const PooledChunk& other)
+    : pool_(other.pool_), index_(other.index_) {
+    if (pool_) {
+        pool_->retain(index_);
+    }
+}
+
+// PooledChunk move constructor
+PooledChunk::PooledChunk(PooledChunk&& other) noexcept
+    : pool_(std::move(other.pool_)), index_(other.index_) {
+}
+
+// PooledChunk assignment
+PooledChunk& PooledChunk::operator=(PooledChunk other) noexcept {
+    reset();
+    pool_ = std::move(other.pool_);
+    index_ = other.index_;
+    return *this;
+}
+
+// PooledChunk destructor
+PooledChunk::~PooledChunk() {
+    reset();
+}
+
+// Get the buffer memory
+char* PooledChunk::data() const {
+    return pool_ ? pool_->base_ + index_ * pool_->stride_ : nullptr;
+}
+
+// Get the number of valid bytes
+size_t PooledChunk::size() const {
+    return pool_ ? pool_->slots_[index_].size : 0;
+}
+
+// Get the buffer capacity
+size_t PooledChunk::capacity() const {
+    return pool_ ? pool_->chunk_bytes_ : 0;
+}
+
+// Get the capture frame of the first byte
+uint64_t PooledChunk::start_frame() const {
+    return pool_ ? pool_->slots_[index_].start_frame : 0;
+}
+
+// Describe the contents
+void PooledChunk::set_contents(size_t size, uint64_t start_frame) {
+    if (!pool_) {
+        return;
+    }
+    ChunkPool::Slot& slot = pool_->slots_[index_];
+    slot.size = size < pool_->chunk_bytes_ ? size : pool_->chunk_bytes_;
+    slot.start_frame = start_frame;
+}
+
+// Drop this reference
+void PooledChunk::reset() {
+    if (pool_) {
+        pool_->release(index_);
+        pool_.reset();
+    }
+}
+
+// Allocate a pool
+std::shared_ptr<ChunkPool> ChunkPool::create(size_t count, size_t chunk_bytes, size_t alignment) {
+    return std::shared_ptr<ChunkPool>(new ChunkPool(count, chunk_bytes, alignment));
+}
+
+// ChunkPool constructor
+ChunkPool::ChunkPool(size_t count, size_t chunk_bytes, size_t alignment)
+    : count_(count),
+      chunk_bytes_(chunk_bytes),
+      stride_(alignment > 1 ? (chunk_bytes + alignment - 1) / alignment * alignment : chunk_bytes),
+      arena_(count * stride_ + (alignment > 1 ? alignment - 1 : 0)),
+      base_(arena_.data()),
+      slots_(new Slot[count]),
+      free_head_(pack(count > 0 ? 0 : kNoSlot, 0)),
+      available_(count) {
+    // Over-allocated by alignment - 1 bytes, so an aligned start always fits
+    if (alignment > 1) {
+        uintptr_t address = reinterpret_cast<uintptr_t>(arena_.data());
+        base_ += (alignment - address % alignment) % alignment;
+    }
+    for (size_t i = 0; i < count; i++) {
+        slots_[i].next.store(i + 1 < count ? static_cast<uint32_t>(i + 1) : kNoSlot,
+                             std::memory_order_relaxed);
+    }
+}
+
+// Take a free buffer
+PooledChunk ChunkPool::acquire() {
+    uint64_t head = free_head_.load(std::memory_order_acquire);
+    while (true) {
+        uint32_t index = index_of(head);
+        if (index == kNoSlot) {
+            return PooledChunk();
+        }
+        // The tag makes the swap fail if the slot was taken and returned meanwhile
+        uint32_t next = slots_[index].next.load(std::memory_order_relaxed);
+        if (free_head_.compare_exchange_weak(head, pack(next, tag_of(head) + 1),
+                                             std::memory_order_acq_rel,
+                                             std::memory_order_acquire)) {
+            available_.fetch_sub(1, std::memory_order_relaxed);
+            slots_[index].refs.store(1, std::memory_order_relaxed);
+            slots_[index].size = 0;
+            slots_[index].start_frame = 0;
+            return PooledChunk(shared_from_this(), index);
+        }
+    }
+}
+
+// Give up a handle's reference without releasing it
+uint32_t ChunkPool::detach(PooledChunk& chunk) {
+    uint32_t index = chunk.index_;
+    chunk.pool_.reset();
+    return index;
+}
+
+// Turn a detached index back into a handle
+PooledChunk ChunkPool::adopt(uint32_t index) {
+    return PooledChunk(shared_from_this(), index);
+}
+
+// Add a reference
+void ChunkPool::retain(uint32_t index) {
+    slots_[index].refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Drop a reference; the last one puts the buffer back on the free list
+void ChunkPool::release(uint32_t index) {
+    if (slots_[index].refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+    uint64_t head = free_head_.load(std::memory_order_relaxed);
+    do {
+        slots_[index].next.store(index_of(head), std::memory_order_relaxed);
+    } while (!free_head_.compare_exchange_weak(head, pack(index, tag_of(head) + 1),
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed));
+    available_.fetch_add(1, std::memory_order_relaxed);
+    if (release_signal_) {
+        release_signal_->notify();
+    }
+}
+
+} // namespace audio
+} // namespace koelingo
@@ -0,0 +1,193 @@
+/**
+ * @file chunk_pool.h
+ * @brief Fixed pool of reusable, reference-counted audio chunk buffers
+ */
+
+#ifndef KOELINGO_CHUNK_POOL_H
+#define KOELINGO_CHUNK_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "data_signal.h"
+
+namespace koelingo {
+namespace audio {
+
+class ChunkPool;
+
+/**
+ * @class PooledChunk
+ * @brief Shared handle to one buffer of a ChunkPool
+ *
+ * Copies share the buffer; it returns to the pool when the last handle is
+ * destroyed or reset. Neither copying nor releasing allocates.
+ */
+class PooledChunk {
+public:
+    PooledChunk() = default;
+    PooledChunk(const PooledChunk& other);
+    PooledChunk(PooledChunk&& other) noexcept;
+    PooledChunk& operator=(PooledChunk other) noexcept;
+    ~PooledChunk();
+
+    /**
+     * @brief Check whether the handle refers to a buffer
+     */
+    explicit operator bool() const { return pool_ != nullptr; }
+
+    /**
+     * @brief Get the buffer memory (capacity() bytes)
+     */
+    char* data() const;
+
+    /**
+     * @brief Get the number of valid bytes
+     */
+    size_t size() const;
+
+    /**
+     * @brief Get the buffer capacity in bytes
+     */
+    size_t capacity() const;
+
+    /**
+     * @brief Get the capture frame index of the first byte
+     */
+    uint64_t start_frame() const;
+
+    /**
+     * @brief Describe the contents after filling the buffer
+     * @param size Number of valid bytes (at most capacity())
+     * @param start_frame Capture frame index of the first byte
+     */
+    void set_contents(size_t size, uint64_t start_frame);
+
+    /**
+     * @brief Drop this reference, returning the buffer if it was the last
+     */
+    void reset();
+
+private:
+    friend class ChunkPool;
+
+    PooledChunk(std::shared_ptr<ChunkPool> pool, uint32_t index)
+        : pool_(std::move(pool)), index_(index) {}
+
+    std::shared_ptr<ChunkPool> pool_;
+    uint32_t index_ = 0;
+};
+
+/**
+ * @class ChunkPool
+ * @brief Preallocated arena of equally sized chunk buffers
+ *
+ * All buffers are carved out of one allocation made by create(). acquire()
+ * and the final release are lock-free, so chunks can be taken on the
+ * processing thread and released from any thread, including one that
+ * holds them through the Python buffer protocol. The pool lives as long
+ * as any chunk does.
+ */
+class ChunkPool : public std::enable_shared_from_this<ChunkPool> {
+public:
+    /**
+     * @brief Allocate a pool
+     * @param count Number of buffers
+     * @param chunk_bytes Size of each buffer in bytes
+     * @param alignment Start every buffer on a multiple of this many bytes
+     *        (0 = packed), e.g. the page size for buffers that a GPU
+     *        runtime registers as pinned memory
+     */
+    static std::shared_ptr<ChunkPool> create(size_t count, size_t chunk_bytes, size_t alignment = 0);
+
+    ChunkPool(const ChunkPool&) = delete;
+    ChunkPool& operator=(const ChunkPool&) = delete;
+
+    /**
+     * @brief Take a free buffer
+     * @return An empty handle if every buffer is in use
+     */
+    PooledChunk acquire();
+
+    /**
+     * @brief Give up a handle's reference without releasing it
+     * @param chunk Handle to detach; becomes empty
+     * @return Buffer index to pass to adopt()
+     *
+     * Lets a chunk travel through a queue of plain indices.
+     */
+    uint32_t detach(PooledChunk& chunk);
+
+    /**
+     * @brief Turn an index from detach() back into a handle
+     */
+    PooledChunk adopt(uint32_t index);
+
+    /**
+     * @brief Get the number of buffers
+     */
+    size_t capacity() const { return count_; }
+
+    /**
+     * @brief Get the size of each buffer in bytes
+     */
+    size_t chunk_bytes() const { return chunk_bytes_; }
+
+    /**
+     * @brief Get the number of free buffers (approximate while in use)
+     */
+    size_t available() const { return available_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Raise a signal whenever a buffer returns to the pool
+     * @param signal Signal to notify, or nullptr for none
+     *
+     * Lets a producer that found the pool exhausted sleep until a consumer
+     * lets go of a buffer. Set it before any buffer is acquired.
+     */
+    void set_release_signal(std::shared_ptr<DataSignal> signal) { release_signal_ = std::move(signal); }
+
+    /**
+     * @brief Get the allocation every buffer is carved from, e.g. to lock it in memory
+     */
+    void* arena() { return base_; }
+
+    /**
+     * @brief Get the size of the arena in bytes
+     */
+    size_t arena_bytes() const { return count_ * stride_; }
+
+private:
+    friend class PooledChunk;
+
+    struct Slot {
+        std::atomic<uint32_t> refs{0};
+        std::atomic<uint32_t> next{0}; // Free list link
+        size_t size = 0;
+        uint64_t start_frame = 0;
+    };
+
+    ChunkPool(size_t count, size_t chunk_bytes, size_t alignment);
+
+    void retain(uint32_t index);
+    void release(uint32_t index);
+
+    size_t count_;
+    size_t chunk_bytes_;
+    size_t stride_; // Distance between buffers (chunk_bytes_ rounded up to the alignment)
+    std::vector<char> arena_;
+    char* base_;    // First buffer, aligned within arena_
+    std::unique_ptr<Slot[]> slots_;
+
+    // Free list head: buffer index in the low half, ABA tag in the high half
+    std::atomic<uint64_t> free_head_;
+    std::atomic<size_t> available_;
+    std::shared_ptr<DataSignal> release_signal_;
+};
+
+} // namespace audio
+} // namespace koelingo
+
+#endif // KOELINGO_CHUNK_POOL_H
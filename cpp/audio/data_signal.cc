@@ -0,0 +1,89 @@
+/**
+ * @file data_signal.cc
+ * @brief Implementation of the DataSignal class
+ */
+
+#include "data_signal.h"
+#include <algorithm>
+#include <climits>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace koelingo {
+namespace audio {
+
+namespace {
+
+#if !defined(__linux__)
+// How often condition-variable waiters re-check for a missed notification
+constexpr std::chrono::microseconds kPollInterval(5000);
+#endif
+
+} // namespace
+
+// DataSignal constructor
+DataSignal::DataSignal()
+    : sequence_(0),
+      waiters_(0) {
+}
+
+// Advance the sequence and wake waiters
+void DataSignal::notify() {
+    sequence_.fetch_add(1);
+
+    // Skip the syscall entirely when nobody is sleeping
+    if (waiters_.load() == 0) {
+        return;
+    }
+
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&sequence_), FUTEX_WAKE_PRIVATE,
+            INT_MAX, nullptr, nullptr, 0);
+#else
+    cv_.notify_all();
+#endif
+}
+
+// Sleep until the sequence changes
+bool DataSignal::wait(uint32_t seen, std::chrono::microseconds timeout) {
+    if (sequence() != seen) {
+        return true;
+    }
+    if (timeout.count() <= 0) {
+        return false;
+    }
+
+    waiters_.fetch_add(1);
+
+#if defined(__linux__)
+    // FUTEX_WAIT re-checks the value atomically, so a notify() that lands
+    // between the check above and going to sleep is never lost
+    timespec ts;
+    ts.tv_sec = static_cast<time_t>(timeout.count() / 1000000);
+    ts.tv_nsec = static_cast<long>((timeout.count() % 1000000) * 1000);
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&sequence_), FUTEX_WAIT_PRIVATE,
+            seen, &ts, nullptr, 0);
+#else
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (sequence() == seen) {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            break;
+        }
+        auto slice = std::min<std::chrono::steady_clock::duration>(deadline - now, kPollInterval);
+        cv_.wait_for(lock, slice);
+    }
+#endif
+
+    waiters_.fetch_sub(1);
+    return sequence() != seen;
+}
+
+} // namespace audio
+} // namespace koelingo
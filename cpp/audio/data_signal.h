@@ -0,0 +1,67 @@
+/**
+ * @file data_signal.h
+ * @brief Wake-up signal that can be raised from a real-time thread
+ */
+
+#ifndef KOELINGO_DATA_SIGNAL_H
+#define KOELINGO_DATA_SIGNAL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace koelingo {
+namespace audio {
+
+/**
+ * @class DataSignal
+ * @brief Sequence counter that consumers can sleep on until it changes
+ *
+ * notify() never blocks or allocates, so it is safe to call from the
+ * PortAudio callback. On Linux waiting is implemented with a futex on the
+ * counter itself; elsewhere a condition variable is used, and because the
+ * notifier does not take the mutex, waiters re-check the counter at least
+ * every few milliseconds.
+ */
+class DataSignal {
+public:
+    DataSignal();
+
+    DataSignal(const DataSignal&) = delete;
+    DataSignal& operator=(const DataSignal&) = delete;
+
+    /**
+     * @brief Get the current sequence number
+     * @return Value to pass to wait()
+     */
+    uint32_t sequence() const { return sequence_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Advance the sequence and wake all waiters
+     */
+    void notify();
+
+    /**
+     * @brief Sleep until the sequence differs from a previously seen value
+     * @param seen Sequence number obtained from sequence()
+     * @param timeout Maximum time to wait
+     * @return True if the sequence changed, false on timeout
+     */
+    bool wait(uint32_t seen, std::chrono::microseconds timeout);
+
+private:
+    std::atomic<uint32_t> sequence_;
+    std::atomic<int> waiters_;
+
+#if !defined(__linux__)
+    std::mutex mutex_;
+    std::condition_variable cv_;
+#endif
+};
+
+} // namespace audio
+} // namespace koelingo
+
+#endif // KOELINGO_DATA_SIGNAL_H
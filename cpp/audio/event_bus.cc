@@ -0,0 +1,217 @@
+/**
+ * @file event_bus.cc
+ * @brief Implementation of the event bus and its subscriptions
+ */
+
+#include "event_bus.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#if defined(__linux__)
+#include <sys/eventfd.h>
+#include <unistd.h>
+#elif !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace koelingo {
+namespace audio {
+
+// EventSubscription constructor: create the wake-up descriptor
+EventSubscription::EventSubscription(uint32_t mask, size_t capacity)
+    : mask_(mask),
+      queue_(std::max<size_t>(1, capacity)),
+      dropped_(0),
+      wake_pending_(false),
+      read_fd_(-1),
+      write_fd_(-1) {
+#if defined(__linux__)
+    read_fd_ = write_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#elif !defined(_WIN32)
+    int fds[2];
+    if (pipe(fds) == 0) {
+        for (int fd : fds) {
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+            fcntl(fd, F_SETFD, FD_CLOEXEC);
+        }
+        read_fd_ = fds[0];
+        write_fd_ = fds[1];
+    }
+#endif
+}
+
+// EventSubscription destructor
+EventSubscription::~EventSubscription() {
+#if !defined(_WIN32)
+    if (read_fd_ >= 0) {
+        close(read_fd_);
+    }
+    if (write_fd_ >= 0 && write_fd_ != read_fd_) {
+        close(write_fd_);
+    }
+#endif
+}
+
+// Queue an event and wake the consumer
+bool EventSubscription::deliver(const Event& event) {
+    if ((mask_ & event_mask(event.type)) == 0) {
+        return false;
+    }
+    if (!queue_.push(event)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    wake();
+    return true;
+}
+
+// Make the descriptor readable unless it already is, and wake wait()
+void EventSubscription::wake() {
+    if (!wake_pending_.exchange(true)) {
+#if defined(__linux__)
+        if (write_fd_ >= 0) {
+            uint64_t one = 1;
+            [[maybe_unused]] ssize_t written = write(write_fd_, &one, sizeof(one));
+        }
+#elif !defined(_WIN32)
+        if (write_fd_ >= 0) {
+            char byte = 1;
+            [[maybe_unused]] ssize_t written = write(write_fd_, &byte, 1);
+        }
+#endif
+    }
+    signal_.notify();
+}
+
+// Consume the descriptor's readiness
+void EventSubscription::clear_wake() {
+    // Cleared before draining: a publisher that queues after this point writes again
+    wake_pending_.store(false);
+#if defined(__linux__)
+    if (read_fd_ >= 0) {
+        uint64_t count;
+        [[maybe_unused]] ssize_t bytes = read(read_fd_, &count, sizeof(count));
+    }
+#elif !defined(_WIN32)
+    if (read_fd_ >= 0) {
+        char buffer[64];
+        while (read(read_fd_, buffer, sizeof(buffer)) > 0) {
+        }
+    }
+#endif
+}
+
+// Take queued events without blocking
+size_t EventSubscription::poll(Event* events, size_t max_events) {
+    clear_wake();
+    size_t count = queue_.pop_batch(events, max_events);
+    if (queue_.size() > 0) {
+        wake(); // Leftovers: come back for them
+    }
+    return count;
+}
+
+// Sleep until events are queued
+bool EventSubscription::wait(int timeout_ms) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (true) {
+        uint32_t seen = signal_.sequence();
+        if (queue_.size() > 0) {
+            return true;
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            return false;
+        }
+        signal_.wait(seen, std::chrono::duration_cast<std::chrono::microseconds>(deadline - now));
+    }
+}
+
+// EventBus constructor
+EventBus::EventBus()
+    : mask_(0),
+      publishing_(0),
+      published_(0) {
+    for (auto& slot : slots_) {
+        slot.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+// EventBus destructor
+EventBus::~EventBus() = default;
+
+// Create a subscription in a free slot
+std::shared_ptr<EventSubscription> EventBus::subscribe(uint32_t mask, size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& slot : slots_) {
+        if (slot.load(std::memory_order_relaxed) == nullptr) {
+            auto subscription = std::make_shared<EventSubscription>(mask & kAllEvents, capacity);
+            subscriptions_.push_back(subscription);
+            slot.store(subscription.get());
+            mask_.fetch_or(subscription->mask());
+            return subscription;
+        }
+    }
+    return nullptr;
+}
+
+// Remove a subscription once no publisher can still be writing to it
+void EventBus::unsubscribe(const std::shared_ptr<EventSubscription>& subscription) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::find(subscriptions_.begin(), subscriptions_.end(), subscription);
+    if (it == subscriptions_.end()) {
+        return;
+    }
+
+    uint32_t mask = 0;
+    for (auto& slot : slots_) {
+        EventSubscription* current = slot.load(std::memory_order_relaxed);
+        if (current == subscription.get()) {
+            slot.store(nullptr);
+        } else if (current) {
+            mask |= current->mask();
+        }
+    }
+    mask_.store(mask);
+
+    // A publisher that loaded the pointer before it was cleared is counted here
+    while (publishing_.load() != 0) {
+        std::this_thread::yield();
+    }
+    subscriptions_.erase(it);
+}
+
+// Copy an event into every matching subscription
+size_t EventBus::publish(const Event& event) {
+    const uint32_t bit = event_mask(event.type);
+    if ((mask_.load(std::memory_order_relaxed) & bit) == 0) {
+        return 0;
+    }
+
+    Event stamped;
+    const Event* message = &event;
+    if (event.timestamp_ns == 0) {
+        stamped = event;
+        stamped.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        message = &stamped;
+    }
+
+    size_t delivered = 0;
+    publishing_.fetch_add(1);
+    for (auto& slot : slots_) {
+        EventSubscription* subscription = slot.load();
+        if (subscription && subscription->deliver(*message)) {
+            delivered++;
+        }
+    }
+    publishing_.fetch_sub(1);
+    published_.fetch_add(1, std::memory_order_relaxed);
+    return delivered;
+}
+
+} // namespace audio
+} // namespace koelingo
@@ -0,0 +1,218 @@
+/**
+ * @file event_bus.h
+ * @brief Typed publish/subscribe bus between capture, VAD, STT and UI
+ */
+
+#ifndef KOELINGO_EVENT_BUS_H
+#define KOELINGO_EVENT_BUS_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "data_signal.h"
+#include "mpmc_queue.h"
+
+namespace koelingo {
+namespace audio {
+
+/**
+ * @brief Kinds of events carried by the EventBus
+ */
+enum class EventType : uint32_t {
+    kLevel = 0,          ///< Meter level of the capture (value)
+    kSpeechOnset,        ///< Speech after an idle spell (start_frame)
+    kUtterance,          ///< Complete utterance queued for recognition (start_frame, end_frame, truncated)
+    kPartialTranscript,  ///< Text decoded so far for an utterance (text, frames)
+    kFinalTranscript,    ///< Finished text of an utterance (text, value = confidence, frames)
+};
+
+/**
+ * @brief Get the subscription mask bit of an event type
+ */
+constexpr uint32_t event_mask(EventType type) {
+    return uint32_t(1) << static_cast<uint32_t>(type);
+}
+
+/// Subscription mask that matches every event type
+constexpr uint32_t kAllEvents = (uint32_t(1) << 5) - 1;
+
+/**
+ * @struct Event
+ * @brief One message on the bus; fields unused by a type are left at zero
+ *
+ * Frame indices refer to the publishing capture's timeline, as in
+ * UtteranceSegment. Only transcripts carry text, so events published from
+ * the processing thread do not allocate.
+ */
+struct Event {
+    EventType type = EventType::kLevel;
+    uint32_t source = 0;      ///< Stream the event belongs to, chosen by the publisher
+    int64_t timestamp_ns = 0; ///< steady_clock time of publication
+    uint64_t start_frame = 0; ///< Onset frame, or first frame of the utterance
+    uint64_t end_frame = 0;   ///< One past the last frame of the utterance
+    float value = 0.0f;       ///< Level in [0, 1], or transcript confidence
+    bool truncated = false;   ///< Utterance was split at max_utterance_ms
+    std::string text;         ///< Transcript text (UTF-8)
+};
+
+/**
+ * @class EventSubscription
+ * @brief One subscriber's bounded queue of events, created by EventBus::subscribe()
+ *
+ * Publishers never block: when the queue is full the event is counted in
+ * dropped() instead. A consumer either sleeps in wait() or watches fd(),
+ * which becomes readable when events arrive, from its own event loop (a
+ * Qt socket notifier, select(), asyncio). The descriptor is only written
+ * when the consumer has drained the queue since the last write, so a busy
+ * stream costs one wake-up per poll() rather than one per event.
+ */
+class EventSubscription {
+public:
+    /**
+     * @brief Constructor
+     * @param mask Event types to receive (see event_mask())
+     * @param capacity Maximum number of queued events
+     */
+    EventSubscription(uint32_t mask, size_t capacity);
+    ~EventSubscription();
+
+    EventSubscription(const EventSubscription&) = delete;
+    EventSubscription& operator=(const EventSubscription&) = delete;
+
+    /**
+     * @brief Get the event types this subscription receives
+     */
+    uint32_t mask() const { return mask_; }
+
+    /**
+     * @brief Get a descriptor that is readable while events may be pending
+     * @return File descriptor owned by the subscription, or -1 where
+     *         unsupported (Windows); use wait() there
+     */
+    int fd() const { return read_fd_; }
+
+    /**
+     * @brief Take queued events without blocking
+     * @param events Receives the oldest events in publication order
+     * @param max_events Capacity of events
+     * @return Number of events returned
+     *
+     * Clears the descriptor's readiness first, and raises it again if
+     * events are left over, so level-triggered loops come back for them.
+     */
+    size_t poll(Event* events, size_t max_events);
+
+    /**
+     * @brief Sleep until events are queued
+     * @param timeout_ms Maximum time to wait in milliseconds
+     * @return True if events are pending
+     */
+    bool wait(int timeout_ms);
+
+    /**
+     * @brief Get the number of queued events (approximate while in use)
+     */
+    size_t pending() const { return queue_.size(); }
+
+    /**
+     * @brief Get the number of events dropped because the queue was full
+     */
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Queue an event if its type matches (called by EventBus::publish())
+     * @param event Event to copy into the queue
+     * @return False if the type does not match or the queue is full
+     */
+    bool deliver(const Event& event);
+
+private:
+    const uint32_t mask_;
+    MpmcQueue<Event> queue_;
+    std::atomic<uint64_t> dropped_;
+    std::atomic<bool> wake_pending_; // The descriptor was written since the last poll()
+    DataSignal signal_;
+    int read_fd_;
+    int write_fd_; // Same as read_fd_ for an eventfd
+
+    void wake();
+    void clear_wake();
+};
+
+/**
+ * @class EventBus
+ * @brief Fans published events out to every matching subscription
+ *
+ * publish() is lock-free: it walks a fixed table of subscription slots
+ * and copies the event into each matching queue. subscribe() and
+ * unsubscribe() take a mutex; unsubscribe() waits for publishers still
+ * walking the table, so a removed subscription is never written again.
+ * A bus can be shared by several captures and transcribers, which tell
+ * their events apart through Event::source.
+ */
+class EventBus {
+public:
+    /// Maximum number of simultaneous subscriptions
+    static constexpr size_t kMaxSubscriptions = 32;
+
+    EventBus();
+    ~EventBus();
+
+    EventBus(const EventBus&) = delete;
+    EventBus& operator=(const EventBus&) = delete;
+
+    /**
+     * @brief Create a subscription
+     * @param mask Event types to receive (see event_mask())
+     * @param capacity Maximum number of queued events
+     * @return The subscription, or nullptr if kMaxSubscriptions are in use
+     */
+    std::shared_ptr<EventSubscription> subscribe(uint32_t mask = kAllEvents, size_t capacity = 256);
+
+    /**
+     * @brief Stop delivering events to a subscription
+     * @param subscription Subscription returned by subscribe()
+     *
+     * Events already queued can still be polled.
+     */
+    void unsubscribe(const std::shared_ptr<EventSubscription>& subscription);
+
+    /**
+     * @brief Deliver an event to every matching subscription
+     * @param event Event to publish; a zero timestamp_ns is filled in
+     * @return Number of subscriptions that queued it
+     */
+    size_t publish(const Event& event);
+
+    /**
+     * @brief Check whether anyone listens for an event type
+     *
+     * Lets publishers skip building events nobody receives.
+     */
+    bool wants(EventType type) const {
+        return (mask_.load(std::memory_order_relaxed) & event_mask(type)) != 0;
+    }
+
+    /**
+     * @brief Get the number of events published so far
+     */
+    uint64_t published() const { return published_.load(std::memory_order_relaxed); }
+
+private:
+    std::array<std::atomic<EventSubscription*>, kMaxSubscriptions> slots_;
+    std::atomic<uint32_t> mask_;       // Union of the subscribed masks
+    std::atomic<int> publishing_;      // publish() calls walking the slots
+    std::atomic<uint64_t> published_;
+    std::mutex mutex_;                 // Serializes subscribe() and unsubscribe()
+    std::vector<std::shared_ptr<EventSubscription>> subscriptions_; // Under mutex_
+};
+
+} // namespace audio
+} // namespace koelingo
+
+#endif // KOELINGO_EVENT_BUS_H
@@ -0,0 +1,183 @@
+/**
+ * @file fft.cc
+ * @brief Implementation of the mixed-radix FFT
+ */
+
+#include "fft.h"
+#include <algorithm>
+#include <cmath>
+
+namespace koelingo {
+namespace audio {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+} // namespace
+
+// RealFft constructor: factor the length and precompute twiddles
+RealFft::RealFft(size_t size)
+    : size_(std::max<size_t>(2, size & ~static_cast<size_t>(1))),
+      half_(size_ / 2) {
+    // Radix 4 first, then 2, 3, 5 and finally any remaining prime
+    size_t remaining = half_;
+    size_t radix = 4;
+    while (remaining > 1) {
+        while (remaining % radix != 0) {
+            if (radix == 4) {
+                radix = 2;
+            } else if (radix == 2) {
+                radix = 3;
+            } else if (radix * radix > remaining) {
+                radix = remaining;
+            } else {
+                radix += 2;
+            }
+        }
+        remaining /= radix;
+        factors_.push_back(radix);
+        factors_.push_back(remaining);
+    }
+
+    twiddles_.resize(half_);
+    for (size_t k = 0; k < half_; k++) {
+        double angle = -2.0 * kPi * k / half_;
+        twiddles_[k] = Complex(static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)));
+    }
+    real_twiddles_.resize(half_ + 1);
+    for (size_t k = 0; k <= half_; k++) {
+        double angle = -2.0 * kPi * k / size_;
+        real_twiddles_[k] = Complex(static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)));
+    }
+
+    size_t max_radix = 1;
+    for (size_t i = 0; i < factors_.size(); i += 2) {
+        max_radix = std::max(max_radix, factors_[i]);
+    }
+    packed_.resize(half_);
+    spectrum_.resize(half_);
+    scratch_.resize(max_radix);
+}
+
+// Real forward transform via a half-length complex FFT
+void RealFft::forward(const float* input, std::complex<float>* output) {
+    for (size_t n = 0; n < half_; n++) {
+        packed_[n] = Complex(input[2 * n], input[2 * n + 1]);
+    }
+
+    if (half_ == 1) {
+        spectrum_[0] = packed_[0];
+    } else {
+        transform(spectrum_.data(), packed_.data(), 1, factors_.data());
+    }
+
+    // Split the packed spectrum into the even and odd sample spectra
+    for (size_t k = 0; k <= half_; k++) {
+        Complex z = spectrum_[k % half_];
+        Complex z_mirror = std::conj(spectrum_[(half_ - k) % half_]);
+        Complex even = 0.5f * (z + z_mirror);
+        Complex odd = Complex(0.0f, -0.5f) * (z - z_mirror);
+        output[k] = even + real_twiddles_[k] * odd;
+    }
+}
+
+// Real inverse transform via a half-length complex FFT
+void RealFft::inverse(const std::complex<float>* input, float* output) {
+    // Merge the even and odd sample spectra back into the packed spectrum
+    for (size_t k = 0; k < half_; k++) {
+        Complex x = input[k];
+        Complex x_mirror = std::conj(input[half_ - k]);
+        Complex even = 0.5f * (x + x_mirror);
+        Complex odd = 0.5f * (x - x_mirror) * std::conj(real_twiddles_[k]);
+        // Conjugated, so the forward transform computes the inverse
+        packed_[k] = std::conj(even + Complex(0.0f, 1.0f) * odd);
+    }
+
+    if (half_ == 1) {
+        spectrum_[0] = packed_[0];
+    } else {
+        transform(spectrum_.data(), packed_.data(), 1, factors_.data());
+    }
+
+    const float scale = 1.0f / static_cast<float>(half_);
+    for (size_t n = 0; n < half_; n++) {
+        output[2 * n] = spectrum_[n].real() * scale;
+        output[2 * n + 1] = -spectrum_[n].imag() * scale;
+    }
+}
+
+// Recursive decimation-in-time step
+void RealFft::transform(Complex* out, const Complex* in, size_t stride, const size_t* factors) {
+    const size_t radix = factors[0];
+    const size_t length = factors[1];
+    Complex* const begin = out;
+    Complex* const end = out + radix * length;
+
+    if (length == 1) {
+        for (; out != end; out++, in += stride) {
+            *out = *in;
+        }
+    } else {
+        // Transform each decimated sub-sequence into its slot of the output
+        for (; out != end; out += length, in += stride) {
+            transform(out, in, stride * radix, factors + 2);
+        }
+    }
+
+    butterfly(begin, stride, radix, length);
+}
+
+// Combine `radix` sub-transforms of `length` points each
+void RealFft::butterfly(Complex* out, size_t stride, size_t radix, size_t length) {
+    if (radix == 2) {
+        for (size_t k = 0; k < length; k++) {
+            Complex t = out[k + length] * twiddles_[k * stride];
+            out[k + length] = out[k] - t;
+            out[k] += t;
+        }
+        return;
+    }
+
+    if (radix == 4) {
+        for (size_t k = 0; k < length; k++) {
+            Complex s0 = out[k + length] * twiddles_[k * stride];
+            Complex s1 = out[k + 2 * length] * twiddles_[2 * k * stride];
+            Complex s2 = out[k + 3 * length] * twiddles_[3 * k * stride];
+            Complex s5 = out[k] - s1;
+            out[k] += s1;
+            Complex s3 = s0 + s2;
+            Complex s4 = s0 - s2;
+            out[k + 2 * length] = out[k] - s3;
+            out[k] += s3;
+            // Multiply s4 by -i for the forward transform
+            out[k + length] = Complex(s5.real() + s4.imag(), s5.imag() - s4.real());
+            out[k + 3 * length] = Complex(s5.real() - s4.imag(), s5.imag() + s4.real());
+        }
+        return;
+    }
+
+    // Generic radix: direct DFT over the radix points
+    for (size_t k = 0; k < length; k++) {
+        for (size_t q = 0; q < radix; q++) {
+            scratch_[q] = out[k + q * length];
+        }
+        for (size_t q = 0; q < radix; q++) {
+            size_t index = k + q * length;
+            size_t step = stride * index % half_;
+            size_t twiddle = 0;
+            Complex sum = scratch_[0];
+            for (size_t j = 1; j < radix; j++) {
+                twiddle += step;
+                if (twiddle >= half_) {
+                    twiddle -= half_;
+                }
+                sum += scratch_[j] * twiddles_[twiddle];
+            }
+            out[index] = sum;
+        }
+    }
+}
+
+} // namespace audio
+} // namespace koelingo
@@ -0,0 +1,74 @@
+/**
+ * @file fft.h
+ * @brief Mixed-radix FFT for arbitrary (non power-of-two) sizes
+ */
+
+#ifndef KOELINGO_FFT_H
+#define KOELINGO_FFT_H
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+namespace koelingo {
+namespace audio {
+
+/**
+ * @class RealFft
+ * @brief FFT of real input of fixed, even length, and its inverse
+ *
+ * Whisper's STFT uses n_fft = 400, so sizes are not restricted to powers
+ * of two: the length is factored into radices 4, 2, 3, 5 and any remaining
+ * primes. The real transform is computed as a complex FFT of half the size.
+ * The plan and all scratch memory are allocated in the constructor.
+ */
+class RealFft {
+public:
+    /**
+     * @brief Constructor
+     * @param size Transform length (must be even and at least 2)
+     */
+    explicit RealFft(size_t size = 2);
+
+    /**
+     * @brief Get the transform length
+     */
+    size_t size() const { return size_; }
+
+    /**
+     * @brief Compute the spectrum of one frame
+     * @param input size() real samples
+     * @param output Receives size() / 2 + 1 complex bins (DC to Nyquist)
+     */
+    void forward(const float* input, std::complex<float>* output);
+
+    /**
+     * @brief Rebuild a frame from its spectrum
+     * @param input size() / 2 + 1 complex bins, as produced by forward()
+     * @param output Receives size() real samples
+     *
+     * Exact inverse of forward(), including the 1 / size() scaling.
+     * The imaginary parts of the DC and Nyquist bins are ignored.
+     */
+    void inverse(const std::complex<float>* input, float* output);
+
+private:
+    using Complex = std::complex<float>;
+
+    size_t size_;
+    size_t half_;                  // Length of the inner complex FFT
+    std::vector<size_t> factors_;  // (radix, remaining length) pairs
+    std::vector<Complex> twiddles_;      // exp(-2*pi*i*k/half_)
+    std::vector<Complex> real_twiddles_; // exp(-2*pi*i*k/size_) for the split step
+    std::vector<Complex> packed_;        // Input packed as even + i * odd samples
+    std::vector<Complex> spectrum_;      // Inner FFT output
+    std::vector<Complex> scratch_;       // One butterfly worth of values
+
+    void transform(Complex* out, const Complex* in, size_t stride, const size_t* factors);
+    void butterfly(Complex* out, size_t stride, size_t radix, size_t length);
+};
+
+} // namespace audio
+} // namespace koelingo
+
+#endif // KOELINGO_FFT_H
@@ -0,0 +1,126 @@
+/**
+ * @file file_segmenter.cc
+ * @brief Implementation of parallel file segmentation
+ */
+
+#include "file_segmenter.h"
+#include "sample_format.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace koelingo {
+namespace audio {
+
+namespace {
+
+constexpr size_t kBlockFrames = 4096; // Frames converted and analysed per step
+
+uint64_t ms_to_frames(int ms, int sample_rate) {
+    return static_cast<uint64_t>(std::max(ms, 0)) * static_cast<uint64_t>(sample_rate) / 1000;
+}
+
+uint64_t round_up(uint64_t value, uint64_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+// Detect the utterances that start in [start, end)
+std::vector<UtteranceSegment> segment_region(const MappedWav& wav, const VadConfig& config,
+                                             uint64_t start, uint64_t end, uint64_t warm_up,
+                                             uint64_t settle, uint64_t overrun) {
+    const int rate = wav.sample_rate();
+    const uint64_t begin = start > warm_up ? start - warm_up : 0;
+    std::vector<UtteranceSegment> found;
+
+    VoiceActivityDetector vad;
+    vad.configure(config, rate);
+    vad.set_segment_callback([&](const UtteranceSegment& segment) {
+        UtteranceSegment shifted = segment;
+        shifted.start_frame += begin;
+        shifted.end_frame += begin;
+        if (shifted.start_frame >= start && shifted.start_frame < end) {
+            found.push_back(shifted);
+        }
+    });
+
+    // Past the end, stop once no utterance that started inside is open
+    std::vector<float> mono(kBlockFrames);
+    uint64_t position = begin;
+    while (position < wav.frames()) {
+        size_t count = static_cast<size_t>(std::min<uint64_t>(kBlockFrames, wav.frames() - position));
+        convert_to_mono_float32(wav.frame(position), count, wav.channels(), wav.format_type(),
+                                mono.data());
+        vad.process(mono.data(), count);
+        position += count;
+        if (position >= end + settle && (!vad.in_speech() || position >= end + overrun)) {
+            break;
+        }
+    }
+    vad.flush();
+    return found;
+}
+
+} // namespace
+
+// Split a file into utterances
+std::vector<UtteranceSegment> segment_file(const MappedWav& wav, const FileSegmenterConfig& config) {
+    std::vector<UtteranceSegment> segments;
+    if (!wav.is_open() || wav.frames() == 0) {
+        return segments;
+    }
+
+    // Regions start on the detector's window grid, so overlapping regions
+    // classify the same windows
+    const int rate = wav.sample_rate();
+    const VadConfig& vad = config.vad;
+    const uint64_t window = std::max<uint64_t>(1, ms_to_frames(vad.frame_ms, rate));
+    const uint64_t region = round_up(std::max<uint64_t>(window, ms_to_frames(
+        std::max(1, config.region_seconds) * 1000, rate)), window);
+    const uint64_t warm_up = round_up(ms_to_frames(vad.hangover_ms + vad.min_speech_ms + vad.pre_roll_ms,
+                                                   rate), window);
+    // An utterance backdated into the region can start speaking pre_roll
+    // after its end, and is confirmed min_speech later
+    const uint64_t settle = ms_to_frames(vad.pre_roll_ms + vad.min_speech_ms, rate) + 2 * window;
+    const uint64_t overrun = ms_to_frames(vad.max_utterance_ms + vad.hangover_ms, rate) + settle;
+
+    const size_t regions = static_cast<size_t>((wav.frames() + region - 1) / region);
+    int threads = config.threads > 0 ? config.threads
+                                     : static_cast<int>(std::thread::hardware_concurrency());
+    threads = std::max(1, std::min(threads, static_cast<int>(regions)));
+
+    std::vector<std::vector<UtteranceSegment>> found(regions);
+    std::atomic<size_t> next(0);
+    auto run = [&] {
+        for (size_t i = next++; i < regions; i = next++) {
+            uint64_t start = i * region;
+            uint64_t end = std::min(wav.frames(), start + region);
+            found[i] = segment_region(wav, vad, start, end, warm_up, settle, overrun);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (int i = 1; i < threads; i++) {
+        workers.emplace_back(run);
+    }
+    run();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    // Where two regions' detectors disagreed about an utterance spanning
+    // the boundary, keep the earlier region's version
+    for (const std::vector<UtteranceSegment>& part : found) {
+        for (UtteranceSegment segment : part) {
+            if (!segments.empty() && segment.start_frame < segments.back().end_frame) {
+                if (segment.end_frame <= segments.back().end_frame) {
+                    continue;
+                }
+                segment.start_frame = segments.back().end_frame;
+            }
+            segments.push_back(segment);
+        }
+    }
+    return segments;
+}
+
+} // namespace audio
+} // namespace koelingo
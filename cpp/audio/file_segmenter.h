@@ -0,0 +1,44 @@
+/**
+ * @file file_segmenter.h
+ * @brief Parallel utterance segmentation of recorded audio files
+ */
+
+#ifndef KOELINGO_FILE_SEGMENTER_H
+#define KOELINGO_FILE_SEGMENTER_H
+
+#include <vector>
+#include "mapped_wav.h"
+#include "vad.h"
+
+namespace koelingo {
+namespace audio {
+
+/**
+ * @struct FileSegmenterConfig
+ * @brief How a file is split for parallel voice activity detection
+ */
+struct FileSegmenterConfig {
+    VadConfig vad;              ///< Detector settings (enabled is ignored)
+    int threads = 0;            ///< Regions analysed at once (0 = one per hardware thread)
+    int region_seconds = 300;   ///< Audio per region; smaller regions balance better
+};
+
+/**
+ * @brief Split a file into utterances, analysing regions in parallel
+ * @param wav Mapped file
+ * @param config Detector settings and parallelism
+ * @return Utterances in file order, as frame ranges of the file
+ *
+ * Each region starts its detector a little early so it has settled by
+ * the region start, and runs past the region end until the utterance in
+ * progress there is finished. A region keeps the utterances that start
+ * inside it, so each utterance is produced by exactly one region and the
+ * result matches a single pass over the file up to detector warm-up at
+ * region boundaries.
+ */
+std::vector<UtteranceSegment> segment_file(const MappedWav& wav, const FileSegmenterConfig& config);
+
+} // namespace audio
+} // namespace koelingo
+
+#endif // KOELINGO_FILE_SEGMENTER_H
@@ -0,0 +1,76 @@
+/**
+ * @file gain_control.cc
+ * @brief Implementation of the automatic gain control
+ */
+
+#include "gain_control.h"
+#include <algorithm>
+#include <cmath>
+#include "vector_math.h"
+
+namespace koelingo {
+namespace audio {
+
+namespace {
+
+float db_to_linear(float db) {
+    return std::pow(10.0f, db / 20.0f);
+}
+
+} // namespace
+
+// AutomaticGainControl constructor: 16 kHz defaults until configured
+AutomaticGainControl::AutomaticGainControl()
+    : block_size_(160),
+      target_(1.0f),
+      max_gain_(1.0f),
+      min_gain_(1.0f),
+      gate_(0.0f),
+      attack_samples_(1.0f),
+      release_samples_(1.0f),
+      limit_(1.0f),
+      gain_(1.0f) {
+    configure(GainControlConfig(), 16000);
+}
+
+// Convert the configuration to linear values and samples
+void AutomaticGainControl::configure(const GainControlConfig& config, int sample_rate) {
+    const float rate = static_cast<float>(std::max(1, sample_rate));
+    block_size_ = std::max<size_t>(1, static_cast<size_t>(rate / 100.0f));
+    target_ = db_to_linear(config.target_db);
+    max_gain_ = db_to_linear(std::max(0.0f, config.max_gain_db));
+    min_gain_ = db_to_linear(std::min(0.0f, config.min_gain_db));
+    gate_ = db_to_linear(config.gate_db);
+    attack_samples_ = std::max(1.0f, config.attack_ms * rate / 1000.0f);
+    release_samples_ = std::max(1.0f, config.release_ms * rate / 1000.0f);
+    limit_ = db_to_linear(std::min(0.0f, config.limit_db));
+    reset();
+}
+
+void AutomaticGainControl::reset() {
+    gain_ = 1.0f;
+}
+
+// Measure each block, move the gain towards its target and ramp it in
+void AutomaticGainControl::process(float* samples, size_t count) {
+    for (size_t offset = 0; offset < count; offset += block_size_) {
+        float* block = samples + offset;
+        size_t length = std::min(block_size_, count - offset);
+
+        float next = gain_;
+        float rms = std::sqrt(dot_product(block, block, length) / static_cast<float>(length));
+        if (rms > gate_) {
+            float desired = std::min(std::max(target_ / rms, min_gain_), max_gain_);
+            float time_constant = desired < gain_ ? attack_samples_ : release_samples_;
+            float coefficient = 1.0f - std::exp(-static_cast<float>(length) / time_constant);
+            next = gain_ + (desired - gain_) * coefficient;
+        }
+
+        apply_gain_ramp(block, length, gain_, (next - gain_) / static_cast<float>(length));
+        gain_ = next;
+    }
+    clamp(samples, count, -limit_, limit_);
+}
+
+} // namespace audio
+} // namespace koelingo
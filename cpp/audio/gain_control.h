@@ -0,0 +1,87 @@
+/**
+ * @file gain_control.h
+ * @brief Automatic gain control with a peak limiter
+ */
+
+#ifndef KOELINGO_GAIN_CONTROL_H
+#define KOELINGO_GAIN_CONTROL_H
+
+#include <cstddef>
+
+namespace koelingo {
+namespace audio {
+
+/**
+ * @struct GainControlConfig
+ * @brief Tuning parameters for the automatic gain control
+ *
+ * Levels are in dBFS. The VAD's energy threshold applies to the audio
+ * after gain control, so max_gain_db bounds how far background noise
+ * above gate_db can be raised towards it.
+ */
+struct GainControlConfig {
+    bool enabled = false;      ///< Normalize the level of the audio the VAD and STT see
+    float target_db = -20.0f;  ///< RMS level speech is brought to
+    float max_gain_db = 12.0f; ///< Most amplification applied
+    float min_gain_db = -12.0f; ///< Most attenuation applied
+    float gate_db = -45.0f;    ///< Blocks quieter than this hold the gain instead of adapting it
+    int attack_ms = 20;        ///< Time constant for lowering the gain
+    int release_ms = 500;      ///< Time constant for raising the gain
+    float limit_db = -1.0f;    ///< Peak ceiling; samples beyond it are clipped
+};
+
+/**
+ * @class AutomaticGainControl
+ * @brief Block-wise level normalization with smoothed gain changes
+ *
+ * The RMS of every 10 ms block sets the gain that would bring it to the
+ * target. The applied gain moves towards it with the attack or release
+ * time constant and is ramped linearly across the block, so it never
+ * steps audibly. Output is in place and has no added latency; no memory
+ * is allocated, so process() may run on the processing thread.
+ */
+class AutomaticGainControl {
+public:
+    AutomaticGainControl();
+
+    /**
+     * @brief Apply a configuration and reset the state
+     * @param config Gain control parameters
+     * @param sample_rate Sample rate of the audio passed to process()
+     */
+    void configure(const GainControlConfig& config, int sample_rate);
+
+    /**
+     * @brief Return to unity gain
+     */
+    void reset();
+
+    /**
+     * @brief Normalize a block of mono audio in place
+     * @param samples Mono samples in the range [-1.0, 1.0]
+     * @param count Number of samples
+     */
+    void process(float* samples, size_t count);
+
+    /**
+     * @brief Get the gain applied to the most recent sample
+     * @return Linear gain
+     */
+    float gain() const { return gain_; }
+
+private:
+    size_t block_size_;
+    float target_;
+    float max_gain_;
+    float min_gain_;
+    float gate_;
+    float attack_samples_;  // Time constants in samples
+    float release_samples_;
+    float limit_;
+    float gain_;
+};
+
+} // namespace audio
+} // namespace koelingo
+
+#endif // KOELINGO_GAIN_CONTROL_H
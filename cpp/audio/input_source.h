@@ -0,0 +1,95 @@
+/**
+ * @file input_source.h
+ * @brief Pluggable audio input for AudioCapture
+ */
+
+#ifndef KOELINGO_INPUT_SOURCE_H
+#define KOELINGO_INPUT_SOURCE_H
+
+#include <cstddef>
+
+namespace koelingo {
+namespace audio {
+
+/**
+ * @struct InputPeriod
+ * @brief One block of interleaved frames delivered by an input source
+ */
+struct InputPeriod {
+    const char* data = nullptr;  ///< Interleaved frames in the requested sample format
+    size_t frames = 0;           ///< Number of frames in data
+    double adc_latency = -1.0;   ///< Seconds since the first frame was sampled (negative if unknown)
+    bool overflow = false;       ///< Input was lost before this period (xrun)
+    bool underflow = false;      ///< The source inserted silence
+};
+
+/**
+ * @class InputSink
+ * @brief Receiver of the periods produced by an InputSource
+ */
+class InputSink {
+public:
+    virtual ~InputSink() = default;
+
+    /**
+     * @brief Consume one period
+     *
+     * Called on the source's delivery thread. The PortAudio callback is a
+     * real-time thread, so the sink must not allocate; it may still wait
+     * to slow down a source that runs faster than real time.
+     */
+    virtual void on_input(const InputPeriod& period) = 0;
+
+    /**
+     * @brief Note that the source has no more input (e.g. a file ended)
+     */
+    virtual void on_input_end() {}
+};
+
+/**
+ * @class InputSource
+ * @brief Audio producer that can replace the PortAudio device in AudioCapture
+ *
+ * A source runs its own delivery thread between start() and stop(). It
+ * reports its native rate and channel count up front; AudioCapture
+ * resamples and downmixes mono captures when they differ, like it does for
+ * devices.
+ */
+class InputSource {
+public:
+    virtual ~InputSource() = default;
+
+    /**
+     * @brief Get the sample rate of the delivered frames in Hz
+     */
+    virtual int sample_rate() const = 0;
+
+    /**
+     * @brief Get the number of interleaved channels in the delivered frames
+     */
+    virtual int channels() const = 0;
+
+    /**
+     * @brief Start delivering periods
+     * @param sink Receiver of the periods (must outlive the delivery)
+     * @param period_frames Frames per period
+     * @param format_type PortAudio sample format to deliver
+     * @return False if already running or the format is not supported
+     */
+    virtual bool start(InputSink* sink, size_t period_frames, int format_type) = 0;
+
+    /**
+     * @brief Stop delivering; no sink call is in progress or made once this returns
+     */
+    virtual void stop() = 0;
+
+    /**
+     * @brief Check whether the source ran out of input
+     */
+    virtual bool finished() const = 0;
+};
+
+} // namespace audio
+} // namespace koelingo
+
+#endif // KOELINGO_INPUT_SOURCE_H
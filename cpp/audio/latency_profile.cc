@@ -0,0 +1,90 @@
+/**
+ * @file latency_profile.cc
+ * @brief Implementation of latency profiles and adaptive period control
+ */
+
+#include "latency_profile.h"
+#include <algorithm>
+
+namespace koelingo {
+namespace audio {
+
+namespace {
+
+int frames_for_ms(int sample_rate, int ms) {
+    return std::max(1, sample_rate * ms / 1000);
+}
+
+} // namespace
+
+// Get the settings of a latency profile
+LatencyConfig latency_profile_config(LatencyProfile profile, int sample_rate) {
+    LatencyConfig config;
+    config.profile = profile;
+    switch (profile) {
+    case LatencyProfile::kUltraLow:
+        config.period_frames = frames_for_ms(sample_rate, 8);
+        break;
+    case LatencyProfile::kBalanced:
+        config.period_frames = frames_for_ms(sample_rate, 32);
+        break;
+    case LatencyProfile::kPowerSave:
+        config.period_frames = frames_for_ms(sample_rate, 128);
+        config.high_latency = true;
+        config.wake_periods = 2;
+        break;
+    case LatencyProfile::kCustom:
+        break;
+    }
+    return config;
+}
+
+// Set up the controller for a recording
+void PeriodController::configure(const LatencyConfig& config, int sample_rate, int period_frames) {
+    adaptive_ = config.adaptive;
+    min_period_ = period_frames;
+    max_period_ = config.max_period_frames > 0 ? std::max(config.max_period_frames, period_frames)
+                                               : period_frames * 8;
+    overflow_limit_ = std::max(1, config.overflow_limit);
+    window_frames_ = static_cast<uint64_t>(sample_rate) * std::max(0, config.overflow_window_ms) / 1000;
+    idle_frames_ = static_cast<uint64_t>(sample_rate) * std::max(0, config.idle_ms) / 1000;
+    set_period(period_frames);
+}
+
+// Account for one device period
+int PeriodController::on_period(size_t frames, bool overflow) {
+    if (!adaptive_ || requested_) {
+        return 0;
+    }
+    frames_ += frames;
+    quiet_frames_ += frames;
+
+    if (overflow) {
+        quiet_frames_ = 0;
+        if (frames_ - window_start_ > window_frames_) {
+            window_start_ = frames_;
+            overflows_ = 0;
+        }
+        if (++overflows_ >= overflow_limit_ && period_ < max_period_) {
+            requested_ = true;
+            return std::min(period_ * 2, max_period_);
+        }
+    } else if (quiet_frames_ >= idle_frames_ && period_ > min_period_) {
+        requested_ = true;
+        return std::max(period_ / 2, min_period_);
+    }
+    return 0;
+}
+
+// Confirm the period the stream now runs with
+void PeriodController::set_period(int period_frames) {
+    period_ = period_frames;
+    frames_ = 0;
+    window_start_ = 0;
+    overflows_ = 0;
+    quiet_frames_ = 0;
+    requested_ = false;
+}
+
+} // namespace audio
+} // namespace koelingo
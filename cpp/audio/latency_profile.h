@@ -0,0 +1,123 @@
+/**
+ * @file latency_profile.h
+ * @brief Latency profiles and adaptive period control for capture streams
+ */
+
+#ifndef KOELINGO_LATENCY_PROFILE_H
+#define KOELINGO_LATENCY_PROFILE_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace koelingo {
+namespace audio {
+
+/**
+ * @enum LatencyProfile
+ * @brief Trade-off between interactive latency and CPU/battery cost
+ */
+enum class LatencyProfile {
+    kCustom,    ///< Periods of chunk_size frames at the device's low latency
+    kUltraLow,  ///< 8 ms periods for live monitoring
+    kBalanced,  ///< 32 ms periods
+    kPowerSave, ///< 128 ms periods at the device's high latency, processing woken every 2 periods
+};
+
+/**
+ * @struct LatencyConfig
+ * @brief How a capture stream is clocked by the device
+ */
+struct LatencyConfig {
+    LatencyProfile profile = LatencyProfile::kCustom; ///< Profile the fields were derived from
+    int period_frames = 0;          ///< Frames per device callback at the capture rate (0 = chunk_size)
+    double suggested_latency = 0.0; ///< Host API latency in seconds (0 = device default)
+    bool high_latency = false;      ///< Default to the device's high latency instead of its low latency
+    int wake_periods = 1;           ///< Device periods per processing wake-up
+    bool adaptive = false;          ///< Grow the period on overflows, shrink it again when idle
+    int overflow_limit = 3;         ///< Overflows within overflow_window_ms that double the period
+    int overflow_window_ms = 10000; ///< Window in which overflows are counted
+    int idle_ms = 30000;            ///< Overflow-free time after which the period is halved
+    int max_period_frames = 0;      ///< Largest adaptive period (0 = 8x period_frames)
+};
+
+/**
+ * @struct EffectiveLatency
+ * @brief Latency a capture stream actually runs with
+ */
+struct EffectiveLatency {
+    int period_frames = 0;        ///< Frames per device callback at the capture rate
+    double period_ms = 0.0;       ///< Duration of one period
+    double host_latency_ms = 0.0; ///< Input latency reported by the host API (0 = unknown)
+    int wake_periods = 1;         ///< Device periods per processing wake-up
+    double total_ms = 0.0;        ///< Worst case from the ADC until processing sees a frame
+    uint64_t period_changes = 0;  ///< Adaptive period changes this recording
+};
+
+/**
+ * @brief Get the settings of a latency profile
+ * @param profile Profile to expand
+ * @param sample_rate Capture sample rate in Hz
+ * @return Configuration; kCustom leaves every field at its default
+ */
+LatencyConfig latency_profile_config(LatencyProfile profile, int sample_rate);
+
+/**
+ * @class PeriodController
+ * @brief Decides when an adaptive stream should change its period
+ *
+ * Fed once per device period from the audio callback; it only does
+ * arithmetic there. Repeated overflows double the period up to the
+ * configured maximum, and a long stretch without overflows halves it
+ * again, never below the period the stream started with. Once a change
+ * is requested no other is made until set_period() confirms it.
+ */
+class PeriodController {
+public:
+    /**
+     * @brief Set up the controller for a recording
+     * @param config Latency settings (a non-adaptive config never requests changes)
+     * @param sample_rate Capture sample rate in Hz
+     * @param period_frames Period the stream starts with, at the capture rate
+     */
+    void configure(const LatencyConfig& config, int sample_rate, int period_frames);
+
+    /**
+     * @brief Account for one device period
+     * @param frames Period length at the capture rate
+     * @param overflow True if the host API flagged an input overflow
+     * @return New period to switch to, or 0 to keep the current one
+     */
+    int on_period(size_t frames, bool overflow);
+
+    /**
+     * @brief Confirm the period the stream now runs with
+     *
+     * Must not race with on_period(); call it while no callbacks run.
+     */
+    void set_period(int period_frames);
+
+    /**
+     * @brief Get the current period at the capture rate
+     */
+    int period() const { return period_; }
+
+private:
+    bool adaptive_ = false;
+    int period_ = 0;
+    int min_period_ = 0;
+    int max_period_ = 0;
+    int overflow_limit_ = 0;
+    uint64_t window_frames_ = 0;
+    uint64_t idle_frames_ = 0;
+
+    uint64_t frames_ = 0;       // Frames since the last change
+    uint64_t window_start_ = 0; // Start of the overflow window, in frames_
+    int overflows_ = 0;         // Overflows in the window
+    uint64_t quiet_frames_ = 0; // Frames since the last overflow
+    bool requested_ = false;
+};
+
+} // namespace audio
+} // namespace koelingo
+
+#endif // KOELINGO_LATENCY_PROFILE_H
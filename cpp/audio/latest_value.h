@@ -0,0 +1,88 @@
+/**
+ * @file latest_value.h
+ * @brief Lock-free single-slot mailbox that keeps only the newest value
+ */
+
+#ifndef KOELINGO_LATEST_VALUE_H
+#define KOELINGO_LATEST_VALUE_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace koelingo {
+namespace audio {
+
+/**
+ * @class LatestValue
+ * @brief Triple-buffered mailbox for publishing state between two threads
+ *
+ * The producer overwrites the pending value on every publish(), so a slow
+ * consumer simply sees fewer, newer updates (coalescing). Neither side
+ * ever blocks, allocates or waits for the other.
+ *
+ * @tparam T Copyable value type
+ */
+template <typename T>
+class LatestValue {
+public:
+    LatestValue()
+        : back_(0),
+          front_(1),
+          middle_(2) {
+    }
+
+    LatestValue(const LatestValue&) = delete;
+    LatestValue& operator=(const LatestValue&) = delete;
+
+    /**
+     * @brief Publish a new value, replacing any unread one (producer thread only)
+     * @param value Value to publish
+     */
+    void publish(const T& value) {
+        slots_[back_] = value;
+        // Swap the filled slot into the middle and mark it as new
+        back_ = middle_.exchange(back_ | kFresh, std::memory_order_acq_rel) & kIndexMask;
+    }
+
+    /**
+     * @brief Check whether a value was published since the last take()
+     */
+    bool has_update() const {
+        return (middle_.load(std::memory_order_acquire) & kFresh) != 0;
+    }
+
+    /**
+     * @brief Take the newest value if there is one (consumer thread only)
+     * @param value Receives the value
+     * @return False if nothing was published since the last call
+     */
+    bool take(T& value) {
+        if (!has_update()) {
+            return false;
+        }
+        front_ = middle_.exchange(front_, std::memory_order_acq_rel) & kIndexMask;
+        value = slots_[front_];
+        return true;
+    }
+
+    /**
+     * @brief Discard any unread value; neither side may be active
+     */
+    void clear() {
+        middle_.fetch_and(kIndexMask, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kFresh = 0x4;
+
+    T slots_[3];
+    uint8_t back_;                 // Slot the producer fills next (producer-owned)
+    uint8_t front_;                // Slot the consumer last read (consumer-owned)
+    alignas(64) std::atomic<uint8_t> middle_; // Shared slot index plus kFresh flag
+};
+
+} // namespace audio
+} // namespace koelingo
+
+#endif // KOELINGO_LATEST_VALUE_H
@@ -0,0 +1,362 @@
+/**
+ * @file level_meter.cc
+ * @brief Implementation of the vectorized level meter
+ */
+
+#include "level_meter.h"
+#include <portaudio.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define KOELINGO_LEVEL_SSE2 1
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define KOELINGO_LEVEL_AVX2 1
+#include <immintrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define KOELINGO_LEVEL_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace koelingo {
+namespace audio {
+
+namespace {
+
+// Scale factors that map integer samples to [-1.0, 1.0]
+constexpr float kInt16Scale = 1.0f / 32768.0f;
+constexpr float kInt32Scale = 1.0f / 2147483648.0f;
+
+enum class Kernel { kScalar, kSse2, kAvx2, kNeon };
+
+// Per-lane accumulators filled by the vector kernels
+struct LaneTotals {
+    float sum[8] = {};
+    float peak[8] = {};
+    uint32_t clipped[8] = {};
+};
+
+// Normalized magnitude at or above which a sample counts as clipped
+float clip_threshold(int format_type) {
+    switch (format_type) {
+        case paInt16:
+            return 32767.0f * kInt16Scale;
+        case paInt8:
+            return 127.0f / 128.0f;
+        case paUInt8:
+            return 127.0f / 128.0f;
+        case paInt24:
+            return 8388607.0f / 8388608.0f;
+        default:
+            return 1.0f; // paFloat32, and paInt32 full scale rounds to 1.0
+    }
+}
+
+// Read one normalized sample of any supported format
+float load_sample(const char* data, size_t index, int format_type) {
+    switch (format_type) {
+        case paFloat32: {
+            float value;
+            std::memcpy(&value, data + index * 4, sizeof(value));
+            return value;
+        }
+        case paInt32: {
+            int32_t value;
+            std::memcpy(&value, data + index * 4, sizeof(value));
+            return static_cast<float>(value) * kInt32Scale;
+        }
+        case paInt24: {
+            const unsigned char* p = reinterpret_cast<const unsigned char*>(data + index * 3);
+            int32_t value = static_cast<int32_t>(static_cast<uint32_t>(p[0]) << 8 |
+                                                 static_cast<uint32_t>(p[1]) << 16 |
+                                                 static_cast<uint32_t>(p[2]) << 24) >> 8;
+            return static_cast<float>(value) / 8388608.0f;
+        }
+        case paInt16: {
+            int16_t value;
+            std::memcpy(&value, data + index * 2, sizeof(value));
+            return value * kInt16Scale;
+        }
+        case paInt8:
+            return static_cast<signed char>(data[index]) / 128.0f;
+        case paUInt8:
+            return (static_cast<unsigned char>(data[index]) - 128) / 128.0f;
+        default:
+            return 0.0f;
+    }
+}
+
+#if defined(KOELINGO_LEVEL_SSE2)
+// Load four normalized samples with SSE2
+template <int Format>
+inline __m128 load4_sse2(const char* data, size_t index) {
+    if constexpr (Format == paFloat32) {
+        return _mm_loadu_ps(reinterpret_cast<const float*>(data) + index);
+    } else if constexpr (Format == paInt32) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + index * 4));
+        return _mm_mul_ps(_mm_cvtepi32_ps(x), _mm_set1_ps(kInt32Scale));
+    } else {
+        __m128i x = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data + index * 2));
+        x = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+        return _mm_mul_ps(_mm_cvtepi32_ps(x), _mm_set1_ps(kInt16Scale));
+    }
+}
+
+// Accumulate four lanes at a time with SSE2; returns samples consumed
+template <int Format>
+size_t levels_sse2(const char* data, size_t count, float clip, LaneTotals& totals) {
+    const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    const __m128 threshold = _mm_set1_ps(clip);
+    __m128 sum = _mm_setzero_ps();
+    __m128 peak = _mm_setzero_ps();
+    __m128i clipped = _mm_setzero_si128();
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = load4_sse2<Format>(data, i);
+        __m128 magnitude = _mm_and_ps(x, abs_mask);
+        sum = _mm_add_ps(sum, _mm_mul_ps(x, x));
+        peak = _mm_max_ps(peak, magnitude);
+        // Comparison masks are all ones (-1) where the sample clipped
+        clipped = _mm_sub_epi32(clipped, _mm_castps_si128(_mm_cmpge_ps(magnitude, threshold)));
+    }
+
+    _mm_storeu_ps(totals.sum, sum);
+    _mm_storeu_ps(totals.peak, peak);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(totals.clipped), clipped);
+    return i;
+}
+#endif
+
+#if defined(KOELINGO_LEVEL_AVX2)
+// Load eight normalized samples with AVX2
+template <int Format>
+__attribute__((target("avx2"))) inline __m256 load8_avx2(const char* data, size_t index) {
+    if constexpr (Format == paFloat32) {
+        return _mm256_loadu_ps(reinterpret_cast<const float*>(data) + index);
+    } else if constexpr (Format == paInt32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + index * 4));
+        return _mm256_mul_ps(_mm256_cvtepi32_ps(x), _mm256_set1_ps(kInt32Scale));
+    } else {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + index * 2));
+        return _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(x)),
+                             _mm256_set1_ps(kInt16Scale));
+    }
+}
+
+// Accumulate eight lanes at a time with AVX2; returns samples consumed
+template <int Format>
+__attribute__((target("avx2")))
+size_t levels_avx2(const char* data, size_t count, float clip, LaneTotals& totals) {
+    const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    const __m256 threshold = _mm256_set1_ps(clip);
+    __m256 sum = _mm256_setzero_ps();
+    __m256 peak = _mm256_setzero_ps();
+    __m256i clipped = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = load8_avx2<Format>(data, i);
+        __m256 magnitude = _mm256_and_ps(x, abs_mask);
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(x, x));
+        peak = _mm256_max_ps(peak, magnitude);
+        clipped = _mm256_sub_epi32(clipped, _mm256_castps_si256(
+            _mm256_cmp_ps(magnitude, threshold, _CMP_GE_OQ)));
+    }
+
+    _mm256_storeu_ps(totals.sum, sum);
+    _mm256_storeu_ps(totals.peak, peak);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(totals.clipped), clipped);
+    return i;
+}
+#endif
+
+#if defined(KOELINGO_LEVEL_NEON)
+// Load four normalized samples with NEON
+template <int Format>
+inline float32x4_t load4_neon(const char* data, size_t index) {
+    if constexpr (Format == paFloat32) {
+        return vld1q_f32(reinterpret_cast<const float*>(data) + index);
+    } else if constexpr (Format == paInt32) {
+        int32x4_t x = vld1q_s32(reinterpret_cast<const int32_t*>(data) + index);
+        return vmulq_n_f32(vcvtq_f32_s32(x), kInt32Scale);
+    } else {
+        int16x4_t x = vld1_s16(reinterpret_cast<const int16_t*>(data) + index);
+        return vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(x)), kInt16Scale);
+    }
+}
+
+// Accumulate four lanes at a time with NEON; returns samples consumed
+template <int Format>
+size_t levels_neon(const char* data, size_t count, float clip, LaneTotals& totals) {
+    const float32x4_t threshold = vdupq_n_f32(clip);
+    float32x4_t sum = vdupq_n_f32(0.0f);
+    float32x4_t peak = vdupq_n_f32(0.0f);
+    uint32x4_t clipped = vdupq_n_u32(0);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t x = load4_neon<Format>(data, i);
+        float32x4_t magnitude = vabsq_f32(x);
+        sum = vmlaq_f32(sum, x, x);
+        peak = vmaxq_f32(peak, magnitude);
+        clipped = vsubq_u32(clipped, vcgeq_f32(magnitude, threshold));
+    }
+
+    vst1q_f32(totals.sum, sum);
+    vst1q_f32(totals.peak, peak);
+    vst1q_u32(totals.clipped, clipped);
+    return i;
+}
+#endif
+
+// Pick the best kernel for this CPU
+Kernel select_kernel() {
+#if defined(KOELINGO_LEVEL_AVX2)
+    if (__builtin_cpu_supports("avx2")) {
+        return Kernel::kAvx2;
+    }
+#endif
+#if defined(KOELINGO_LEVEL_SSE2)
+    return Kernel::kSse2;
+#elif defined(KOELINGO_LEVEL_NEON)
+    return Kernel::kNeon;
+#else
+    return Kernel::kScalar;
+#endif
+}
+
+// Kernel chosen on first use
+Kernel active_kernel() {
+    static const Kernel kernel = select_kernel();
+    return kernel;
+}
+
+// Run the vector kernel for a format; returns samples consumed and lane count
+template <int Format>
+size_t run_kernel(const char* data, size_t count, int channels, float clip,
+                  LaneTotals& totals, int& lanes) {
+    switch (active_kernel()) {
+#if defined(KOELINGO_LEVEL_AVX2)
+        case Kernel::kAvx2:
+            if (8 % channels == 0) {
+                lanes = 8;
+                return levels_avx2<Format>(data, count, clip, totals);
+            }
+            break;
+#endif
+#if defined(KOELINGO_LEVEL_SSE2)
+        case Kernel::kSse2:
+            break;
+#endif
+#if defined(KOELINGO_LEVEL_NEON)
+        case Kernel::kNeon:
+            if (4 % channels == 0) {
+                lanes = 4;
+                return levels_neon<Format>(data, count, clip, totals);
+            }
+            break;
+#endif
+        default:
+            break;
+    }
+
+#if defined(KOELINGO_LEVEL_SSE2)
+    // Also used when AVX2 lanes do not line up with the channel count
+    if (4 % channels == 0) {
+        lanes = 4;
+        return levels_sse2<Format>(data, count, clip, totals);
+    }
+#endif
+    return 0;
+}
+
+} // namespace
+
+// Measure RMS, peak and clip count per channel
+void measure_levels(const char* data, size_t frames, int channels, int format_type,
+                    ChannelLevel* levels) {
+    if (channels <= 0) {
+        return;
+    }
+    std::fill(levels, levels + channels, ChannelLevel());
+    if (frames == 0) {
+        return;
+    }
+
+    const size_t count = frames * static_cast<size_t>(channels);
+    const float clip = clip_threshold(format_type);
+
+    // Vector lanes map onto channels as long as the lane count is a multiple
+    // of the channel count; each kernel consumes whole vectors only
+    LaneTotals totals;
+    int lanes = 0;
+    size_t done = 0;
+    switch (format_type) {
+        case paInt16:
+            done = run_kernel<paInt16>(data, count, channels, clip, totals, lanes);
+            break;
+        case paInt32:
+            done = run_kernel<paInt32>(data, count, channels, clip, totals, lanes);
+            break;
+        case paFloat32:
+            done = run_kernel<paFloat32>(data, count, channels, clip, totals, lanes);
+            break;
+        default:
+            break;
+    }
+
+    // rms holds the sum of squares until the end
+    for (int lane = 0; lane < lanes; lane++) {
+        ChannelLevel& level = levels[lane % channels];
+        level.rms += totals.sum[lane];
+        level.peak = std::max(level.peak, totals.peak[lane]);
+        level.clipped += totals.clipped[lane];
+    }
+
+    // Scalar tail (or the whole block when no kernel applies)
+    for (size_t i = done; i < count; i++) {
+        float sample = load_sample(data, i, format_type);
+        float magnitude = std::fabs(sample);
+        ChannelLevel& level = levels[i % channels];
+        level.rms += sample * sample;
+        level.peak = std::max(level.peak, magnitude);
+        if (magnitude >= clip) {
+            level.clipped++;
+        }
+    }
+
+    for (int c = 0; c < channels; c++) {
+        levels[c].rms = std::sqrt(levels[c].rms / frames);
+    }
+}
+
+// Map an RMS value to the normalized meter scale
+float rms_to_meter_level(float rms) {
+    // Convert to dB
+    float db = 20.0f * log10f(std::max(rms, 0.0000001f)); // Avoid log(0)
+
+    // Normalize to [0.0, 1.0] range, assuming -60dB is silence
+    float normalized = std::max(0.0f, (db + 60.0f) / 60.0f);
+    return std::min(normalized, 1.0f);
+}
+
+// Name of the kernel in use
+const char* level_kernel_name() {
+    switch (active_kernel()) {
+        case Kernel::kAvx2:
+            return "avx2";
+        case Kernel::kSse2:
+            return "sse2";
+        case Kernel::kNeon:
+            return "neon";
+        default:
+            return "scalar";
+    }
+}
+
+} // namespace audio
+} // namespace koelingo
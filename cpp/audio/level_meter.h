@@ -0,0 +1,71 @@
+/**
+ * @file level_meter.h
+ * @brief Vectorized RMS/peak/clip level measurement for captured audio
+ */
+
+#ifndef KOELINGO_LEVEL_METER_H
+#define KOELINGO_LEVEL_METER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace koelingo {
+namespace audio {
+
+/**
+ * @brief Maximum number of channels reported individually in AudioLevels
+ */
+constexpr int kMaxLevelChannels = 8;
+
+/**
+ * @struct ChannelLevel
+ * @brief Level statistics for one channel of one block
+ */
+struct ChannelLevel {
+    float rms = 0.0f;      ///< Root mean square, relative to full scale
+    float peak = 0.0f;     ///< Largest absolute sample, relative to full scale
+    uint32_t clipped = 0;  ///< Number of samples at full scale
+};
+
+/**
+ * @struct AudioLevels
+ * @brief Level payload delivered to level callbacks
+ */
+struct AudioLevels {
+    float level = 0.0f;      ///< Overall meter level in [0.0, 1.0] (-60 dB..0 dB)
+    int channel_count = 0;   ///< Number of valid entries in channels
+    std::array<ChannelLevel, kMaxLevelChannels> channels; ///< Per-channel statistics
+};
+
+/**
+ * @brief Measure RMS, peak and clip count per channel in a single pass
+ * @param data Interleaved frames in the given format
+ * @param frames Number of frames
+ * @param channels Number of interleaved channels
+ * @param format_type PortAudio sample format (paInt16, paInt32 or paFloat32)
+ * @param levels Output array with room for `channels` entries
+ *
+ * Uses AVX2, SSE2 or NEON kernels when available (chosen at runtime) and
+ * falls back to scalar code for other formats or channel layouts.
+ */
+void measure_levels(const char* data, size_t frames, int channels, int format_type,
+                    ChannelLevel* levels);
+
+/**
+ * @brief Map an RMS value to the normalized meter scale
+ * @param rms RMS relative to full scale
+ * @return Level in [0.0, 1.0], where 0.0 is -60 dB or quieter
+ */
+float rms_to_meter_level(float rms);
+
+/**
+ * @brief Get the name of the kernel measure_levels() dispatches to
+ * @return "avx2", "sse2", "neon" or "scalar"
+ */
+const char* level_kernel_name();
+
+} // namespace audio
+} // namespace koelingo
+
+#endif // KOELINGO_LEVEL_METER_H
@@ -0,0 +1,208 @@
+/**
+ * @file mapped_wav.cc
+ * @brief Implementation of memory-mapped WAV files
+ */
+
+#include "mapped_wav.h"
+#include "sample_format.h"
+#include <portaudio.h>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace koelingo {
+namespace audio {
+
+namespace {
+
+uint16_t read_le16(const unsigned char* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t read_le32(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// PortAudio format matching a WAV encoding, or 0 if unsupported
+int wav_sample_format(uint16_t format_tag, uint16_t bits) {
+    if (format_tag == 1) {
+        switch (bits) {
+            case 8: return paUInt8; // 8-bit WAV is unsigned
+            case 16: return paInt16;
+            case 24: return paInt24;
+            case 32: return paInt32;
+            default: return 0;
+        }
+    }
+    if (format_tag == 3 && bits == 32) {
+        return paFloat32;
+    }
+    return 0;
+}
+
+} // namespace
+
+// MappedWav constructor
+MappedWav::MappedWav()
+    : mapping_(nullptr),
+      mapping_size_(0),
+#if defined(_WIN32)
+      file_handle_(nullptr),
+      map_handle_(nullptr),
+#endif
+      data_(nullptr),
+      frames_(0),
+      sample_rate_(0),
+      channels_(0),
+      format_type_(0),
+      frame_bytes_(0) {
+}
+
+// MappedWav destructor
+MappedWav::~MappedWav() {
+    close();
+}
+
+// Map a file
+bool MappedWav::open(const std::string& path) {
+    close();
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "Failed to open file: " << path << std::endl;
+        return false;
+    }
+    LARGE_INTEGER size;
+    HANDLE map = GetFileSizeEx(file, &size) && size.QuadPart > 0
+        ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr)
+        : nullptr;
+    void* view = map ? MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        std::cerr << "Failed to map file: " << path << std::endl;
+        if (map) {
+            CloseHandle(map);
+        }
+        CloseHandle(file);
+        return false;
+    }
+    file_handle_ = file;
+    map_handle_ = map;
+    mapping_ = view;
+    mapping_size_ = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Failed to open file: " << path << std::endl;
+        return false;
+    }
+    struct stat info;
+    void* view = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd); // The mapping keeps the file referenced
+    if (view == MAP_FAILED) {
+        std::cerr << "Failed to map file: " << path << std::endl;
+        return false;
+    }
+
+    // Readers walk their part of the file front to back
+    madvise(view, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+    mapping_ = view;
+    mapping_size_ = static_cast<size_t>(info.st_size);
+#endif
+
+    if (!parse(path)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+// Unmap the file
+void MappedWav::close() {
+    if (mapping_) {
+#if defined(_WIN32)
+        UnmapViewOfFile(mapping_);
+        CloseHandle(map_handle_);
+        CloseHandle(file_handle_);
+        map_handle_ = nullptr;
+        file_handle_ = nullptr;
+#else
+        munmap(mapping_, mapping_size_);
+#endif
+    }
+    mapping_ = nullptr;
+    mapping_size_ = 0;
+    data_ = nullptr;
+    frames_ = 0;
+    sample_rate_ = 0;
+    channels_ = 0;
+    format_type_ = 0;
+    frame_bytes_ = 0;
+}
+
+// Locate the format and data chunks
+bool MappedWav::parse(const std::string& path) {
+    const unsigned char* file = static_cast<const unsigned char*>(mapping_);
+    const size_t size = mapping_size_;
+    if (size < 12 || std::memcmp(file, "RIFF", 4) != 0 || std::memcmp(file + 8, "WAVE", 4) != 0) {
+        std::cerr << "Not a WAV file: " << path << std::endl;
+        return false;
+    }
+
+    size_t offset = 12;
+    while (offset + 8 <= size && !data_) {
+        const unsigned char* chunk = file + offset;
+        uint32_t chunk_size = read_le32(chunk + 4);
+        offset += 8;
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0) {
+            if (chunk_size < 16 || offset + 16 > size) {
+                break;
+            }
+            const unsigned char* fmt = file + offset;
+            uint16_t format_tag = read_le16(fmt);
+            if (format_tag == 0xFFFE && chunk_size >= 40 && offset + 40 <= size) {
+                format_tag = read_le16(fmt + 24); // First bytes of the SubFormat GUID
+            }
+            channels_ = read_le16(fmt + 2);
+            sample_rate_ = static_cast<int>(read_le32(fmt + 4));
+            format_type_ = wav_sample_format(format_tag, read_le16(fmt + 14));
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            // A recording that was not finalized has a zero or oversized
+            // length; take everything up to the end of the file then
+            size_t available = size - offset;
+            size_t length = chunk_size == 0 || chunk_size > available ? available : chunk_size;
+            data_ = reinterpret_cast<const char*>(file + offset);
+            frame_bytes_ = format_type_ && channels_ > 0
+                ? bytes_per_sample(format_type_) * static_cast<size_t>(channels_)
+                : 0;
+            frames_ = frame_bytes_ ? length / frame_bytes_ : 0;
+            break;
+        }
+        offset += chunk_size + (chunk_size & 1);
+    }
+
+    if (!data_ || format_type_ == 0 || channels_ <= 0 || sample_rate_ <= 0) {
+        std::cerr << "Unsupported or corrupt WAV file: " << path << std::endl;
+        data_ = nullptr;
+        return false;
+    }
+    return true;
+}
+
+} // namespace audio
+} // namespace koelingo
@@ -0,0 +1,108 @@
+/**
+ * @file mapped_wav.h
+ * @brief Memory-mapped WAV files for offline processing
+ */
+
+#ifndef KOELINGO_MAPPED_WAV_H
+#define KOELINGO_MAPPED_WAV_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace koelingo {
+namespace audio {
+
+/**
+ * @class MappedWav
+ * @brief Read-only view of the sample data of a WAV file
+ *
+ * The file is mapped rather than read, so hours of audio cost no heap
+ * and pages are only faulted in as they are touched. Any number of
+ * threads may read from the mapping at once.
+ *
+ * Supports 8/16/24/32-bit PCM and 32-bit float, including
+ * WAVE_FORMAT_EXTENSIBLE. A recording that was not finalized (zero or
+ * oversized data length) is read up to the end of the file.
+ */
+class MappedWav {
+public:
+    MappedWav();
+    ~MappedWav();
+
+    MappedWav(const MappedWav&) = delete;
+    MappedWav& operator=(const MappedWav&) = delete;
+
+    /**
+     * @brief Map a file
+     * @param path WAV file to open
+     * @return False if the file cannot be mapped or its encoding is unsupported
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Unmap the file
+     */
+    void close();
+
+    /**
+     * @brief Check whether a file is mapped
+     */
+    bool is_open() const { return data_ != nullptr; }
+
+    /**
+     * @brief Get the interleaved sample data
+     */
+    const char* data() const { return data_; }
+
+    /**
+     * @brief Get the number of frames
+     */
+    uint64_t frames() const { return frames_; }
+
+    /**
+     * @brief Get the sample rate in Hz
+     */
+    int sample_rate() const { return sample_rate_; }
+
+    /**
+     * @brief Get the number of interleaved channels
+     */
+    int channels() const { return channels_; }
+
+    /**
+     * @brief Get the PortAudio sample format of the data
+     */
+    int format_type() const { return format_type_; }
+
+    /**
+     * @brief Get the size of one frame in bytes
+     */
+    size_t frame_bytes() const { return frame_bytes_; }
+
+    /**
+     * @brief Get a pointer to a frame
+     */
+    const char* frame(uint64_t index) const { return data_ + index * frame_bytes_; }
+
+private:
+    void* mapping_;       // Start of the mapped file
+    size_t mapping_size_;
+#if defined(_WIN32)
+    void* file_handle_;
+    void* map_handle_;
+#endif
+    const char* data_;    // First byte of the data chunk
+    uint64_t frames_;
+    int sample_rate_;
+    int channels_;
+    int format_type_;
+    size_t frame_bytes_;
+
+    bool parse(const std::string& path);
+};
+
+} // namespace audio
+} // namespace koelingo
+
+#endif // KOELINGO_MAPPED_WAV_H
@@ -0,0 +1,270 @@
+/**
+ * @file mel_spectrogram.cc
+ * @brief Implementation of the incremental log-mel front end
+ */
+
+#include "mel_spectrogram.h"
+#include "vector_math.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+namespace koelingo {
+namespace audio {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+// Energies are clamped here before taking the log, as in Whisper
+constexpr float kLogFloor = 1e-10f;
+
+// Slaney mel scale (librosa's default, which Whisper's filters use)
+double hz_to_mel(double hz) {
+    const double f_sp = 200.0 / 3.0;
+    const double min_log_hz = 1000.0;
+    const double min_log_mel = min_log_hz / f_sp;
+    const double log_step = std::log(6.4) / 27.0;
+    return hz < min_log_hz ? hz / f_sp : min_log_mel + std::log(hz / min_log_hz) / log_step;
+}
+
+// Inverse of hz_to_mel()
+double mel_to_hz(double mel) {
+    const double f_sp = 200.0 / 3.0;
+    const double min_log_hz = 1000.0;
+    const double min_log_mel = min_log_hz / f_sp;
+    const double log_step = std::log(6.4) / 27.0;
+    return mel < min_log_mel ? mel * f_sp : min_log_hz * std::exp(log_step * (mel - min_log_mel));
+}
+
+} // namespace
+
+// MelSpectrogram constructor
+MelSpectrogram::MelSpectrogram()
+    : capacity_(0),
+      bins_(0),
+      input_start_(0),
+      input_fill_(0),
+      primed_(false),
+      discard_(0),
+      position_(0),
+      frames_written_(0) {
+}
+
+// Allocate buffers and design the filterbank
+bool MelSpectrogram::configure(const MelConfig& config, int sample_rate) {
+    if (sample_rate <= 0 || config.n_mels <= 0 || config.n_fft < 4 || config.n_fft % 2 != 0 ||
+        config.hop_length <= 0 || config.hop_length > config.n_fft || config.buffer_frames <= 0) {
+        std::cerr << "Invalid mel spectrogram configuration" << std::endl;
+        return false;
+    }
+
+    config_ = config;
+    capacity_ = static_cast<size_t>(config.buffer_frames);
+    const size_t n_fft = static_cast<size_t>(config.n_fft);
+    bins_ = n_fft / 2 + 1;
+
+    fft_ = RealFft(n_fft);
+    windowed_.assign(n_fft, 0.0f);
+    spectrum_.assign(bins_, std::complex<float>());
+    power_.assign(bins_, 0.0f);
+    row_.assign(static_cast<size_t>(config.n_mels), 0.0f);
+
+    // Periodic Hann window, like torch.hann_window()
+    window_.resize(n_fft);
+    for (size_t i = 0; i < n_fft; i++) {
+        window_[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * kPi * i / n_fft));
+    }
+
+    // Triangular filters between mel-spaced edges, area-normalized (Slaney)
+    const double max_mel = hz_to_mel(sample_rate / 2.0);
+    std::vector<double> edges(static_cast<size_t>(config.n_mels) + 2);
+    for (size_t i = 0; i < edges.size(); i++) {
+        edges[i] = mel_to_hz(max_mel * i / (edges.size() - 1));
+    }
+
+    filter_weights_.clear();
+    filter_offset_.assign(config.n_mels, 0);
+    filter_start_.assign(config.n_mels, 0);
+    filter_length_.assign(config.n_mels, 0);
+    for (int m = 0; m < config.n_mels; m++) {
+        const double lower = edges[m];
+        const double center = edges[m + 1];
+        const double upper = edges[m + 2];
+        const double norm = 2.0 / (upper - lower);
+
+        filter_offset_[m] = filter_weights_.size();
+        bool started = false;
+        for (size_t k = 0; k < bins_; k++) {
+            double hz = static_cast<double>(k) * sample_rate / n_fft;
+            double weight = std::max(0.0, std::min((hz - lower) / (center - lower),
+                                                   (upper - hz) / (upper - center)));
+            if (weight <= 0.0) {
+                if (started) {
+                    break;
+                }
+                continue;
+            }
+            if (!started) {
+                filter_start_[m] = k;
+                started = true;
+            }
+            filter_weights_.push_back(static_cast<float>(weight * norm));
+            filter_length_[m]++;
+        }
+    }
+
+    input_.assign(2 * n_fft, 0.0f);
+
+    // Fresh storage: existing views keep the old buffer alive
+    storage_ = std::make_shared<std::vector<float>>(2 * capacity_ * config.n_mels, std::log10(kLogFloor));
+
+    reset();
+    return true;
+}
+
+// Restart at frame 0
+void MelSpectrogram::reset() {
+    input_start_ = 0;
+    input_fill_ = static_cast<size_t>(config_.n_fft / 2);
+    primed_ = false;
+    discard_ = 0;
+    position_ = 0;
+    frames_written_.store(0, std::memory_order_release);
+}
+
+// Analyse a block of audio
+void MelSpectrogram::process(const float* samples, size_t count) {
+    if (!storage_) {
+        return;
+    }
+
+    const size_t n_fft = static_cast<size_t>(config_.n_fft);
+    const size_t hop = static_cast<size_t>(config_.hop_length);
+
+    while (count > 0) {
+        // After a gap, drop samples until the next frame boundary
+        if (discard_ > 0) {
+            size_t drop = static_cast<size_t>(std::min<uint64_t>(count, discard_));
+            discard_ -= drop;
+            position_ += drop;
+            samples += drop;
+            count -= drop;
+            continue;
+        }
+
+        // Move the unconsumed tail to the front when the input buffer is full
+        if (input_fill_ == input_.size()) {
+            std::memmove(input_.data(), input_.data() + input_start_,
+                         (input_fill_ - input_start_) * sizeof(float));
+            input_fill_ -= input_start_;
+            input_start_ = 0;
+        }
+
+        size_t take = std::min(count, input_.size() - input_fill_);
+        std::copy(samples, samples + take, input_.data() + input_fill_);
+        input_fill_ += take;
+        position_ += take;
+        samples += take;
+        count -= take;
+
+        if (!primed_) {
+            // The reflection needs samples 1..n_fft/2 of the run
+            if (input_fill_ < n_fft + 1) {
+                continue;
+            }
+            prime();
+        }
+
+        while (input_fill_ - input_start_ >= n_fft) {
+            compute_frame(input_.data() + input_start_, row_.data());
+            write_row(frames_written_.load(std::memory_order_relaxed), row_.data());
+            input_start_ += hop;
+        }
+    }
+}
+
+// Jump over missing samples
+void MelSpectrogram::skip(uint64_t samples) {
+    if (samples == 0 || !storage_) {
+        return;
+    }
+
+    const uint64_t hop = static_cast<uint64_t>(config_.hop_length);
+    position_ += samples;
+    uint64_t next_frame = (position_ + hop - 1) / hop;
+
+    // Frames whose windows needed the lost audio become silence
+    std::fill(row_.begin(), row_.end(), std::log10(kLogFloor));
+    uint64_t written = frames_written_.load(std::memory_order_relaxed);
+    uint64_t first = std::max(written, next_frame > capacity_ ? next_frame - capacity_ : 0);
+    for (uint64_t frame = first; frame < next_frame; frame++) {
+        write_row(frame, row_.data());
+    }
+    frames_written_.store(std::max(written, next_frame), std::memory_order_release);
+
+    // Start a new reflect-padded run centred on the next frame
+    input_start_ = 0;
+    input_fill_ = static_cast<size_t>(config_.n_fft / 2);
+    primed_ = false;
+    discard_ = next_frame * hop - position_;
+}
+
+// Mirror the start of the run to emulate reflect padding
+void MelSpectrogram::prime() {
+    const size_t half = static_cast<size_t>(config_.n_fft / 2);
+    for (size_t j = 1; j <= half; j++) {
+        input_[half - j] = input_[half + j];
+    }
+    primed_ = true;
+}
+
+// Window, transform and project one frame onto the mel bands
+void MelSpectrogram::compute_frame(const float* samples, float* row) {
+    multiply(samples, window_.data(), windowed_.data(), static_cast<size_t>(config_.n_fft));
+    fft_.forward(windowed_.data(), spectrum_.data());
+    magnitude_squared(spectrum_.data(), power_.data(), bins_);
+
+    for (int m = 0; m < config_.n_mels; m++) {
+        float energy = dot_product(filter_weights_.data() + filter_offset_[m],
+                                   power_.data() + filter_start_[m], filter_length_[m]);
+        row[m] = std::log10(std::max(energy, kLogFloor));
+    }
+}
+
+// Store a frame in both mirrored slots and publish it
+void MelSpectrogram::write_row(uint64_t frame, const float* row) {
+    const size_t n_mels = static_cast<size_t>(config_.n_mels);
+    float* data = storage_->data();
+    size_t slot = static_cast<size_t>(frame % capacity_);
+    std::copy(row, row + n_mels, data + slot * n_mels);
+    std::copy(row, row + n_mels, data + (slot + capacity_) * n_mels);
+    frames_written_.store(frame + 1, std::memory_order_release);
+}
+
+// Oldest frame still retained
+uint64_t MelSpectrogram::oldest_frame() const {
+    uint64_t written = frames_written();
+    return written > capacity_ ? written - capacity_ : 0;
+}
+
+// Pointer to a retained frame
+const float* MelSpectrogram::frame_data(uint64_t frame) const {
+    if (!storage_ || capacity_ == 0) {
+        return nullptr;
+    }
+    return storage_->data() + static_cast<size_t>(frame % capacity_) * config_.n_mels;
+}
+
+// Check that frames from an index were not overwritten while being read
+bool MelSpectrogram::is_intact(uint64_t frame) const {
+    // Order the caller's reads of the frames before the check below
+    std::atomic_thread_fence(std::memory_order_acquire);
+    // The writer only touches the slot of frame frames_written(), which
+    // aliases frame (frames_written() - capacity_)
+    return frames_written_.load(std::memory_order_relaxed) < frame + capacity_;
+}
+
+} // namespace audio
+} // namespace koelingo
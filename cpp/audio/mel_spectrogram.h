@@ -0,0 +1,162 @@
+/**
+ * @file mel_spectrogram.h
+ * @brief Incremental log-mel spectrogram matching Whisper's front end
+ */
+
+#ifndef KOELINGO_MEL_SPECTROGRAM_H
+#define KOELINGO_MEL_SPECTROGRAM_H
+
+#include <atomic>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "fft.h"
+
+namespace koelingo {
+namespace audio {
+
+/**
+ * @struct MelConfig
+ * @brief Parameters of the log-mel front end
+ *
+ * The defaults reproduce whisper.log_mel_spectrogram() at 16 kHz
+ * (25 ms periodic Hann window, 10 ms hop, Slaney mel filterbank).
+ */
+struct MelConfig {
+    bool enabled = false;      ///< Compute mel frames while recording
+    int n_mels = 80;           ///< Number of mel bins (80, or 128 for large-v3)
+    int n_fft = 400;           ///< FFT / window length in samples
+    int hop_length = 160;      ///< Samples between frames
+    int buffer_frames = 6000;  ///< Frames retained (6000 = 60 s at a 10 ms hop)
+};
+
+/**
+ * @class MelSpectrogram
+ * @brief Streaming STFT and mel filterbank with a mirrored frame buffer
+ *
+ * Frames are computed as soon as their window is complete, so each sample
+ * is only analysed once. Frame t is centred on sample t * hop_length of
+ * the capture timeline (the start of the stream is reflect-padded, as in
+ * Whisper) and holds log10 mel energies without Whisper's per-segment
+ * normalization.
+ *
+ * Frames are stored in a ring in which every row is written twice, so any
+ * run of up to capacity() consecutive frames is contiguous in memory and
+ * can be handed out without copying. One thread writes (process()) while
+ * others read; readers holding a view should check is_intact() afterwards.
+ */
+class MelSpectrogram {
+public:
+    MelSpectrogram();
+
+    /**
+     * @brief Allocate buffers, design the filterbank and reset the state
+     * @param config Front-end parameters
+     * @param sample_rate Sample rate of the audio passed to process()
+     * @return False if the parameters are invalid
+     *
+     * New storage is allocated on every call, so views handed out earlier
+     * stay valid (they keep their own reference via storage()).
+     */
+    bool configure(const MelConfig& config, int sample_rate);
+
+    /**
+     * @brief Restart at frame 0 with an empty history
+     */
+    void reset();
+
+    /**
+     * @brief Analyse a block of mono audio
+     * @param samples Mono samples in the range [-1.0, 1.0]
+     * @param count Number of samples; they follow the previous block directly
+     */
+    void process(const float* samples, size_t count);
+
+    /**
+     * @brief Jump over samples that were lost before they could be analysed
+     * @param samples Number of missing samples
+     *
+     * Frames that fall into the gap are filled with the log floor.
+     */
+    void skip(uint64_t samples);
+
+    /**
+     * @brief Get the number of frames computed since the last reset
+     */
+    uint64_t frames_written() const { return frames_written_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Get the index of the oldest frame still retained
+     */
+    uint64_t oldest_frame() const;
+
+    /**
+     * @brief Get the number of frames retained
+     */
+    size_t capacity() const { return capacity_; }
+
+    /**
+     * @brief Get the number of mel bins per frame
+     */
+    int n_mels() const { return config_.n_mels; }
+
+    /**
+     * @brief Get a pointer to a retained frame
+     * @param frame Frame index between oldest_frame() and frames_written()
+     * @return Row-major frames; the next capacity() - 1 frames follow contiguously
+     */
+    const float* frame_data(uint64_t frame) const;
+
+    /**
+     * @brief Check whether frames from a given index have not been overwritten
+     * @param frame Index of the first frame that was read
+     */
+    bool is_intact(uint64_t frame) const;
+
+    /**
+     * @brief Get shared ownership of the frame storage
+     *
+     * Lets zero-copy views outlive a later configure().
+     */
+    std::shared_ptr<const std::vector<float>> storage() const { return storage_; }
+
+private:
+    MelConfig config_;
+    size_t capacity_;
+    size_t bins_;  // n_fft / 2 + 1
+
+    RealFft fft_;
+    std::vector<float> window_;
+    std::vector<float> windowed_;
+    std::vector<std::complex<float>> spectrum_;
+    std::vector<float> power_;
+    std::vector<float> row_;
+
+    // Slaney filterbank stored sparsely: weights of bin range per mel band
+    std::vector<float> filter_weights_;
+    std::vector<size_t> filter_offset_;
+    std::vector<size_t> filter_start_;
+    std::vector<size_t> filter_length_;
+
+    // Analysis input: frames are taken from input_[start_, start_ + n_fft)
+    std::vector<float> input_;
+    size_t input_start_;
+    size_t input_fill_;
+    bool primed_;          // Reflect padding for the current run is in place
+    uint64_t discard_;     // Samples to drop before the run's first frame
+    uint64_t position_;    // Capture sample index of the next input sample
+
+    std::shared_ptr<std::vector<float>> storage_;
+    std::atomic<uint64_t> frames_written_;
+
+    void compute_frame(const float* samples, float* row);
+    void write_row(uint64_t frame, const float* row);
+    void prime();
+};
+
+} // namespace audio
+} // namespace koelingo
+
+#endif // KOELINGO_MEL_SPECTROGRAM_H
@@ -0,0 +1,168 @@
+/**
+ * @file mpmc_queue.h
+ * @brief Bounded lock-free multi-producer/multi-consumer queue
+ */
+
+#ifndef KOELINGO_MPMC_QUEUE_H
+#define KOELINGO_MPMC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace koelingo {
+namespace audio {
+
+/**
+ * @class MpmcQueue
+ * @brief Fixed-capacity queue any number of threads may push to and pop from
+ *
+ * Every slot carries a sequence number that tells producers and consumers
+ * whose turn it is, so a push or pop claims its slot with one
+ * compare-and-swap and never blocks on a slow peer. pop_batch() claims a
+ * run of ready slots with a single compare-and-swap. Storage is allocated
+ * once in the constructor; the capacity is rounded up to a power of two.
+ *
+ * @tparam T Default-constructible, movable element type
+ */
+template <typename T>
+class MpmcQueue {
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Minimum number of queued elements
+     */
+    explicit MpmcQueue(size_t capacity)
+        : slots_(round_up(capacity)),
+          mask_(slots_.size() - 1),
+          head_(0),
+          tail_(0) {
+        for (size_t i = 0; i < slots_.size(); i++) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    /**
+     * @brief Append an element (any thread)
+     * @param item Element to append; moved from only on success
+     * @return False if the queue is full
+     */
+    bool push(T&& item) {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots_[pos & mask_];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.value = std::move(item);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // The slot still holds an element from the previous lap
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Append a copy of an element (any thread)
+     * @param item Element to append
+     * @return False if the queue is full
+     */
+    bool push(const T& item) {
+        T copy = item;
+        return push(std::move(copy));
+    }
+
+    /**
+     * @brief Remove the oldest element (any thread)
+     * @param item Receives the element
+     * @return False if the queue is empty
+     */
+    bool pop(T& item) {
+        return pop_batch(&item, 1) == 1;
+    }
+
+    /**
+     * @brief Remove up to max_items of the oldest elements at once (any thread)
+     * @param items Receives the elements in queue order
+     * @param max_items Capacity of items
+     * @return Number of elements removed (0 if the queue is empty)
+     */
+    size_t pop_batch(T* items, size_t max_items) {
+        if (max_items == 0) {
+            return 0;
+        }
+        size_t pos = head_.load(std::memory_order_relaxed);
+        while (true) {
+            // Count the published elements from pos onwards
+            size_t ready = 0;
+            while (ready < max_items && ready <= mask_ &&
+                   slots_[(pos + ready) & mask_].sequence.load(std::memory_order_acquire) == pos + ready + 1) {
+                ready++;
+            }
+            if (ready == 0) {
+                size_t sequence = slots_[pos & mask_].sequence.load(std::memory_order_acquire);
+                if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1) < 0) {
+                    return 0; // Empty, or the next element is still being written
+                }
+                pos = head_.load(std::memory_order_relaxed); // Another consumer got there first
+                continue;
+            }
+            if (head_.compare_exchange_weak(pos, pos + ready, std::memory_order_relaxed)) {
+                for (size_t i = 0; i < ready; i++) {
+                    Slot& slot = slots_[(pos + i) & mask_];
+                    items[i] = std::move(slot.value);
+                    slot.sequence.store(pos + i + mask_ + 1, std::memory_order_release);
+                }
+                return ready;
+            }
+        }
+    }
+
+    /**
+     * @brief Get the number of queued elements (approximate while in use)
+     */
+    size_t size() const {
+        size_t head = head_.load(std::memory_order_acquire);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    /**
+     * @brief Get the maximum number of queued elements
+     */
+    size_t capacity() const { return slots_.size(); }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    static size_t round_up(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        return size;
+    }
+
+    std::vector<Slot> slots_;
+    const size_t mask_;
+    alignas(64) std::atomic<size_t> head_; // Next position to pop
+    alignas(64) std::atomic<size_t> tail_; // Next position to fill
+};
+
+} // namespace audio
+} // namespace koelingo
+
+#endif // KOELINGO_MPMC_QUEUE_H
@@ -0,0 +1,163 @@
+/**
+ * @file noise_suppressor.cc
+ * @brief Implementation of the streaming noise suppressor
+ */
+
+#include "noise_suppressor.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "vector_math.h"
+
+namespace koelingo {
+namespace audio {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+// Weight of the previous frame in the smoothed bin power
+constexpr float kPowerSmoothing = 0.7f;
+
+// Keeps the gain division finite in silent bins
+constexpr float kMinPower = 1e-12f;
+
+} // namespace
+
+// NoiseSuppressor constructor: 16 kHz defaults until configured
+NoiseSuppressor::NoiseSuppressor()
+    : frame_length_(0),
+      hop_(0),
+      bins_(0),
+      floor_gain_(1.0f),
+      noise_rise_(1.0f),
+      input_fill_(0),
+      noise_valid_(false),
+      input_position_(0),
+      output_position_(0),
+      discard_(0) {
+    configure(NoiseSuppressionConfig(), 16000);
+}
+
+// Size the buffers for the frame length and precompute the window
+void NoiseSuppressor::configure(const NoiseSuppressionConfig& config, int sample_rate) {
+    config_ = config;
+
+    // An even length makes the half-overlapped squared windows sum to one
+    size_t length = static_cast<size_t>(std::max(1, sample_rate) * static_cast<int64_t>(std::max(1, config.frame_ms)) / 1000);
+    frame_length_ = std::max<size_t>(4, length & ~static_cast<size_t>(1));
+    hop_ = frame_length_ / 2;
+    bins_ = frame_length_ / 2 + 1;
+    floor_gain_ = std::pow(10.0f, std::min(0.0f, config.floor_db) / 20.0f);
+    double hop_seconds = static_cast<double>(hop_) / std::max(1, sample_rate);
+    noise_rise_ = static_cast<float>(std::pow(10.0, std::max(0.0f, config.noise_rise_db_per_s) * hop_seconds / 10.0));
+
+    fft_ = RealFft(frame_length_);
+    window_.resize(frame_length_);
+    for (size_t n = 0; n < frame_length_; n++) {
+        double hann = 0.5 - 0.5 * std::cos(2.0 * kPi * n / frame_length_);
+        window_[n] = static_cast<float>(std::sqrt(hann));
+    }
+    input_.assign(frame_length_, 0.0f);
+    overlap_.assign(frame_length_, 0.0f);
+    frame_.assign(frame_length_, 0.0f);
+    spectrum_.assign(bins_, std::complex<float>());
+    power_.assign(bins_, 0.0f);
+    smoothed_power_.assign(bins_, 0.0f);
+    noise_.assign(bins_, 0.0f);
+    gains_.assign(bins_, 1.0f);
+
+    reset();
+}
+
+// Forget everything learned about the stream
+void NoiseSuppressor::reset() {
+    noise_valid_ = false;
+    std::fill(gains_.begin(), gains_.end(), 1.0f);
+    input_position_ = 0;
+    output_position_ = 0;
+    restart();
+}
+
+// Restart the overlap-add state at the current position
+void NoiseSuppressor::restart() {
+    // Prime with one hop of zeros so the first frame completes after one hop
+    std::fill(input_.begin(), input_.end(), 0.0f);
+    std::fill(overlap_.begin(), overlap_.end(), 0.0f);
+    input_fill_ = frame_length_ - hop_;
+    discard_ = frame_length_ - hop_;
+}
+
+// Buffer input, process every completed frame and emit finished samples
+size_t NoiseSuppressor::process(const float* input, size_t count, float* output) {
+    size_t produced = 0;
+    while (count > 0) {
+        size_t take = std::min(count, frame_length_ - input_fill_);
+        std::memcpy(input_.data() + input_fill_, input, take * sizeof(float));
+        input_fill_ += take;
+        input += take;
+        count -= take;
+        input_position_ += take;
+
+        if (input_fill_ < frame_length_) {
+            break;
+        }
+        process_frame();
+
+        // The first hop of the accumulator now holds every contribution it will get
+        size_t skipped = std::min(discard_, hop_);
+        discard_ -= skipped;
+        std::memcpy(output + produced, overlap_.data() + skipped, (hop_ - skipped) * sizeof(float));
+        produced += hop_ - skipped;
+
+        std::memmove(overlap_.data(), overlap_.data() + hop_, (frame_length_ - hop_) * sizeof(float));
+        std::fill(overlap_.begin() + (frame_length_ - hop_), overlap_.end(), 0.0f);
+        std::memmove(input_.data(), input_.data() + hop_, (frame_length_ - hop_) * sizeof(float));
+        input_fill_ = frame_length_ - hop_;
+    }
+    output_position_ += produced;
+    return produced;
+}
+
+// Drop the buffered input and move both positions past the gap
+uint64_t NoiseSuppressor::skip(uint64_t frames) {
+    input_position_ += frames;
+    uint64_t lost = input_position_ - output_position_;
+    output_position_ = input_position_;
+    restart();
+    return lost;
+}
+
+// Analyse, attenuate and overlap-add one frame
+void NoiseSuppressor::process_frame() {
+    multiply(input_.data(), window_.data(), frame_.data(), frame_length_);
+    fft_.forward(frame_.data(), spectrum_.data());
+    magnitude_squared(spectrum_.data(), power_.data(), bins_);
+    update_gains();
+    scale_complex(spectrum_.data(), gains_.data(), bins_);
+    fft_.inverse(spectrum_.data(), frame_.data());
+    multiply_add(frame_.data(), window_.data(), overlap_.data(), frame_length_);
+}
+
+// Track the noise floor and derive the per-bin gains
+void NoiseSuppressor::update_gains() {
+    if (!noise_valid_) {
+        std::copy(power_.begin(), power_.end(), smoothed_power_.begin());
+        std::copy(power_.begin(), power_.end(), noise_.begin());
+        noise_valid_ = true;
+    }
+
+    const float smoothing = std::min(std::max(config_.gain_smoothing, 0.0f), 0.99f);
+    for (size_t k = 0; k < bins_; k++) {
+        float smoothed = kPowerSmoothing * smoothed_power_[k] + (1.0f - kPowerSmoothing) * power_[k];
+        smoothed_power_[k] = smoothed;
+        noise_[k] = std::min(std::max(noise_[k], kMinPower) * noise_rise_, smoothed);
+
+        float gain = 1.0f - config_.over_subtraction * noise_[k] / std::max(power_[k], kMinPower);
+        gain = std::max(gain, floor_gain_);
+        gains_[k] = smoothing * gains_[k] + (1.0f - smoothing) * gain;
+    }
+}
+
+} // namespace audio
+} // namespace koelingo
@@ -0,0 +1,130 @@
+/**
+ * @file noise_suppressor.h
+ * @brief Streaming spectral noise suppression
+ */
+
+#ifndef KOELINGO_NOISE_SUPPRESSOR_H
+#define KOELINGO_NOISE_SUPPRESSOR_H
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "fft.h"
+
+namespace koelingo {
+namespace audio {
+
+/**
+ * @struct NoiseSuppressionConfig
+ * @brief Tuning parameters for the noise suppressor
+ */
+struct NoiseSuppressionConfig {
+    bool enabled = false;              ///< Denoise the audio the VAD and STT see
+    int frame_ms = 20;                 ///< Analysis window length; frames overlap by half
+    float over_subtraction = 1.5f;     ///< Multiple of the noise estimate removed from each bin
+    float floor_db = -18.0f;           ///< Strongest attenuation applied to any bin
+    float noise_rise_db_per_s = 3.0f;  ///< How fast the noise estimate may rise
+    float gain_smoothing = 0.5f;       ///< Weight of the previous frame's gains (limits musical noise)
+};
+
+/**
+ * @class NoiseSuppressor
+ * @brief Spectral subtraction with a minimum-tracking noise estimate
+ *
+ * Audio is cut into sqrt-Hann windowed frames with 50% overlap. Each bin's
+ * noise power follows the smoothed power downwards immediately and upwards
+ * at most noise_rise_db_per_s, so it settles on the stationary background
+ * while speech passes over it. The bins are attenuated by the Wiener-style
+ * gain 1 - over_subtraction * noise / power and resynthesised by
+ * overlap-add.
+ *
+ * Output sample i is the denoised input sample i; it is produced
+ * latency_frames() samples later, once the frame that completes it has
+ * been analysed. No memory is allocated after configure(), so process()
+ * may run on the processing thread.
+ */
+class NoiseSuppressor {
+public:
+    NoiseSuppressor();
+
+    /**
+     * @brief Apply a configuration and reset the state
+     * @param config Suppressor parameters
+     * @param sample_rate Sample rate of the audio passed to process()
+     */
+    void configure(const NoiseSuppressionConfig& config, int sample_rate);
+
+    /**
+     * @brief Forget the noise estimate and any buffered audio
+     */
+    void reset();
+
+    /**
+     * @brief Denoise a block of mono audio
+     * @param input Mono samples in the range [-1.0, 1.0]
+     * @param count Number of samples; they follow the previous block directly
+     * @param output Receives the denoised samples; must hold count + hop() samples
+     * @return Number of samples written to output
+     */
+    size_t process(const float* input, size_t count, float* output);
+
+    /**
+     * @brief Jump over frames that were lost before they could be denoised
+     * @param frames Number of missing input frames
+     * @return Number of output frames that will never be produced: the
+     *         buffered input plus the missing frames
+     *
+     * The noise estimate is kept; the overlap state restarts after the gap.
+     */
+    uint64_t skip(uint64_t frames);
+
+    /**
+     * @brief Get the analysis window length in samples
+     */
+    size_t frame_length() const { return frame_length_; }
+
+    /**
+     * @brief Get the number of samples between frames
+     */
+    size_t hop() const { return hop_; }
+
+    /**
+     * @brief Get the delay between an input sample and its denoised output
+     */
+    size_t latency_frames() const { return frame_length_ - hop_; }
+
+private:
+    NoiseSuppressionConfig config_;
+    RealFft fft_;
+    size_t frame_length_;
+    size_t hop_;
+    size_t bins_;
+    float floor_gain_;
+    float noise_rise_; // Per-frame power ratio the noise estimate may grow by
+
+    std::vector<float> window_;                 // sqrt-Hann, used for analysis and synthesis
+    std::vector<float> input_;                  // Newest frame_length_ input samples
+    size_t input_fill_;
+    std::vector<float> overlap_;                // Overlap-add accumulator
+    std::vector<float> frame_;                  // Windowed frame / resynthesised frame
+    std::vector<std::complex<float>> spectrum_;
+    std::vector<float> power_;
+    std::vector<float> smoothed_power_;
+    std::vector<float> noise_;
+    std::vector<float> gains_;
+    bool noise_valid_;
+
+    uint64_t input_position_;  // Input samples consumed
+    uint64_t output_position_; // Output samples emitted
+    size_t discard_;           // Leading output samples that belong to the priming zeros
+
+    void restart();
+    void process_frame();
+    void update_gains();
+};
+
+} // namespace audio
+} // namespace koelingo
+
+#endif // KOELINGO_NOISE_SUPPRESSOR_H
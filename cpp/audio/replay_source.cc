@@ -0,0 +1,171 @@
+/**
+ * @file replay_source.cc
+ * @brief Implementation of the WAV/in-memory replay source
+ */
+
+#include "replay_source.h"
+#include "mapped_wav.h"
+#include "sample_format.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace koelingo {
+namespace audio {
+
+// Read a WAV file as normalized float32 samples
+bool read_wav_file(const std::string& path, std::vector<float>& samples, int& sample_rate,
+                   int& channels) {
+    MappedWav wav;
+    if (!wav.open(path)) {
+        return false;
+    }
+    sample_rate = wav.sample_rate();
+    channels = wav.channels();
+    samples.resize(static_cast<size_t>(wav.frames()) * static_cast<size_t>(channels));
+    convert_to_float32(wav.data(), samples.size(), wav.format_type(), samples.data());
+    return true;
+}
+
+// ReplaySource constructor
+ReplaySource::ReplaySource(std::vector<float> samples, int sample_rate, int channels)
+    : samples_(std::move(samples)),
+      sample_rate_(sample_rate),
+      channels_(std::max(1, channels)),
+      frames_(samples_.size() / static_cast<size_t>(std::max(1, channels))),
+      speed_(1.0),
+      frames_delivered_(0),
+      finished_(false) {
+}
+
+// ReplaySource destructor
+ReplaySource::~ReplaySource() {
+    stop();
+}
+
+// Load a WAV file for replay
+std::shared_ptr<ReplaySource> ReplaySource::from_wav(const std::string& path) {
+    std::vector<float> samples;
+    int sample_rate = 0;
+    int channels = 0;
+    if (!read_wav_file(path, samples, sample_rate, channels)) {
+        return nullptr;
+    }
+    return std::make_shared<ReplaySource>(std::move(samples), sample_rate, channels);
+}
+
+// Set the replay speed
+bool ReplaySource::set_speed(double speed) {
+    if (speed < 0.0) {
+        std::cerr << "Replay speed must not be negative" << std::endl;
+        return false;
+    }
+    speed_ = speed;
+
+    // Re-evaluate a pending sleep at the new speed
+    std::lock_guard<std::mutex> lock(mutex_);
+    wake_.notify_all();
+    return true;
+}
+
+// Loop the audio
+bool ReplaySource::set_loop(bool loop) {
+    if (thread_ && !finished_) {
+        std::cerr << "Cannot change looping while replaying" << std::endl;
+        return false;
+    }
+    loop_ = loop;
+    return true;
+}
+
+// Start delivering periods
+bool ReplaySource::start(InputSink* sink, size_t period_frames, int format_type) {
+    if (thread_ && !finished_) {
+        std::cerr << "Replay is already running" << std::endl;
+        return false;
+    }
+    stop(); // Join a replay that reached the end
+
+    // Encode once up front so delivery is a plain pointer bump
+    frame_bytes_ = bytes_per_sample(format_type) * channels_;
+    encoded_.resize(samples_.size() * bytes_per_sample(format_type));
+    convert_from_float32(samples_.data(), samples_.size(), format_type, encoded_.data());
+
+    sink_ = sink;
+    period_frames_ = std::max<size_t>(1, period_frames);
+    frames_delivered_ = 0;
+    finished_ = false;
+    stop_ = false;
+    thread_ = std::make_unique<std::thread>(&ReplaySource::run, this);
+    return true;
+}
+
+// Stop delivering
+void ReplaySource::stop() {
+    if (!thread_) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+        wake_.notify_all();
+    }
+    if (thread_->joinable()) {
+        thread_->join();
+    }
+    thread_.reset();
+}
+
+// Delivery thread
+void ReplaySource::run() {
+    using clock = std::chrono::steady_clock;
+    uint64_t position = 0;
+    clock::time_point next = clock::now();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+        if (position >= frames_) {
+            if (!loop_ || frames_ == 0) {
+                finished_ = true;
+                break;
+            }
+            position = 0;
+        }
+
+        size_t count = static_cast<size_t>(std::min<uint64_t>(period_frames_, frames_ - position));
+        InputPeriod period;
+        period.data = encoded_.data() + position * frame_bytes_;
+        period.frames = count;
+
+        // Deliver without the lock so stop() is never held up by the sink
+        lock.unlock();
+        sink_->on_input(period);
+        lock.lock();
+        position += count;
+        frames_delivered_ += count;
+
+        // Pace against an absolute schedule so sleeps do not drift
+        double speed = speed_;
+        if (speed <= 0.0) {
+            next = clock::now();
+            continue;
+        }
+        next += std::chrono::duration_cast<clock::duration>(
+            std::chrono::duration<double>(count / (sample_rate_ * speed)));
+        while (!stop_ && speed_ == speed && wake_.wait_until(lock, next) != std::cv_status::timeout) {
+        }
+
+        // After a stall or a speed change, resume from now instead of bursting
+        if (clock::now() - next > std::chrono::milliseconds(100) || speed_ != speed) {
+            next = clock::now();
+        }
+    }
+    lock.unlock();
+
+    if (finished_) {
+        sink_->on_input_end();
+    }
+}
+
+} // namespace audio
+} // namespace koelingo
@@ -0,0 +1,140 @@
+/**
+ * @file replay_source.h
+ * @brief Input source that replays WAV files or in-memory audio
+ */
+
+#ifndef KOELINGO_REPLAY_SOURCE_H
+#define KOELINGO_REPLAY_SOURCE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "input_source.h"
+
+namespace koelingo {
+namespace audio {
+
+/**
+ * @brief Read a WAV file as normalized float32 samples
+ * @param path File to read
+ * @param samples Receives the interleaved samples in [-1.0, 1.0]
+ * @param sample_rate Receives the sample rate in Hz
+ * @param channels Receives the channel count
+ * @return False if the file cannot be read or its encoding is unsupported
+ *
+ * Reads 8/16/24/32-bit PCM and 32-bit float, including WAVE_FORMAT_EXTENSIBLE.
+ */
+bool read_wav_file(const std::string& path, std::vector<float>& samples, int& sample_rate,
+                   int& channels);
+
+/**
+ * @class ReplaySource
+ * @brief Plays recorded audio into an AudioCapture in place of a microphone
+ *
+ * Delivers periods from a delivery thread paced at speed() times real
+ * time, or as fast as the sink accepts them when the speed is 0, so the
+ * whole pipeline can be load-tested deterministically without hardware.
+ * AudioCapture holds delivery back while processing is more than half a
+ * ring buffer behind, so no audio is dropped at any speed.
+ */
+class ReplaySource : public InputSource {
+public:
+    /**
+     * @brief Replay in-memory audio
+     * @param samples Interleaved samples in [-1.0, 1.0]
+     * @param sample_rate Sample rate in Hz
+     * @param channels Number of interleaved channels
+     */
+    ReplaySource(std::vector<float> samples, int sample_rate, int channels);
+
+    /**
+     * @brief Stop the delivery thread
+     */
+    ~ReplaySource() override;
+
+    ReplaySource(const ReplaySource&) = delete;
+    ReplaySource& operator=(const ReplaySource&) = delete;
+
+    /**
+     * @brief Load a WAV file for replay
+     * @param path File to read
+     * @return The source, or nullptr if the file cannot be read
+     */
+    static std::shared_ptr<ReplaySource> from_wav(const std::string& path);
+
+    /**
+     * @brief Set the replay speed
+     * @param speed Multiple of real time (1.0 = real time), or 0 for as fast as possible
+     * @return False if the speed is negative
+     *
+     * Takes effect immediately, also while replaying.
+     */
+    bool set_speed(double speed);
+
+    /**
+     * @brief Get the replay speed (0 = as fast as possible)
+     */
+    double speed() const { return speed_; }
+
+    /**
+     * @brief Start over from the beginning whenever the end is reached
+     * @param loop True to loop forever
+     * @return False while replaying (the setting is unchanged)
+     */
+    bool set_loop(bool loop);
+
+    /**
+     * @brief Check whether the audio loops
+     */
+    bool loop() const { return loop_; }
+
+    /**
+     * @brief Get the length of the audio in frames
+     */
+    uint64_t total_frames() const { return frames_; }
+
+    /**
+     * @brief Get the frames delivered since the last start()
+     */
+    uint64_t frames_delivered() const { return frames_delivered_; }
+
+    int sample_rate() const override { return sample_rate_; }
+    int channels() const override { return channels_; }
+    bool start(InputSink* sink, size_t period_frames, int format_type) override;
+    void stop() override;
+    bool finished() const override { return finished_; }
+
+private:
+    std::vector<float> samples_;
+    int sample_rate_;
+    int channels_;
+    uint64_t frames_;
+
+    std::atomic<double> speed_;
+    bool loop_ = false;
+
+    // Delivery state
+    std::vector<char> encoded_; // samples_ in the sink's sample format
+    size_t frame_bytes_ = 0;
+    size_t period_frames_ = 0;
+    InputSink* sink_ = nullptr;
+    std::atomic<uint64_t> frames_delivered_;
+    std::atomic<bool> finished_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stop_ = false;
+    std::unique_ptr<std::thread> thread_;
+
+    void run();
+};
+
+} // namespace audio
+} // namespace koelingo
+
+#endif // KOELINGO_REPLAY_SOURCE_H
@@ -0,0 +1,194 @@
+/**
+ * @file resampler.cc
+ * @brief Implementation of the polyphase resampler
+ */
+
+#include "resampler.h"
+#include "sample_format.h"
+#include "vector_math.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+
+namespace koelingo {
+namespace audio {
+
+namespace {
+
+// Largest number of filter phases we are willing to tabulate
+constexpr uint32_t kMaxPhases = 1024;
+
+// Kaiser window shape; about 75 dB of stopband attenuation
+constexpr double kKaiserBeta = 7.5;
+
+// Passband edge as a fraction of the lower Nyquist frequency
+constexpr double kRolloff = 0.9;
+
+constexpr double kPi = 3.14159265358979323846;
+
+// Zeroth-order modified Bessel function of the first kind
+double bessel_i0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 50; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-12) {
+            break;
+        }
+    }
+    return sum;
+}
+
+} // namespace
+
+// Resampler constructor
+Resampler::Resampler()
+    : interpolation_(0),
+      decimation_(0),
+      input_channels_(1),
+      input_format_(0),
+      input_frame_bytes_(0),
+      taps_(0),
+      max_block_(0),
+      history_fill_(0),
+      base_(0),
+      phase_(0) {
+}
+
+// Design the filter for a rate pair
+bool Resampler::configure(int input_rate, int output_rate, int input_channels, int input_format,
+                          size_t max_input_frames, int zero_crossings) {
+    interpolation_ = 0;
+    if (input_rate <= 0 || output_rate <= 0 || input_channels <= 0 || max_input_frames == 0) {
+        std::cerr << "Invalid resampler configuration" << std::endl;
+        return false;
+    }
+
+    uint32_t divisor = static_cast<uint32_t>(std::gcd(input_rate, output_rate));
+    uint32_t interpolation = static_cast<uint32_t>(output_rate) / divisor;
+    if (interpolation > kMaxPhases) {
+        std::cerr << "Unsupported resampling ratio " << input_rate << " -> " << output_rate << std::endl;
+        return false;
+    }
+
+    interpolation_ = interpolation;
+    decimation_ = static_cast<uint32_t>(input_rate) / divisor;
+    input_channels_ = input_channels;
+    input_format_ = input_format;
+    input_frame_bytes_ = bytes_per_sample(input_format) * input_channels;
+    max_block_ = max_input_frames;
+
+    design_filter(std::max(zero_crossings, 2));
+
+    history_.assign(taps_ - 1 + max_block_, 0.0f);
+    reset();
+    return true;
+}
+
+// Build the windowed-sinc prototype and split it into phases
+void Resampler::design_filter(int zero_crossings) {
+    const double ratio = static_cast<double>(decimation_) / interpolation_;
+
+    // When decimating the sinc widens to stay below the output Nyquist
+    size_t taps = static_cast<size_t>(std::ceil(2.0 * zero_crossings * std::max(1.0, ratio)));
+    taps_ = (taps + 3) & ~static_cast<size_t>(3); // Whole SIMD vectors
+
+    const size_t length = taps_ * interpolation_;
+    const double center = (length - 1) / 2.0;
+    // Cutoff in cycles per sample at the upsampled rate
+    const double cutoff = kRolloff * 0.5 / std::max<double>(interpolation_, decimation_);
+    const double window_norm = bessel_i0(kKaiserBeta);
+
+    filters_.assign(length, 0.0f);
+    for (uint32_t phase = 0; phase < interpolation_; phase++) {
+        float* row = filters_.data() + phase * taps_;
+        double sum = 0.0;
+        for (size_t k = 0; k < taps_; k++) {
+            // Row entry k multiplies input sample (newest - (taps - 1 - k))
+            size_t n = (taps_ - 1 - k) * interpolation_ + phase;
+            double x = n - center;
+            double sinc = x == 0.0 ? 1.0 : std::sin(2.0 * kPi * cutoff * x) / (2.0 * kPi * cutoff * x);
+            double r = x / (center + 0.5);
+            double window = bessel_i0(kKaiserBeta * std::sqrt(std::max(0.0, 1.0 - r * r))) / window_norm;
+            row[k] = static_cast<float>(sinc * window);
+            sum += row[k];
+        }
+
+        // Normalize every phase to unity DC gain
+        for (size_t k = 0; k < taps_; k++) {
+            row[k] = static_cast<float>(row[k] / sum);
+        }
+    }
+}
+
+// Clear the filter history
+void Resampler::reset() {
+    std::fill(history_.begin(), history_.end(), 0.0f);
+    history_fill_ = taps_ > 0 ? taps_ - 1 : 0;
+    base_ = history_fill_;
+    phase_ = 0;
+}
+
+// Upper bound on the output of one block
+size_t Resampler::max_output_frames(size_t input_frames) const {
+    if (!is_configured()) {
+        return 0;
+    }
+    return input_frames * interpolation_ / decimation_ + 2;
+}
+
+// Constant group delay of the filter in output frames
+size_t Resampler::latency_frames() const {
+    if (!is_configured()) {
+        return 0;
+    }
+    return (taps_ * interpolation_ / 2) / decimation_;
+}
+
+// Resample a block of frames to mono
+size_t Resampler::process(const char* input, size_t frames, float* output, size_t max_output) {
+    if (!is_configured()) {
+        return 0;
+    }
+
+    size_t produced = 0;
+    while (frames > 0) {
+        // Downmix and convert straight into the filter history
+        size_t space = history_.size() - history_fill_;
+        size_t block = std::min(frames, space);
+        if (block == 0) {
+            break; // Output buffer was too small to drain the history
+        }
+        convert_to_mono_float32(input, block, input_channels_, input_format_,
+                                history_.data() + history_fill_);
+        history_fill_ += block;
+        input += block * input_frame_bytes_;
+        frames -= block;
+
+        // Evaluate every output sample whose newest input has arrived
+        while (base_ < history_fill_ && produced < max_output) {
+            const float* window = history_.data() + base_ - (taps_ - 1);
+            output[produced++] = dot_product(filters_.data() + phase_ * taps_, window, taps_);
+
+            phase_ += decimation_;
+            base_ += phase_ / interpolation_;
+            phase_ %= interpolation_;
+        }
+
+        // Keep only the history the next output still needs
+        size_t discard = std::min(base_ - (taps_ - 1), history_fill_);
+        if (discard > 0) {
+            std::memmove(history_.data(), history_.data() + discard,
+                         (history_fill_ - discard) * sizeof(float));
+            history_fill_ -= discard;
+            base_ -= discard;
+        }
+    }
+    return produced;
+}
+
+} // namespace audio
+} // namespace koelingo
@@ -0,0 +1,105 @@
+/**
+ * @file resampler.h
+ * @brief Streaming polyphase sample rate converter with mono downmix
+ */
+
+#ifndef KOELINGO_RESAMPLER_H
+#define KOELINGO_RESAMPLER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace koelingo {
+namespace audio {
+
+/**
+ * @class Resampler
+ * @brief Windowed-sinc polyphase resampler for a fixed rational ratio
+ *
+ * Converts interleaved frames of any PortAudio sample format and channel
+ * count to mono float32 at the output rate. Conversion to float and the
+ * downmix happen while the input is copied into the filter history, and
+ * the polyphase filter is then evaluated with SIMD dot products.
+ *
+ * All memory is allocated in configure(), so process() is real-time safe.
+ * The group delay is constant and reported by latency_frames().
+ */
+class Resampler {
+public:
+    Resampler();
+
+    /**
+     * @brief Design the filter and reset the stream state
+     * @param input_rate Sample rate of the frames passed to process()
+     * @param output_rate Sample rate of the produced samples
+     * @param input_channels Number of interleaved input channels (averaged to mono)
+     * @param input_format PortAudio sample format of the input
+     * @param max_input_frames Largest block process() will be called with;
+     *        larger blocks are handled in pieces
+     * @param zero_crossings Half-width of the sinc in periods of the lower
+     *        of the two rates (quality vs. cost)
+     * @return False if the rates are invalid or the ratio is too complex
+     */
+    bool configure(int input_rate, int output_rate, int input_channels, int input_format,
+                   size_t max_input_frames, int zero_crossings = 24);
+
+    /**
+     * @brief Forget the filter history
+     */
+    void reset();
+
+    /**
+     * @brief Resample a block of interleaved frames
+     * @param input Interleaved frames in the configured format
+     * @param frames Number of input frames
+     * @param output Destination for mono float32 samples
+     * @param max_output Capacity of output; use max_output_frames(frames)
+     * @return Number of samples written to output
+     */
+    size_t process(const char* input, size_t frames, float* output, size_t max_output);
+
+    /**
+     * @brief Get the most output samples a block of input can produce
+     * @param input_frames Number of input frames
+     */
+    size_t max_output_frames(size_t input_frames) const;
+
+    /**
+     * @brief Get the fixed delay added by the filter, in output frames
+     */
+    size_t latency_frames() const;
+
+    /**
+     * @brief Check whether configure() succeeded
+     */
+    bool is_configured() const { return interpolation_ > 0; }
+
+private:
+    // Ratio output/input = interpolation_ / decimation_ in lowest terms
+    uint32_t interpolation_;
+    uint32_t decimation_;
+    int input_channels_;
+    int input_format_;
+    size_t input_frame_bytes_;
+    size_t taps_;
+    size_t max_block_;
+
+    // One row of taps_ coefficients per phase, stored in time order
+    std::vector<float> filters_;
+
+    // Mono input: taps_ - 1 samples of history followed by the current block
+    std::vector<float> history_;
+    size_t history_fill_;
+
+    // Position of the next output sample: newest input index and phase
+    size_t base_;
+    uint32_t phase_;
+
+    void design_filter(int zero_crossings);
+};
+
+} // namespace audio
+} // namespace koelingo
+
+#endif // KOELINGO_RESAMPLER_H
@@ -0,0 +1,163 @@
+/**
+ * @file ring_buffer.cc
+ * @brief Implementation of the RingBuffer class
+ */
+
+#include "ring_buffer.h"
+#include <algorithm>
+#include <cstring>
+
+namespace koelingo {
+namespace audio {
+
+// RingBuffer constructor
+RingBuffer::RingBuffer(size_t capacity)
+    : data_(nullptr),
+      capacity_(0),
+      write_pos_(0),
+      reserve_pos_(0) {
+    resize(capacity);
+}
+
+// Reallocate the storage
+void RingBuffer::resize(size_t capacity) {
+    data_.reset(capacity > 0 ? new char[capacity]() : nullptr);
+    capacity_ = capacity;
+    reset();
+}
+
+// Discard all data
+void RingBuffer::reset() {
+    write_pos_.store(0, std::memory_order_relaxed);
+    reserve_pos_.store(0, std::memory_order_release);
+}
+
+// Append data from the producer thread
+void RingBuffer::write(const void* data, size_t size) {
+    if (capacity_ == 0 || size == 0) {
+        return;
+    }
+
+    const char* src = static_cast<const char*>(data);
+    uint64_t pos = write_pos_.load(std::memory_order_relaxed);
+    const uint64_t end = pos + size;
+
+    // Only the newest capacity_ bytes can survive a single write
+    if (size > capacity_) {
+        src += size - capacity_;
+        pos += size - capacity_;
+        size = capacity_;
+    }
+
+    // Announce the region being overwritten before touching it, so readers
+    // can detect that their data was clobbered
+    reserve_pos_.store(end, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    size_t offset = static_cast<size_t>(pos % capacity_);
+    size_t first = std::min(size, capacity_ - offset);
+    std::memcpy(data_.get() + offset, src, first);
+    if (first < size) {
+        std::memcpy(data_.get(), src + first, size - first);
+    }
+
+    write_pos_.store(end, std::memory_order_release);
+}
+
+// Append a run of one repeated byte
+void RingBuffer::fill(unsigned char value, size_t size) {
+    if (capacity_ == 0 || size == 0) {
+        return;
+    }
+
+    uint64_t pos = write_pos_.load(std::memory_order_relaxed);
+    const uint64_t end = pos + size;
+    if (size > capacity_) {
+        pos += size - capacity_;
+        size = capacity_;
+    }
+
+    reserve_pos_.store(end, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    size_t offset = static_cast<size_t>(pos % capacity_);
+    size_t first = std::min(size, capacity_ - offset);
+    std::memset(data_.get() + offset, value, first);
+    if (first < size) {
+        std::memset(data_.get(), value, size - first);
+    }
+
+    write_pos_.store(end, std::memory_order_release);
+}
+
+// Get the oldest retained position
+uint64_t RingBuffer::oldest_position() const {
+    uint64_t pos = write_position();
+    return pos > capacity_ ? pos - capacity_ : 0;
+}
+
+// Get views over a range of the buffer
+RingBufferSpans RingBuffer::read_spans(uint64_t from, uint64_t to) const {
+    RingBufferSpans spans;
+
+    uint64_t newest = write_position();
+    uint64_t oldest = newest > capacity_ ? newest - capacity_ : 0;
+    to = std::min(to, newest);
+    from = std::min(std::max(from, oldest), to);
+
+    spans.start = from;
+    if (capacity_ == 0 || from >= to) {
+        return spans;
+    }
+
+    size_t size = static_cast<size_t>(to - from);
+    size_t offset = static_cast<size_t>(from % capacity_);
+    spans.first = data_.get() + offset;
+    spans.first_size = std::min(size, capacity_ - offset);
+    if (spans.first_size < size) {
+        spans.second = data_.get();
+        spans.second_size = size - spans.first_size;
+    }
+
+    return spans;
+}
+
+// Check whether previously read data is still valid
+bool RingBuffer::is_intact(uint64_t position) const {
+    // Pairs with the release fence in write(): if any of the data we read
+    // came from an in-flight write, we are guaranteed to see its reservation
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t reserved = reserve_pos_.load(std::memory_order_relaxed);
+    return reserved <= capacity_ || position >= reserved - capacity_;
+}
+
+// Copy a range of the buffer out
+uint64_t RingBuffer::copy(uint64_t from, uint64_t to, void* dst) const {
+    char* out = static_cast<char*>(dst);
+
+    while (true) {
+        // Data always lands at the front of dst, even if the start was clamped
+        RingBufferSpans spans = read_spans(from, to);
+        if (spans.size() == 0) {
+            // Nothing left in range (possibly all of it was overwritten)
+            return spans.start;
+        }
+
+        if (spans.first_size > 0) {
+            std::memcpy(out, spans.first, spans.first_size);
+        }
+        if (spans.second_size > 0) {
+            std::memcpy(out + spans.first_size, spans.second, spans.second_size);
+        }
+
+        if (is_intact(spans.start)) {
+            return spans.start;
+        }
+
+        // The writer lapped us while copying; retry from the new oldest byte
+        from = reserve_pos_.load(std::memory_order_relaxed) - capacity_;
+    }
+}
+
+} // namespace audio
+} // namespace koelingo
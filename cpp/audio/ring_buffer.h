@@ -0,0 +1,157 @@
+/**
+ * @file ring_buffer.h
+ * @brief Lock-free single-producer ring buffer for captured audio
+ */
+
+#ifndef KOELINGO_RING_BUFFER_H
+#define KOELINGO_RING_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace koelingo {
+namespace audio {
+
+/**
+ * @struct RingBufferSpans
+ * @brief Contiguous views over a range of the ring buffer
+ *
+ * A range that crosses the end of the storage is returned as two spans;
+ * otherwise the second span is empty.
+ */
+struct RingBufferSpans {
+    const char* first = nullptr;  ///< Start of the first contiguous region
+    size_t first_size = 0;        ///< Size of the first region in bytes
+    const char* second = nullptr; ///< Start of the wrapped region (may be null)
+    size_t second_size = 0;       ///< Size of the wrapped region in bytes
+    uint64_t start = 0;           ///< Absolute stream position of the first byte
+
+    /**
+     * @brief Total number of bytes covered by both spans
+     */
+    size_t size() const { return first_size + second_size; }
+};
+
+/**
+ * @class RingBuffer
+ * @brief Preallocated, allocation-free ring buffer with a single writer
+ *
+ * The writer (the PortAudio callback) only performs a memcpy and publishes
+ * the new write position with an atomic store, so it never blocks or
+ * allocates. When the buffer is full the oldest data is overwritten.
+ *
+ * Positions are absolute byte offsets into the stream since the last
+ * reset() and only ever grow. Readers never modify the buffer, so any
+ * number of readers may run concurrently with the writer. Because data can
+ * be overwritten while a reader is looking at it, readers that consume
+ * spans in place must call is_intact() afterwards to confirm the data they
+ * used was still valid.
+ */
+class RingBuffer {
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Size of the storage in bytes
+     */
+    explicit RingBuffer(size_t capacity = 0);
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    /**
+     * @brief Reallocate the storage and reset positions
+     * @param capacity New size of the storage in bytes
+     *
+     * Must not be called while the writer is active.
+     */
+    void resize(size_t capacity);
+
+    /**
+     * @brief Discard all data and reset positions to zero
+     *
+     * Must not be called while the writer is active.
+     */
+    void reset();
+
+    /**
+     * @brief Get the size of the storage in bytes
+     */
+    size_t capacity() const { return capacity_; }
+
+    /**
+     * @brief Get the storage, e.g. to lock it in memory
+     */
+    void* storage() { return data_.get(); }
+
+    /**
+     * @brief Append data, overwriting the oldest bytes if necessary
+     * @param data Source data
+     * @param size Number of bytes to append
+     *
+     * Wait-free; must only be called from the single producer thread.
+     */
+    void write(const void* data, size_t size);
+
+    /**
+     * @brief Append a run of one repeated byte, e.g. silence
+     * @param value Byte to append
+     * @param size Number of bytes to append
+     *
+     * Wait-free; must only be called from the single producer thread.
+     */
+    void fill(unsigned char value, size_t size);
+
+    /**
+     * @brief Get the absolute position one past the newest published byte
+     */
+    uint64_t write_position() const { return write_pos_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Get the absolute position of the oldest byte still retained
+     */
+    uint64_t oldest_position() const;
+
+    /**
+     * @brief Get views over the absolute range [from, to)
+     * @param from Absolute start position (clamped to the oldest retained byte)
+     * @param to Absolute end position (clamped to the write position)
+     * @return Spans covering the available part of the range
+     */
+    RingBufferSpans read_spans(uint64_t from, uint64_t to) const;
+
+    /**
+     * @brief Check whether data starting at a position has not been overwritten
+     * @param position Absolute position of the first byte that was read
+     * @return True if every byte from position onwards that was read before
+     *         this call is still valid
+     */
+    bool is_intact(uint64_t position) const;
+
+    /**
+     * @brief Copy the absolute range [from, to) into a destination buffer
+     * @param from Absolute start position
+     * @param to Absolute end position (at most write_position())
+     * @param dst Destination with room for at least (to - from) bytes
+     * @return Absolute position of the first byte copied. Bytes that were
+     *         already overwritten are skipped, so (to - result) bytes are
+     *         valid at the start of dst.
+     */
+    uint64_t copy(uint64_t from, uint64_t to, void* dst) const;
+
+private:
+    std::unique_ptr<char[]> data_;
+    size_t capacity_;
+
+    // Published write position; bytes before it are readable
+    alignas(64) std::atomic<uint64_t> write_pos_;
+    // Position the writer is currently filling up to; bytes older than
+    // (reserve_pos_ - capacity_) may be getting overwritten
+    std::atomic<uint64_t> reserve_pos_;
+};
+
+} // namespace audio
+} // namespace koelingo
+
+#endif // KOELINGO_RING_BUFFER_H
@@ -0,0 +1,165 @@
+/**
+ * @file sample_format.cc
+ * @brief Implementation of the sample format helpers
+ */
+
+#include "sample_format.h"
+#include <portaudio.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace koelingo {
+namespace audio {
+
+// Size of one sample in bytes for a PortAudio sample format
+size_t bytes_per_sample(int format_type) {
+    switch (format_type) {
+        case paInt8:
+        case paUInt8:
+            return 1;
+        case paInt16:
+            return 2;
+        case paInt24:
+            return 3;
+        default:
+            return 4; // paFloat32, paInt32
+    }
+}
+
+// Convert raw samples of a PortAudio sample format to normalized float32
+void convert_to_float32(const char* src, size_t sample_count, int format_type, float* dst) {
+    if (sample_count == 0) {
+        return;
+    }
+
+    switch (format_type) {
+        case paFloat32:
+            std::memcpy(dst, src, sample_count * sizeof(float));
+            break;
+        case paInt32: {
+            const int32_t* samples = reinterpret_cast<const int32_t*>(src);
+            for (size_t i = 0; i < sample_count; i++) {
+                dst[i] = static_cast<float>(samples[i]) / 2147483648.0f;
+            }
+            break;
+        }
+        case paInt16: {
+            const int16_t* samples = reinterpret_cast<const int16_t*>(src);
+            for (size_t i = 0; i < sample_count; i++) {
+                dst[i] = samples[i] / 32768.0f;
+            }
+            break;
+        }
+        case paInt24: {
+            // Packed little-endian; shift into the top of an int32 to sign-extend
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(src);
+            for (size_t i = 0; i < sample_count; i++, bytes += 3) {
+                uint32_t packed = (static_cast<uint32_t>(bytes[0]) << 8) |
+                                  (static_cast<uint32_t>(bytes[1]) << 16) |
+                                  (static_cast<uint32_t>(bytes[2]) << 24);
+                dst[i] = static_cast<float>(static_cast<int32_t>(packed)) / 2147483648.0f;
+            }
+            break;
+        }
+        case paInt8: {
+            const int8_t* samples = reinterpret_cast<const int8_t*>(src);
+            for (size_t i = 0; i < sample_count; i++) {
+                dst[i] = samples[i] / 128.0f;
+            }
+            break;
+        }
+        case paUInt8: {
+            const uint8_t* samples = reinterpret_cast<const uint8_t*>(src);
+            for (size_t i = 0; i < sample_count; i++) {
+                dst[i] = (static_cast<int>(samples[i]) - 128) / 128.0f;
+            }
+            break;
+        }
+        default:
+            std::fill(dst, dst + sample_count, 0.0f);
+            break;
+    }
+}
+
+// Convert interleaved frames to mono float32 by averaging the channels
+void convert_to_mono_float32(const char* src, size_t frame_count, int channels,
+                             int format_type, float* dst) {
+    if (channels <= 1) {
+        convert_to_float32(src, frame_count, format_type, dst);
+        return;
+    }
+
+    // Convert one frame at a time so no temporary buffer is needed
+    const size_t frame_bytes = bytes_per_sample(format_type) * channels;
+    const float scale = 1.0f / channels;
+    float frame[8];
+    for (size_t i = 0; i < frame_count; i++) {
+        const char* in = src + i * frame_bytes;
+        float sum = 0.0f;
+        for (int c = 0; c < channels; c += 8) {
+            int n = std::min(8, channels - c);
+            convert_to_float32(in + c * bytes_per_sample(format_type), n, format_type, frame);
+            for (int k = 0; k < n; k++) {
+                sum += frame[k];
+            }
+        }
+        dst[i] = sum * scale;
+    }
+}
+
+// Convert normalized float32 samples back to a PortAudio sample format
+void convert_from_float32(const float* src, size_t sample_count, int format_type, char* dst) {
+    if (sample_count == 0) {
+        return;
+    }
+
+    switch (format_type) {
+        case paFloat32:
+            std::memcpy(dst, src, sample_count * sizeof(float));
+            break;
+        case paInt32:
+            for (size_t i = 0; i < sample_count; i++) {
+                // Go through double: float cannot represent INT32_MAX
+                double value = std::clamp(static_cast<double>(src[i]), -1.0, 1.0) * 2147483648.0;
+                int32_t sample = static_cast<int32_t>(std::min(std::lround(value), 2147483647L));
+                std::memcpy(dst + i * sizeof(sample), &sample, sizeof(sample));
+            }
+            break;
+        case paInt16:
+            for (size_t i = 0; i < sample_count; i++) {
+                float value = std::clamp(src[i], -1.0f, 1.0f) * 32768.0f;
+                int16_t sample = static_cast<int16_t>(std::min(std::lround(value), 32767L));
+                std::memcpy(dst + i * sizeof(sample), &sample, sizeof(sample));
+            }
+            break;
+        case paInt24:
+            for (size_t i = 0; i < sample_count; i++) {
+                float value = std::clamp(src[i], -1.0f, 1.0f) * 8388608.0f;
+                int32_t sample = static_cast<int32_t>(std::min(std::lround(value), 8388607L));
+                dst[i * 3] = static_cast<char>(sample & 0xFF);
+                dst[i * 3 + 1] = static_cast<char>((sample >> 8) & 0xFF);
+                dst[i * 3 + 2] = static_cast<char>((sample >> 16) & 0xFF);
+            }
+            break;
+        case paInt8:
+            for (size_t i = 0; i < sample_count; i++) {
+                float value = std::clamp(src[i], -1.0f, 1.0f) * 128.0f;
+                dst[i] = static_cast<char>(std::min(std::lround(value), 127L));
+            }
+            break;
+        case paUInt8:
+            for (size_t i = 0; i < sample_count; i++) {
+                float value = std::clamp(src[i], -1.0f, 1.0f) * 128.0f;
+                dst[i] = static_cast<char>(std::min(std::lround(value), 127L) + 128);
+            }
+            break;
+        default:
+            std::fill(dst, dst + sample_count * bytes_per_sample(format_type), 0);
+            break;
+    }
+}
+
+} // namespace audio
+} // namespace koelingo
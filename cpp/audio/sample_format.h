@@ -0,0 +1,57 @@
+/**
+ * @file sample_format.h
+ * @brief Helpers for PortAudio sample formats
+ */
+
+#ifndef KOELINGO_SAMPLE_FORMAT_H
+#define KOELINGO_SAMPLE_FORMAT_H
+
+#include <cstddef>
+
+namespace koelingo {
+namespace audio {
+
+/**
+ * @brief Get the size of one sample in bytes
+ * @param format_type PortAudio sample format (e.g. 8 for paInt16)
+ * @return Bytes per sample
+ */
+size_t bytes_per_sample(int format_type);
+
+/**
+ * @brief Convert raw samples to normalized float32
+ * @param src Raw samples in the given format
+ * @param sample_count Number of samples (not frames) to convert
+ * @param format_type PortAudio sample format of src
+ * @param dst Destination for sample_count floats in the range [-1.0, 1.0]
+ *
+ * Unsupported formats produce silence.
+ */
+void convert_to_float32(const char* src, size_t sample_count, int format_type, float* dst);
+
+/**
+ * @brief Convert interleaved raw frames to normalized mono float32
+ * @param src Interleaved frames in the given format
+ * @param frame_count Number of frames to convert
+ * @param channels Number of interleaved channels in src
+ * @param format_type PortAudio sample format of src
+ * @param dst Destination for frame_count floats (channel average)
+ */
+void convert_to_mono_float32(const char* src, size_t frame_count, int channels,
+                             int format_type, float* dst);
+
+/**
+ * @brief Convert normalized float32 samples to a PortAudio sample format
+ * @param src Samples in the range [-1.0, 1.0] (values outside are clamped)
+ * @param sample_count Number of samples to convert
+ * @param format_type PortAudio sample format of dst
+ * @param dst Destination for sample_count samples in the given format
+ *
+ * Unsupported formats produce zeroed output.
+ */
+void convert_from_float32(const float* src, size_t sample_count, int format_type, char* dst);
+
+} // namespace audio
+} // namespace koelingo
+
+#endif // KOELINGO_SAMPLE_FORMAT_H
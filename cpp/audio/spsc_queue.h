@@ -0,0 +1,103 @@
+/**
+ * @file spsc_queue.h
+ * @brief Bounded lock-free single-producer/single-consumer queue
+ */
+
+#ifndef KOELINGO_SPSC_QUEUE_H
+#define KOELINGO_SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace koelingo {
+namespace audio {
+
+/**
+ * @class SpscQueue
+ * @brief Fixed-capacity queue for passing small records between two threads
+ *
+ * Storage is allocated once in the constructor; push() and pop() never
+ * allocate or block, so the producer may be a real-time thread.
+ *
+ * @tparam T Copyable element type
+ */
+template <typename T>
+class SpscQueue {
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Maximum number of queued elements
+     */
+    explicit SpscQueue(size_t capacity)
+        : slots_(capacity + 1),
+          head_(0),
+          tail_(0) {
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+     * @brief Append an element (producer thread only)
+     * @param item Element to append
+     * @return False if the queue is full
+     */
+    bool push(const T& item) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t next = (tail + 1) % slots_.size();
+        if (next == head_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        slots_[tail] = item;
+        tail_.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Remove the oldest element (consumer thread only)
+     * @param item Receives the element
+     * @return False if the queue is empty
+     */
+    bool pop(T& item) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = slots_[head];
+        head_.store((head + 1) % slots_.size(), std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Get the number of queued elements (approximate while in use)
+     */
+    size_t size() const {
+        size_t head = head_.load(std::memory_order_acquire);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        return (tail + slots_.size() - head) % slots_.size();
+    }
+
+    /**
+     * @brief Get the maximum number of queued elements
+     */
+    size_t capacity() const { return slots_.size() - 1; }
+
+    /**
+     * @brief Drop all elements; neither side may be active
+     */
+    void clear() {
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_release);
+    }
+
+private:
+    std::vector<T> slots_;
+    alignas(64) std::atomic<size_t> head_; // Next slot to pop (consumer-owned)
+    alignas(64) std::atomic<size_t> tail_; // Next slot to fill (producer-owned)
+};
+
+} // namespace audio
+} // namespace koelingo
+
+#endif // KOELINGO_SPSC_QUEUE_H
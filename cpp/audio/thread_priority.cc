@@ -0,0 +1,227 @@
+/**
+ * @file thread_priority.cc
+ * @brief Implementation of real-time scheduling, CPU pinning and memory locking
+ */
+
+#include "thread_priority.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <avrt.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#include <mach/mach_time.h>
+#include <mach/thread_policy.h>
+#endif
+
+namespace koelingo {
+namespace audio {
+
+namespace {
+
+constexpr size_t kPageBytes = 4096; // Touching every 4 KiB covers any page size
+
+void add_error(std::string& errors, const std::string& error) {
+    if (!errors.empty()) {
+        errors += "; ";
+    }
+    errors += error;
+}
+
+// Request real-time scheduling for the calling thread
+bool set_realtime(const ThreadPolicy& policy, std::string& error) {
+#if defined(_WIN32)
+    (void)policy;
+    DWORD task_index = 0;
+    HANDLE task = AvSetMmThreadCharacteristicsW(L"Pro Audio", &task_index);
+    if (!task) {
+        error = "MMCSS registration failed (error " + std::to_string(GetLastError()) + ")";
+        return false;
+    }
+    AvSetMmThreadPriority(task, AVRT_PRIORITY_HIGH);
+    return true;
+#elif defined(__APPLE__)
+    mach_timebase_info_data_t timebase;
+    mach_timebase_info(&timebase);
+    double ticks_per_ms = 1e6 * timebase.denom / timebase.numer;
+    double period = std::max(1.0, policy.period_ms) * ticks_per_ms;
+
+    // Ask for up to half of each period, finished within the period
+    thread_time_constraint_policy_data_t constraint;
+    constraint.period = static_cast<uint32_t>(period);
+    constraint.computation = static_cast<uint32_t>(std::min(period / 2, 50.0 * ticks_per_ms));
+    constraint.constraint = static_cast<uint32_t>(period);
+    constraint.preemptible = 1;
+    kern_return_t result = thread_policy_set(pthread_mach_thread_np(pthread_self()),
+                                             THREAD_TIME_CONSTRAINT_POLICY,
+                                             reinterpret_cast<thread_policy_t>(&constraint),
+                                             THREAD_TIME_CONSTRAINT_POLICY_COUNT);
+    if (result != KERN_SUCCESS) {
+        error = "time-constraint policy refused (kern_return " + std::to_string(result) + ")";
+        return false;
+    }
+    return true;
+#else
+    sched_param param;
+    std::memset(&param, 0, sizeof(param));
+    int lowest = sched_get_priority_min(SCHED_FIFO);
+    int highest = sched_get_priority_max(SCHED_FIFO);
+    param.sched_priority = std::clamp(policy.priority > 0 ? policy.priority : 70, lowest, highest);
+
+    int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (result == EPERM) {
+        error = "SCHED_FIFO needs CAP_SYS_NICE or an rtprio limit (ulimit -r)";
+        return false;
+    }
+    if (result != 0) {
+        error = std::string("SCHED_FIFO refused: ") + std::strerror(result);
+        return false;
+    }
+    return true;
+#endif
+}
+
+// Pin the calling thread to a set of CPUs
+bool set_affinity(const std::vector<int>& cpus, std::string& error) {
+#if defined(_WIN32)
+    DWORD_PTR mask = 0;
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < static_cast<int>(sizeof(DWORD_PTR) * 8)) {
+            mask |= static_cast<DWORD_PTR>(1) << cpu;
+        }
+    }
+    if (!mask || !SetThreadAffinityMask(GetCurrentThread(), mask)) {
+        error = "CPU affinity refused";
+        return false;
+    }
+    return true;
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    int result = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (result != 0) {
+        error = std::string("CPU affinity refused: ") + std::strerror(result);
+        return false;
+    }
+    return true;
+#else
+    (void)cpus;
+    error = "CPU pinning is not supported on this platform";
+    return false;
+#endif
+}
+
+} // namespace
+
+// Apply a policy to the calling thread
+ThreadPolicyResult apply_thread_policy(const ThreadPolicy& policy) {
+    ThreadPolicyResult result;
+    std::string error;
+    if (policy.realtime) {
+        result.realtime = set_realtime(policy, error);
+        if (!result.realtime) {
+            add_error(result.error, error);
+        }
+    }
+    if (!policy.cpus.empty()) {
+        result.pinned = set_affinity(policy.cpus, error);
+        if (!result.pinned) {
+            add_error(result.error, error);
+        }
+    }
+    return result;
+}
+
+// Fault in and lock memory
+bool lock_memory(void* data, size_t bytes, std::string* error) {
+    if (!data || bytes == 0) {
+        return true;
+    }
+
+    // Touch every page so the first callbacks do not take page faults
+    volatile char* pages = static_cast<volatile char*>(data);
+    for (size_t offset = 0; offset < bytes; offset += kPageBytes) {
+        pages[offset] = pages[offset];
+    }
+
+#if defined(_WIN32)
+    if (!VirtualLock(data, bytes)) {
+        if (error) {
+            *error = "VirtualLock failed (error " + std::to_string(GetLastError()) +
+                     "); the working set may be too small";
+        }
+        return false;
+    }
+#else
+    if (mlock(data, bytes) != 0) {
+        if (error) {
+            *error = errno == EPERM || errno == ENOMEM
+                ? "mlock of " + std::to_string(bytes) + " bytes needs CAP_IPC_LOCK or a larger "
+                  "memlock limit (ulimit -l)"
+                : std::string("mlock failed: ") + std::strerror(errno);
+        }
+        return false;
+    }
+#endif
+    return true;
+}
+
+// Undo lock_memory()
+void unlock_memory(void* data, size_t bytes) {
+    if (!data || bytes == 0) {
+        return;
+    }
+#if defined(_WIN32)
+    VirtualUnlock(data, bytes);
+#else
+    munlock(data, bytes);
+#endif
+}
+
+// Get the page size
+size_t memory_page_size() {
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwPageSize;
+#else
+    long size = sysconf(_SC_PAGESIZE);
+    return size > 0 ? static_cast<size_t>(size) : kPageBytes;
+#endif
+}
+
+// Merge results
+ThreadPolicyResult combine_policy_results(const std::vector<ThreadPolicyResult>& results) {
+    ThreadPolicyResult combined;
+    if (results.empty()) {
+        return combined;
+    }
+    combined.realtime = true;
+    combined.pinned = true;
+    for (const ThreadPolicyResult& result : results) {
+        combined.realtime = combined.realtime && result.realtime;
+        combined.pinned = combined.pinned && result.pinned;
+        if (combined.error.empty()) {
+            combined.error = result.error;
+        }
+    }
+    return combined;
+}
+
+} // namespace audio
+} // namespace koelingo
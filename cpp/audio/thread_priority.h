@@ -0,0 +1,87 @@
+/**
+ * @file thread_priority.h
+ * @brief Real-time scheduling, CPU pinning and memory locking for audio threads
+ */
+
+#ifndef KOELINGO_THREAD_PRIORITY_H
+#define KOELINGO_THREAD_PRIORITY_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace koelingo {
+namespace audio {
+
+/**
+ * @struct ThreadPolicy
+ * @brief Scheduling requested for a thread
+ *
+ * Real-time scheduling maps to SCHED_FIFO on Linux, the time-constraint
+ * policy on macOS and MMCSS "Pro Audio" on Windows.
+ */
+struct ThreadPolicy {
+    bool realtime = false;   ///< Request real-time scheduling
+    int priority = 0;        ///< SCHED_FIFO priority 1-99 (0 = 70; Linux only)
+    double period_ms = 10.0; ///< Typical wake-up interval (macOS time-constraint policy)
+    std::vector<int> cpus;   ///< CPUs to run on (empty = no pinning; not supported on macOS)
+};
+
+/**
+ * @struct ThreadPolicyResult
+ * @brief What a ThreadPolicy actually achieved
+ */
+struct ThreadPolicyResult {
+    bool realtime = false; ///< Real-time scheduling is in effect
+    bool pinned = false;   ///< The CPU affinity is in effect
+    std::string error;     ///< Why a requested setting was not applied (empty if all were)
+};
+
+/**
+ * @struct RealtimeReport
+ * @brief Scheduling and memory locking in effect for a capture stream
+ */
+struct RealtimeReport {
+    ThreadPolicyResult processing; ///< Processing (DSP) threads
+    ThreadPolicyResult capture;    ///< Thread delivering device or source periods
+    bool memory_locked = false;    ///< Capture buffers are locked in RAM
+    std::string memory_error;      ///< Why locking failed (empty otherwise)
+};
+
+/**
+ * @brief Apply a policy to the calling thread
+ * @param policy Requested scheduling
+ * @return What was applied; settings that need privileges the process
+ *         lacks are left unchanged and described in error
+ */
+ThreadPolicyResult apply_thread_policy(const ThreadPolicy& policy);
+
+/**
+ * @brief Fault in and lock memory so it is never paged out
+ * @param data Start of the region
+ * @param bytes Size of the region
+ * @param error Receives the reason on failure (may be nullptr)
+ * @return False if the region could not be locked (it is still faulted in)
+ */
+bool lock_memory(void* data, size_t bytes, std::string* error);
+
+/**
+ * @brief Undo lock_memory()
+ */
+void unlock_memory(void* data, size_t bytes);
+
+/**
+ * @brief Get the virtual memory page size in bytes
+ */
+size_t memory_page_size();
+
+/**
+ * @brief Merge results, e.g. of every thread in a pool
+ * @return Applied only if applied everywhere; the first error is kept
+ */
+ThreadPolicyResult combine_policy_results(const std::vector<ThreadPolicyResult>& results);
+
+} // namespace audio
+} // namespace koelingo
+
+#endif // KOELINGO_THREAD_PRIORITY_H
@@ -0,0 +1,227 @@
+/**
+ * @file vad.cc
+ * @brief Implementation of voice activity detection and segmentation
+ */
+
+#include "vad.h"
+#include <algorithm>
+#include <cmath>
+
+namespace koelingo {
+namespace audio {
+
+namespace {
+
+// Convert a duration in milliseconds to a number of frames
+uint64_t ms_to_frames(int ms, int sample_rate) {
+    return static_cast<uint64_t>(std::max(ms, 0)) * static_cast<uint64_t>(sample_rate) / 1000;
+}
+
+} // namespace
+
+// EnergyZcrDetector constructor
+EnergyZcrDetector::EnergyZcrDetector(float energy_threshold, float zcr_threshold)
+    : energy_threshold_(energy_threshold),
+      zcr_threshold_(zcr_threshold) {
+}
+
+// Nothing to prepare for the stateless detector
+void EnergyZcrDetector::reset(int sample_rate [[maybe_unused]], size_t window_size [[maybe_unused]]) {
+}
+
+// Score a window from its energy and zero-crossing rate
+float EnergyZcrDetector::classify(const float* samples, size_t count) {
+    if (count == 0) {
+        return 0.0f;
+    }
+
+    float sum = 0.0f;
+    size_t crossings = 0;
+    for (size_t i = 0; i < count; i++) {
+        sum += samples[i] * samples[i];
+        if (i > 0 && (samples[i] >= 0.0f) != (samples[i - 1] >= 0.0f)) {
+            crossings++;
+        }
+    }
+
+    float rms = sqrtf(sum / count);
+    float zcr = static_cast<float>(crossings) / count;
+
+    if (rms >= energy_threshold_) {
+        return 1.0f;
+    }
+    if (rms >= 0.5f * energy_threshold_ && zcr >= zcr_threshold_) {
+        return 1.0f;
+    }
+    return 0.0f;
+}
+
+// VoiceActivityDetector constructor
+VoiceActivityDetector::VoiceActivityDetector()
+    : window_size_(0),
+      min_speech_frames_(0),
+      hangover_frames_(0),
+      pre_roll_frames_(0),
+      min_utterance_frames_(0),
+      max_utterance_frames_(0),
+      warmup_idle_frames_(0),
+      window_fill_(0) {
+    configure(VadConfig(), 16000);
+}
+
+// Apply a configuration
+void VoiceActivityDetector::configure(const VadConfig& config, int sample_rate,
+                                      std::shared_ptr<SpeechDetector> detector) {
+    config_ = config;
+
+    window_size_ = std::max<size_t>(1, ms_to_frames(config_.frame_ms, sample_rate));
+    min_speech_frames_ = ms_to_frames(config_.min_speech_ms, sample_rate);
+    hangover_frames_ = ms_to_frames(config_.hangover_ms, sample_rate);
+    pre_roll_frames_ = ms_to_frames(config_.pre_roll_ms, sample_rate);
+    min_utterance_frames_ = ms_to_frames(config_.min_utterance_ms, sample_rate);
+    max_utterance_frames_ = std::max<uint64_t>(window_size_,
+                                               ms_to_frames(config_.max_utterance_ms, sample_rate));
+    // An onset needs at least one silent window in front of it
+    warmup_idle_frames_ = std::max<uint64_t>(window_size_,
+                                             ms_to_frames(config_.warmup_idle_ms, sample_rate));
+
+    detector_ = detector ? std::move(detector)
+                         : std::make_shared<EnergyZcrDetector>(config_.energy_threshold,
+                                                               config_.zcr_threshold);
+    detector_->reset(sample_rate, window_size_);
+
+    window_.assign(window_size_, 0.0f);
+    reset();
+}
+
+// Reset the stream state
+void VoiceActivityDetector::reset() {
+    window_fill_ = 0;
+    position_ = 0;
+    last_end_ = 0;
+    in_speech_ = false;
+    speech_start_ = 0;
+    segment_start_ = 0;
+    speech_run_ = 0;
+    silence_run_ = 0;
+    continuation_ = false;
+    heard_speech_ = false;
+    last_speech_end_ = 0;
+}
+
+// Analyse a block of audio
+void VoiceActivityDetector::process(const float* samples, size_t count) {
+    while (count > 0) {
+        size_t take = std::min(count, window_size_ - window_fill_);
+        std::copy(samples, samples + take, window_.data() + window_fill_);
+        window_fill_ += take;
+        position_ += take;
+        samples += take;
+        count -= take;
+
+        if (window_fill_ == window_size_) {
+            process_window();
+            window_fill_ = 0;
+        }
+    }
+}
+
+// Run the state machine for one complete window
+void VoiceActivityDetector::process_window() {
+    const uint64_t window_end = position_;
+    const uint64_t window_start = window_end - window_size_;
+    const bool is_speech = detector_->classify(window_.data(), window_size_) >= config_.speech_probability;
+
+    if (is_speech) {
+        // Speculative onset: reported before min_speech_ms confirms the speech
+        if (onset_callback_ && config_.warmup_idle_ms >= 0 &&
+            (!heard_speech_ || window_start - last_speech_end_ >= warmup_idle_frames_)) {
+            onset_callback_(window_start);
+        }
+        heard_speech_ = true;
+        last_speech_end_ = window_end;
+    }
+
+    if (!in_speech_) {
+        if (!is_speech) {
+            speech_run_ = 0;
+            return;
+        }
+
+        if (speech_run_ == 0) {
+            speech_start_ = window_start;
+        }
+        speech_run_ += window_size_;
+
+        if (speech_run_ >= min_speech_frames_) {
+            // Onset: backdate by the pre-roll, but never into the previous utterance
+            in_speech_ = true;
+            silence_run_ = 0;
+            uint64_t padded = speech_start_ > pre_roll_frames_ ? speech_start_ - pre_roll_frames_ : 0;
+            segment_start_ = std::max(padded, last_end_);
+        }
+        return;
+    }
+
+    if (is_speech) {
+        silence_run_ = 0;
+    } else {
+        silence_run_ += window_size_;
+        if (silence_run_ >= hangover_frames_) {
+            emit(window_end, false);
+            return;
+        }
+    }
+
+    // Split very long utterances so they fit in the capture buffer
+    if (window_end - segment_start_ >= max_utterance_frames_) {
+        emit(window_end, true);
+        in_speech_ = true;
+        continuation_ = true;
+        segment_start_ = window_end;
+    }
+}
+
+// Emit the utterance in progress
+void VoiceActivityDetector::flush() {
+    if (in_speech_) {
+        emit(position_, false);
+    }
+}
+
+// Jump over frames that were never analysed
+void VoiceActivityDetector::skip(uint64_t frames) {
+    if (frames == 0) {
+        return;
+    }
+    flush();
+    window_fill_ = 0;
+    speech_run_ = 0;
+    position_ += frames;
+    last_end_ = position_;
+}
+
+// Hand a finished utterance to the callback
+void VoiceActivityDetector::emit(uint64_t end_frame, bool truncated) {
+    UtteranceSegment segment;
+    segment.start_frame = segment_start_;
+    segment.end_frame = end_frame;
+    segment.truncated = truncated;
+
+    // Pieces of a split utterance are always kept, however short
+    bool keep = truncated || continuation_ ||
+                end_frame - segment.start_frame >= min_utterance_frames_;
+
+    in_speech_ = false;
+    continuation_ = false;
+    speech_run_ = 0;
+    silence_run_ = 0;
+    last_end_ = end_frame;
+
+    if (segment_callback_ && keep) {
+        segment_callback_(segment);
+    }
+}
+
+} // namespace audio
+} // namespace koelingo
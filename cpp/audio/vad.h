@@ -0,0 +1,217 @@
+/**
+ * @file vad.h
+ * @brief Voice activity detection and utterance segmentation
+ */
+
+#ifndef KOELINGO_VAD_H
+#define KOELINGO_VAD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace koelingo {
+namespace audio {
+
+/**
+ * @struct VadConfig
+ * @brief Tuning parameters for the voice activity detector
+ *
+ * Durations are in milliseconds of audio. The defaults mirror the
+ * thresholds the Python implementation used for continuous mode.
+ */
+struct VadConfig {
+    bool enabled = false;             ///< Run the VAD while recording
+    int frame_ms = 30;                ///< Analysis window length
+    float energy_threshold = 0.02f;   ///< RMS level above which a window is speech
+    float zcr_threshold = 0.25f;      ///< Zero-crossing rate that marks unvoiced speech
+    float speech_probability = 0.5f;  ///< Detector output at or above which a window is speech
+    int min_speech_ms = 150;          ///< Speech needed before an utterance starts
+    int hangover_ms = 900;            ///< Silence needed before an utterance ends
+    int pre_roll_ms = 300;            ///< Audio kept before the detected onset
+    int min_utterance_ms = 500;       ///< Shorter utterances are discarded
+    int max_utterance_ms = 10000;     ///< Longer utterances are split
+    int warmup_idle_ms = 2000;        ///< Silence after which the next speech window raises an onset (-1 = never)
+};
+
+/**
+ * @struct UtteranceSegment
+ * @brief Span of the capture stream that contains one utterance
+ *
+ * Frame indices refer to the same monotonic timeline as
+ * AudioCapture::read_new(), and include pre-roll and hangover padding.
+ */
+struct UtteranceSegment {
+    uint64_t start_frame = 0; ///< First frame of the utterance
+    uint64_t end_frame = 0;   ///< One past the last frame of the utterance
+    bool truncated = false;   ///< True if split because it hit max_utterance_ms
+};
+
+/**
+ * @class SpeechDetector
+ * @brief Interface for per-window speech classifiers
+ *
+ * Implement this to plug a model-based detector (e.g. a small neural VAD)
+ * into VoiceActivityDetector. classify() is called from the audio
+ * processing thread and must not block.
+ */
+class SpeechDetector {
+public:
+    virtual ~SpeechDetector() = default;
+
+    /**
+     * @brief Prepare for a new stream
+     * @param sample_rate Sample rate of the windows that will be classified
+     * @param window_size Number of samples per window
+     */
+    virtual void reset(int sample_rate, size_t window_size) = 0;
+
+    /**
+     * @brief Score one analysis window
+     * @param samples Mono samples in the range [-1.0, 1.0]
+     * @param count Number of samples
+     * @return Probability of speech between 0.0 and 1.0
+     */
+    virtual float classify(const float* samples, size_t count) = 0;
+};
+
+/**
+ * @class EnergyZcrDetector
+ * @brief Default detector based on short-term energy and zero-crossing rate
+ *
+ * Windows louder than the energy threshold are speech. Quieter windows
+ * still count as speech if they are at least half as loud and have the
+ * high zero-crossing rate typical of unvoiced consonants.
+ */
+class EnergyZcrDetector : public SpeechDetector {
+public:
+    /**
+     * @brief Constructor
+     * @param energy_threshold RMS level above which a window is speech
+     * @param zcr_threshold Zero-crossing rate (crossings per sample) for unvoiced speech
+     */
+    EnergyZcrDetector(float energy_threshold, float zcr_threshold);
+
+    void reset(int sample_rate, size_t window_size) override;
+    float classify(const float* samples, size_t count) override;
+
+private:
+    float energy_threshold_;
+    float zcr_threshold_;
+};
+
+/**
+ * @class VoiceActivityDetector
+ * @brief Streaming speech/silence state machine that emits utterances
+ *
+ * Audio is fed in arbitrary block sizes and cut into fixed analysis
+ * windows. An utterance starts after min_speech_ms of speech (backdated by
+ * pre_roll_ms) and ends after hangover_ms of silence. No memory is
+ * allocated after configure(), so process() may run on the capture thread.
+ *
+ * The first speech window after warmup_idle_ms of silence is also
+ * reported as an onset, before min_speech_ms confirms it, so consumers can
+ * warm up a recognizer while the utterance is still being spoken. Onsets
+ * are speculative: a cough raises one without producing an utterance.
+ */
+class VoiceActivityDetector {
+public:
+    VoiceActivityDetector();
+
+    /**
+     * @brief Apply a configuration and reset the state
+     * @param config VAD parameters
+     * @param sample_rate Sample rate of the audio passed to process()
+     * @param detector Custom detector, or nullptr for EnergyZcrDetector
+     */
+    void configure(const VadConfig& config, int sample_rate,
+                   std::shared_ptr<SpeechDetector> detector = nullptr);
+
+    /**
+     * @brief Forget any speech in progress and restart at frame 0
+     */
+    void reset();
+
+    /**
+     * @brief Set the function that receives completed utterances
+     * @param callback Called on the processing thread for each utterance
+     */
+    void set_segment_callback(std::function<void(const UtteranceSegment&)> callback) {
+        segment_callback_ = std::move(callback);
+    }
+
+    /**
+     * @brief Set the function that receives speech onsets after idle
+     * @param callback Called on the processing thread with the first frame of
+     *        the speech window; must not block
+     */
+    void set_onset_callback(std::function<void(uint64_t)> callback) {
+        onset_callback_ = std::move(callback);
+    }
+
+    /**
+     * @brief Analyse a block of mono audio
+     * @param samples Mono samples in the range [-1.0, 1.0]
+     * @param count Number of samples; they follow the previous block directly
+     */
+    void process(const float* samples, size_t count);
+
+    /**
+     * @brief Emit the utterance in progress, if any (e.g. when recording stops)
+     */
+    void flush();
+
+    /**
+     * @brief Jump over frames that were lost before they could be analysed
+     * @param frames Number of missing frames
+     *
+     * Any utterance in progress is emitted first, so segments never span a gap.
+     */
+    void skip(uint64_t frames);
+
+    /**
+     * @brief Check whether an utterance is currently in progress
+     */
+    bool in_speech() const { return in_speech_; }
+
+private:
+    VadConfig config_;
+    std::shared_ptr<SpeechDetector> detector_;
+    std::function<void(const UtteranceSegment&)> segment_callback_;
+    std::function<void(uint64_t)> onset_callback_;
+
+    // Durations converted to frames
+    size_t window_size_;
+    uint64_t min_speech_frames_;
+    uint64_t hangover_frames_;
+    uint64_t pre_roll_frames_;
+    uint64_t min_utterance_frames_;
+    uint64_t max_utterance_frames_;
+    uint64_t warmup_idle_frames_;
+
+    // Partially filled analysis window
+    std::vector<float> window_;
+    size_t window_fill_;
+
+    // Stream state
+    uint64_t position_;        // Frame index of the next sample to arrive
+    uint64_t last_end_;        // End of the previous utterance
+    bool in_speech_;
+    uint64_t speech_start_;    // First frame of the current speech run
+    uint64_t segment_start_;   // Start of the utterance being built
+    uint64_t speech_run_;      // Consecutive speech frames before onset
+    uint64_t silence_run_;     // Consecutive silent frames during speech
+    bool continuation_;        // Current utterance continues a split one
+    bool heard_speech_;        // A speech window was seen since reset()
+    uint64_t last_speech_end_; // End of the most recent speech window
+
+    void process_window();
+    void emit(uint64_t end_frame, bool truncated);
+};
+
+} // namespace audio
+} // namespace koelingo
+
+#endif // KOELINGO_VAD_H
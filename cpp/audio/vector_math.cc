@@ -0,0 +1,188 @@
+/**
+ * @file vector_math.cc
+ * @brief Implementation of the shared SIMD kernels
+ */
+
+#include "vector_math.h"
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define KOELINGO_VECTOR_SSE 1
+#include <xmmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define KOELINGO_VECTOR_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace koelingo {
+namespace audio {
+
+// Dot product of two float arrays
+float dot_product(const float* a, const float* b, size_t count) {
+    size_t i = 0;
+    float sum = 0.0f;
+
+#if defined(KOELINGO_VECTOR_SSE)
+    // Two accumulators hide the add latency
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    for (; i + 8 <= count; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    for (; i + 4 <= count; i += 4) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+    sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif defined(KOELINGO_VECTOR_NEON)
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    for (; i + 4 <= count; i += 4) {
+        acc = vmlaq_f32(acc, vld1q_f32(a + i), vld1q_f32(b + i));
+    }
+    sum = vaddvq_f32(acc);
+#endif
+
+    for (; i < count; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+// Element-wise product of two float arrays
+void multiply(const float* a, const float* b, float* output, size_t count) {
+    size_t i = 0;
+#if defined(KOELINGO_VECTOR_SSE)
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+#elif defined(KOELINGO_VECTOR_NEON)
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(output + i, vmulq_f32(vld1q_f32(a + i), vld1q_f32(b + i)));
+    }
+#endif
+    for (; i < count; i++) {
+        output[i] = a[i] * b[i];
+    }
+}
+
+// Accumulate the element-wise product of two float arrays
+void multiply_add(const float* a, const float* b, float* accumulator, size_t count) {
+    size_t i = 0;
+#if defined(KOELINGO_VECTOR_SSE)
+    for (; i + 4 <= count; i += 4) {
+        __m128 product = _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i));
+        _mm_storeu_ps(accumulator + i, _mm_add_ps(_mm_loadu_ps(accumulator + i), product));
+    }
+#elif defined(KOELINGO_VECTOR_NEON)
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(accumulator + i, vmlaq_f32(vld1q_f32(accumulator + i), vld1q_f32(a + i), vld1q_f32(b + i)));
+    }
+#endif
+    for (; i < count; i++) {
+        accumulator[i] += a[i] * b[i];
+    }
+}
+
+// Squared magnitude of interleaved (re, im) pairs
+void magnitude_squared(const std::complex<float>* input, float* output, size_t count) {
+    const float* values = reinterpret_cast<const float*>(input);
+    size_t i = 0;
+#if defined(KOELINGO_VECTOR_SSE)
+    for (; i + 4 <= count; i += 4) {
+        __m128 lo = _mm_loadu_ps(values + 2 * i);      // re0 im0 re1 im1
+        __m128 hi = _mm_loadu_ps(values + 2 * i + 4);  // re2 im2 re3 im3
+        lo = _mm_mul_ps(lo, lo);
+        hi = _mm_mul_ps(hi, hi);
+        __m128 re = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 im = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm_storeu_ps(output + i, _mm_add_ps(re, im));
+    }
+#elif defined(KOELINGO_VECTOR_NEON)
+    for (; i + 4 <= count; i += 4) {
+        float32x4x2_t pairs = vld2q_f32(values + 2 * i);  // De-interleaves re and im
+        vst1q_f32(output + i, vmlaq_f32(vmulq_f32(pairs.val[0], pairs.val[0]), pairs.val[1], pairs.val[1]));
+    }
+#endif
+    for (; i < count; i++) {
+        float re = values[2 * i];
+        float im = values[2 * i + 1];
+        output[i] = re * re + im * im;
+    }
+}
+
+// Scale interleaved (re, im) pairs by one real gain each
+void scale_complex(std::complex<float>* data, const float* gains, size_t count) {
+    float* values = reinterpret_cast<float*>(data);
+    size_t i = 0;
+#if defined(KOELINGO_VECTOR_SSE)
+    for (; i + 4 <= count; i += 4) {
+        __m128 g = _mm_loadu_ps(gains + i);
+        __m128 g_lo = _mm_unpacklo_ps(g, g);  // g0 g0 g1 g1
+        __m128 g_hi = _mm_unpackhi_ps(g, g);  // g2 g2 g3 g3
+        _mm_storeu_ps(values + 2 * i, _mm_mul_ps(_mm_loadu_ps(values + 2 * i), g_lo));
+        _mm_storeu_ps(values + 2 * i + 4, _mm_mul_ps(_mm_loadu_ps(values + 2 * i + 4), g_hi));
+    }
+#elif defined(KOELINGO_VECTOR_NEON)
+    for (; i + 4 <= count; i += 4) {
+        float32x4x2_t pairs = vld2q_f32(values + 2 * i);
+        float32x4_t g = vld1q_f32(gains + i);
+        pairs.val[0] = vmulq_f32(pairs.val[0], g);
+        pairs.val[1] = vmulq_f32(pairs.val[1], g);
+        vst2q_f32(values + 2 * i, pairs);
+    }
+#endif
+    for (; i < count; i++) {
+        values[2 * i] *= gains[i];
+        values[2 * i + 1] *= gains[i];
+    }
+}
+
+// Multiply samples by gain, gain + step, gain + 2 * step, ...
+void apply_gain_ramp(float* data, size_t count, float gain, float step) {
+    size_t i = 0;
+#if defined(KOELINGO_VECTOR_SSE)
+    __m128 gains = _mm_add_ps(_mm_set1_ps(gain), _mm_mul_ps(_mm_set1_ps(step), _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f)));
+    const __m128 advance = _mm_set1_ps(4.0f * step);
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), gains));
+        gains = _mm_add_ps(gains, advance);
+    }
+#elif defined(KOELINGO_VECTOR_NEON)
+    const float offsets[4] = {0.0f, 1.0f, 2.0f, 3.0f};
+    float32x4_t gains = vmlaq_n_f32(vdupq_n_f32(gain), vld1q_f32(offsets), step);
+    const float32x4_t advance = vdupq_n_f32(4.0f * step);
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(data + i, vmulq_f32(vld1q_f32(data + i), gains));
+        gains = vaddq_f32(gains, advance);
+    }
+#endif
+    for (; i < count; i++) {
+        data[i] *= gain + step * static_cast<float>(i);
+    }
+}
+
+// Clamp samples to [low, high]
+void clamp(float* data, size_t count, float low, float high) {
+    size_t i = 0;
+#if defined(KOELINGO_VECTOR_SSE)
+    const __m128 lo = _mm_set1_ps(low);
+    const __m128 hi = _mm_set1_ps(high);
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(data + i, _mm_min_ps(_mm_max_ps(_mm_loadu_ps(data + i), lo), hi));
+    }
+#elif defined(KOELINGO_VECTOR_NEON)
+    const float32x4_t lo = vdupq_n_f32(low);
+    const float32x4_t hi = vdupq_n_f32(high);
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(data + i, vminq_f32(vmaxq_f32(vld1q_f32(data + i), lo), hi));
+    }
+#endif
+    for (; i < count; i++) {
+        data[i] = std::min(std::max(data[i], low), high);
+    }
+}
+
+} // namespace audio
+} // namespace koelingo
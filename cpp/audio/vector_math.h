@@ -0,0 +1,81 @@
+/**
+ * @file vector_math.h
+ * @brief Small SIMD kernels shared by the DSP stages
+ */
+
+#ifndef KOELINGO_VECTOR_MATH_H
+#define KOELINGO_VECTOR_MATH_H
+
+#include <complex>
+#include <cstddef>
+
+namespace koelingo {
+namespace audio {
+
+/**
+ * @brief Compute the dot product of two float arrays
+ * @param a First array
+ * @param b Second array
+ * @param count Number of elements in each array
+ * @return Sum of a[i] * b[i]
+ *
+ * Uses SSE on x86-64 and NEON on ARM64, with a scalar tail.
+ */
+float dot_product(const float* a, const float* b, size_t count);
+
+/**
+ * @brief Multiply two float arrays element-wise
+ * @param a First array
+ * @param b Second array
+ * @param output Receives a[i] * b[i]; may alias a or b
+ * @param count Number of elements
+ */
+void multiply(const float* a, const float* b, float* output, size_t count);
+
+/**
+ * @brief Add the element-wise product of two arrays to an accumulator
+ * @param a First array
+ * @param b Second array
+ * @param accumulator Receives accumulator[i] + a[i] * b[i]
+ * @param count Number of elements
+ */
+void multiply_add(const float* a, const float* b, float* accumulator, size_t count);
+
+/**
+ * @brief Compute the squared magnitude of complex values
+ * @param input Complex values
+ * @param output Receives |input[i]|^2
+ * @param count Number of values
+ */
+void magnitude_squared(const std::complex<float>* input, float* output, size_t count);
+
+/**
+ * @brief Scale complex values by real gains
+ * @param data Complex values, scaled in place
+ * @param gains One gain per value
+ * @param count Number of values
+ */
+void scale_complex(std::complex<float>* data, const float* gains, size_t count);
+
+/**
+ * @brief Multiply samples by a linearly changing gain
+ * @param data Samples, scaled in place
+ * @param count Number of samples
+ * @param gain Gain applied to the first sample
+ * @param step Gain increment per sample
+ */
+void apply_gain_ramp(float* data, size_t count, float gain, float step);
+
+/**
+ * @brief Clamp samples to a range
+ * @param data Samples, clamped in place
+ * @param count Number of samples
+ * @param low Smallest allowed value
+ * @param high Largest allowed value
+ */
+void clamp(float* data, size_t count, float low, float high);
+
+} // namespace audio
+} // namespace koelingo
+
+#endif // KOELINGO_VECTOR_MATH_H
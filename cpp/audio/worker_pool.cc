@@ -0,0 +1,131 @@
+/**
+ * @file worker_pool.cc
+ * @brief Implementation of the shared processing pool
+ */
+
+#include "worker_pool.h"
+#include <algorithm>
+#include <chrono>
+
+namespace koelingo {
+namespace audio {
+
+// WorkerPool constructor
+WorkerPool::WorkerPool(int threads, const ThreadPolicy& policy)
+    : stop_(false),
+      policy_(policy) {
+    if (threads <= 0) {
+        threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    threads_.reserve(static_cast<size_t>(threads));
+    for (int i = 0; i < threads; i++) {
+        threads_.emplace_back(&WorkerPool::run, this);
+    }
+
+    // Report the policy once every thread has applied it
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this] { return policy_results_.size() == threads_.size(); });
+    policy_result_ = combine_policy_results(policy_results_);
+}
+
+// WorkerPool destructor
+WorkerPool::~WorkerPool() {
+    stop_ = true;
+    signal_.notify();
+    for (std::thread& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+// Register a task
+void WorkerPool::add(ProcessingTask* task) {
+    auto entry = std::make_shared<Entry>();
+    entry->task = task;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.push_back(std::move(entry));
+    }
+
+    // It may already have work
+    signal_.notify();
+}
+
+// Unregister a task
+void WorkerPool::remove(ProcessingTask* task) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = std::find_if(entries_.begin(), entries_.end(),
+                           [task](const std::shared_ptr<Entry>& entry) { return entry->task == task; });
+    if (it == entries_.end()) {
+        return;
+    }
+    std::shared_ptr<Entry> entry = *it;
+    entries_.erase(it);
+
+    // A thread that claims the task after this store sees it and backs off
+    entry->removed = true;
+    idle_.wait(lock, [&entry] { return !entry->busy; });
+}
+
+// Service every task that has work once
+bool WorkerPool::run_pass() {
+    bool did_work = false;
+
+    for (size_t i = 0;; i++) {
+        std::shared_ptr<Entry> entry;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (i >= entries_.size()) {
+                break;
+            }
+            entry = entries_[i];
+        }
+
+        // Claim the task first so it cannot be removed (and destroyed)
+        // while we look at it; skip it if another thread is running it
+        if (entry->busy.exchange(true)) {
+            continue;
+        }
+        if (!entry->removed && entry->task->has_work()) {
+            entry->task->run_pending();
+            did_work = true;
+        }
+        entry->busy = false;
+
+        // Only remove() waits for the release
+        if (entry->removed) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            idle_.notify_all();
+        }
+    }
+
+    return did_work;
+}
+
+// Pool thread
+void WorkerPool::run() {
+    ThreadPolicyResult result = apply_thread_policy(policy_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        policy_results_.push_back(result);
+        idle_.notify_all();
+    }
+
+    while (true) {
+        // Sample the sequence first so a notify landing during the pass wakes us
+        uint32_t seen = signal_.sequence();
+        if (stop_) {
+            break;
+        }
+
+        // Keep going while there is work; a task held by another thread is
+        // rescanned by that thread once it finishes
+        if (!run_pass()) {
+            signal_.wait(seen, std::chrono::milliseconds(500));
+        }
+    }
+}
+
+} // namespace audio
+} // namespace koelingo
@@ -0,0 +1,131 @@
+/**
+ * @file worker_pool.h
+ * @brief Processing threads shared by several capture streams
+ */
+
+#ifndef KOELINGO_WORKER_POOL_H
+#define KOELINGO_WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "data_signal.h"
+#include "thread_priority.h"
+
+namespace koelingo {
+namespace audio {
+
+/**
+ * @class ProcessingTask
+ * @brief Unit of work serviced by a WorkerPool, such as one capture stream
+ *
+ * A task is only ever run by one pool thread at a time, so its processing
+ * state needs no locking of its own.
+ */
+class ProcessingTask {
+public:
+    virtual ~ProcessingTask() = default;
+
+    /**
+     * @brief Check whether there is anything to process
+     *
+     * Called from any pool thread, concurrently with run_pending().
+     */
+    virtual bool has_work() const = 0;
+
+    /**
+     * @brief Process everything that is currently pending
+     */
+    virtual void run_pending() = 0;
+};
+
+/**
+ * @class WorkerPool
+ * @brief Fixed set of threads that service any number of processing tasks
+ *
+ * Producers call signal().notify() when a task may have work (it is safe
+ * from the PortAudio callback). Idle threads then scan the registered tasks
+ * and run every one that has work and is not already being run elsewhere,
+ * so N capture streams need only as many threads as there are cores
+ * rather than one each.
+ */
+class WorkerPool {
+public:
+    /**
+     * @brief Start the pool threads
+     * @param threads Number of threads (0 for one per hardware thread)
+     * @param policy Scheduling each thread applies to itself before it
+     *        runs any task; see policy_result() for what took effect
+     */
+    explicit WorkerPool(int threads = 0, const ThreadPolicy& policy = ThreadPolicy());
+
+    /**
+     * @brief Stop and join the pool threads
+     *
+     * Every task must have been removed first.
+     */
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /**
+     * @brief Register a task; it is serviced until remove() is called
+     * @param task Task to service (not owned)
+     */
+    void add(ProcessingTask* task);
+
+    /**
+     * @brief Unregister a task, waiting for a run in progress to finish
+     * @param task Task previously passed to add()
+     *
+     * Once this returns no pool thread touches the task again.
+     */
+    void remove(ProcessingTask* task);
+
+    /**
+     * @brief Get the signal that wakes the pool threads
+     */
+    DataSignal& signal() { return signal_; }
+
+    /**
+     * @brief Get the number of pool threads
+     */
+    int thread_count() const { return static_cast<int>(threads_.size()); }
+
+    /**
+     * @brief Get what the thread policy achieved on every pool thread
+     */
+    const ThreadPolicyResult& policy_result() const { return policy_result_; }
+
+private:
+    struct Entry {
+        ProcessingTask* task;
+        std::atomic<bool> busy{false};
+        std::atomic<bool> removed{false};
+    };
+
+    std::mutex mutex_;
+    std::condition_variable idle_;
+    std::vector<std::shared_ptr<Entry>> entries_;
+
+    DataSignal signal_;
+    std::atomic<bool> stop_;
+    std::vector<std::thread> threads_;
+
+    // Each thread reports how its policy went before it starts working
+    ThreadPolicy policy_;
+    std::vector<ThreadPolicyResult> policy_results_;
+    ThreadPolicyResult policy_result_;
+
+    void run();
+    bool run_pass();
+};
+
+} // namespace audio
+} // namespace koelingo
+
+#endif // KOELINGO_WORKER_POOL_H
@@ -0,0 +1,270 @@
+/**
+ * @file audio_bench.cc
+ * @brief Micro-benchmarks for the native audio hot paths
+ *
+ * Every benchmark feeds a synthetic tone straight into the component under
+ * test, so no audio device (or PortAudio stream) is needed. Results can be
+ * tracked over time with --benchmark_out=results.json --benchmark_out_format=json;
+ * the x_realtime counter is seconds of audio processed per second of CPU.
+ */
+
+#include <benchmark/benchmark.h>
+#include <portaudio.h>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+#include "audio_recorder.h"
+#include "capture_stats.h"
+#include "data_signal.h"
+#include "gain_control.h"
+#include "level_meter.h"
+#include "mel_spectrogram.h"
+#include "noise_suppressor.h"
+#include "resampler.h"
+#include "ring_buffer.h"
+#include "sample_format.h"
+
+using namespace koelingo::audio;
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+/**
+ * @brief Generate interleaved frames of a 440 Hz tone with a little noise
+ * @param frames Number of frames
+ * @param channels Number of interleaved channels
+ * @param sample_rate Sample rate in Hz
+ * @param format_type paInt16 or paFloat32
+ * @return Raw frames in the requested format
+ */
+std::vector<char> make_tone(size_t frames, int channels, int sample_rate, int format_type) {
+    std::vector<float> samples(frames * channels);
+    uint32_t noise = 1;
+    for (size_t i = 0; i < frames; i++) {
+        noise = noise * 1664525u + 1013904223u;
+        float value = 0.5f * static_cast<float>(std::sin(2.0 * kPi * 440.0 * i / sample_rate)) +
+                      0.01f * (static_cast<float>(noise >> 8) / 16777216.0f - 0.5f);
+        for (int c = 0; c < channels; c++) {
+            samples[i * channels + c] = value;
+        }
+    }
+
+    std::vector<char> data(samples.size() * bytes_per_sample(format_type));
+    convert_from_float32(samples.data(), samples.size(), format_type, data.data());
+    return data;
+}
+
+/**
+ * @brief Report audio throughput relative to real time
+ */
+void set_realtime_counter(benchmark::State& state, size_t frames, int sample_rate) {
+    state.counters["x_realtime"] = benchmark::Counter(
+        static_cast<double>(frames) / sample_rate, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+// Level metering of one chunk (the work behind level callbacks)
+void BM_MeasureLevels(benchmark::State& state) {
+    const size_t frames = static_cast<size_t>(state.range(0));
+    const int channels = static_cast<int>(state.range(1));
+    const int format_type = static_cast<int>(state.range(2));
+    std::vector<char> chunk = make_tone(frames, channels, 16000, format_type);
+    std::vector<ChannelLevel> levels(channels);
+
+    for (auto _ : state) {
+        measure_levels(chunk.data(), frames, channels, format_type, levels.data());
+        benchmark::DoNotOptimize(rms_to_meter_level(levels[0].rms));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * chunk.size()));
+    set_realtime_counter(state, frames, 16000);
+    state.SetLabel(level_kernel_name());
+}
+BENCHMARK(BM_MeasureLevels)
+    ->ArgNames({"chunk", "channels", "format"})
+    ->ArgsProduct({{256, 1024, 4096}, {1, 2}, {paInt16, paFloat32}});
+
+// What the PortAudio callback does per period without resampling: copy into
+// the ring, record statistics and wake the consumers
+void BM_CallbackEnqueue(benchmark::State& state) {
+    const size_t frames = static_cast<size_t>(state.range(0));
+    std::vector<char> period = make_tone(frames, 1, 16000, paInt16);
+    RingBuffer ring(30 * 16000 * sizeof(int16_t));
+    DataSignal data_signal;
+    DataSignal pool_signal;
+    LatencyHistogram callback_duration;
+
+    for (auto _ : state) {
+        auto entered = std::chrono::steady_clock::now();
+        ring.write(period.data(), period.size());
+        data_signal.notify();
+        pool_signal.notify();
+        callback_duration.record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - entered).count()));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * period.size()));
+    set_realtime_counter(state, frames, 16000);
+}
+BENCHMARK(BM_CallbackEnqueue)->ArgName("chunk")->Arg(256)->Arg(1024)->Arg(4096);
+
+// The callback path when capturing at the device rate and resampling to 16 kHz
+void BM_CallbackResampled(benchmark::State& state) {
+    const int input_rate = static_cast<int>(state.range(0));
+    const size_t frames = static_cast<size_t>(state.range(1));
+    std::vector<char> period = make_tone(frames, 1, input_rate, paInt16);
+    RingBuffer ring(30 * 16000 * sizeof(int16_t));
+    Resampler resampler;
+    resampler.configure(input_rate, 16000, 1, paInt16, frames);
+    std::vector<float> output(resampler.max_output_frames(frames));
+    std::vector<char> output_bytes(output.size() * sizeof(int16_t));
+
+    for (auto _ : state) {
+        size_t count = resampler.process(period.data(), frames, output.data(), output.size());
+        convert_from_float32(output.data(), count, paInt16, output_bytes.data());
+        ring.write(output_bytes.data(), count * sizeof(int16_t));
+    }
+    set_realtime_counter(state, frames, input_rate);
+}
+BENCHMARK(BM_CallbackResampled)
+    ->ArgNames({"rate", "chunk"})
+    ->ArgsProduct({{44100, 48000}, {256, 1024, 4096}});
+
+// Copying the whole retained capture out of the ring, as get_buffer() does
+void BM_GetBuffer(benchmark::State& state) {
+    const size_t seconds = static_cast<size_t>(state.range(0));
+    const size_t frames = seconds * 16000;
+    std::vector<char> capture = make_tone(frames, 1, 16000, paInt16);
+    RingBuffer ring(30 * 16000 * sizeof(int16_t));
+    ring.write(capture.data(), capture.size());
+
+    for (auto _ : state) {
+        uint64_t end = ring.write_position();
+        std::vector<char> buffer(static_cast<size_t>(end - ring.oldest_position()));
+        ring.copy(ring.oldest_position(), end, buffer.data());
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * capture.size()));
+}
+BENCHMARK(BM_GetBuffer)->ArgName("seconds")->Arg(1)->Arg(10)->Arg(30)->Unit(benchmark::kMicrosecond);
+
+// Streaming a capture to a WAV file on the recorder's I/O thread
+void BM_WavWrite(benchmark::State& state) {
+    const int sample_rate = static_cast<int>(state.range(0));
+    const size_t frames = 10 * static_cast<size_t>(sample_rate);
+    std::vector<char> capture = make_tone(frames, 1, sample_rate, paInt16);
+    RingBuffer ring(capture.size());
+    ring.write(capture.data(), capture.size());
+    DataSignal signal;
+
+    RecorderConfig config;
+    config.path = (std::filesystem::temp_directory_path() / "koelingo_bench.wav").string();
+    config.format = RecordingFormat::kWav;
+
+    for (auto _ : state) {
+        AudioRecorder recorder;
+        if (!recorder.start(config, ring, signal, 0, sample_rate, 1, paInt16)) {
+            state.SkipWithError("Could not create the WAV file");
+            break;
+        }
+        recorder.stop();
+    }
+    std::remove(config.path.c_str());
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * capture.size()));
+    set_realtime_counter(state, frames, sample_rate);
+}
+BENCHMARK(BM_WavWrite)
+    ->ArgName("rate")->Arg(16000)->Arg(44100)->Arg(48000)
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Resampling device audio to the 16 kHz capture rate
+void BM_Resample(benchmark::State& state) {
+    const int input_rate = static_cast<int>(state.range(0));
+    const size_t frames = static_cast<size_t>(state.range(1));
+    const int channels = static_cast<int>(state.range(2));
+    std::vector<char> period = make_tone(frames, channels, input_rate, paInt16);
+    Resampler resampler;
+    if (!resampler.configure(input_rate, 16000, channels, paInt16, frames)) {
+        state.SkipWithError("Unsupported conversion");
+        return;
+    }
+    std::vector<float> output(resampler.max_output_frames(frames));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(resampler.process(period.data(), frames, output.data(), output.size()));
+    }
+    set_realtime_counter(state, frames, input_rate);
+}
+BENCHMARK(BM_Resample)
+    ->ArgNames({"rate", "chunk", "channels"})
+    ->ArgsProduct({{44100, 48000}, {256, 1024, 4096}, {1, 2}});
+
+// Incremental log-mel extraction
+void BM_MelSpectrogram(benchmark::State& state) {
+    const int sample_rate = static_cast<int>(state.range(0));
+    const size_t frames = static_cast<size_t>(state.range(1));
+    std::vector<float> block(frames);
+    std::vector<char> tone = make_tone(frames, 1, sample_rate, paFloat32);
+    std::memcpy(block.data(), tone.data(), tone.size());
+
+    MelSpectrogram mel;
+    if (!mel.configure(MelConfig(), sample_rate)) {
+        state.SkipWithError("Invalid mel configuration");
+        return;
+    }
+
+    for (auto _ : state) {
+        mel.process(block.data(), frames);
+    }
+    benchmark::DoNotOptimize(mel.frames_written());
+    set_realtime_counter(state, frames, sample_rate);
+}
+BENCHMARK(BM_MelSpectrogram)
+    ->ArgNames({"rate", "chunk"})
+    ->ArgsProduct({{16000, 44100, 48000}, {256, 1024, 4096}});
+
+// Spectral noise suppression ahead of the VAD
+void BM_NoiseSuppressor(benchmark::State& state) {
+    const int sample_rate = static_cast<int>(state.range(0));
+    const size_t frames = static_cast<size_t>(state.range(1));
+    std::vector<float> block(frames);
+    std::vector<char> tone = make_tone(frames, 1, sample_rate, paFloat32);
+    std::memcpy(block.data(), tone.data(), tone.size());
+
+    NoiseSuppressor suppressor;
+    suppressor.configure(NoiseSuppressionConfig(), sample_rate);
+    std::vector<float> output(frames + suppressor.hop());
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(suppressor.process(block.data(), frames, output.data()));
+    }
+    set_realtime_counter(state, frames, sample_rate);
+}
+BENCHMARK(BM_NoiseSuppressor)
+    ->ArgNames({"rate", "chunk"})
+    ->ArgsProduct({{16000, 48000}, {256, 1024, 4096}});
+
+// Automatic gain control (in place, so the level keeps adapting)
+void BM_GainControl(benchmark::State& state) {
+    const size_t frames = static_cast<size_t>(state.range(0));
+    std::vector<float> block(frames);
+    std::vector<char> tone = make_tone(frames, 1, 16000, paFloat32);
+    std::memcpy(block.data(), tone.data(), tone.size());
+
+    AutomaticGainControl agc;
+    agc.configure(GainControlConfig(), 16000);
+
+    for (auto _ : state) {
+        agc.process(block.data(), frames);
+    }
+    benchmark::DoNotOptimize(agc.gain());
+    set_realtime_counter(state, frames, 16000);
+}
+BENCHMARK(BM_GainControl)->ArgName("chunk")->Arg(256)->Arg(1024)->Arg(4096);
+
+} // namespace
+
+BENCHMARK_MAIN();
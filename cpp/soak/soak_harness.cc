@@ -0,0 +1,665 @@
+/**
+ * @file soak_harness.cc
+ * @brief Long-running soak and latency-regression harness for the native pipeline
+ *
+ * Loops a WAV file through a ReplaySource in real time (or N x real time)
+ * into AudioCapture, its VAD and, when built with whisper.cpp, a
+ * WhisperTranscriber, for as long as requested. Latencies are taken from
+ * the event bus: the period holding an utterance's last frame is looked up
+ * in a log of the times the replay handed each period over, and compared
+ * with the time its utterance and final transcript events were published.
+ * RSS, the capture counters and queue depths are sampled along the way.
+ *
+ * The summary can be written as a baseline and later runs compared with
+ * it; any metric worse than the baseline by more than the tolerance fails
+ * the run (exit status 1).
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "audio_capture.h"
+#include "capture_stats.h"
+#include "event_bus.h"
+#include "input_source.h"
+#include "replay_source.h"
+#ifdef KOELINGO_HAVE_WHISPER_CPP
+#include "whisper_transcriber.h"
+#endif
+
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#elif !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+using namespace koelingo::audio;
+#ifdef KOELINGO_HAVE_WHISPER_CPP
+using koelingo::stt::WhisperConfig;
+using koelingo::stt::WhisperTranscriber;
+#endif
+
+namespace {
+
+constexpr int kSampleRate = 16000;
+
+/**
+ * @struct Options
+ * @brief Command line settings
+ */
+struct Options {
+    std::string wav;            // Input looped for the whole run
+    std::string model;          // ggml model; empty for capture and VAD only
+    std::string language = "ja";
+    int workers = 1;
+    double duration_s = 3600.0;
+    double speed = 1.0;         // Replay speed relative to real time
+    double warmup_s = 300.0;    // RSS growth is measured after this
+    double sample_s = 10.0;     // Interval of RSS and queue samples
+    double report_s = 60.0;     // Interval of progress lines
+    std::string baseline;       // Compare with this baseline
+    std::string write_baseline; // Write the run's metrics here
+    double tolerance = 0.10;    // Allowed relative regression
+};
+
+/**
+ * @struct MetricRule
+ * @brief How a summary value is compared with its baseline
+ */
+struct MetricRule {
+    const char* name;
+    double slack; // Absolute allowance on top of the relative tolerance
+};
+
+// Metrics checked against a baseline; lower is better for all of them.
+// The slack absorbs noise where the baseline is (close to) zero.
+const MetricRule kRules[] = {
+    {"vad_latency_p50_ms", 5.0},
+    {"vad_latency_p95_ms", 10.0},
+    {"vad_latency_p99_ms", 20.0},
+    {"e2e_latency_p50_ms", 20.0},
+    {"e2e_latency_p95_ms", 50.0},
+    {"e2e_latency_p99_ms", 100.0},
+    {"rss_growth_mb_per_hour", 2.0},
+    {"callback_overruns", 0.0},
+    {"input_overflows", 0.0},
+    {"dropped_frames", 0.0},
+    {"dropped_utterances", 0.0},
+    {"dropped_events", 0.0},
+    {"peak_ring_backlog_frames", 4096.0},
+    {"peak_stt_queue", 1.0},
+};
+
+/**
+ * @brief Print the command line help
+ */
+void usage(const char* program) {
+    std::cerr
+        << "Usage: " << program << " --wav FILE [options]\n"
+        << "  --model FILE            ggml model for whisper.cpp (default: capture and VAD only)\n"
+        << "  --language CODE         Spoken language (default: ja)\n"
+        << "  --workers N             Decode workers (default: 1)\n"
+        << "  --duration TIME         Run length, e.g. 90s, 30m, 4h (default: 1h)\n"
+        << "  --speed X               Replay speed relative to real time (default: 1)\n"
+        << "  --warmup TIME           Time before RSS growth is measured (default: 5m)\n"
+        << "  --sample-interval TIME  RSS and queue sampling interval (default: 10s)\n"
+        << "  --report-interval TIME  Progress line interval (default: 1m)\n"
+        << "  --baseline FILE         Fail if a metric regresses past this baseline\n"
+        << "  --write-baseline FILE   Write this run's metrics as a baseline\n"
+        << "  --tolerance X           Allowed relative regression (default: 0.10)\n";
+}
+
+/**
+ * @brief Parse a duration such as "90", "90s", "30m" or "4h"
+ * @param text Duration text
+ * @param seconds Receives the duration in seconds
+ * @return False if the text is not a positive duration
+ */
+bool parse_duration(const std::string& text, double& seconds) {
+    char* end = nullptr;
+    double value = std::strtod(text.c_str(), &end);
+    if (end == text.c_str() || value < 0.0) {
+        return false;
+    }
+    std::string unit(end);
+    if (unit.empty() || unit == "s") {
+        seconds = value;
+    } else if (unit == "m") {
+        seconds = value * 60.0;
+    } else if (unit == "h") {
+        seconds = value * 3600.0;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Parse the command line
+ * @return False (after printing why) if it is invalid
+ */
+bool parse_options(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            return false;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+        bool ok = true;
+        if (arg == "--wav") {
+            options.wav = value;
+        } else if (arg == "--model") {
+            options.model = value;
+        } else if (arg == "--language") {
+            options.language = value;
+        } else if (arg == "--workers") {
+            options.workers = std::atoi(value.c_str());
+            ok = options.workers > 0;
+        } else if (arg == "--duration") {
+            ok = parse_duration(value, options.duration_s) && options.duration_s > 0.0;
+        } else if (arg == "--speed") {
+            options.speed = std::atof(value.c_str());
+            ok = options.speed > 0.0;
+        } else if (arg == "--warmup") {
+            ok = parse_duration(value, options.warmup_s);
+        } else if (arg == "--sample-interval") {
+            ok = parse_duration(value, options.sample_s) && options.sample_s > 0.0;
+        } else if (arg == "--report-interval") {
+            ok = parse_duration(value, options.report_s) && options.report_s > 0.0;
+        } else if (arg == "--baseline") {
+            options.baseline = value;
+        } else if (arg == "--write-baseline") {
+            options.write_baseline = value;
+        } else if (arg == "--tolerance") {
+            options.tolerance = std::atof(value.c_str());
+            ok = options.tolerance >= 0.0;
+        } else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return false;
+        }
+        if (!ok) {
+            std::cerr << "Invalid value for " << arg << ": " << value << std::endl;
+            return false;
+        }
+    }
+    if (options.wav.empty()) {
+        std::cerr << "--wav is required" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Get the resident set size of this process
+ * @return RSS in bytes, or 0 where it cannot be read
+ */
+uint64_t resident_bytes() {
+#if defined(__APPLE__)
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO,
+                  reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS) {
+        return 0;
+    }
+    return info.resident_size;
+#elif defined(__linux__)
+    std::ifstream statm("/proc/self/statm");
+    uint64_t size = 0;
+    uint64_t resident = 0;
+    if (!(statm >> size >> resident)) {
+        return 0;
+    }
+    return resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Get the steady clock in nanoseconds, the clock of Event::timestamp_ns
+ */
+int64_t steady_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @class StampedSource
+ * @brief Passes a ReplaySource through and records when each period is handed over
+ *
+ * The replay delivers whole periods at the start of their interval, so the
+ * arrival time of a frame cannot be derived from its index and the speed.
+ * Instead the steady-clock time of every delivery is kept, keyed by the
+ * period's first source frame, for the most recent kHistory periods.
+ */
+class StampedSource : public InputSource, public InputSink {
+public:
+    explicit StampedSource(std::shared_ptr<ReplaySource> inner)
+        : inner_(std::move(inner)), stamps_(kHistory) {}
+
+    int sample_rate() const override { return inner_->sample_rate(); }
+    int channels() const override { return inner_->channels(); }
+    bool finished() const override { return inner_->finished(); }
+
+    bool start(InputSink* sink, size_t period_frames, int format_type) override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            delivered_ = 0;
+            count_ = 0;
+        }
+        sink_ = sink;
+        return inner_->start(this, period_frames, format_type);
+    }
+
+    void stop() override { inner_->stop(); }
+
+    void on_input(const InputPeriod& period) override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stamps_[count_ % kHistory] = {delivered_, period.frames, steady_ns()};
+            count_++;
+            delivered_ += period.frames;
+        }
+        sink_->on_input(period);
+    }
+
+    void on_input_end() override { sink_->on_input_end(); }
+
+    /**
+     * @brief Look up when a source frame was handed to the capture
+     * @param frame Source frame index since start()
+     * @param ns Receives the steady-clock time of its delivery
+     * @return False if the frame was not delivered yet or has left the history
+     */
+    bool delivery_time(uint64_t frame, int64_t& ns) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (count_ == 0 || frame >= delivered_) {
+            return false;
+        }
+        // Periods are stored in delivery order; search the retained ones
+        uint64_t low = count_ > kHistory ? count_ - kHistory : 0;
+        uint64_t high = count_;
+        while (high - low > 1) {
+            uint64_t middle = low + (high - low) / 2;
+            if (stamps_[middle % kHistory].first_frame <= frame) {
+                low = middle;
+            } else {
+                high = middle;
+            }
+        }
+        const Stamp& stamp = stamps_[low % kHistory];
+        if (frame < stamp.first_frame || frame >= stamp.first_frame + stamp.frames) {
+            return false;
+        }
+        ns = stamp.ns;
+        return true;
+    }
+
+private:
+    static constexpr uint64_t kHistory = 16384;
+
+    struct Stamp {
+        uint64_t first_frame = 0;
+        size_t frames = 0;
+        int64_t ns = 0;
+    };
+
+    std::shared_ptr<ReplaySource> inner_;
+    InputSink* sink_ = nullptr;
+    mutable std::mutex mutex_;
+    std::vector<Stamp> stamps_;
+    uint64_t count_ = 0;     // Periods delivered
+    uint64_t delivered_ = 0; // Source frames delivered
+};
+
+/**
+ * @brief Get a percentile of a set of samples
+ * @param values Samples; reordered
+ * @param quantile Quantile in [0.0, 1.0]
+ * @return Nearest-rank percentile, or 0 if there are no samples
+ */
+double percentile(std::vector<double>& values, double quantile) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    size_t rank = static_cast<size_t>(std::ceil(quantile * values.size()));
+    size_t index = std::min(values.size() - 1, rank > 0 ? rank - 1 : 0);
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+/**
+ * @brief Count callbacks that took longer than one period
+ * @param histogram Callback durations
+ * @param period_us Period length in microseconds
+ * @return Callbacks in buckets that lie entirely above the period
+ */
+uint64_t count_overruns(const HistogramSnapshot& histogram, double period_us) {
+    uint64_t overruns = 0;
+    if (period_us <= 0.0) {
+        return 0;
+    }
+    for (size_t i = 1; i < kHistogramBuckets; i++) {
+        if (static_cast<double>(HistogramSnapshot::bucket_bound_us(i - 1)) >= period_us) {
+            overruns += histogram.buckets[i];
+        }
+    }
+    return overruns;
+}
+
+/**
+ * @brief Least-squares slope of y over x
+ * @return Slope, or 0 with fewer than two distinct x values
+ */
+double slope(const std::vector<double>& x, const std::vector<double>& y) {
+    size_t n = x.size();
+    if (n < 2) {
+        return 0.0;
+    }
+    double mean_x = 0.0;
+    double mean_y = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        mean_x += x[i];
+        mean_y += y[i];
+    }
+    mean_x /= n;
+    mean_y /= n;
+    double covariance = 0.0;
+    double variance = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        covariance += (x[i] - mean_x) * (y[i] - mean_y);
+        variance += (x[i] - mean_x) * (x[i] - mean_x);
+    }
+    return variance > 0.0 ? covariance / variance : 0.0;
+}
+
+/**
+ * @brief Read a baseline written by write_metrics()
+ * @return Metric values by name; empty if the file cannot be read
+ */
+std::map<std::string, double> read_metrics(const std::string& path) {
+    std::map<std::string, double> metrics;
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream fields(line);
+        std::string name;
+        double value;
+        if (fields >> name >> value) {
+            metrics[name] = value;
+        }
+    }
+    return metrics;
+}
+
+/**
+ * @brief Write metrics as "name value" lines
+ * @return False if the file cannot be written
+ */
+bool write_metrics(const std::string& path, const std::vector<std::pair<std::string, double>>& metrics,
+                   const Options& options) {
+    std::ofstream file(path);
+    if (!file) {
+        return false;
+    }
+    file << "# koelingo_soak baseline: " << options.duration_s << " s of " << options.wav
+         << " at " << options.speed << "x" << (options.model.empty() ? ", no STT" : ", model " + options.model)
+         << "\n";
+    for (const auto& metric : metrics) {
+        file << metric.first << " " << metric.second << "\n";
+    }
+    return static_cast<bool>(file);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::shared_ptr<ReplaySource> source = ReplaySource::from_wav(options.wav);
+    if (!source) {
+        std::cerr << "Cannot read WAV file: " << options.wav << std::endl;
+        return 2;
+    }
+    source->set_loop(true);
+    source->set_speed(options.speed);
+    auto stamped = std::make_shared<StampedSource>(source);
+
+    AudioCapture capture(kSampleRate, 1024, 1);
+    VadConfig vad = capture.get_vad_config();
+    vad.enabled = true;
+    capture.set_vad_config(vad);
+    capture.set_input_source(stamped);
+
+    auto bus = std::make_shared<EventBus>();
+    std::shared_ptr<EventSubscription> events = bus->subscribe(
+        event_mask(EventType::kUtterance) | event_mask(EventType::kFinalTranscript), 4096);
+    capture.set_event_bus(bus);
+
+#ifdef KOELINGO_HAVE_WHISPER_CPP
+    std::unique_ptr<WhisperTranscriber> transcriber;
+    if (!options.model.empty()) {
+        WhisperConfig config;
+        config.model_path = options.model;
+        config.language = options.language;
+        config.workers = options.workers;
+        transcriber = std::make_unique<WhisperTranscriber>();
+        transcriber->set_event_bus(bus);
+        if (!transcriber->load(config) || transcriber->attach(&capture) < 0) {
+            std::cerr << "Cannot load whisper.cpp model: " << options.model << std::endl;
+            return 2;
+        }
+    }
+#else
+    if (!options.model.empty()) {
+        std::cerr << "Built without whisper.cpp (KOELINGO_WITH_WHISPER_CPP); --model is not supported" << std::endl;
+        return 2;
+    }
+#endif
+    bool transcribing = !options.model.empty();
+
+    // The replay delivers its first period from inside start_recording()
+    int64_t start_ns = steady_ns();
+    if (!capture.start_recording()) {
+        std::cerr << "Cannot start the replay" << std::endl;
+        return 2;
+    }
+    double period_us = capture.get_effective_latency().period_ms * 1000.0;
+
+    // Capture frames map to source frames through the resampler (if any)
+    const double source_per_capture = static_cast<double>(source->sample_rate()) / kSampleRate;
+    const uint64_t resampler_delay = capture.resampler_latency_frames();
+
+    std::vector<double> vad_latency_ms;
+    std::vector<double> e2e_latency_ms;
+    std::vector<double> rss_hours;
+    std::vector<double> rss_mb;
+    uint64_t utterances = 0;
+    uint64_t transcripts = 0;
+    uint64_t untimed_events = 0;
+    size_t peak_stt_queue = 0;
+    size_t peak_event_queue = 0;
+    double rss_start_mb = static_cast<double>(resident_bytes()) / (1 << 20);
+    double rss_peak_mb = rss_start_mb;
+    double warmup_s = std::min(options.warmup_s, options.duration_s / 4.0);
+
+    double next_sample_s = 0.0;
+    double next_report_s = options.report_s;
+    std::vector<Event> batch(256);
+    Utterance utterance;
+    while (true) {
+        double elapsed_s = (steady_ns() - start_ns) / 1e9;
+        if (elapsed_s >= options.duration_s) {
+            break;
+        }
+
+        if (events->wait(100)) {
+            size_t count = events->poll(batch.data(), batch.size());
+            for (size_t i = 0; i < count; i++) {
+                const Event& event = batch[i];
+                if (event.type == EventType::kUtterance) {
+                    utterances++;
+                } else {
+                    transcripts++;
+                }
+
+                // The event could only be raised once its last frame had arrived
+                int64_t delivered_ns;
+                uint64_t last_frame = event.end_frame > 0 ? event.end_frame - 1 : 0;
+                uint64_t source_frame = static_cast<uint64_t>(
+                    (last_frame + resampler_delay) * source_per_capture);
+                if (!stamped->delivery_time(source_frame, delivered_ns)) {
+                    untimed_events++;
+                    continue;
+                }
+                double latency_ms = (event.timestamp_ns - delivered_ns) / 1e6;
+                if (event.type == EventType::kUtterance) {
+                    vad_latency_ms.push_back(latency_ms);
+                } else {
+                    e2e_latency_ms.push_back(latency_ms);
+                }
+            }
+        }
+        // Without a transcriber the utterances are only counted
+        if (!transcribing) {
+            while (capture.wait_for_utterance(utterance, 0)) {
+            }
+        }
+
+        if (elapsed_s >= next_sample_s) {
+            double mb = static_cast<double>(resident_bytes()) / (1 << 20);
+            rss_peak_mb = std::max(rss_peak_mb, mb);
+            if (elapsed_s >= warmup_s) {
+                rss_hours.push_back(elapsed_s / 3600.0);
+                rss_mb.push_back(mb);
+            }
+#ifdef KOELINGO_HAVE_WHISPER_CPP
+            if (transcriber) {
+                peak_stt_queue = std::max(peak_stt_queue, transcriber->pending());
+            }
+#endif
+            peak_event_queue = std::max(peak_event_queue, events->pending());
+            next_sample_s += options.sample_s;
+        }
+
+        if (elapsed_s >= next_report_s) {
+            CaptureStats stats = capture.get_stats();
+            std::printf("[%8.0f s] utterances %llu, transcripts %llu, rss %.1f MB, backlog %llu frames, "
+                        "dropped frames %llu, dropped utterances %llu\n",
+                        elapsed_s, static_cast<unsigned long long>(utterances),
+                        static_cast<unsigned long long>(transcripts),
+                        rss_mb.empty() ? rss_start_mb : rss_mb.back(),
+                        static_cast<unsigned long long>(stats.ring_backlog_frames),
+                        static_cast<unsigned long long>(stats.dropped_frames),
+                        static_cast<unsigned long long>(stats.dropped_utterances));
+            std::fflush(stdout);
+            next_report_s += options.report_s;
+        }
+    }
+
+    CaptureStats stats = capture.get_stats();
+    capture.stop_recording();
+#ifdef KOELINGO_HAVE_WHISPER_CPP
+    if (transcriber) {
+        transcriber->stop();
+    }
+#endif
+
+    std::vector<std::pair<std::string, double>> metrics = {
+        {"utterances", static_cast<double>(utterances)},
+        {"transcripts", static_cast<double>(transcripts)},
+        {"vad_latency_p50_ms", percentile(vad_latency_ms, 0.50)},
+        {"vad_latency_p95_ms", percentile(vad_latency_ms, 0.95)},
+        {"vad_latency_p99_ms", percentile(vad_latency_ms, 0.99)},
+    };
+    if (transcribing) {
+        metrics.push_back({"e2e_latency_p50_ms", percentile(e2e_latency_ms, 0.50)});
+        metrics.push_back({"e2e_latency_p95_ms", percentile(e2e_latency_ms, 0.95)});
+        metrics.push_back({"e2e_latency_p99_ms", percentile(e2e_latency_ms, 0.99)});
+    }
+    metrics.push_back({"untimed_events", static_cast<double>(untimed_events)});
+    metrics.push_back({"rss_start_mb", rss_start_mb});
+    metrics.push_back({"rss_peak_mb", rss_peak_mb});
+    metrics.push_back({"rss_growth_mb_per_hour", slope(rss_hours, rss_mb)});
+    metrics.push_back({"callback_overruns",
+                       static_cast<double>(count_overruns(stats.callback_duration, period_us))});
+    metrics.push_back({"input_overflows", static_cast<double>(stats.input_overflows)});
+    metrics.push_back({"dropped_frames", static_cast<double>(stats.dropped_frames)});
+    metrics.push_back({"dropped_utterances", static_cast<double>(stats.dropped_utterances)});
+    metrics.push_back({"dropped_events", static_cast<double>(events->dropped())});
+    metrics.push_back({"peak_ring_backlog_frames", static_cast<double>(stats.ring_peak_backlog_frames)});
+    metrics.push_back({"peak_stt_queue", static_cast<double>(peak_stt_queue)});
+    metrics.push_back({"peak_event_queue", static_cast<double>(peak_event_queue)});
+
+    std::printf("\nSummary after %.0f s:\n", options.duration_s);
+    for (const auto& metric : metrics) {
+        std::printf("  %-26s %12.2f\n", metric.first.c_str(), metric.second);
+    }
+
+    int status = 0;
+    if (utterances == 0) {
+        std::printf("FAIL: no utterances were detected\n");
+        status = 1;
+    }
+    // An event cannot precede the delivery of its last frame; if it seems to,
+    // the latency measurement itself is broken
+    for (const std::vector<double>* latencies : {&vad_latency_ms, &e2e_latency_ms}) {
+        if (!latencies->empty() && *std::min_element(latencies->begin(), latencies->end()) < 0.0) {
+            std::printf("FAIL: negative latency %.2f ms recorded\n",
+                        *std::min_element(latencies->begin(), latencies->end()));
+            status = 1;
+        }
+    }
+    if (!options.baseline.empty()) {
+        std::map<std::string, double> baseline = read_metrics(options.baseline);
+        if (baseline.empty()) {
+            std::cerr << "Cannot read baseline: " << options.baseline << std::endl;
+            return 2;
+        }
+        for (const MetricRule& rule : kRules) {
+            auto expected = baseline.find(rule.name);
+            auto measured = std::find_if(metrics.begin(), metrics.end(),
+                                         [&](const auto& metric) { return metric.first == rule.name; });
+            if (expected == baseline.end() || measured == metrics.end()) {
+                continue;
+            }
+            double limit = std::max(expected->second, 0.0) * (1.0 + options.tolerance) + rule.slack;
+            if (measured->second > limit) {
+                std::printf("FAIL: %s %.2f exceeds baseline %.2f (limit %.2f)\n",
+                            rule.name, measured->second, expected->second, limit);
+                status = 1;
+            }
+        }
+        if (status == 0) {
+            std::printf("PASS: no metric regressed past %s\n", options.baseline.c_str());
+        }
+    }
+    if (!options.write_baseline.empty() && !write_metrics(options.write_baseline, metrics, options)) {
+        std::cerr << "Cannot write baseline: " << options.write_baseline << std::endl;
+        return 2;
+    }
+    return status;
+}
@@ -0,0 +1,551 @@
+/**
+ * @file whisper_transcriber.cc
+ * @brief Implementation of the whisper.cpp transcriber
+ */
+
+#include "whisper_transcriber.h"
+#include "resampler.h"
+#include "sample_format.h"
+#include <portaudio.h>
+#include <whisper.h>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <numeric>
+
+namespace koelingo {
+namespace stt {
+
+namespace {
+
+constexpr int kWhisperRate = 16000;
+constexpr size_t kWarmUpSamples = kWhisperRate / 2;
+
+// Where the new-segment callback publishes partial transcripts
+struct PartialSink {
+    audio::EventBus* bus;
+    const Transcript* transcript; // Stream and frames of the utterance being decoded
+};
+
+// whisper.cpp new-segment callback: publish the text decoded so far
+void publish_partial(whisper_context* /*ctx*/, whisper_state* state, int /*n_new*/, void* user_data) {
+    const PartialSink* sink = static_cast<const PartialSink*>(user_data);
+    audio::Event event;
+    event.type = audio::EventType::kPartialTranscript;
+    event.source = static_cast<uint32_t>(std::max(0, sink->transcript->stream));
+    event.start_frame = sink->transcript->start_frame;
+    event.end_frame = sink->transcript->end_frame;
+    int segments = whisper_full_n_segments_from_state(state);
+    for (int i = 0; i < segments; i++) {
+        event.text += whisper_full_get_segment_text_from_state(state, i);
+    }
+    size_t first = event.text.find_first_not_of(' ');
+    event.text.erase(0, first == std::string::npos ? event.text.size() : first);
+    if (!event.text.empty()) {
+        sink->bus->publish(event);
+    }
+}
+
+// Per-worker job queues; owners take from the front, idle workers steal
+// from the back of the others
+class StealingQueues {
+public:
+    explicit StealingQueues(size_t queues) {
+        for (size_t i = 0; i < queues; i++) {
+            queues_.push_back(std::make_unique<Queue>());
+        }
+    }
+
+    void push(size_t queue, size_t job) {
+        queues_[queue]->jobs.push_back(job);
+    }
+
+    bool pop(size_t queue, size_t& job) {
+        for (size_t i = 0; i < queues_.size(); i++) {
+            Queue& victim = *queues_[(queue + i) % queues_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.jobs.empty()) {
+                continue;
+            }
+            if (i == 0) {
+                job = victim.jobs.front();
+                victim.jobs.pop_front();
+            } else {
+                job = victim.jobs.back();
+                victim.jobs.pop_back();
+            }
+            return true;
+        }
+        return false;
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<size_t> jobs;
+    };
+    std::vector<std::unique_ptr<Queue>> queues_;
+};
+
+} // namespace
+
+// Convert captured frames to 16 kHz mono float32
+bool to_whisper_input(const char* data, size_t frames, int sample_rate, int channels,
+                      int format_type, std::vector<float>& output) {
+    if (sample_rate == kWhisperRate && channels == 1) {
+        output.resize(frames);
+        audio::convert_to_float32(data, frames, format_type, output.data());
+        return true;
+    }
+
+    // The resampler also downmixes to mono
+    audio::Resampler resampler;
+    if (!resampler.configure(sample_rate, kWhisperRate, channels, format_type, frames)) {
+        std::cerr << "Cannot convert " << sample_rate << " Hz audio for whisper.cpp" << std::endl;
+        return false;
+    }
+
+    // Push silence through to flush the filter delay, then drop the delay
+    size_t delay = resampler.latency_frames();
+    size_t flush_frames = (delay * sample_rate + kWhisperRate - 1) / kWhisperRate + 1;
+    std::vector<char> silence(flush_frames * channels * audio::bytes_per_sample(format_type), 0);
+    if (format_type == paUInt8) { // Unsigned samples are centred on 128
+        std::fill(silence.begin(), silence.end(), static_cast<char>(128));
+    }
+
+    std::vector<float> converted(resampler.max_output_frames(frames) +
+                                 resampler.max_output_frames(flush_frames));
+    size_t count = resampler.process(data, frames, converted.data(), converted.size());
+    count += resampler.process(silence.data(), flush_frames, converted.data() + count,
+                               converted.size() - count);
+
+    size_t wanted = static_cast<size_t>(static_cast<uint64_t>(frames) * kWhisperRate / sample_rate);
+    size_t start = std::min(delay, count);
+    output.assign(converted.begin() + start,
+                  converted.begin() + std::min(count, start + wanted));
+    return true;
+}
+
+// WhisperTranscriber constructor
+WhisperTranscriber::WhisperTranscriber()
+    : ctx_(nullptr),
+      stopping_(false),
+      sync_state_(nullptr) {
+}
+
+// WhisperTranscriber destructor
+WhisperTranscriber::~WhisperTranscriber() {
+    stop();
+    if (sync_state_) {
+        whisper_free_state(sync_state_);
+    }
+    if (ctx_) {
+        whisper_free(ctx_);
+    }
+}
+
+// Load the model and start the decode workers
+bool WhisperTranscriber::load(const WhisperConfig& config) {
+    if (ctx_) {
+        std::cerr << "A whisper.cpp model is already loaded" << std::endl;
+        return false;
+    }
+
+    whisper_context_params params = whisper_context_default_params();
+    params.use_gpu = config.use_gpu;
+    params.flash_attn = config.flash_attention;
+
+    // Weights are shared; every worker allocates its own state below
+    ctx_ = whisper_init_from_file_with_params_no_state(config.model_path.c_str(), params);
+    if (!ctx_) {
+        std::cerr << "Failed to load whisper.cpp model: " << config.model_path << std::endl;
+        return false;
+    }
+    config_ = config;
+    config_.workers = std::max(1, config.workers);
+    config_.queue_limit = std::max(1, config.queue_limit);
+
+    stopping_ = false;
+    worker_results_.clear();
+    for (int i = 0; i < config_.workers; i++) {
+        workers_.emplace_back(&WhisperTranscriber::run_worker, this);
+    }
+
+    // Workers report their policy before they take jobs
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    queue_cv_.wait(lock, [this] { return worker_results_.size() == workers_.size(); });
+    return true;
+}
+
+// Set the function receiving transcripts
+void WhisperTranscriber::set_callback(std::function<void(const Transcript&)> callback) {
+    callback_ = std::move(callback);
+}
+
+// Publish transcripts on an event bus
+void WhisperTranscriber::set_event_bus(std::shared_ptr<audio::EventBus> bus) {
+    event_bus_ = std::move(bus);
+}
+
+// Transcribe the utterances of a capture
+int WhisperTranscriber::attach(audio::AudioCapture* capture) {
+    if (!ctx_ || !capture || workers_.empty()) {
+        return -1;
+    }
+
+    std::lock_guard<std::mutex> lock(streams_mutex_);
+    int index = static_cast<int>(streams_.size());
+    streams_.push_back(std::make_unique<Stream>());
+    Stream& stream = *streams_.back();
+    stream.capture = capture;
+    stream.active = true;
+    stream.reader = std::make_unique<std::thread>(&WhisperTranscriber::read_utterances, this, index);
+    return index;
+}
+
+// Stop reading utterances from a stream
+void WhisperTranscriber::detach(int stream) {
+    std::unique_ptr<std::thread> reader;
+    {
+        std::lock_guard<std::mutex> lock(streams_mutex_);
+        if (stream < 0 || stream >= static_cast<int>(streams_.size()) || !streams_[stream]->active) {
+            return;
+        }
+        streams_[stream]->active = false;
+        reader = std::move(streams_[stream]->reader);
+    }
+
+    // A reader blocked on a full queue must see the detach
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+    }
+    queue_cv_.notify_all();
+    if (reader && reader->joinable()) {
+        reader->join();
+    }
+}
+
+// Detach every stream and stop the workers
+void WhisperTranscriber::stop() {
+    size_t count;
+    {
+        std::lock_guard<std::mutex> lock(streams_mutex_);
+        count = streams_.size();
+    }
+    for (size_t i = 0; i < count; i++) {
+        detach(static_cast<int>(i));
+    }
+
+    // Workers finish what is queued before they exit
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        stopping_ = true;
+    }
+    queue_cv_.notify_all();
+    for (std::thread& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers_.clear();
+}
+
+// Transcribe audio synchronously
+bool WhisperTranscriber::transcribe(const float* samples, size_t count, Transcript& result) {
+    if (!ctx_) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(sync_mutex_);
+    if (!sync_state_) {
+        sync_state_ = whisper_init_state(ctx_);
+        if (!sync_state_) {
+            return false;
+        }
+    }
+    return decode(sync_state_, samples, count, result);
+}
+
+// Transcribe a recorded WAV file
+bool WhisperTranscriber::transcribe_file(const std::string& path, const FileTranscriptionConfig& config,
+                                         FileTranscription& result,
+                                         std::function<void(size_t, size_t)> progress) {
+    result = FileTranscription();
+    if (!ctx_) {
+        return false;
+    }
+    auto started = std::chrono::steady_clock::now();
+
+    audio::MappedWav wav;
+    if (!wav.open(path)) {
+        return false;
+    }
+    result.sample_rate = wav.sample_rate();
+    result.audio_seconds = static_cast<double>(wav.frames()) / wav.sample_rate();
+
+    std::vector<audio::UtteranceSegment> segments = audio::segment_file(wav, config.segmenter);
+    result.utterances = segments.size();
+    std::vector<Transcript> transcripts(segments.size());
+    std::vector<char> decoded(segments.size(), 0); // Not vector<bool>: workers write concurrently
+
+    // Longest first, dealt round-robin, so the tail left to steal is short jobs
+    size_t workers = static_cast<size_t>(config.workers > 0 ? config.workers : config_.workers);
+    workers = std::max<size_t>(1, std::min(workers, segments.size()));
+    std::vector<size_t> order(segments.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return segments[a].end_frame - segments[a].start_frame >
+               segments[b].end_frame - segments[b].start_frame;
+    });
+    StealingQueues queues(workers);
+    for (size_t i = 0; i < order.size(); i++) {
+        queues.push(i % workers, order[i]);
+    }
+
+    std::mutex progress_mutex;
+    size_t done = 0;
+    auto run = [&](size_t queue) {
+        audio::apply_thread_policy(config_.worker_policy);
+        whisper_state* state = whisper_init_state(ctx_);
+        if (!state) {
+            std::cerr << "Failed to allocate a whisper.cpp state" << std::endl;
+            return;
+        }
+        std::vector<float> samples;
+        size_t job;
+        while (queues.pop(queue, job)) {
+            const audio::UtteranceSegment& segment = segments[job];
+            Transcript& transcript = transcripts[job];
+            transcript.start_frame = segment.start_frame;
+            transcript.end_frame = segment.end_frame;
+            size_t frames = static_cast<size_t>(segment.end_frame - segment.start_frame);
+            decoded[job] = to_whisper_input(wav.frame(segment.start_frame), frames, wav.sample_rate(),
+                                            wav.channels(), wav.format_type(), samples) &&
+                           decode(state, samples.data(), samples.size(), transcript);
+
+            if (progress) {
+                std::lock_guard<std::mutex> lock(progress_mutex);
+                progress(++done, segments.size());
+            }
+        }
+        whisper_free_state(state);
+    };
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < workers; i++) {
+        threads.emplace_back(run, i);
+    }
+    run(0);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    for (size_t i = 0; i < transcripts.size(); i++) {
+        if (!decoded[i]) {
+            result.failed++;
+        } else if (!transcripts[i].text.empty()) {
+            result.transcripts.push_back(std::move(transcripts[i]));
+        }
+    }
+    result.elapsed_seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - started).count();
+    return true;
+}
+
+// Get the number of utterances waiting for a worker
+size_t WhisperTranscriber::pending() const {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    return queue_.size();
+}
+
+// Get what the worker policy achieved
+audio::ThreadPolicyResult WhisperTranscriber::worker_policy_result() const {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    return audio::combine_policy_results(worker_results_);
+}
+
+// Get the acceleration backends compiled into whisper.cpp
+std::string WhisperTranscriber::system_info() {
+    return whisper_print_system_info();
+}
+
+// Reader thread: move utterances from a capture's VAD queue to the workers
+void WhisperTranscriber::read_utterances(int index) {
+    Stream* stream;
+    {
+        std::lock_guard<std::mutex> lock(streams_mutex_);
+        stream = streams_[index].get();
+    }
+    audio::AudioCapture* capture = stream->capture;
+
+    audio::Utterance utterance;
+    uint64_t onsets_seen = capture->speech_onsets();
+    while (stream->active) {
+        // Leave utterances in the VAD queue while the workers are saturated
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            queue_cv_.wait(lock, [&] {
+                return queue_.size() < static_cast<size_t>(config_.queue_limit) || !stream->active;
+            });
+        }
+        if (!stream->active) {
+            break;
+        }
+        bool found = capture->wait_for_utterance(utterance, 200);
+
+        // Polled rather than waited for: the utterance follows the onset by
+        // at least min_speech_ms plus hangover_ms
+        uint64_t onsets = capture->speech_onsets();
+        if (onsets != onsets_seen) {
+            onsets_seen = onsets;
+            if (config_.warm_up_on_onset) {
+                queue_warm_up();
+            }
+        }
+
+        if (!found) {
+            // Returns at once while the capture is stopped
+            if (!capture->is_recording()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            }
+            continue;
+        }
+
+        Job job;
+        size_t frames = utterance.data.size() / capture->bytes_per_frame();
+        if (!to_whisper_input(utterance.data.data(), frames, capture->sample_rate(),
+                              capture->channels(), capture->format_type(), job.samples)) {
+            continue;
+        }
+        job.transcript.stream = index;
+        job.transcript.start_frame = utterance.start_frame;
+        job.transcript.end_frame = utterance.end_frame;
+
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            queue_.push_back(std::move(job));
+        }
+        queue_cv_.notify_all();
+    }
+}
+
+// Queue a silent decode if no worker has anything to do
+void WhisperTranscriber::queue_warm_up() {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    if (!queue_.empty()) {
+        return; // Busy, so already warm
+    }
+    Job job;
+    job.warm_up = true;
+    job.samples.assign(kWarmUpSamples, 0.0f);
+    queue_.push_back(std::move(job));
+    queue_cv_.notify_all();
+}
+
+// Decode worker
+void WhisperTranscriber::run_worker() {
+    audio::ThreadPolicyResult result = audio::apply_thread_policy(config_.worker_policy);
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        worker_results_.push_back(result);
+    }
+    queue_cv_.notify_all();
+
+    whisper_state* state = whisper_init_state(ctx_);
+    if (!state) {
+        std::cerr << "Failed to allocate a whisper.cpp state" << std::endl;
+        return;
+    }
+
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            queue_cv_.wait(lock, [this] { return !queue_.empty() || stopping_; });
+            if (queue_.empty()) {
+                break;
+            }
+            job = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        queue_cv_.notify_all(); // Room for readers
+
+        if (decode(state, job.samples.data(), job.samples.size(), job.transcript, !job.warm_up) &&
+            !job.warm_up && !job.transcript.text.empty()) {
+            if (callback_) {
+                callback_(job.transcript);
+            }
+            if (event_bus_) {
+                audio::Event event;
+                event.type = audio::EventType::kFinalTranscript;
+                event.source = static_cast<uint32_t>(std::max(0, job.transcript.stream));
+                event.start_frame = job.transcript.start_frame;
+                event.end_frame = job.transcript.end_frame;
+                event.value = job.transcript.confidence;
+                event.text = job.transcript.text;
+                event_bus_->publish(event);
+            }
+        }
+    }
+
+    whisper_free_state(state);
+}
+
+// Run whisper.cpp on one utterance
+bool WhisperTranscriber::decode(whisper_state* state, const float* samples, size_t count,
+                                Transcript& result, bool publish_partials) {
+    whisper_full_params params = whisper_full_default_params(
+        config_.beam_size > 1 ? WHISPER_SAMPLING_BEAM_SEARCH : WHISPER_SAMPLING_GREEDY);
+    params.n_threads = std::max(1, config_.threads_per_worker);
+    params.language = config_.language.c_str();
+    params.translate = false;
+    params.no_context = true;       // Utterances are independent
+    params.no_timestamps = true;
+    params.print_progress = false;
+    params.print_realtime = false;
+    params.print_timestamps = false;
+    params.print_special = false;
+    params.suppress_blank = true;
+    params.beam_search.beam_size = std::max(1, config_.beam_size);
+
+    // Subscribers see each segment as soon as it is decoded
+    PartialSink sink{event_bus_.get(), &result};
+    if (publish_partials && event_bus_ && event_bus_->wants(audio::EventType::kPartialTranscript)) {
+        params.new_segment_callback = publish_partial;
+        params.new_segment_callback_user_data = &sink;
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    if (whisper_full_with_state(ctx_, state, params, samples, static_cast<int>(count)) != 0) {
+        std::cerr << "whisper.cpp failed to decode an utterance" << std::endl;
+        return false;
+    }
+    result.decode_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - started).count();
+
+    // Concatenate the segments; confidence is the mean probability of the text tokens
+    const whisper_token eot = whisper_token_eot(ctx_);
+    double probability = 0.0;
+    int tokens = 0;
+    result.text.clear();
+    int segments = whisper_full_n_segments_from_state(state);
+    for (int i = 0; i < segments; i++) {
+        result.text += whisper_full_get_segment_text_from_state(state, i);
+        int n = whisper_full_n_tokens_from_state(state, i);
+        for (int j = 0; j < n; j++) {
+            if (whisper_full_get_token_id_from_state(state, i, j) >= eot) {
+                continue; // Special and timestamp tokens
+            }
+            probability += whisper_full_get_token_p_from_state(state, i, j);
+            tokens++;
+        }
+    }
+
+    // whisper.cpp keeps the leading space of the first token
+    size_t first = result.text.find_first_not_of(' ');
+    result.text.erase(0, first == std::string::npos ? result.text.size() : first);
+    result.confidence = tokens ? static_cast<float>(probability / tokens) : 0.0f;
+    return true;
+}
+
+} // namespace stt
+} // namespace koelingo
@@ -0,0 +1,259 @@
+/**
+ * @file whisper_transcriber.h
+ * @brief Native whisper.cpp speech recognition fed by AudioCapture utterances
+ */
+
+#ifndef KOELINGO_WHISPER_TRANSCRIBER_H
+#define KOELINGO_WHISPER_TRANSCRIBER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "audio_capture.h"
+#include "event_bus.h"
+#include "file_segmenter.h"
+
+struct whisper_context;
+struct whisper_state;
+
+namespace koelingo {
+namespace stt {
+
+/**
+ * @struct WhisperConfig
+ * @brief Model and decoding parameters for WhisperTranscriber
+ */
+struct WhisperConfig {
+    std::string model_path;      ///< ggml model file (e.g. ggml-small.bin)
+    std::string language = "ja"; ///< Spoken language, or "auto" to detect
+    bool use_gpu = true;         ///< Use Metal/CUDA when whisper.cpp was built with them
+    bool flash_attention = false; ///< Flash attention (GPU builds only)
+    int workers = 1;             ///< Utterances decoded in parallel (one whisper state each)
+    int threads_per_worker = 4;  ///< CPU threads per decode
+    int beam_size = 5;           ///< Beam width; 1 for greedy decoding
+    int queue_limit = 8;         ///< Pending utterances at which readers stop draining the VAD
+    bool warm_up_on_onset = true; ///< Decode a short silence when speech starts after idle
+    /// Scheduling of the decode workers. Pinning keeps inference off the
+    /// capture cores; on Linux the ggml threads they start inherit the CPUs.
+    audio::ThreadPolicy worker_policy;
+};
+
+/**
+ * @struct Transcript
+ * @brief Text recognized for one utterance
+ */
+struct Transcript {
+    std::string text;          ///< Recognized text (UTF-8)
+    float confidence = 0.0f;   ///< Mean token probability in [0, 1]
+    int stream = -1;           ///< Index returned by attach(), or -1 for transcribe()
+    uint64_t start_frame = 0;  ///< First frame of the utterance in its capture stream
+    uint64_t end_frame = 0;    ///< One past the last frame
+    double decode_ms = 0.0;    ///< Time spent in whisper.cpp
+};
+
+/**
+ * @struct FileTranscriptionConfig
+ * @brief How WhisperTranscriber::transcribe_file() splits and spreads the work
+ */
+struct FileTranscriptionConfig {
+    audio::FileSegmenterConfig segmenter; ///< Utterance detection, run in parallel regions
+    int workers = 0;                      ///< Decode workers (0 = WhisperConfig::workers)
+};
+
+/**
+ * @struct FileTranscription
+ * @brief Transcript of a whole file
+ */
+struct FileTranscription {
+    std::vector<Transcript> transcripts; ///< Non-empty utterances in file order; frames index the file
+    int sample_rate = 0;                 ///< Rate of the frame indices
+    double audio_seconds = 0.0;          ///< Length of the file
+    double elapsed_seconds = 0.0;        ///< Wall time spent, segmentation included
+    size_t utterances = 0;               ///< Utterances found by the VAD
+    size_t failed = 0;                   ///< Utterances whisper.cpp could not decode
+};
+
+/**
+ * @class WhisperTranscriber
+ * @brief Transcribes VAD utterances with whisper.cpp on its own threads
+ *
+ * Each attached AudioCapture gets a reader thread that takes utterances
+ * from its VAD queue, converts them to 16 kHz mono float and queues them
+ * for a pool of decode workers. Workers share the model weights but each
+ * owns a whisper state, so several utterances (from one or many streams)
+ * decode at once. Only the finished Transcript reaches the callback; no
+ * Python or GIL is involved on the way from audio to text.
+ *
+ * When queue_limit utterances are waiting, readers stop taking new ones,
+ * so a model that cannot keep up fills the capture's VAD queue and shows
+ * up as dropped_utterances there.
+ *
+ * With warm_up_on_onset, a speech onset on an idle transcriber queues a
+ * short silent decode, so GPU kernels and allocator pools are warm by the
+ * time the utterance itself is complete.
+ *
+ * GPU and BLAS acceleration are whatever the linked whisper.cpp/ggml was
+ * built with (Metal on Apple silicon, CUDA, OpenBLAS or Accelerate).
+ */
+class WhisperTranscriber {
+public:
+    WhisperTranscriber();
+    ~WhisperTranscriber();
+
+    WhisperTranscriber(const WhisperTranscriber&) = delete;
+    WhisperTranscriber& operator=(const WhisperTranscriber&) = delete;
+
+    /**
+     * @brief Load the model and start the decode workers
+     * @param config Model path and decoding parameters
+     * @return False if the model cannot be loaded or a model is already loaded
+     */
+    bool load(const WhisperConfig& config);
+
+    /**
+     * @brief Check whether a model is loaded
+     */
+    bool is_loaded() const { return ctx_ != nullptr; }
+
+    /**
+     * @brief Set the function receiving transcripts
+     * @param callback Called on a decode worker thread; must be set before attach()
+     */
+    void set_callback(std::function<void(const Transcript&)> callback);
+
+    /**
+     * @brief Publish the transcripts of attached streams on an event bus
+     * @param bus Bus to publish on, or nullptr to stop; must be set before attach()
+     *
+     * A partial transcript with the text so far is published as each
+     * whisper.cpp segment of an utterance is decoded, and a final one
+     * when the utterance is done, next to the callback. Event::source is
+     * the stream index returned by attach().
+     */
+    void set_event_bus(std::shared_ptr<audio::EventBus> bus);
+
+    /**
+     * @brief Transcribe the utterances of a capture until detach() or stop()
+     * @param capture Capture with VAD enabled; must outlive the attachment.
+     *        Becomes this transcriber's exclusive utterance consumer.
+     * @return Stream index reported in Transcript::stream, or -1 if no model is loaded
+     */
+    int attach(audio::AudioCapture* capture);
+
+    /**
+     * @brief Stop reading utterances from a stream; queued ones are still decoded
+     * @param stream Index returned by attach()
+     */
+    void detach(int stream);
+
+    /**
+     * @brief Detach every stream, finish queued utterances and stop the workers
+     */
+    void stop();
+
+    /**
+     * @brief Transcribe audio synchronously on the calling thread
+     * @param samples 16 kHz mono samples in [-1.0, 1.0]
+     * @param count Number of samples
+     * @param result Receives the text
+     * @return False if no model is loaded or decoding failed
+     */
+    bool transcribe(const float* samples, size_t count, Transcript& result);
+
+    /**
+     * @brief Transcribe a recorded WAV file as fast as the machine allows
+     * @param path WAV file; it is memory-mapped, not read into memory
+     * @param config Segmentation and worker settings
+     * @param result Receives the transcripts in file order
+     * @param progress Called with (decoded, total) utterances after each one,
+     *        on a worker thread and never concurrently
+     * @return False if no model is loaded or the file cannot be read
+     *
+     * The VAD splits the file into utterances in parallel regions. They are
+     * dealt out longest first to per-worker queues, each worker with its
+     * own whisper state (on the GPU when use_gpu is set), and a worker
+     * whose queue runs dry steals from the others. Throughput therefore
+     * scales with workers * threads_per_worker up to the core count.
+     * Independent of the live workers; both may run at once.
+     */
+    bool transcribe_file(const std::string& path, const FileTranscriptionConfig& config,
+                         FileTranscription& result,
+                         std::function<void(size_t, size_t)> progress = nullptr);
+
+    /**
+     * @brief Get the number of utterances waiting for a worker
+     */
+    size_t pending() const;
+
+    /**
+     * @brief Get what WhisperConfig::worker_policy achieved on the decode workers
+     */
+    audio::ThreadPolicyResult worker_policy_result() const;
+
+    /**
+     * @brief Get the name of the acceleration backends compiled into whisper.cpp
+     */
+    static std::string system_info();
+
+private:
+    struct Job {
+        std::vector<float> samples;
+        Transcript transcript;
+        bool warm_up = false; // Decode only to warm caches; no transcript
+    };
+
+    struct Stream {
+        audio::AudioCapture* capture = nullptr;
+        std::atomic<bool> active{false};
+        std::unique_ptr<std::thread> reader;
+    };
+
+    WhisperConfig config_;
+    whisper_context* ctx_;
+    std::function<void(const Transcript&)> callback_;
+    std::shared_ptr<audio::EventBus> event_bus_;
+
+    std::vector<std::unique_ptr<Stream>> streams_;
+    std::mutex streams_mutex_;
+
+    mutable std::mutex queue_mutex_;
+    std::condition_variable queue_cv_;
+    std::deque<Job> queue_;
+    bool stopping_;
+    std::vector<std::thread> workers_;
+    std::vector<audio::ThreadPolicyResult> worker_results_; // Under queue_mutex_
+
+    std::mutex sync_mutex_; // Serializes transcribe() on sync_state_
+    whisper_state* sync_state_;
+
+    void read_utterances(int stream);
+    void queue_warm_up();
+    void run_worker();
+    bool decode(whisper_state* state, const float* samples, size_t count, Transcript& result,
+                bool publish_partials = false);
+};
+
+/**
+ * @brief Convert captured frames to the 16 kHz mono float32 whisper.cpp expects
+ * @param data Interleaved frames
+ * @param frames Number of frames
+ * @param sample_rate Capture sample rate in Hz
+ * @param channels Number of interleaved channels
+ * @param format_type PortAudio sample format
+ * @param output Receives the converted samples
+ * @return False if the rate cannot be converted
+ */
+bool to_whisper_input(const char* data, size_t frames, int sample_rate, int channels,
+                      int format_type, std::vector<float>& output);
+
+} // namespace stt
+} // namespace koelingo
+
+#endif // KOELINGO_WHISPER_TRANSCRIBER_H
@@ -4,14 +4,38 @@ Audio capture module for KoeLingo.
 This module handles microphone input and audio processing.
 """
 
+import atexit
+import os
 import pyaudio
 import numpy as np
 import wave
 import threading
 import time
-from typing import Optional, Callable, Tuple
+from typing import Optional, Callable, Tuple, List
 from collections import deque
 
+from .chunk_pool import ChunkPool, PooledChunk
+from .event_bus import Event, EventBus, EventType
+
+
+_shared_audio = None
+_shared_audio_lock = threading.Lock()
+
+
+def _get_shared_audio() -> pyaudio.PyAudio:
+    """
+    Get the PortAudio instance shared by every AudioCapture.
+
+    Initializing PortAudio rescans every device, so it is done once per
+    process and terminated at exit rather than per capture.
+    """
+    global _shared_audio
+    with _shared_audio_lock:
+        if _shared_audio is None:
+            _shared_audio = pyaudio.PyAudio()
+            atexit.register(_shared_audio.terminate)
+        return _shared_audio
+
 
 class AudioCapture:
     """Audio capture and processing class for real-time audio input."""
@@ -37,25 +61,60 @@ class AudioCapture:
         self.channels = channels
         self.format_type = format_type
 
-        self.audio = pyaudio.PyAudio()
+        self.audio = _get_shared_audio()
         self.stream = None
         self.is_recording = False
         self.audio_level_callback = None
         self._recording_thread = None
 
-        # Audio buffer for storing chunks (30 seconds of audio)
+        # Maximum level callback rate in Hz (0 = every chunk)
+        self.level_update_hz = 30
+        self._next_level_time = 0.0
+
+        # Bus receiving level, speech onset and utterance events (see set_event_bus())
+        self._event_bus = None
+        self._event_source = 0
+
+        # Device period and periods per processing wake-up (see set_latency_profile())
+        self._period_frames = chunk_size
+        self._wake_periods = 1
+
+        # Ring buffer of the last 30 seconds, preallocated so the callback only copies
         self.buffer_seconds = 30
+        self._frame_bytes = self.channels * self.audio.get_sample_size(self.format_type)
         self.max_buffer_size = int(self.buffer_seconds * self.sample_rate / self.chunk_size)
-        self.audio_buffer = []
 
         # Frame counter for testing purposes
         self.frame_count = 0
 
-        # Audio queue for processing
-        self.audio_queue = deque(maxlen=100)
+        # Total audio frames (samples per channel) captured, used as the
+        # monotonically increasing cursor for read_new()
+        self._frames_written = 0
+        self._data_available = threading.Condition()
+
+        # Pipeline counters reported by get_stats()
+        self._reset_stats()
+
+        # Streaming file recording (WAV only); written from the processing thread
+        self._file_lock = threading.Lock()
+        self._file_config = None
+        self._file_writer = None
+        self._file_index = 0
+        self._file_frames = 0
+        self._file_cursor = 0
+
+        # Pooled chunks queued for read_chunk() (see set_chunk_queue())
+        self._chunk_pool = None
+        self.audio_queue = deque()
 
         # Selected device index
         self.selected_device_index = None
+
+        # Recorded audio replayed in place of the device: (int16 frames, speed, loop)
+        self._replay = None
+        self._replay_thread = None
+        self._replay_stop = threading.Event()
+        self.replay_finished = False
         
         # Continuous processing settings
         self.continuous_mode = False
@@ -68,11 +127,17 @@ class AudioCapture:
         self.buffered_chunks_for_processing = []
         self.continuous_chunks_to_process = 32  # Number of chunks to process at once
         self.speech_energy_threshold = 0.02  # Energy threshold to detect speech
+        self.pre_roll_ms = 300  # Audio kept from before the detected speech
+        self.warmup_idle_ms = 2000  # Silence after which speech raises an onset
+        self.speech_onset_callback = None
+        self._continuous_frames = 0  # Frames analysed in continuous mode
+        self._last_speech_frame = None
 
     def start_recording(self, 
                         audio_level_callback: Optional[Callable[[float], None]] = None,
                         chunk_processing_callback: Optional[Callable[[np.ndarray], None]] = None,
-                        continuous_mode: bool = False) -> bool:
+                        continuous_mode: bool = False,
+                        speech_onset_callback: Optional[Callable[[int], None]] = None) -> bool:
         """
         Start recording audio from the microphone.
 
@@ -80,6 +145,8 @@ class AudioCapture:
             audio_level_callback: Optional callback function to receive audio level updates
             chunk_processing_callback: Optional callback for processing chunks in continuous mode
             continuous_mode: If True, enables continuous chunk processing
+            speech_onset_callback: Called with the first frame of speech that
+                follows warmup_idle_ms of silence, in continuous mode
 
         Returns:
             bool: True if recording started successfully, False otherwise
@@ -91,35 +158,49 @@ class AudioCapture:
             self.audio_level_callback = audio_level_callback
             self.chunk_processing_callback = chunk_processing_callback
             self.continuous_mode = continuous_mode
+            self.speech_onset_callback = speech_onset_callback
             self.speech_detected = False
             self.current_silence_count = 0
             self.buffered_chunks_for_processing = []
+            self._continuous_frames = 0
+            self._last_speech_frame = None
 
             # Use selected device if specified
             input_device = None
             if self.selected_device_index is not None:
                 input_device = self.selected_device_index
 
-            self.stream = self.audio.open(
-                format=self.format_type,
-                channels=self.channels,
-                rate=self.sample_rate,
-                input=True,
-                input_device_index=input_device,
-                frames_per_buffer=self.chunk_size,
-                stream_callback=self._audio_callback
-            )
-
+            if self._replay is None:
+                self.stream = self.audio.open(
+                    format=self.format_type,
+                    channels=self.channels,
+                    rate=self.sample_rate,
+                    input=True,
+                    input_device_index=input_device,
+                    frames_per_buffer=self._period_frames,
+                    stream_callback=self._audio_callback
+                )
+
+            with self._data_available:
+                self._frames_written = 0
+                self._reset_stats()
+                self._clear_chunk_queue()
             self.is_recording = True
-            self.audio_buffer = []
             self.frame_count = 0
-            self.audio_queue.clear()
 
             # Start a thread to process audio in background
             self._recording_thread = threading.Thread(target=self._process_audio)
             self._recording_thread.daemon = True
             self._recording_thread.start()
 
+            # Feed the replay through the stream callback, like device audio
+            if self._replay is not None:
+                self.replay_finished = False
+                self._replay_stop.clear()
+                self._replay_thread = threading.Thread(target=self._run_replay)
+                self._replay_thread.daemon = True
+                self._replay_thread.start()
+
             return True
         except Exception as e:
             print(f"Error starting audio recording: {e}")
@@ -131,50 +212,514 @@ class AudioCapture:
             return
 
         self.is_recording = False
+
+        # Release anyone blocked in wait_for_frames() or read_chunk()
+        with self._data_available:
+            self._data_available.notify_all()
+
         if self.stream:
             self.stream.stop_stream()
             self.stream.close()
             self.stream = None
 
+        if self._replay_thread:
+            self._replay_stop.set()
+            self._replay_thread.join()
+            self._replay_thread = None
+
         if self._recording_thread and self._recording_thread.is_alive():
             self._recording_thread.join(timeout=1.0)
 
+        # Write out what is left and close the recording file
+        self.stop_file_recording()
+
     def _audio_callback(self, in_data, frame_count, time_info, status):
         """Callback function for audio stream."""
         if self.is_recording:
-            # Add the chunk to our buffer
-            self.audio_buffer.append(in_data)
-            self.frame_count += 1
-
-            # Add to processing queue
-            self.audio_queue.append(in_data)
+            with self._data_available:
+                # Copy the period into the ring, overwriting the oldest audio
+                self._write_ring(in_data)
+                self._frames_written += frame_count
+
+                # Queue pooled copies of chunk_size frames each for read_chunk()
+                if self._chunk_pool is not None:
+                    data = memoryview(in_data)
+                    period = self._chunk_pool.chunk_bytes
+                    for offset in range(0, len(data), period):
+                        start_frame = self._frames_written - frame_count + offset // self._frame_bytes
+                        chunk = self._chunk_pool.acquire(data[offset:offset + period], start_frame)
+                        if chunk is None:
+                            self._stats['dropped_chunks'] += 1
+                        else:
+                            self.audio_queue.append(chunk)
+
+                self._stats['callbacks'] += 1
+                if status and status & pyaudio.paInputOverflow:
+                    self._stats['input_overflows'] += 1
+                if status and status & pyaudio.paInputUnderflow:
+                    self._stats['input_underflows'] += 1
+
+                self._data_available.notify_all()
 
-            # Keep buffer at maximum size
-            while len(self.audio_buffer) > self.max_buffer_size:
-                self.audio_buffer.pop(0)
+            self.frame_count += 1
 
             return (in_data, pyaudio.paContinue)
         return (in_data, pyaudio.paComplete)
 
     def _process_audio(self) -> None:
         """Process audio in a background thread."""
+        cursor = 0
+        chunk_samples = self.chunk_size * self.channels
+
         while self.is_recording:
-            # If we have data and a callback for audio levels
-            if self.audio_buffer and self.audio_level_callback:
-                # Calculate audio level from the latest chunk
-                latest_chunk = self.audio_buffer[-1]
-                audio_array = np.frombuffer(latest_chunk, dtype=np.int16)
-                audio_level = self._calculate_audio_level(audio_array)
-
-                # Call the callback with the audio level
-                self.audio_level_callback(audio_level)
-                
+            # Sleep until a full chunk (or wake-up's worth of periods) has arrived instead of polling
+            wake_frames = max(self.chunk_size, self._period_frames * self._wake_periods)
+            if not self.wait_for_frames(cursor, wake_frames, timeout_ms=500):
+                continue
+
+            # Stream to the recording file, if any, before analysis
+            self._write_file_frames()
+
+            # Only read what is new since the last pass, so no chunk is skipped
+            backlog = self._frames_written - cursor
+            audio_array, start_frame, next_cursor = self.read_new(cursor)
+            self._stats['dropped_frames'] += start_frame - cursor
+            self._stats['ring_peak_backlog_frames'] = max(
+                self._stats['ring_peak_backlog_frames'], backlog)
+            cursor = self._processed_frames = next_cursor
+            continuous = self.continuous_mode and self.chunk_processing_callback
+            bus = self._event_bus
+            levels = self.audio_level_callback or (bus and bus.wants(EventType.LEVEL))
+            if not levels and not continuous:
+                continue
+
+            for start in range(0, len(audio_array), chunk_samples):
+                chunk = audio_array[start:start + chunk_samples]
+                audio_level = self._calculate_audio_level(chunk)
+
+                # Report the audio level, at most level_update_hz times a second
+                now = time.monotonic()
+                if levels and now >= self._next_level_time:
+                    if self.audio_level_callback:
+                        self.audio_level_callback(audio_level)
+                    if bus:
+                        bus.publish(Event(EventType.LEVEL, source=self._event_source,
+                                          value=audio_level))
+                    if self.level_update_hz > 0:
+                        self._next_level_time = now + 1.0 / self.level_update_hz
+
                 # Handle continuous mode processing if enabled
-                if self.continuous_mode and self.chunk_processing_callback:
-                    self._handle_continuous_processing(audio_array, audio_level)
+                if continuous:
+                    self._handle_continuous_processing(chunk, audio_level)
+
+    def set_replay_source(self, source, speed: float = 1.0, loop: bool = False,
+                          sample_rate: Optional[int] = None) -> bool:
+        """
+        Replay recorded audio instead of capturing from the device.
+
+        Args:
+            source: Path of a 16-bit WAV file, an array of samples shaped
+                (frames,) or (frames, channels) (int16, or float in [-1, 1]),
+                or None to capture from the device again
+            speed: Replay speed relative to real time (0 = as fast as processing keeps up)
+            loop: Restart from the beginning instead of finishing
+            sample_rate: Sample rate of an array source (default: the capture rate)
+
+        Returns:
+            bool: False if recording is active or the audio does not match
+            the capture format (this implementation does not convert)
+        """
+        if self.is_recording or speed < 0:
+            return False
+        if source is None:
+            self._replay = None
+            return True
+        if self.format_type != pyaudio.paInt16:
+            return False
+
+        try:
+            if isinstance(source, str):
+                with wave.open(source, 'rb') as wav:
+                    if wav.getsampwidth() != 2:
+                        return False
+                    sample_rate = wav.getframerate()
+                    channels = wav.getnchannels()
+                    frames = np.frombuffer(wav.readframes(wav.getnframes()), dtype=np.int16)
+            else:
+                samples = np.asarray(source)
+                channels = samples.shape[1] if samples.ndim == 2 else 1
+                if samples.dtype != np.int16:
+                    samples = np.clip(samples * 32768.0, -32768, 32767).astype(np.int16)
+                frames = samples.reshape(-1)
+        except (OSError, EOFError, wave.Error) as e:
+            print(f"Error loading replay source: {e}")
+            return False
+
+        if (sample_rate or self.sample_rate) != self.sample_rate or channels != self.channels:
+            return False
+        self._replay = (frames, speed, loop)
+        return True
+
+    def _run_replay(self) -> None:
+        """Deliver the replay source in device-sized periods."""
+        frames, speed, loop = self._replay
+        chunk_samples = self._period_frames * self.channels
+        limit = self.max_buffer_size * self.chunk_size // 2
+        position = 0
+        next_time = time.monotonic()
+
+        while not self._replay_stop.is_set():
+            if position >= len(frames):
+                if not loop or len(frames) == 0:
+                    self.replay_finished = True
+                    break
+                position = 0
+
+            # Faster than real time, wait for processing instead of dropping chunks
+            while (self._frames_written - self._processed_frames > limit and
+                   not self._replay_stop.is_set()):
+                time.sleep(0.001)
+
+            chunk = frames[position:position + chunk_samples]
+            position += len(chunk)
+            self._audio_callback(chunk.tobytes(), len(chunk) // self.channels, None, 0)
+
+            if speed > 0:
+                next_time += len(chunk) / self.channels / (self.sample_rate * speed)
+                delay = next_time - time.monotonic()
+                if delay > 0:
+                    self._replay_stop.wait(delay)
+                else:
+                    next_time = time.monotonic()
+
+    def _reset_stats(self) -> None:
+        """Clear the pipeline counters at the start of a recording."""
+        self._stats = {
+            'callbacks': 0,
+            'input_overflows': 0,
+            'input_underflows': 0,
+            'dropped_frames': 0,
+            'dropped_chunks': 0,
+            'ring_peak_backlog_frames': 0,
+        }
+        self._processed_frames = 0
+
+    def get_stats(self) -> dict:
+        """
+        Get pipeline counters for the current (or last) recording.
+
+        Uses the same keys as the C++ implementation; latency histograms are
+        only measured there and are left out.
+
+        Returns:
+            dict: Counters and ring-buffer occupancy in frames
+        """
+        with self._data_available:
+            stats = dict(self._stats)
+            stats['frames_captured'] = self._frames_written
+        stats['dropped_utterances'] = 0
+        stats['recording_dropped_frames'] = 0
+        stats['device_failures'] = 0
+        stats['ring_capacity_frames'] = self.max_buffer_size * self.chunk_size
+        stats['ring_backlog_frames'] = max(0, stats['frames_captured'] - self._processed_frames)
+        return stats
+
+    def start_file_recording(self, path: str, max_file_bytes: int = 0,
+                             max_file_seconds: float = 0.0) -> bool:
+        """
+        Stream the capture to WAV files while recording.
 
-            # Sleep to avoid using too much CPU
-            time.sleep(0.05)
+        Args:
+            path: Output file; numbered (session_000.wav, ...) when rotating
+            max_file_bytes: Start a new file past this size (0 = no limit)
+            max_file_seconds: Start a new file past this duration (0 = no limit)
+
+        Returns:
+            bool: False if a file recording is already active
+        """
+        with self._file_lock:
+            if self._file_config is not None:
+                return False
+            self._file_config = (path, max_file_bytes, max_file_seconds)
+            self._file_index = 0
+            self._file_cursor = self._frames_written if self.is_recording else 0
+            return True
+
+    def stop_file_recording(self) -> None:
+        """Write out the remaining audio and close the recording file."""
+        self._write_file_frames()
+        with self._file_lock:
+            if self._file_writer:
+                self._file_writer.close()
+                self._file_writer = None
+            self._file_config = None
+
+    @property
+    def is_file_recording(self) -> bool:
+        """Check whether a file recording is active or waiting to start."""
+        return self._file_config is not None
+
+    def _write_file_frames(self) -> None:
+        """Append the frames captured since the last call to the recording file."""
+        with self._file_lock:
+            if self._file_config is None:
+                return
+            path, max_file_bytes, max_file_seconds = self._file_config
+            samples, _, self._file_cursor = self.read_new(self._file_cursor)
+            sample_width = self.audio.get_sample_size(self.format_type)
+            frame_bytes = self.channels * sample_width
+            data = samples.tobytes()
+
+            # Frames per file under the rotation limits (44-byte header)
+            limit = 0
+            if max_file_seconds > 0:
+                limit = max(1, int(round(max_file_seconds * self.sample_rate)))
+            if max_file_bytes > 0:
+                by_size = max(1, (max_file_bytes - 44) // frame_bytes)
+                limit = min(limit, by_size) if limit else by_size
+
+            while data:
+                if self._file_writer is None:
+                    name = path
+                    if limit:
+                        stem, ext = os.path.splitext(path)
+                        name = f"{stem}_{self._file_index:03d}{ext}"
+                    self._file_writer = wave.open(name, 'wb')
+                    self._file_writer.setnchannels(self.channels)
+                    self._file_writer.setsampwidth(sample_width)
+                    self._file_writer.setframerate(self.sample_rate)
+                    self._file_frames = 0
+
+                frames = len(data) // frame_bytes
+                if limit:
+                    frames = min(frames, limit - self._file_frames)
+                self._file_writer.writeframes(data[:frames * frame_bytes])
+                data = data[frames * frame_bytes:]
+                self._file_frames += frames
+
+                if limit and self._file_frames >= limit:
+                    self._file_writer.close()
+                    self._file_writer = None
+                    self._file_index += 1
+
+    def set_latency_profile(self, profile: str = "balanced", adaptive: bool = False) -> bool:
+        """
+        Choose the device period and processing wake-up cadence.
+
+        Profiles match the C++ implementation ('ultra-low' 8 ms, 'balanced'
+        32 ms, 'power-save' 128 ms woken every second period, 'custom'
+        chunk_size). PyAudio cannot request a host API latency, and
+        processing still runs in chunk_size steps.
+
+        Args:
+            profile: Profile name
+            adaptive: Not supported here
+
+        Returns:
+            bool: False if recording is active, the profile is unknown or
+            adaptive is requested
+        """
+        profiles = {
+            "custom": (self.chunk_size, 1),
+            "ultra-low": (max(1, self.sample_rate * 8 // 1000), 1),
+            "balanced": (max(1, self.sample_rate * 32 // 1000), 1),
+            "power-save": (max(1, self.sample_rate * 128 // 1000), 2),
+        }
+        if self.is_recording or adaptive or profile not in profiles:
+            return False
+        self._period_frames, self._wake_periods = profiles[profile]
+        return True
+
+    def get_latency(self) -> dict:
+        """
+        Get the latency the current (or last) recording runs with.
+
+        Returns:
+            dict: Same keys as the C++ implementation; period_changes is always 0
+        """
+        host_latency_ms = 0.0
+        if self.stream:
+            try:
+                host_latency_ms = 1000.0 * self.stream.get_input_latency()
+            except (IOError, OSError):
+                pass
+        period_ms = 1000.0 * self._period_frames / self.sample_rate
+        return {
+            'period_frames': self._period_frames,
+            'period_ms': period_ms,
+            'host_latency_ms': host_latency_ms,
+            'wake_periods': self._wake_periods,
+            'total_ms': host_latency_ms + period_ms * self._wake_periods,
+            'period_changes': 0,
+        }
+
+    def set_level_update_rate(self, hz: int) -> bool:
+        """
+        Set the maximum rate at which the audio level callback is invoked.
+
+        Args:
+            hz: Updates per second, or 0 to report every chunk
+
+        Returns:
+            bool: False if recording is active or hz is negative
+        """
+        if self.is_recording or hz < 0:
+            return False
+        self.level_update_hz = hz
+        return True
+
+    def set_event_bus(self, bus: Optional[EventBus], source: int = 0) -> bool:
+        """
+        Publish level, speech onset and utterance events on a bus.
+
+        Levels are published at most level_update_hz times a second, onsets
+        and utterances in continuous mode.
+
+        Args:
+            bus: Bus to publish on, or None to stop
+            source: Event.source of the events, to tell captures apart
+
+        Returns:
+            bool: False if recording is active
+        """
+        if self.is_recording:
+            return False
+        self._event_bus = bus
+        self._event_source = source
+        return True
+
+    def read_new(self, cursor: int = 0, max_frames: int = 0,
+                 dtype=np.int16) -> Tuple[np.ndarray, int, int]:
+        """
+        Read only the frames captured since a cursor.
+
+        Args:
+            cursor: Cursor returned by the previous call (0 to start)
+            max_frames: Maximum number of frames to return (0 for no limit)
+            dtype: np.int16 for raw samples, or np.float32 for samples
+                normalized to [-1.0, 1.0]
+
+        Returns:
+            tuple: (samples, start_frame, next_cursor). If the cursor has
+            fallen out of the buffer, start_frame is the oldest retained frame.
+        """
+        with self._data_available:
+            end_frame = self._frames_written
+            start_frame = min(max(cursor, end_frame - self._ring_frames), end_frame)
+            if max_frames > 0:
+                end_frame = min(end_frame, start_frame + max_frames)
+            data = self._read_ring(start_frame, end_frame)
+        next_cursor = end_frame
+
+        audio_array = np.frombuffer(data, dtype=np.int16)
+        if np.dtype(dtype) == np.float32:
+            audio_array = audio_array.astype(np.float32) / 32768.0
+        return audio_array, start_frame, next_cursor
+
+    @property
+    def max_buffer_size(self) -> int:
+        """Ring buffer capacity in chunk_size periods."""
+        return self._ring_frames // self.chunk_size
+
+    @max_buffer_size.setter
+    def max_buffer_size(self, chunks: int) -> None:
+        # Reallocates the ring, so only change it while stopped
+        self._ring_frames = chunks * self.chunk_size
+        self._ring = memoryview(bytearray(self._ring_frames * self._frame_bytes))
+
+    def _write_ring(self, data: bytes) -> None:
+        """Copy a period into the ring buffer (lock held)."""
+        data = memoryview(data).cast('B')
+        size = len(self._ring)
+        offset = self._frames_written * self._frame_bytes % size
+        first = min(len(data), size - offset)
+        self._ring[offset:offset + first] = data[:first]
+        self._ring[:len(data) - first] = data[first:]
+
+    def _read_ring(self, start_frame: int, end_frame: int) -> bytes:
+        """Copy frames still held by the ring buffer out of it (lock held)."""
+        size = len(self._ring)
+        offset = start_frame * self._frame_bytes % size
+        length = (end_frame - start_frame) * self._frame_bytes
+        if offset + length <= size:
+            return self._ring[offset:offset + length].tobytes()
+        return b''.join((self._ring[offset:], self._ring[:offset + length - size]))
+
+    @property
+    def audio_buffer(self) -> List[bytes]:
+        """The retained audio as chunk_size periods (a copy, kept for compatibility)."""
+        data = self.get_buffer()
+        period = self.chunk_size * self._frame_bytes
+        return [data[i:i + period] for i in range(0, len(data), period)]
+
+    def set_chunk_queue(self, chunks: int) -> bool:
+        """
+        Queue every period as a pooled chunk for read_chunk().
+
+        The chunks come from a fixed pool allocated here; when every chunk
+        is still held by a consumer, periods are counted in dropped_chunks.
+
+        Args:
+            chunks: Pool size in periods (0 = stop queueing)
+
+        Returns:
+            bool: False if recording is active or chunks is negative
+        """
+        if self.is_recording or chunks < 0:
+            return False
+        with self._data_available:
+            self._clear_chunk_queue()
+            period = self.chunk_size * self._frame_bytes
+            self._chunk_pool = ChunkPool(chunks, period) if chunks else None
+        return True
+
+    def read_chunk(self, timeout_ms: int) -> Optional[PooledChunk]:
+        """
+        Take the next queued chunk.
+
+        Args:
+            timeout_ms: Maximum time to wait in milliseconds
+
+        Returns:
+            PooledChunk (call release() when done with it), or None on
+            timeout, when recording has stopped and the queue is empty, or
+            when no chunk queue is set
+        """
+        with self._data_available:
+            self._data_available.wait_for(
+                lambda: self.audio_queue or not self.is_recording or self._chunk_pool is None,
+                timeout=timeout_ms / 1000.0,
+            )
+            return self.audio_queue.popleft() if self.audio_queue else None
+
+    def _clear_chunk_queue(self) -> None:
+        """Return chunks nobody read to the pool (lock held)."""
+        while self.audio_queue:
+            self.audio_queue.popleft().release()
+
+    def wait_for_frames(self, cursor: int, frames: int, timeout_ms: int) -> bool:
+        """
+        Block until enough frames are available after a cursor.
+
+        Args:
+            cursor: Frame index to count from
+            frames: Number of frames to wait for
+            timeout_ms: Maximum time to wait in milliseconds
+
+        Returns:
+            bool: True if the frames are available, False on timeout or
+            when recording stops
+        """
+        with self._data_available:
+            return self._data_available.wait_for(
+                lambda: self._frames_written >= cursor + frames or not self.is_recording,
+                timeout=timeout_ms / 1000.0,
+            ) and self._frames_written >= cursor + frames
+
+    @property
+    def frames_written(self) -> int:
+        """Total number of frames captured since recording started."""
+        return self._frames_written
 
     def _calculate_audio_level(self, audio_array: np.ndarray) -> float:
         """
@@ -203,17 +748,26 @@ class AudioCapture:
         Returns:
             bytes: Audio data from the buffer
         """
-        return b''.join(self.audio_buffer)
+        with self._data_available:
+            end_frame = self._frames_written
+            return self._read_ring(max(0, end_frame - self._ring_frames), end_frame)
 
-    def get_buffer_as_numpy(self) -> np.ndarray:
+    def get_buffer_as_numpy(self, dtype=np.int16) -> np.ndarray:
         """
         Get the current audio buffer as a numpy array.
 
+        Args:
+            dtype: np.int16 for raw samples, or np.float32 for samples
+                normalized to [-1.0, 1.0] (ready for Whisper)
+
         Returns:
             np.ndarray: Audio data as a numpy array
         """
         buffer_bytes = self.get_buffer()
-        return np.frombuffer(buffer_bytes, dtype=np.int16)
+        audio_array = np.frombuffer(buffer_bytes, dtype=np.int16)
+        if np.dtype(dtype) == np.float32:
+            return audio_array.astype(np.float32) / 32768.0
+        return audio_array
 
     def save_buffer_to_file(self, filename: str) -> bool:
         """
@@ -309,11 +863,14 @@ class AudioCapture:
         Returns:
             bool: True if signal is detected, False otherwise
         """
-        if not self.audio_buffer:
-            return False
+        with self._data_available:
+            end_frame = self._frames_written
+            if end_frame == 0:
+                return False
+            data = self._read_ring(max(0, end_frame - self.chunk_size), end_frame)
 
-        # Convert last buffer to numpy array
-        audio_array = np.frombuffer(self.audio_buffer[-1], dtype=np.int16)
+        # Convert the last period to a numpy array
+        audio_array = np.frombuffer(data, dtype=np.int16)
 
         # Calculate RMS level
         level = self._calculate_audio_level(audio_array)
@@ -323,9 +880,8 @@ class AudioCapture:
 
     def __del__(self):
         """Clean up resources when object is deleted."""
+        # The PortAudio instance is shared and terminated at exit
         self.stop_recording()
-        if self.audio:
-            self.audio.terminate()
 
     def _handle_continuous_processing(self, audio_array: np.ndarray, level: float) -> None:
         """
@@ -340,16 +896,38 @@ class AudioCapture:
         """
         # Add the current chunk to our buffer for processing
         self.buffered_chunks_for_processing.append(audio_array)
-        
+        frame = self._continuous_frames
+        self._continuous_frames += len(audio_array) // self.channels
+
         # Determine if this is speech or silence
         is_silence = level < self.silence_threshold
-        
+
+        if not is_silence:
+            # Let the recognizer warm up while the first words are spoken
+            idle_frames = self.warmup_idle_ms * self.sample_rate // 1000
+            if (self.speech_onset_callback or self._event_bus) and self.warmup_idle_ms >= 0 and (
+                    self._last_speech_frame is None or frame - self._last_speech_frame >= idle_frames):
+                if self._event_bus:
+                    self._event_bus.publish(Event(EventType.SPEECH_ONSET, source=self._event_source,
+                                                  start_frame=frame))
+                if self.speech_onset_callback:
+                    try:
+                        self.speech_onset_callback(frame)
+                    except Exception as e:
+                        print(f"Error in speech onset callback: {e}")
+            self._last_speech_frame = self._continuous_frames
+
         if not self.speech_detected:
             # If we're not currently tracking speech and this isn't silence,
             # start tracking potential speech
             if not is_silence:
                 self.speech_detected = True
                 self.current_silence_count = 0
+            else:
+                # Only the pre-roll of silence is kept ahead of the speech
+                pre_roll_chunks = -(-self.pre_roll_ms * self.sample_rate // (1000 * self.chunk_size))
+                if len(self.buffered_chunks_for_processing) > pre_roll_chunks:
+                    del self.buffered_chunks_for_processing[:-pre_roll_chunks or None]
         else:
             # If we are tracking speech
             if is_silence:
@@ -375,6 +953,13 @@ class AudioCapture:
         if len(self.buffered_chunks_for_processing) >= self.min_speech_chunks:
             # Combine all chunks into a single array
             combined_audio = np.concatenate(self.buffered_chunks_for_processing)
+
+            if self._event_bus:
+                end_frame = self._continuous_frames
+                self._event_bus.publish(Event(
+                    EventType.UTTERANCE, source=self._event_source,
+                    start_frame=end_frame - len(combined_audio) // self.channels,
+                    end_frame=end_frame))
             
             # Send to callback for processing (likely STT)
             if self.chunk_processing_callback:
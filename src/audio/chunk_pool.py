@@ -0,0 +1,108 @@
+"""
+Pool of reusable audio chunk buffers for the Python implementation.
+
+Mirrors the C++ ChunkPool: every buffer is a slice of one preallocated
+bytearray, so handing chunks to consumers does not create a bytes object
+per period. A chunk returns to the pool when it is released (or collected).
+"""
+
+import threading
+from collections import deque
+from typing import Optional
+
+
+class PooledChunk:
+    """One buffer of a ChunkPool; supports the buffer protocol through data."""
+
+    __slots__ = ("_pool", "_index", "nbytes", "start_frame", "__weakref__")
+
+    def __init__(self, pool: "ChunkPool", index: int):
+        self._pool = pool
+        self._index = index
+        self.nbytes = 0
+        self.start_frame = 0
+
+    @property
+    def data(self) -> memoryview:
+        """
+        The valid bytes of the chunk.
+
+        The view refers to pooled memory: copy it (e.g. np.array(...)) to
+        keep the samples past release().
+        """
+        if self._pool is None:
+            raise ValueError("chunk was released")
+        return self._pool._slots[self._index][:self.nbytes]
+
+    def release(self) -> None:
+        """Return the buffer to the pool; the chunk is empty afterwards."""
+        pool, self._pool = self._pool, None
+        if pool is not None:
+            pool._release(self._index)
+
+    def __enter__(self) -> "PooledChunk":
+        return self
+
+    def __exit__(self, *exc) -> None:
+        self.release()
+
+    def __del__(self):
+        # Safety net for chunks dropped without release()
+        self.release()
+
+
+class ChunkPool:
+    """Fixed number of equally sized buffers carved out of one bytearray."""
+
+    def __init__(self, count: int, chunk_bytes: int):
+        """
+        Allocate the pool.
+
+        Args:
+            count: Number of buffers
+            chunk_bytes: Size of each buffer in bytes
+        """
+        self.chunk_bytes = chunk_bytes
+        self._arena = bytearray(count * chunk_bytes)
+        arena = memoryview(self._arena)
+        self._slots = [arena[i * chunk_bytes:(i + 1) * chunk_bytes] for i in range(count)]
+        self._free = deque(range(count))
+        self._lock = threading.Lock()
+
+    def acquire(self, data: Optional[bytes] = None, start_frame: int = 0) -> Optional[PooledChunk]:
+        """
+        Take a free buffer, optionally filling it.
+
+        Args:
+            data: Bytes to copy in (truncated to chunk_bytes)
+            start_frame: Capture frame index of the first byte
+
+        Returns:
+            PooledChunk, or None if every buffer is in use
+        """
+        with self._lock:
+            if not self._free:
+                return None
+            index = self._free.popleft()
+        chunk = PooledChunk(self, index)
+        if data is not None:
+            nbytes = min(len(data), self.chunk_bytes)
+            self._slots[index][:nbytes] = memoryview(data)[:nbytes]
+            chunk.nbytes = nbytes
+            chunk.start_frame = start_frame
+        return chunk
+
+    def _release(self, index: int) -> None:
+        with self._lock:
+            self._free.append(index)
+
+    @property
+    def capacity(self) -> int:
+        """Number of buffers."""
+        return len(self._slots)
+
+    @property
+    def available(self) -> int:
+        """Number of free buffers."""
+        with self._lock:
+            return len(self._free)
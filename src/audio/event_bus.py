@@ -0,0 +1,218 @@
+"""
+Typed event bus for the Python implementation.
+
+Mirrors the C++ EventBus: the capture and the recognizer publish level,
+speech onset, utterance and transcript events, and every subscription
+gets its own bounded queue of the types it asked for. Events that do not
+fit are counted as dropped instead of blocking the publisher. Each
+subscription also has a descriptor that is readable while events are
+queued, so a UI event loop can watch it (e.g. with QSocketNotifier)
+instead of polling on a timer.
+"""
+
+import enum
+import os
+import threading
+import time
+from collections import deque
+from typing import Iterable, List, Optional
+
+
+class EventType(enum.IntEnum):
+    """Kinds of events on the bus."""
+
+    LEVEL = 0               # Meter level of the capture (value)
+    SPEECH_ONSET = 1        # Speech after an idle spell (start_frame)
+    UTTERANCE = 2           # Complete utterance queued for recognition (start_frame, end_frame, truncated)
+    PARTIAL_TRANSCRIPT = 3  # Text decoded so far for an utterance (text, frames)
+    FINAL_TRANSCRIPT = 4    # Finished text of an utterance (text, value = confidence, frames)
+
+
+ALL_EVENTS = (1 << len(EventType)) - 1
+
+
+class Event:
+    """One event; fields a type does not use are left at their defaults."""
+
+    __slots__ = ('type', 'source', 'timestamp_ns', 'start_frame', 'end_frame',
+                 'value', 'truncated', 'text')
+
+    def __init__(self, type: EventType, source: int = 0, timestamp_ns: int = 0,
+                 start_frame: int = 0, end_frame: int = 0, value: float = 0.0,
+                 truncated: bool = False, text: str = ""):
+        self.type = type
+        self.source = source              # Publisher index, e.g. the stream of a transcript
+        self.timestamp_ns = timestamp_ns  # Monotonic time of publication
+        self.start_frame = start_frame
+        self.end_frame = end_frame
+        self.value = value
+        self.truncated = truncated
+        self.text = text
+
+
+class EventSubscription:
+    """Bounded queue of the events one consumer subscribed to."""
+
+    def __init__(self, mask: int, capacity: int):
+        self.mask = mask
+        self._queue = deque()
+        self._capacity = max(1, capacity)
+        self._dropped = 0
+        self._cond = threading.Condition()
+        self._wake_pending = False
+        # Select-able descriptor; Windows pipes cannot be watched by an event loop
+        self._read_fd = self._write_fd = -1
+        if os.name != 'nt':
+            self._read_fd, self._write_fd = os.pipe()
+            os.set_blocking(self._read_fd, False)
+            os.set_blocking(self._write_fd, False)
+
+    def fileno(self) -> int:
+        """Descriptor that is readable while events are queued (-1 on Windows)."""
+        return self._read_fd
+
+    def poll(self, max_events: int = 64) -> List[Event]:
+        """
+        Take queued events, oldest first.
+
+        Clears the descriptor's readiness unless events are left over.
+
+        Args:
+            max_events: Maximum number of events to return
+
+        Returns:
+            list: Events taken from the queue
+        """
+        with self._cond:
+            count = min(max_events, len(self._queue))
+            events = [self._queue.popleft() for _ in range(count)]
+            if self._wake_pending and not self._queue:
+                self._wake_pending = False
+                self._drain()
+        return events
+
+    def wait(self, timeout_ms: int) -> bool:
+        """
+        Wait until events are queued.
+
+        Returns:
+            bool: False on timeout
+        """
+        with self._cond:
+            return bool(self._cond.wait_for(lambda: self._queue, timeout_ms / 1000.0))
+
+    @property
+    def pending(self) -> int:
+        """Events waiting to be polled."""
+        return len(self._queue)
+
+    @property
+    def dropped(self) -> int:
+        """Events lost because the queue was full."""
+        return self._dropped
+
+    def _deliver(self, event: Event) -> bool:
+        """Queue an event; False (and counted) if the queue is full."""
+        with self._cond:
+            if len(self._queue) >= self._capacity:
+                self._dropped += 1
+                return False
+            self._queue.append(event)
+            if not self._wake_pending:
+                self._wake_pending = True
+                if self._write_fd >= 0:
+                    try:
+                        os.write(self._write_fd, b'\x01')
+                    except BlockingIOError:
+                        pass  # Already readable
+            self._cond.notify_all()
+        return True
+
+    def _drain(self) -> None:
+        """Empty the pipe so the descriptor is no longer readable."""
+        if self._read_fd < 0:
+            return
+        try:
+            while os.read(self._read_fd, 64):
+                pass
+        except BlockingIOError:
+            pass
+
+    def __del__(self):
+        for fd in (self._read_fd, self._write_fd):
+            if fd >= 0:
+                os.close(fd)
+
+
+class EventBus:
+    """Fan-out of typed events to bounded per-consumer queues."""
+
+    def __init__(self):
+        self._subscriptions: List[EventSubscription] = []
+        self._mask = 0  # Union of the subscriptions' masks
+        self._published = 0
+        self._lock = threading.Lock()
+
+    def subscribe(self, types: Optional[Iterable[EventType]] = None,
+                  capacity: int = 256) -> EventSubscription:
+        """
+        Subscribe to events.
+
+        Args:
+            types: Event types to receive (None = all)
+            capacity: Events queued before further ones are dropped
+
+        Returns:
+            EventSubscription: Queue to poll
+        """
+        mask = ALL_EVENTS if types is None else sum({1 << int(t) for t in types})
+        subscription = EventSubscription(mask, capacity)
+        with self._lock:
+            self._subscriptions = self._subscriptions + [subscription]
+            self._mask |= mask
+        return subscription
+
+    def unsubscribe(self, subscription: EventSubscription) -> None:
+        """Stop delivering events to a subscription."""
+        with self._lock:
+            self._subscriptions = [s for s in self._subscriptions if s is not subscription]
+            self._mask = 0
+            for s in self._subscriptions:
+                self._mask |= s.mask
+
+    def wants(self, type: EventType) -> bool:
+        """Check whether any subscription receives a type, to skip building its events."""
+        return bool(self._mask & (1 << int(type)))
+
+    def publish(self, event: Event) -> int:
+        """
+        Deliver an event to every subscription of its type.
+
+        Fills in timestamp_ns if it is zero.
+
+        Returns:
+            int: Number of subscriptions the event was queued on
+        """
+        if not event.timestamp_ns:
+            event.timestamp_ns = time.monotonic_ns()
+        bit = 1 << int(event.type)
+        delivered = 0
+        # Publishers never take the lock; subscribe() swaps in a new list
+        for subscription in self._subscriptions:
+            if subscription.mask & bit and subscription._deliver(event):
+                delivered += 1
+        self._published += 1
+        return delivered
+
+    def publish_transcript(self, text: str, confidence: float = 0.0, final: bool = True,
+                           start_frame: int = 0, end_frame: int = 0, source: int = 0) -> int:
+        """Publish a transcript; returns the number of subscriptions reached."""
+        return self.publish(Event(
+            EventType.FINAL_TRANSCRIPT if final else EventType.PARTIAL_TRANSCRIPT,
+            source=source, start_frame=start_frame, end_frame=end_frame,
+            value=confidence, text=text))
+
+    @property
+    def published(self) -> int:
+        """Events published so far."""
+        return self._published
@@ -8,11 +8,27 @@ and provides a wrapper to ensure compatibility with the Python implementation.
 import os
 import sys
 import logging
-from typing import Optional, Callable, Any, Dict, List, Union
+import threading
+import numpy as np
+from typing import Optional, Callable, Any, Dict, List, Tuple, Union
 
 # Try to import the C++ extension
 try:
-    from .audio_capture_cpp import AudioCaptureCpp
+    try:
+        # Module built next to the audio package (development mode)
+        from ..audio_capture_cc import (AudioCaptureCpp, VadConfig, MelConfig,
+                                        RecorderConfig, RecordingFormat, ReplaySource, WorkerPool,
+                                        LatencyProfile, latency_profile_config, ThreadPolicy,
+                                        EventBus as _CppEventBus, EventType,
+                                        notify_devices_changed as _notify_devices_changed)
+    except ImportError:
+        # Installed package
+        from koelingo.audio.audio_capture_cc import (AudioCaptureCpp, VadConfig, MelConfig,
+                                                     RecorderConfig, RecordingFormat, ReplaySource,
+                                                     WorkerPool, LatencyProfile,
+                                                     latency_profile_config, ThreadPolicy,
+                                                     EventBus as _CppEventBus, EventType,
+                                                     notify_devices_changed as _notify_devices_changed)
     _HAS_CPP_IMPL = True
 except ImportError as e:
     logging.warning(f"Failed to import C++ audio capture implementation: {e}")
@@ -21,6 +37,75 @@ except ImportError as e:
 
 # Import the Python implementation for fallback
 from ..audio_capture import AudioCapture as PyAudioCapture
+from ..event_bus import EventBus as PyEventBus
+if not _HAS_CPP_IMPL:
+    from ..event_bus import EventType
+
+
+def _thread_policy(realtime: bool, priority: int = 0,
+                   cpus: Optional[List[int]] = None) -> Any:
+    """Build a C++ ThreadPolicy."""
+    policy = ThreadPolicy()
+    policy.realtime = realtime
+    policy.priority = priority
+    policy.cpus = list(cpus or [])
+    return policy
+
+
+def _policy_result(result: Any) -> Dict[str, Any]:
+    """Convert a C++ ThreadPolicyResult to a dict."""
+    return {'realtime': result.realtime, 'pinned': result.pinned, 'error': result.error}
+
+
+def create_worker_pool(threads: int = 0, realtime: bool = False,
+                       cpus: Optional[List[int]] = None) -> Optional[Any]:
+    """
+    Create processing threads that several AudioCapture instances can share.
+
+    Pass the pool to AudioCapture.set_worker_pool() on each capture, e.g.
+    one per booth microphone, so N streams do not need N threads. The
+    pool's policy_result tells whether realtime and cpus took effect.
+
+    Args:
+        threads: Number of threads (0 for one per core)
+        realtime: Run the threads with real-time scheduling if permitted
+        cpus: CPUs to pin the threads to (None for no pinning)
+
+    Returns:
+        The pool, or None if the C++ implementation is not available
+    """
+    if not _HAS_CPP_IMPL:
+        return None
+    return WorkerPool(threads, _thread_policy(realtime, cpus=cpus))
+
+
+def create_event_bus() -> Any:
+    """
+    Create a bus for level, speech onset, utterance and transcript events.
+
+    Pass it to AudioCapture.set_event_bus() and, with the C++
+    implementation, to WhisperCppSTT.set_event_bus(). Consumers call
+    subscribe([EventType.LEVEL, ...]) and poll() the subscription when its
+    fileno() becomes readable (e.g. with koelingo.ui.event_bridge), so no
+    Python callback runs on the audio threads. Compare Event.type with
+    this module's EventType, which matches the implementation in use.
+
+    Returns:
+        The C++ EventBus, or the Python one if the extension is not available
+    """
+    return _CppEventBus() if _HAS_CPP_IMPL else PyEventBus()
+
+
+def notify_devices_changed() -> None:
+    """
+    Tell the engine that audio devices were plugged in or removed.
+
+    Devices are enumerated once per process and cached; call this from a
+    hotplug notification and the list is rescanned the next time it is
+    needed with no stream open.
+    """
+    if _HAS_CPP_IMPL:
+        _notify_devices_changed()
 
 
 class AudioCapture:
@@ -48,6 +133,12 @@ class AudioCapture:
             format_type: Audio format type from PortAudio
         """
         self._impl = None
+        self._utterance_thread = None
+        self._onset_thread = None
+        self._chunk_processing_callback = None
+        self._sample_rate = sample_rate
+        self._native_consumer = False  # Utterances go to a native transcriber
+        self._staging = False  # Utterances come in float32 staging buffers
 
         # Try to use C++ implementation first
         if _HAS_CPP_IMPL:
@@ -65,22 +156,99 @@ class AudioCapture:
             self._using_cpp = False
             logging.info("Using Python audio capture implementation")
 
-    def start_recording(self, audio_level_callback: Optional[Callable[[float], None]] = None) -> bool:
+    def start_recording(self,
+                        audio_level_callback: Optional[Callable[[float], None]] = None,
+                        chunk_processing_callback: Optional[Callable[[np.ndarray], None]] = None,
+                        continuous_mode: bool = False,
+                        speech_onset_callback: Optional[Callable[[int], None]] = None) -> bool:
         """
         Start recording audio from the microphone.
 
+        In continuous mode the C++ implementation segments speech with its
+        native voice activity detector, and chunk_processing_callback is only
+        invoked once per complete utterance (as float32 samples).
+
         Args:
             audio_level_callback: Optional callback function to receive audio level updates
+            chunk_processing_callback: Optional callback for processing utterances in continuous mode
+            continuous_mode: If True, enables continuous utterance processing
+            speech_onset_callback: Called with the first frame of speech that follows
+                a quiet spell, long before the utterance is complete, e.g.
+                WhisperSTT.warm_up (continuous mode only)
 
         Returns:
             bool: True if recording started successfully, False otherwise
         """
-        return self._impl.start_recording(audio_level_callback)
+        if not self._using_cpp:
+            return self._impl.start_recording(audio_level_callback,
+                                              chunk_processing_callback,
+                                              continuous_mode,
+                                              speech_onset_callback)
+
+        use_vad = continuous_mode and chunk_processing_callback is not None
+        config = self._impl.vad_config
+        config.enabled = use_vad or self._native_consumer
+        self._impl.set_vad_config(config)
+
+        if not self._impl.start_recording(audio_level_callback):
+            return False
+
+        # An attached native transcriber is the only consumer of the VAD queue
+        if use_vad and not self._native_consumer:
+            self._chunk_processing_callback = chunk_processing_callback
+            self._utterance_thread = threading.Thread(target=self._utterance_loop)
+            self._utterance_thread.daemon = True
+            self._utterance_thread.start()
+
+        if config.enabled and speech_onset_callback:
+            self._onset_thread = threading.Thread(target=self._onset_loop,
+                                                  args=(speech_onset_callback,))
+            self._onset_thread.daemon = True
+            self._onset_thread.start()
+
+        return True
+
+    def _onset_loop(self, callback: Callable[[int], None]) -> None:
+        """Deliver speech onsets from the native VAD."""
+        while True:
+            frame = self._impl.wait_for_speech_onset(timeout_ms=1000)
+            if frame is None:
+                if not self._impl.is_recording:
+                    break
+                continue
+            try:
+                callback(frame)
+            except Exception as e:
+                logging.error(f"Error in speech onset callback: {e}")
+
+    def _utterance_loop(self) -> None:
+        """Deliver utterances from the native VAD; the GIL is only taken per utterance."""
+        wait = self._impl.wait_for_staged_utterance if self._staging else self._impl.wait_for_utterance
+        while True:
+            utterance = wait(timeout_ms=1000)
+            if utterance is None:
+                if not self._impl.is_recording:
+                    break
+                continue
+
+            samples = utterance[0]
+            if self._chunk_processing_callback:
+                try:
+                    self._chunk_processing_callback(samples)
+                except Exception as e:
+                    logging.error(f"Error in utterance callback: {e}")
 
     def stop_recording(self) -> None:
         """Stop recording audio from the microphone."""
         self._impl.stop_recording()
 
+        if self._utterance_thread and self._utterance_thread.is_alive():
+            self._utterance_thread.join(timeout=2.0)
+        self._utterance_thread = None
+        if self._onset_thread and self._onset_thread.is_alive():
+            self._onset_thread.join(timeout=2.0)
+        self._onset_thread = None
+
     def get_buffer(self) -> bytes:
         """
         Get the current audio buffer.
@@ -90,6 +258,316 @@ class AudioCapture:
         """
         return self._impl.get_buffer()
 
+    def get_buffer_as_numpy(self, dtype: Any = np.int16) -> np.ndarray:
+        """
+        Get the current audio buffer as a numpy array.
+
+        With the C++ implementation the array is backed directly by memory
+        owned by the extension, so no extra copy is made on the Python side.
+
+        Args:
+            dtype: np.int16 for raw samples, or np.float32 for samples
+                normalized to [-1.0, 1.0]
+
+        Returns:
+            np.ndarray: Audio data as a numpy array
+        """
+        if self._using_cpp:
+            return self._impl.get_buffer_as_numpy(np.dtype(dtype).name)
+        return self._impl.get_buffer_as_numpy(dtype)
+
+    def read_new(self, cursor: int = 0, max_frames: int = 0,
+                 dtype: Any = np.int16) -> Tuple[np.ndarray, int, int]:
+        """
+        Read only the frames captured since a cursor.
+
+        Args:
+            cursor: Cursor returned by the previous call (0 to start)
+            max_frames: Maximum number of frames to return (0 for no limit)
+            dtype: np.int16 for raw samples, or np.float32 for samples
+                normalized to [-1.0, 1.0]
+
+        Returns:
+            tuple: (samples, start_frame, next_cursor)
+        """
+        if self._using_cpp:
+            return self._impl.read_new(cursor, max_frames, np.dtype(dtype).name)
+        return self._impl.read_new(cursor, max_frames, dtype)
+
+    def wait_for_frames(self, cursor: int, frames: int, timeout_ms: int) -> bool:
+        """
+        Block until enough frames are available after a cursor.
+
+        Args:
+            cursor: Frame index to count from
+            frames: Number of frames to wait for
+            timeout_ms: Maximum time to wait in milliseconds
+
+        Returns:
+            bool: True if the frames are available, False on timeout
+        """
+        return self._impl.wait_for_frames(cursor, frames, timeout_ms)
+
+    @property
+    def frames_written(self) -> int:
+        """Total number of frames captured since recording started."""
+        return self._impl.frames_written
+
+    def set_chunk_queue(self, chunks: int) -> bool:
+        """
+        Queue every period as a pooled chunk for read_chunk().
+
+        Chunks come from a fixed pool of reusable buffers, so queueing does
+        not allocate per period. When every chunk is still held, periods are
+        counted in the dropped_chunks statistic instead.
+
+        Args:
+            chunks: Pool size in periods (0 = stop queueing)
+
+        Returns:
+            bool: False if recording is active
+        """
+        return self._impl.set_chunk_queue(chunks)
+
+    def read_chunk(self, timeout_ms: int) -> Optional[Any]:
+        """
+        Take the next queued chunk.
+
+        The chunk exposes its bytes through the buffer protocol (data,
+        nbytes, start_frame). Call release(), or use it as a context
+        manager, to return the buffer to the pool; copy the samples first
+        if they must outlive it, e.g. np.frombuffer(chunk.data, np.int16).copy().
+
+        Args:
+            timeout_ms: Maximum time to wait in milliseconds
+
+        Returns:
+            The chunk, or None on timeout or once recording has stopped and
+            the queue is empty
+        """
+        if self._using_cpp:
+            return self._impl.wait_for_chunk(timeout_ms)
+        return self._impl.read_chunk(timeout_ms)
+
+    def set_utterance_staging(self, buffers: int = 8) -> bool:
+        """
+        Deliver continuous-mode utterances in reusable float32 staging buffers.
+
+        The C++ implementation converts each utterance straight from its
+        ring buffer into one of `buffers` page-aligned buffers, and the
+        chunk_processing_callback gets a float32 array over that buffer.
+        The buffer returns to the pool once the array is garbage collected,
+        so a GPU backend that registers the pool (see get_staging_arena())
+        can copy utterances to the device without another host copy. While
+        every buffer is held, utterances wait in the VAD queue.
+
+        Args:
+            buffers: Number of staging buffers (0 = off)
+
+        Returns:
+            bool: False if recording is active or the implementation does not support it
+        """
+        if not self._using_cpp or not self._impl.set_utterance_staging(buffers):
+            return False
+        self._staging = buffers > 0
+        return True
+
+    def get_staging_arena(self) -> Optional[Tuple[int, int]]:
+        """
+        Get the memory the staging buffers are carved from.
+
+        Returns:
+            tuple: (address, nbytes), e.g. for WhisperSTT.register_host_memory(),
+            or None if staging is off
+        """
+        if not self._using_cpp:
+            return None
+        return self._impl.staging_arena
+
+    def set_native_rate_capture(self, enabled: bool) -> bool:
+        """
+        Choose whether mono capture runs the device at its native rate.
+
+        When enabled (the C++ default), the device stream runs at its default
+        sample rate and channel layout and is resampled and downmixed to the
+        requested rate inside the engine. The Python implementation always
+        opens the device at the requested rate.
+
+        Args:
+            enabled: True to capture at the device's native rate
+
+        Returns:
+            bool: False if recording is active or the implementation does not support it
+        """
+        if not self._using_cpp:
+            return False
+        return self._impl.set_native_rate_capture(enabled)
+
+    def set_latency_profile(self, profile: str = "balanced", adaptive: bool = False) -> bool:
+        """
+        Trade latency against CPU and battery cost.
+
+        Profiles choose the device period, the host API latency and how
+        often processing wakes up:
+
+        - 'ultra-low': 8 ms periods, for live monitoring
+        - 'balanced': 32 ms periods
+        - 'power-save': 128 ms periods at the device's high latency,
+          processing woken every second period
+        - 'custom': chunk_size periods (the default)
+
+        With adaptive=True (C++ implementation only), the stream moves to
+        longer periods after repeated input overflows and back once it has
+        been running without overflows for a while.
+
+        Args:
+            profile: One of the profile names above
+            adaptive: Adapt the period to overflows
+
+        Returns:
+            bool: False if recording is active, the profile is unknown or
+            the implementation does not support the request
+        """
+        if not self._using_cpp:
+            return self._impl.set_latency_profile(profile, adaptive)
+
+        profiles = {
+            "custom": LatencyProfile.CUSTOM,
+            "ultra-low": LatencyProfile.ULTRA_LOW,
+            "balanced": LatencyProfile.BALANCED,
+            "power-save": LatencyProfile.POWER_SAVE,
+        }
+        if profile not in profiles:
+            return False
+        config = latency_profile_config(profiles[profile], self._sample_rate)
+        config.adaptive = adaptive
+        return self._impl.set_latency_config(config)
+
+    def get_latency(self) -> Dict[str, Any]:
+        """
+        Get the latency the current (or last) recording runs with.
+
+        Returns:
+            dict: period_frames, period_ms, host_latency_ms (0 if unknown),
+            wake_periods, total_ms (host latency plus one wake-up worth of
+            periods) and period_changes (adaptive changes this recording)
+        """
+        if not self._using_cpp:
+            return self._impl.get_latency()
+
+        latency = self._impl.effective_latency
+        return {key: getattr(latency, key) for key in (
+            'period_frames', 'period_ms', 'host_latency_ms', 'wake_periods', 'total_ms',
+            'period_changes')}
+
+    def set_mel_enabled(self, enabled: bool, n_mels: int = 80) -> bool:
+        """
+        Enable the native log-mel front end.
+
+        While recording, the C++ implementation computes Whisper-compatible
+        log-mel frames as audio arrives, so transcription only pays for new
+        frames. The Python implementation does not compute features.
+
+        Args:
+            enabled: True to compute mel frames while recording
+            n_mels: Number of mel bins (80, or 128 for large-v3)
+
+        Returns:
+            bool: False if recording is active or the implementation does not support it
+        """
+        if not self._using_cpp:
+            return False
+        config = self._impl.mel_config
+        config.enabled = enabled
+        config.n_mels = n_mels
+        return self._impl.set_mel_config(config)
+
+    def get_mel(self, start_frame: int = 0, end_frame: int = 0) -> Optional[Tuple[np.ndarray, int]]:
+        """
+        Get log-mel frames computed from the capture.
+
+        The array is a read-only view of the C++ frame buffer (no copy) with
+        shape (n_mels, frames), like whisper.log_mel_spectrogram() but
+        without its per-segment normalization. Mel frame t is centred on
+        capture frame t * 160 at 16 kHz.
+
+        Args:
+            start_frame: First mel frame (clamped to the oldest retained frame)
+            end_frame: One past the last mel frame (0 for all frames so far)
+
+        Returns:
+            tuple: (mel, start_frame), or None if features are unavailable
+        """
+        if not self._using_cpp or not self._impl.mel_config.enabled:
+            return None
+        return self._impl.get_mel(start_frame, end_frame)
+
+    def set_preprocessing(self, noise_suppression: bool = True, gain_control: bool = True,
+                          target_db: float = -20.0, max_gain_db: float = 12.0) -> bool:
+        """
+        Denoise and level the audio before voice activity detection.
+
+        The C++ implementation runs spectral noise suppression and automatic
+        gain control on its processing thread, ahead of the VAD and mel
+        front end. Utterances are then delivered denoised and levelled,
+        while audio levels, chunks and file recordings keep the raw capture.
+        Noise suppression delays the VAD by half its 20 ms window (see
+        get_stats() for what each stage costs). Both stages need mono
+        capture; the Python implementation does not support them.
+
+        Args:
+            noise_suppression: True to denoise
+            gain_control: True to normalize the speech level
+            target_db: RMS level in dBFS that gain control aims for
+            max_gain_db: Most amplification gain control applies
+
+        Returns:
+            bool: False if recording is active or the implementation does not support it
+        """
+        if not self._using_cpp:
+            return False
+        denoise = self._impl.noise_suppression_config
+        denoise.enabled = noise_suppression
+        agc = self._impl.gain_control_config
+        agc.enabled = gain_control
+        agc.target_db = target_db
+        agc.max_gain_db = max_gain_db
+        return (self._impl.set_noise_suppression_config(denoise) and
+                self._impl.set_gain_control_config(agc))
+
+    def set_level_update_rate(self, hz: int) -> bool:
+        """
+        Set the maximum rate at which the audio level callback is invoked.
+
+        With the C++ implementation level updates are coalesced and delivered
+        on a separate notifier thread, so a slow callback (or waiting for the
+        GIL) never delays audio capture.
+
+        Args:
+            hz: Updates per second, or 0 to report every processed chunk
+
+        Returns:
+            bool: False if recording is active or hz is negative
+        """
+        return self._impl.set_level_update_rate(hz)
+
+    def set_event_bus(self, bus: Optional[Any], source: int = 0) -> bool:
+        """
+        Publish level, speech onset and utterance events on a bus.
+
+        Levels are published at most level_update_hz times a second, even
+        without an audio_level_callback; onsets and utterances while the
+        VAD runs (continuous mode or an attached native transcriber).
+
+        Args:
+            bus: Bus from create_event_bus(), or None to stop
+            source: Event.source of the events, to tell captures apart
+
+        Returns:
+            bool: False if recording is active
+        """
+        return self._impl.set_event_bus(bus, source)
+
     def save_buffer_to_file(self, filename: str) -> bool:
         """
         Save the current audio buffer to a WAV file.
@@ -102,6 +580,252 @@ class AudioCapture:
         """
         return self._impl.save_buffer_to_file(filename)
 
+    def start_file_recording(self, path: str, format: str = "wav",
+                             max_file_bytes: int = 0, max_file_seconds: float = 0.0) -> bool:
+        """
+        Stream the whole session to disk while recording.
+
+        Audio is written on a background I/O thread with constant memory use,
+        unlike save_buffer_to_file(), which only has the last 30 seconds.
+        If called before start_recording(), the file starts with the first
+        captured frame. The file is finalized by stop_file_recording() or
+        stop_recording().
+
+        Args:
+            path: Output file; numbered (session_000.wav, ...) when rotating
+            format: "wav", or "flac"/"opus" if the C++ library was built with them
+            max_file_bytes: Start a new file past this size (0 = no limit)
+            max_file_seconds: Start a new file past this duration (0 = no limit)
+
+        Returns:
+            bool: False if a file recording is already active, the format is
+            unavailable, or the file could not be created
+        """
+        if not self._using_cpp:
+            if format != "wav":
+                return False
+            return self._impl.start_file_recording(path, max_file_bytes, max_file_seconds)
+
+        formats = {"wav": RecordingFormat.WAV, "flac": RecordingFormat.FLAC,
+                   "opus": RecordingFormat.OPUS}
+        if format not in formats:
+            raise ValueError("format must be 'wav', 'flac' or 'opus'")
+        config = RecorderConfig()
+        config.path = path
+        config.format = formats[format]
+        config.max_file_bytes = max_file_bytes
+        config.max_file_seconds = max_file_seconds
+        return self._impl.start_file_recording(config)
+
+    def stop_file_recording(self) -> None:
+        """Write out the remaining audio and close the recording file."""
+        self._impl.stop_file_recording()
+
+    @property
+    def is_file_recording(self) -> bool:
+        """Check whether a file recording is active or waiting to start."""
+        return self._impl.is_file_recording
+
+    def select_device(self, device: Union[int, str]) -> bool:
+        """
+        Select the input device used by the next start_recording().
+
+        Args:
+            device: Index from get_available_devices(), -1 for the system
+                default, or an exact or partial (case-insensitive) device name
+
+        Returns:
+            bool: False if recording is active or no input device matches
+        """
+        if self._using_cpp:
+            return self._impl.set_input_device(device)
+        if isinstance(device, str):
+            devices = self._impl.get_available_devices()
+            matches = ([d for d in devices if d['name'] == device] or
+                       [d for d in devices if device.casefold() in d['name'].casefold()])
+            if not matches:
+                return False
+            device = matches[0]['index']
+        return self._impl.select_device(device)
+
+    def set_replay_source(self, source: Union[str, np.ndarray, None], speed: float = 1.0,
+                          loop: bool = False, sample_rate: Optional[int] = None) -> bool:
+        """
+        Replay recorded audio through the pipeline instead of a device.
+
+        Useful for soak tests and throughput benchmarks without audio
+        hardware: speed=20 replays at 20x real time, speed=0 as fast as
+        processing keeps up (no audio is dropped either way).
+
+        Args:
+            source: Path of a WAV file, an array of samples shaped (frames,)
+                or (frames, channels) (int16, or float in [-1, 1]), or None
+                to capture from the device again
+            speed: Replay speed relative to real time (0 = as fast as possible)
+            loop: Restart from the beginning instead of finishing
+            sample_rate: Sample rate of an array source (default: the capture rate)
+
+        Returns:
+            bool: False if recording is active or the audio cannot be replayed.
+            The C++ implementation converts other rates and channel counts
+            for mono captures; the Python one needs 16-bit audio matching the
+            capture format.
+        """
+        if not self._using_cpp:
+            return self._impl.set_replay_source(source, speed, loop, sample_rate)
+        if self._impl.is_recording or speed < 0:
+            return False
+        if source is None:
+            return self._impl.set_input_source(None)
+
+        try:
+            if isinstance(source, str):
+                replay = ReplaySource.from_wav(source)
+            else:
+                samples = np.asarray(source)
+                if samples.dtype == np.int16:
+                    samples = samples / 32768.0
+                replay = ReplaySource(samples.astype(np.float32),
+                                      sample_rate or self._sample_rate)
+        except ValueError as e:
+            logging.error(f"Cannot replay audio: {e}")
+            return False
+        replay.set_speed(speed)
+        replay.set_loop(loop)
+        return self._impl.set_input_source(replay)
+
+    def attach_native_transcriber(self, transcriber: Any) -> int:
+        """
+        Send this capture's utterances straight to a native transcriber.
+
+        The transcriber (e.g. WhisperCppSTT) takes utterances from the C++
+        VAD queue on its own threads, so audio never passes through Python.
+        VAD is enabled on every following start_recording(), and a
+        chunk_processing_callback is no longer called.
+
+        Args:
+            transcriber: Object with attach(AudioCaptureCpp) returning a stream index
+
+        Returns:
+            int: Stream index reported with each transcript, or -1 if the C++
+            implementation is not in use, recording is active or attaching failed
+        """
+        if not self._using_cpp or self._impl.is_recording:
+            return -1
+        stream = transcriber.attach(self._impl)
+        if stream >= 0:
+            self._native_consumer = True
+        return stream
+
+    @property
+    def replay_finished(self) -> bool:
+        """Check whether the replay source has delivered all of its audio."""
+        if self._using_cpp:
+            return self._impl.input_finished
+        return self._impl.replay_finished
+
+    def set_realtime(self, enabled: bool = True, priority: int = 0,
+                     processing_cpus: Optional[List[int]] = None,
+                     capture_cpus: Optional[List[int]] = None,
+                     lock_memory: bool = False) -> bool:
+        """
+        Run capture and processing with real-time scheduling and CPU pinning.
+
+        Uses SCHED_FIFO on Linux, the time-constraint policy on macOS and
+        MMCSS on Windows. Missing privileges (e.g. CAP_SYS_NICE, rtprio or
+        memlock limits) do not stop recording; get_realtime_report() shows
+        what took effect once recording has started.
+
+        Args:
+            enabled: Request real-time scheduling
+            priority: SCHED_FIFO priority 1-99 (0 for the default; Linux only)
+            processing_cpus: CPUs for the private processing thread
+            capture_cpus: CPUs for the device callback thread
+            lock_memory: Fault in and lock the capture buffers in RAM
+
+        Returns:
+            bool: False if recording is active or the implementation does not support it
+        """
+        if not self._using_cpp:
+            return False
+        return (self._impl.set_processing_policy(_thread_policy(enabled, priority, processing_cpus)) and
+                self._impl.set_capture_policy(_thread_policy(enabled, priority, capture_cpus)) and
+                self._impl.set_lock_memory(lock_memory))
+
+    def get_realtime_report(self) -> Dict[str, Any]:
+        """
+        Get the scheduling and memory locking of the current (or last) recording.
+
+        Returns:
+            dict: 'processing' and 'capture' (each with realtime, pinned
+            and error), memory_locked and memory_error
+        """
+        if not self._using_cpp:
+            unsupported = {'realtime': False, 'pinned': False,
+                           'error': 'not supported by the Python implementation'}
+            return {'processing': dict(unsupported), 'capture': dict(unsupported),
+                    'memory_locked': False, 'memory_error': unsupported['error']}
+
+        report = self._impl.realtime_report
+        return {'processing': _policy_result(report.processing),
+                'capture': _policy_result(report.capture),
+                'memory_locked': report.memory_locked,
+                'memory_error': report.memory_error}
+
+    def set_worker_pool(self, pool: Optional[Any]) -> bool:
+        """
+        Run analysis (levels, VAD, mel) on a pool shared with other captures.
+
+        Args:
+            pool: Pool from create_worker_pool(), or None for a private thread
+
+        Returns:
+            bool: False if recording is active or the implementation does not support it
+        """
+        if not self._using_cpp:
+            return False
+        return self._impl.set_processing_pool(pool)
+
+    def get_stats(self) -> Dict[str, Any]:
+        """
+        Get pipeline counters and latency histograms.
+
+        Cheap enough to poll; see koelingo.audio.stats_exporter for
+        Prometheus and statsd export.
+
+        Returns:
+            dict: Counters and ring occupancy (in frames) for the current or
+            last recording. With the C++ implementation, callback_duration,
+            input_latency and processing_latency hold histograms with count,
+            sum_us, max_us, mean_us, p50_us, p90_us, p99_us and buckets
+            (bucket i counts durations below 2**i microseconds), and
+            level_time, denoise_time, agc_time, vad_time and mel_time hold
+            the same for the time each processing stage spent per block.
+        """
+        if not self._using_cpp:
+            return self._impl.get_stats()
+
+        stats = self._impl.get_stats()
+        result = {key: getattr(stats, key) for key in (
+            'callbacks', 'frames_captured', 'input_overflows', 'input_underflows',
+            'dropped_frames', 'dropped_utterances', 'dropped_chunks',
+            'recording_dropped_frames', 'device_failures',
+            'ring_capacity_frames', 'ring_backlog_frames', 'ring_peak_backlog_frames')}
+        for key in ('callback_duration', 'input_latency', 'processing_latency',
+                    'level_time', 'denoise_time', 'agc_time', 'vad_time', 'mel_time'):
+            histogram = getattr(stats, key)
+            result[key] = {
+                'count': histogram.count,
+                'sum_us': histogram.sum_us,
+                'max_us': histogram.max_us,
+                'mean_us': histogram.mean_us,
+                'p50_us': histogram.percentile_us(0.5),
+                'p90_us': histogram.percentile_us(0.9),
+                'p99_us': histogram.percentile_us(0.99),
+                'buckets': list(histogram.buckets),
+            }
+        return result
+
     def get_available_devices(self) -> List[Dict[str, Union[int, str]]]:
         """
         Get a list of available audio input devices.
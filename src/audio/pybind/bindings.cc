@@ -4,18 +4,724 @@
  */
 
 #include <pybind11/pybind11.h>
+#include <pybind11/complex.h>
 #include <pybind11/functional.h>
+#include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 #include <pybind11/stl_bind.h>
+#include <portaudio.h>
+#include "audio_backend.h"
 #include "audio_capture.h"  // Include directly from cpp/audio
+#include "audio_recorder.h"
+#include "capture_stats.h"
+#include "chunk_pool.h"
+#include "event_bus.h"
+#include "fft.h"
+#include "file_segmenter.h"
+#include "gain_control.h"
+#include "latency_profile.h"
+#include "level_meter.h"
+#include "mel_spectrogram.h"
+#include "noise_suppressor.h"
+#include "replay_source.h"
+#include "sample_format.h"
+#include "thread_priority.h"
+#include "worker_pool.h"
+#if defined(KOELINGO_HAVE_WHISPER_CPP)
+#include "whisper_transcriber.h"
+#endif
 
 namespace py = pybind11;
 using namespace koelingo::audio;
 
+namespace {
+
+/**
+ * @brief Wrap a C++ vector in a NumPy array without copying
+ *
+ * Ownership of the vector moves to a capsule that frees it when the
+ * array (and every view derived from it) is garbage collected.
+ *
+ * @tparam T Element type of the resulting array
+ * @tparam Storage Element type of the vector holding the data
+ */
+template <typename T, typename Storage>
+py::array_t<T> vector_to_numpy(std::vector<Storage>&& data) {
+    auto* owned = new std::vector<Storage>(std::move(data));
+    py::capsule owner(owned, [](void* ptr) {
+        delete static_cast<std::vector<Storage>*>(ptr);
+    });
+
+    py::ssize_t count = static_cast<py::ssize_t>(owned->size() * sizeof(Storage) / sizeof(T));
+    return py::array_t<T>({count}, {static_cast<py::ssize_t>(sizeof(T))},
+                          reinterpret_cast<const T*>(owned->data()), owner);
+}
+
+/**
+ * @brief Check a requested NumPy dtype name
+ * @param dtype "int16" or "float32"
+ */
+void check_dtype(const std::string& dtype) {
+    if (dtype != "int16" && dtype != "float32") {
+        throw py::value_error("dtype must be 'int16' or 'float32'");
+    }
+}
+
+/**
+ * @brief Turn raw captured frames into a NumPy array of the requested dtype
+ * @param raw Frames in the capture sample format (ownership is taken)
+ * @param format_type PortAudio sample format of raw
+ * @param dtype "int16" for raw samples or "float32" for normalized samples
+ */
+py::array raw_to_numpy(std::vector<char>&& raw, int format_type, const std::string& dtype) {
+    check_dtype(dtype);
+
+    if (dtype == "int16") {
+        if (format_type != paInt16) {
+            throw py::value_error("int16 output requires a paInt16 capture format");
+        }
+        return vector_to_numpy<int16_t>(std::move(raw));
+    }
+
+    if (format_type == paFloat32) {
+        return vector_to_numpy<float>(std::move(raw));
+    }
+
+    std::vector<float> samples(raw.size() / bytes_per_sample(format_type));
+    convert_to_float32(raw.data(), samples.size(), format_type, samples.data());
+    return vector_to_numpy<float>(std::move(samples));
+}
+
+/**
+ * @brief Get the capture buffer as a NumPy array backed by C++ memory
+ * @param self AudioCapture instance
+ * @param dtype "int16" for raw samples or "float32" for normalized samples
+ */
+py::array get_buffer_as_numpy(const AudioCapture& self, const std::string& dtype) {
+    check_dtype(dtype);
+
+    if (dtype == "float32") {
+        std::vector<float> samples;
+        {
+            py::gil_scoped_release release;
+            samples = self.get_buffer_float32();
+        }
+        return vector_to_numpy<float>(std::move(samples));
+    }
+
+    std::vector<char> buffer;
+    {
+        py::gil_scoped_release release;
+        buffer = self.get_buffer();
+    }
+    return raw_to_numpy(std::move(buffer), self.format_type(), dtype);
+}
+
+/**
+ * @brief Read the frames captured since a cursor as a NumPy array
+ * @param self AudioCapture instance
+ * @param cursor Cursor returned by the previous call (0 to start)
+ * @param max_frames Maximum number of frames to return (0 for no limit)
+ * @param dtype "int16" for raw samples or "float32" for normalized samples
+ * @return Tuple of (samples, start_frame, next_cursor)
+ */
+py::tuple read_new(const AudioCapture& self, uint64_t cursor, size_t max_frames,
+                   const std::string& dtype) {
+    check_dtype(dtype);
+
+    AudioReadResult result;
+    {
+        py::gil_scoped_release release;
+        result = self.read_new(cursor, max_frames);
+    }
+
+    uint64_t start_frame = result.start_frame;
+    uint64_t next_cursor = result.next_cursor;
+    return py::make_tuple(raw_to_numpy(std::move(result.data), self.format_type(), dtype),
+                          start_frame, next_cursor);
+}
+
+/**
+ * @brief Get log-mel frames as a read-only NumPy view of the C++ frame buffer
+ * @param self AudioCapture instance
+ * @param start_frame First mel frame (clamped to the oldest retained frame)
+ * @param end_frame One past the last mel frame (0 for all frames so far)
+ * @return Tuple of (mel, start_frame); mel has shape (n_mels, frames) like
+ *         whisper.log_mel_spectrogram() and shares memory with the buffer
+ */
+py::tuple get_mel(const AudioCapture& self, uint64_t start_frame, uint64_t end_frame) {
+    const MelSpectrogram& mel = self.get_mel_spectrogram();
+    std::shared_ptr<const std::vector<float>> storage = mel.storage();
+    if (!storage) {
+        return py::make_tuple(py::array_t<float>(std::vector<py::ssize_t>{self.get_mel_config().n_mels, 0}),
+                              0);
+    }
+
+    uint64_t written = mel.frames_written();
+    uint64_t end = end_frame == 0 ? written : std::min(end_frame, written);
+    uint64_t start = std::min(std::max(start_frame, mel.oldest_frame()), end);
+
+    // Frames are stored row-major (frame, mel); a transposed view gives (mel, frame)
+    const py::ssize_t n_mels = mel.n_mels();
+    const float* data = storage->data() + static_cast<size_t>(start % mel.capacity()) * n_mels;
+    auto* owner = new std::shared_ptr<const std::vector<float>>(std::move(storage));
+    py::capsule base(owner, [](void* ptr) {
+        delete static_cast<std::shared_ptr<const std::vector<float>>*>(ptr);
+    });
+
+    py::array_t<float> view({n_mels, static_cast<py::ssize_t>(end - start)},
+                            {static_cast<py::ssize_t>(sizeof(float)),
+                             static_cast<py::ssize_t>(n_mels * sizeof(float))},
+                            data, base);
+    view.attr("setflags")(py::arg("write") = false);
+    return py::make_tuple(view, start);
+}
+
+/**
+ * @brief Wait for the next utterance detected by the native VAD
+ * @param self AudioCapture instance
+ * @param timeout_ms Maximum time to wait in milliseconds
+ * @param dtype "int16" for raw samples or "float32" for normalized samples
+ * @return Tuple of (samples, start_frame, end_frame, truncated), or None
+ */
+py::object wait_for_utterance(AudioCapture& self, int timeout_ms, const std::string& dtype) {
+    check_dtype(dtype);
+
+    Utterance utterance;
+    bool found;
+    {
+        py::gil_scoped_release release;
+        found = self.wait_for_utterance(utterance, timeout_ms);
+    }
+    if (!found) {
+        return py::none();
+    }
+
+    uint64_t start_frame = utterance.start_frame;
+    uint64_t end_frame = utterance.end_frame;
+    bool truncated = utterance.truncated;
+    return py::make_tuple(raw_to_numpy(std::move(utterance.data), self.format_type(), dtype),
+                          start_frame, end_frame, truncated);
+}
+
+/**
+ * @brief Wait for the next utterance, converted into a staging buffer
+ * @param self AudioCapture instance
+ * @param timeout_ms Maximum time to wait in milliseconds
+ * @return Tuple of (samples, start_frame, end_frame, truncated), or None;
+ *         samples is a float32 array over the staging buffer, which
+ *         returns to the pool once the array and every view of it are
+ *         garbage collected
+ */
+py::object wait_for_staged_utterance(AudioCapture& self, int timeout_ms) {
+    StagedUtterance utterance;
+    bool found;
+    {
+        py::gil_scoped_release release;
+        found = self.wait_for_staged_utterance(utterance, timeout_ms);
+    }
+    if (!found) {
+        return py::none();
+    }
+
+    py::ssize_t count = static_cast<py::ssize_t>(utterance.samples.size() / sizeof(float));
+    float* data = reinterpret_cast<float*>(utterance.samples.data());
+    py::object owner = py::cast(std::move(utterance.samples));
+    py::array_t<float> samples({count}, {static_cast<py::ssize_t>(sizeof(float))}, data, owner);
+    return py::make_tuple(samples, utterance.start_frame, utterance.end_frame, utterance.truncated);
+}
+
+/**
+ * @brief Wait for the next speech onset reported by the native VAD
+ * @param self AudioCapture instance
+ * @param timeout_ms Maximum time to wait in milliseconds
+ * @return First frame of the speech, or None
+ */
+py::object wait_for_speech_onset(AudioCapture& self, int timeout_ms) {
+    uint64_t frame = 0;
+    bool found;
+    {
+        py::gil_scoped_release release;
+        found = self.wait_for_speech_onset(frame, timeout_ms);
+    }
+    if (!found) {
+        return py::none();
+    }
+    return py::int_(frame);
+}
+
+/**
+ * @brief Wait for the next pooled chunk
+ * @param self AudioCapture instance
+ * @param timeout_ms Maximum time to wait in milliseconds
+ * @return PooledChunk, or None
+ */
+py::object wait_for_chunk(AudioCapture& self, int timeout_ms) {
+    PooledChunk chunk;
+    bool found;
+    {
+        py::gil_scoped_release release;
+        found = self.wait_for_chunk(chunk, timeout_ms);
+    }
+    if (!found) {
+        return py::none();
+    }
+    return py::cast(std::move(chunk));
+}
+
+/**
+ * @brief Event mask from a list of EventType values
+ * @param types Iterable of EventType, or None for every type
+ * @return Mask for EventBus::subscribe()
+ */
+uint32_t event_mask_from(const py::object& types) {
+    if (types.is_none()) {
+        return kAllEvents;
+    }
+    uint32_t mask = 0;
+    for (py::handle type : types) {
+        mask |= event_mask(type.cast<EventType>());
+    }
+    return mask;
+}
+
+/**
+ * @brief Take the queued events of a subscription
+ * @param self Subscription
+ * @param max_events Maximum number of events to return
+ * @return List of Event, oldest first
+ */
+py::list poll_events(EventSubscription& self, size_t max_events) {
+    std::vector<Event> events(max_events);
+    size_t count;
+    {
+        py::gil_scoped_release release;
+        count = self.poll(events.data(), events.size());
+    }
+    py::list result;
+    for (size_t i = 0; i < count; i++) {
+        result.append(std::move(events[i]));
+    }
+    return result;
+}
+
+/**
+ * @brief Holder deleter that releases the GIL while an object is destroyed
+ *
+ * Destruction of an AudioCapture or WhisperTranscriber joins its threads,
+ * which may be waiting for the GIL to run a Python level callback.
+ */
+template <typename T>
+struct ReleaseGilDeleter {
+    void operator()(T* object) const {
+        py::gil_scoped_release release;
+        delete object;
+    }
+};
+
+} // namespace
+
 PYBIND11_MODULE(audio_capture_cc, m) {
     m.doc() = "Python bindings for AudioCapture C++ class";
 
-    py::class_<AudioCapture>(m, "AudioCaptureCpp")
+    py::class_<VadConfig>(m, "VadConfig")
+        .def(py::init<>())
+        .def_readwrite("enabled", &VadConfig::enabled)
+        .def_readwrite("frame_ms", &VadConfig::frame_ms)
+        .def_readwrite("energy_threshold", &VadConfig::energy_threshold)
+        .def_readwrite("zcr_threshold", &VadConfig::zcr_threshold)
+        .def_readwrite("speech_probability", &VadConfig::speech_probability)
+        .def_readwrite("min_speech_ms", &VadConfig::min_speech_ms)
+        .def_readwrite("hangover_ms", &VadConfig::hangover_ms)
+        .def_readwrite("pre_roll_ms", &VadConfig::pre_roll_ms)
+        .def_readwrite("min_utterance_ms", &VadConfig::min_utterance_ms)
+        .def_readwrite("max_utterance_ms", &VadConfig::max_utterance_ms)
+        .def_readwrite("warmup_idle_ms", &VadConfig::warmup_idle_ms);
+
+    py::class_<FileSegmenterConfig>(m, "FileSegmenterConfig")
+        .def(py::init<>())
+        .def_readwrite("vad", &FileSegmenterConfig::vad)
+        .def_readwrite("threads", &FileSegmenterConfig::threads)
+        .def_readwrite("region_seconds", &FileSegmenterConfig::region_seconds);
+
+    m.def("segment_wav_file", [](const std::string& path, const FileSegmenterConfig& config) {
+              MappedWav wav;
+              std::vector<UtteranceSegment> segments;
+              {
+                  py::gil_scoped_release release;
+                  if (wav.open(path)) {
+                      segments = segment_file(wav, config);
+                  }
+              }
+              if (!wav.is_open()) {
+                  throw py::value_error("Cannot read WAV file: " + path);
+              }
+              py::list spans;
+              for (const UtteranceSegment& segment : segments) {
+                  spans.append(py::make_tuple(segment.start_frame, segment.end_frame));
+              }
+              return py::make_tuple(spans, wav.sample_rate());
+          },
+          py::arg("path"),
+          py::arg("config") = FileSegmenterConfig(),
+          "Split a memory-mapped WAV file into utterances with parallel VAD; "
+          "returns ([(start_frame, end_frame)], sample_rate)");
+
+    py::class_<MelConfig>(m, "MelConfig")
+        .def(py::init<>())
+        .def_readwrite("enabled", &MelConfig::enabled)
+        .def_readwrite("n_mels", &MelConfig::n_mels)
+        .def_readwrite("n_fft", &MelConfig::n_fft)
+        .def_readwrite("hop_length", &MelConfig::hop_length)
+        .def_readwrite("buffer_frames", &MelConfig::buffer_frames);
+
+    py::class_<RealFft>(m, "RealFft")
+        .def(py::init([](size_t size) {
+                 if (size < 2 || size % 2 != 0) {
+                     throw py::value_error("size must be even and at least 2");
+                 }
+                 return RealFft(size);
+             }),
+             py::arg("size"))
+        .def_property_readonly("size", &RealFft::size)
+        .def("forward", [](RealFft& self, py::array_t<float, py::array::c_style | py::array::forcecast> samples) {
+                 if (samples.ndim() != 1 || static_cast<size_t>(samples.shape(0)) != self.size()) {
+                     throw py::value_error("samples must be a 1-D array of size() values");
+                 }
+                 py::array_t<std::complex<float>> spectrum(static_cast<py::ssize_t>(self.size() / 2 + 1));
+                 self.forward(samples.data(), spectrum.mutable_data());
+                 return spectrum;
+             },
+             py::arg("samples"),
+             "Spectrum of one frame (size() / 2 + 1 complex64 bins)")
+        .def("inverse", [](RealFft& self,
+                           py::array_t<std::complex<float>, py::array::c_style | py::array::forcecast> spectrum) {
+                 if (spectrum.ndim() != 1 || static_cast<size_t>(spectrum.shape(0)) != self.size() / 2 + 1) {
+                     throw py::value_error("spectrum must be a 1-D array of size() / 2 + 1 bins");
+                 }
+                 py::array_t<float> samples(static_cast<py::ssize_t>(self.size()));
+                 self.inverse(spectrum.data(), samples.mutable_data());
+                 return samples;
+             },
+             py::arg("spectrum"),
+             "Frame rebuilt from its spectrum (float32, scaled by 1 / size())");
+
+    py::class_<NoiseSuppressionConfig>(m, "NoiseSuppressionConfig")
+        .def(py::init<>())
+        .def_readwrite("enabled", &NoiseSuppressionConfig::enabled)
+        .def_readwrite("frame_ms", &NoiseSuppressionConfig::frame_ms)
+        .def_readwrite("over_subtraction", &NoiseSuppressionConfig::over_subtraction)
+        .def_readwrite("floor_db", &NoiseSuppressionConfig::floor_db)
+        .def_readwrite("noise_rise_db_per_s", &NoiseSuppressionConfig::noise_rise_db_per_s)
+        .def_readwrite("gain_smoothing", &NoiseSuppressionConfig::gain_smoothing);
+
+    py::class_<GainControlConfig>(m, "GainControlConfig")
+        .def(py::init<>())
+        .def_readwrite("enabled", &GainControlConfig::enabled)
+        .def_readwrite("target_db", &GainControlConfig::target_db)
+        .def_readwrite("max_gain_db", &GainControlConfig::max_gain_db)
+        .def_readwrite("min_gain_db", &GainControlConfig::min_gain_db)
+        .def_readwrite("gate_db", &GainControlConfig::gate_db)
+        .def_readwrite("attack_ms", &GainControlConfig::attack_ms)
+        .def_readwrite("release_ms", &GainControlConfig::release_ms)
+        .def_readwrite("limit_db", &GainControlConfig::limit_db);
+
+    py::enum_<RecordingFormat>(m, "RecordingFormat")
+        .value("WAV", RecordingFormat::kWav)
+        .value("FLAC", RecordingFormat::kFlac)
+        .value("OPUS", RecordingFormat::kOpus);
+
+    py::class_<RecorderConfig>(m, "RecorderConfig")
+        .def(py::init<>())
+        .def_readwrite("path", &RecorderConfig::path)
+        .def_readwrite("format", &RecorderConfig::format)
+        .def_readwrite("max_file_bytes", &RecorderConfig::max_file_bytes)
+        .def_readwrite("max_file_seconds", &RecorderConfig::max_file_seconds)
+        .def_readwrite("buffer_bytes", &RecorderConfig::buffer_bytes)
+        .def_readwrite("flush_interval_ms", &RecorderConfig::flush_interval_ms)
+        .def_readwrite("flac_compression_level", &RecorderConfig::flac_compression_level)
+        .def_readwrite("opus_bitrate", &RecorderConfig::opus_bitrate);
+
+    m.def("recording_format_supported", &AudioRecorder::format_supported,
+          py::arg("format"),
+          "Check whether a recording format was compiled into this build");
+
+    py::enum_<LatencyProfile>(m, "LatencyProfile")
+        .value("CUSTOM", LatencyProfile::kCustom)
+        .value("ULTRA_LOW", LatencyProfile::kUltraLow)
+        .value("BALANCED", LatencyProfile::kBalanced)
+        .value("POWER_SAVE", LatencyProfile::kPowerSave);
+
+    py::class_<LatencyConfig>(m, "LatencyConfig")
+        .def(py::init<>())
+        .def_readwrite("profile", &LatencyConfig::profile)
+        .def_readwrite("period_frames", &LatencyConfig::period_frames)
+        .def_readwrite("suggested_latency", &LatencyConfig::suggested_latency)
+        .def_readwrite("high_latency", &LatencyConfig::high_latency)
+        .def_readwrite("wake_periods", &LatencyConfig::wake_periods)
+        .def_readwrite("adaptive", &LatencyConfig::adaptive)
+        .def_readwrite("overflow_limit", &LatencyConfig::overflow_limit)
+        .def_readwrite("overflow_window_ms", &LatencyConfig::overflow_window_ms)
+        .def_readwrite("idle_ms", &LatencyConfig::idle_ms)
+        .def_readwrite("max_period_frames", &LatencyConfig::max_period_frames);
+
+    m.def("latency_profile_config", &latency_profile_config,
+          py::arg("profile"),
+          py::arg("sample_rate") = 16000,
+          "Get the LatencyConfig of a predefined profile");
+
+    py::class_<EffectiveLatency>(m, "EffectiveLatency")
+        .def_readonly("period_frames", &EffectiveLatency::period_frames)
+        .def_readonly("period_ms", &EffectiveLatency::period_ms)
+        .def_readonly("host_latency_ms", &EffectiveLatency::host_latency_ms)
+        .def_readonly("wake_periods", &EffectiveLatency::wake_periods)
+        .def_readonly("total_ms", &EffectiveLatency::total_ms)
+        .def_readonly("period_changes", &EffectiveLatency::period_changes);
+
+    py::class_<ThreadPolicy>(m, "ThreadPolicy")
+        .def(py::init<>())
+        .def_readwrite("realtime", &ThreadPolicy::realtime)
+        .def_readwrite("priority", &ThreadPolicy::priority)
+        .def_readwrite("period_ms", &ThreadPolicy::period_ms)
+        .def_readwrite("cpus", &ThreadPolicy::cpus);
+
+    py::class_<ThreadPolicyResult>(m, "ThreadPolicyResult")
+        .def_readonly("realtime", &ThreadPolicyResult::realtime)
+        .def_readonly("pinned", &ThreadPolicyResult::pinned)
+        .def_readonly("error", &ThreadPolicyResult::error);
+
+    py::class_<RealtimeReport>(m, "RealtimeReport")
+        .def_readonly("processing", &RealtimeReport::processing)
+        .def_readonly("capture", &RealtimeReport::capture)
+        .def_readonly("memory_locked", &RealtimeReport::memory_locked)
+        .def_readonly("memory_error", &RealtimeReport::memory_error);
+
+    py::class_<ChannelLevel>(m, "ChannelLevel")
+        .def_readonly("rms", &ChannelLevel::rms)
+        .def_readonly("peak", &ChannelLevel::peak)
+        .def_readonly("clipped", &ChannelLevel::clipped);
+
+    py::class_<AudioLevels>(m, "AudioLevels")
+        .def_readonly("level", &AudioLevels::level)
+        .def_property_readonly("channels", [](const AudioLevels& self) {
+                 return std::vector<ChannelLevel>(self.channels.begin(),
+                                                  self.channels.begin() + self.channel_count);
+             },
+             "Per-channel RMS, peak and clip count");
+
+    m.def("level_kernel_name", &level_kernel_name,
+          "Name of the SIMD kernel used for level metering");
+    m.def("measure_levels", [](py::array samples) {
+              if (samples.ndim() != 1 && samples.ndim() != 2) {
+                  throw py::value_error("samples must be 1-D or (frames, channels)");
+              }
+              int format_type;
+              if (samples.dtype().is(py::dtype::of<int16_t>())) {
+                  format_type = paInt16;
+              } else if (samples.dtype().is(py::dtype::of<int32_t>())) {
+                  format_type = paInt32;
+              } else if (samples.dtype().is(py::dtype::of<float>())) {
+                  format_type = paFloat32;
+              } else {
+                  throw py::value_error("samples must be int16, int32 or float32");
+              }
+              if (!(samples.flags() & py::array::c_style)) {
+                  throw py::value_error("samples must be C-contiguous");
+              }
+              size_t frames = static_cast<size_t>(samples.shape(0));
+              int channels = samples.ndim() == 2 ? static_cast<int>(samples.shape(1)) : 1;
+              std::vector<ChannelLevel> levels(static_cast<size_t>(std::max(channels, 0)));
+              measure_levels(static_cast<const char*>(samples.data()), frames, channels, format_type,
+                             levels.data());
+              return levels;
+          },
+          py::arg("samples"),
+          "Per-channel RMS, peak and clip count of int16, int32 or float32 frames, "
+          "as the capture measures them");
+
+    m.def("refresh_devices", []() { return AudioBackend::acquire()->refresh_devices(); },
+          py::call_guard<py::gil_scoped_release>(),
+          "Rescan input devices now (returns False and defers while any stream is open)");
+    m.def("notify_devices_changed", []() { AudioBackend::acquire()->notify_devices_changed(); },
+          "Mark the cached device list stale, e.g. from a hotplug notification");
+
+    py::class_<HistogramSnapshot>(m, "HistogramSnapshot")
+        .def_readonly("count", &HistogramSnapshot::count)
+        .def_readonly("sum_us", &HistogramSnapshot::sum_us)
+        .def_readonly("max_us", &HistogramSnapshot::max_us)
+        .def_readonly("buckets", &HistogramSnapshot::buckets,
+             "Per-bucket counts; bucket i holds durations below 2**i microseconds")
+        .def_property_readonly("mean_us", &HistogramSnapshot::mean_us)
+        .def("percentile_us", &HistogramSnapshot::percentile_us,
+             py::arg("quantile"),
+             "Estimate a percentile (e.g. 0.99) from the buckets");
+
+    py::class_<CaptureStats>(m, "CaptureStats")
+        .def_readonly("callbacks", &CaptureStats::callbacks)
+        .def_readonly("frames_captured", &CaptureStats::frames_captured)
+        .def_readonly("input_overflows", &CaptureStats::input_overflows)
+        .def_readonly("input_underflows", &CaptureStats::input_underflows)
+        .def_readonly("dropped_frames", &CaptureStats::dropped_frames)
+        .def_readonly("dropped_utterances", &CaptureStats::dropped_utterances)
+        .def_readonly("dropped_chunks", &CaptureStats::dropped_chunks)
+        .def_readonly("recording_dropped_frames", &CaptureStats::recording_dropped_frames)
+        .def_readonly("device_failures", &CaptureStats::device_failures,
+             "Device reopens that failed after a period change; a second failure in a row ends the recording")
+        .def_readonly("ring_capacity_frames", &CaptureStats::ring_capacity_frames)
+        .def_readonly("ring_backlog_frames", &CaptureStats::ring_backlog_frames)
+        .def_readonly("ring_peak_backlog_frames", &CaptureStats::ring_peak_backlog_frames)
+        .def_readonly("callback_duration", &CaptureStats::callback_duration)
+        .def_readonly("input_latency", &CaptureStats::input_latency)
+        .def_readonly("processing_latency", &CaptureStats::processing_latency)
+        .def_readonly("level_time", &CaptureStats::level_time)
+        .def_readonly("denoise_time", &CaptureStats::denoise_time)
+        .def_readonly("agc_time", &CaptureStats::agc_time)
+        .def_readonly("vad_time", &CaptureStats::vad_time)
+        .def_readonly("mel_time", &CaptureStats::mel_time);
+
+    // Raw capture bytes; the buffer returns to the pool on release() or collection
+    py::class_<PooledChunk>(m, "PooledChunk", py::buffer_protocol())
+        .def_buffer([](PooledChunk& self) -> py::buffer_info {
+            static char empty = 0;
+            char* data = self ? self.data() : &empty;
+            return py::buffer_info(data, 1, py::format_descriptor<uint8_t>::format(), 1,
+                                   {static_cast<py::ssize_t>(self.size())}, {1}, true);
+        })
+        .def_property_readonly("data", [](py::object self) {
+                 return py::memoryview(self);
+             },
+             "Read-only view of the valid bytes (refers to pooled memory; copy to keep it past release())")
+        .def_property_readonly("nbytes", &PooledChunk::size,
+             "Number of valid bytes")
+        .def_property_readonly("start_frame", &PooledChunk::start_frame,
+             "Capture frame index of the first byte")
+        .def("release", &PooledChunk::reset,
+             "Return the buffer to the pool; the chunk is empty afterwards")
+        .def("__enter__", [](py::object self) { return self; })
+        .def("__exit__", [](PooledChunk& self, py::args) { self.reset(); });
+
+    py::class_<WorkerPool, std::shared_ptr<WorkerPool>>(m, "WorkerPool")
+        .def(py::init<int, const ThreadPolicy&>(),
+             py::arg("threads") = 0,
+             py::arg("policy") = ThreadPolicy(),
+             py::call_guard<py::gil_scoped_release>(),
+             "Processing threads that several AudioCaptureCpp instances can share (0 = one per core)")
+        .def_property_readonly("thread_count", &WorkerPool::thread_count,
+             "Number of pool threads")
+        .def_property_readonly("policy_result", &WorkerPool::policy_result,
+             "What the ThreadPolicy achieved on every pool thread");
+
+    py::class_<InputSource, std::shared_ptr<InputSource>>(m, "InputSource")
+        .def_property_readonly("sample_rate", &InputSource::sample_rate)
+        .def_property_readonly("channels", &InputSource::channels)
+        .def_property_readonly("finished", &InputSource::finished,
+             "True once every frame has been delivered");
+
+    py::class_<ReplaySource, InputSource, std::shared_ptr<ReplaySource>>(m, "ReplaySource")
+        .def(py::init([](py::array_t<float, py::array::c_style | py::array::forcecast> samples,
+                         int sample_rate) {
+                 if (samples.ndim() != 1 && samples.ndim() != 2) {
+                     throw py::value_error("samples must be 1-D or (frames, channels)");
+                 }
+                 if (sample_rate <= 0) {
+                     throw py::value_error("sample_rate must be positive");
+                 }
+                 int channels = samples.ndim() == 2 ? static_cast<int>(samples.shape(1)) : 1;
+                 std::vector<float> data(samples.data(), samples.data() + samples.size());
+                 return std::make_shared<ReplaySource>(std::move(data), sample_rate, channels);
+             }),
+             py::arg("samples"),
+             py::arg("sample_rate"),
+             "Replay float samples in [-1, 1], shaped (frames,) or (frames, channels)")
+        .def_static("from_wav", [](const std::string& path) {
+                 std::shared_ptr<ReplaySource> source = ReplaySource::from_wav(path);
+                 if (!source) {
+                     throw py::value_error("Cannot read WAV file: " + path);
+                 }
+                 return source;
+             },
+             py::arg("path"),
+             py::call_guard<py::gil_scoped_release>(),
+             "Load a PCM or float WAV file for replay")
+        .def("set_speed", &ReplaySource::set_speed,
+             py::arg("speed"),
+             "Replay speed relative to real time (0 = as fast as the pipeline keeps up)")
+        .def_property_readonly("speed", &ReplaySource::speed)
+        .def("set_loop", &ReplaySource::set_loop,
+             py::arg("loop"),
+             "Restart from the beginning at the end instead of finishing (only while stopped)")
+        .def_property_readonly("loop", &ReplaySource::loop)
+        .def_property_readonly("total_frames", &ReplaySource::total_frames)
+        .def_property_readonly("frames_delivered", &ReplaySource::frames_delivered,
+             "Frames delivered since the last start");
+
+    py::enum_<EventType>(m, "EventType")
+        .value("LEVEL", EventType::kLevel)
+        .value("SPEECH_ONSET", EventType::kSpeechOnset)
+        .value("UTTERANCE", EventType::kUtterance)
+        .value("PARTIAL_TRANSCRIPT", EventType::kPartialTranscript)
+        .value("FINAL_TRANSCRIPT", EventType::kFinalTranscript);
+
+    py::class_<Event>(m, "Event")
+        .def_readonly("type", &Event::type)
+        .def_readonly("source", &Event::source)
+        .def_readonly("timestamp_ns", &Event::timestamp_ns)
+        .def_readonly("start_frame", &Event::start_frame)
+        .def_readonly("end_frame", &Event::end_frame)
+        .def_readonly("value", &Event::value)
+        .def_readonly("truncated", &Event::truncated)
+        .def_readonly("text", &Event::text);
+
+    py::class_<EventSubscription, std::shared_ptr<EventSubscription>>(m, "EventSubscription")
+        .def("fileno", &EventSubscription::fd,
+             "Descriptor that is readable while events are queued (-1 on Windows)")
+        .def("poll", &poll_events,
+             py::arg("max_events") = 64,
+             "Take up to max_events queued events, oldest first")
+        .def("wait", &EventSubscription::wait,
+             py::arg("timeout_ms"),
+             py::call_guard<py::gil_scoped_release>(),
+             "Wait until events are queued; returns False on timeout")
+        .def_property_readonly("pending", &EventSubscription::pending,
+             "Events waiting to be polled")
+        .def_property_readonly("dropped", &EventSubscription::dropped,
+             "Events lost because the queue was full");
+
+    py::class_<EventBus, std::shared_ptr<EventBus>>(m, "EventBus")
+        .def(py::init<>())
+        .def("subscribe", [](EventBus& self, const py::object& types, size_t capacity) {
+                 return self.subscribe(event_mask_from(types), capacity);
+             },
+             py::arg("types") = py::none(),
+             py::arg("capacity") = 256,
+             "Subscribe to a list of EventType (None = all) with a bounded queue")
+        .def("unsubscribe", &EventBus::unsubscribe,
+             py::arg("subscription"),
+             py::call_guard<py::gil_scoped_release>(),
+             "Stop delivering events to a subscription")
+        .def("publish_transcript", [](EventBus& self, const std::string& text, float confidence,
+                                      bool final, uint64_t start_frame, uint64_t end_frame,
+                                      uint32_t source) {
+                 Event event;
+                 event.type = final ? EventType::kFinalTranscript : EventType::kPartialTranscript;
+                 event.source = source;
+                 event.start_frame = start_frame;
+                 event.end_frame = end_frame;
+                 event.value = confidence;
+                 event.text = text;
+                 return self.publish(event);
+             },
+             py::arg("text"),
+             py::arg("confidence") = 0.0f,
+             py::arg("final") = true,
+             py::arg("start_frame") = 0,
+             py::arg("end_frame") = 0,
+             py::arg("source") = 0,
+             "Publish a transcript from Python; returns the number of subscriptions reached")
+        .def_property_readonly("published", &EventBus::published,
+             "Events published so far");
+
+    py::class_<AudioCapture, std::unique_ptr<AudioCapture, ReleaseGilDeleter<AudioCapture>>>(m, "AudioCaptureCpp")
         .def(py::init<int, int, int, int>(),
              py::arg("sample_rate") = 16000,
              py::arg("chunk_size") = 1024,
@@ -23,16 +729,298 @@ PYBIND11_MODULE(audio_capture_cc, m) {
              py::arg("format_type") = 8)
         .def("start_recording", &AudioCapture::start_recording,
              py::arg("audio_level_callback") = nullptr,
+             py::arg("levels_callback") = nullptr,
+             py::call_guard<py::gil_scoped_release>(),
              "Start recording audio from the microphone")
         .def("stop_recording", &AudioCapture::stop_recording,
+             py::call_guard<py::gil_scoped_release>(),
              "Stop recording audio")
-        .def("get_buffer", &AudioCapture::get_buffer,
+        .def("set_input_device", py::overload_cast<int>(&AudioCapture::set_input_device),
+             py::arg("index"),
+             "Select the input device by index (-1 for the default; only while stopped)")
+        .def("set_input_device", py::overload_cast<const std::string&>(&AudioCapture::set_input_device),
+             py::arg("name"),
+             "Select the input device by exact or partial name (only while stopped)")
+        .def_property_readonly("input_device", &AudioCapture::input_device,
+             "Index of the selected input device (-1 for the default)")
+        .def("set_input_source", &AudioCapture::set_input_source,
+             py::arg("source"),
+             "Capture from an InputSource such as a ReplaySource, or None for the device (only while stopped)")
+        .def_property_readonly("input_finished", &AudioCapture::input_finished,
+             "True once the input source has delivered all of its audio")
+        .def("set_processing_pool", &AudioCapture::set_processing_pool,
+             py::arg("pool"),
+             "Run analysis on a shared WorkerPool, or None for a private thread (only while stopped)")
+        .def("set_processing_policy", &AudioCapture::set_processing_policy,
+             py::arg("policy"),
+             "Scheduling and CPUs of the private processing thread (only while stopped)")
+        .def("set_capture_policy", &AudioCapture::set_capture_policy,
+             py::arg("policy"),
+             "Scheduling and CPUs of the callback or input source thread (only while stopped)")
+        .def("set_lock_memory", &AudioCapture::set_lock_memory,
+             py::arg("enabled"),
+             "Fault in and lock the capture buffers in RAM while recording (only while stopped)")
+        .def_property_readonly("realtime_report", &AudioCapture::get_realtime_report,
+             "Scheduling and memory locking the current (or last) recording got")
+        .def("set_native_rate_capture", &AudioCapture::set_native_rate_capture,
+             py::arg("enabled"),
+             "Open mono capture at the device's native rate and resample in the engine (only while stopped)")
+        .def_property_readonly("device_sample_rate", &AudioCapture::device_sample_rate,
+             "Sample rate the device stream runs at")
+        .def_property_readonly("resampler_latency_frames", &AudioCapture::resampler_latency_frames,
+             "Fixed delay added by in-engine resampling, in frames at the capture rate")
+        .def("set_latency_config", &AudioCapture::set_latency_config,
+             py::arg("config"),
+             "Choose the device period, host latency, wake cadence and adaptation (only while stopped)")
+        .def_property_readonly("latency_config", &AudioCapture::get_latency_config,
+             "Current latency settings")
+        .def_property_readonly("effective_latency", &AudioCapture::get_effective_latency,
+             "Latency the current (or last) recording runs with")
+        .def("set_level_update_rate", &AudioCapture::set_level_update_rate,
+             py::arg("hz"),
+             "Set the maximum level callback rate in Hz (0 = every block; only while stopped)")
+        .def_property_readonly("level_update_rate", &AudioCapture::level_update_rate,
+             "Maximum level callback rate in Hz")
+        .def("get_buffer", [](const AudioCapture& self) {
+                 std::vector<char> buffer = self.get_buffer();
+                 return py::bytes(buffer.data(), buffer.size());
+             },
              "Get the current audio buffer as bytes")
+        .def("get_buffer_as_numpy", &get_buffer_as_numpy,
+             py::arg("dtype") = "int16",
+             "Get the current audio buffer as a NumPy array (int16 or float32) without copying")
+        .def("read_new", &read_new,
+             py::arg("cursor") = 0,
+             py::arg("max_frames") = 0,
+             py::arg("dtype") = "int16",
+             "Read only the frames captured since cursor; returns (samples, start_frame, next_cursor)")
+        .def("wait_for_frames", &AudioCapture::wait_for_frames,
+             py::arg("cursor"),
+             py::arg("frames"),
+             py::arg("timeout_ms"),
+             py::call_guard<py::gil_scoped_release>(),
+             "Block until at least `frames` frames are available after cursor")
+        .def_property_readonly("frames_written", &AudioCapture::frames_written,
+             "Total number of frames captured since recording started")
+        .def("set_vad_config", &AudioCapture::set_vad_config,
+             py::arg("config"),
+             "Configure the native voice activity detector (only while stopped)")
+        .def_property_readonly("vad_config", [](const AudioCapture& self) {
+                 return self.get_vad_config();
+             },
+             "Current voice activity detector configuration")
+        .def("wait_for_utterance", &wait_for_utterance,
+             py::arg("timeout_ms"),
+             py::arg("dtype") = "float32",
+             "Wait for a complete utterance; returns (samples, start_frame, end_frame, truncated) or None")
+        .def("set_utterance_staging", &AudioCapture::set_utterance_staging,
+             py::arg("buffers"),
+             py::arg("max_frames") = 0,
+             "Stage utterances as float32 in a pool of page-aligned buffers (0 = off; only while stopped)")
+        .def("wait_for_staged_utterance", &wait_for_staged_utterance,
+             py::arg("timeout_ms"),
+             "Wait for a complete utterance in a staging buffer; returns (samples, start_frame, end_frame, truncated) or None")
+        .def_property_readonly("staging_arena", [](const AudioCapture& self) -> py::object {
+                 std::shared_ptr<ChunkPool> pool = self.staging_pool();
+                 if (!pool) {
+                     return py::none();
+                 }
+                 return py::make_tuple(reinterpret_cast<uintptr_t>(pool->arena()), pool->arena_bytes());
+             },
+             "(address, nbytes) of the staging buffers, e.g. for cudaHostRegister, or None")
+        .def("set_event_bus", &AudioCapture::set_event_bus,
+             py::arg("bus"),
+             py::arg("source") = 0,
+             "Publish level, speech onset and utterance events on an EventBus (None = off; only while stopped)")
+        .def("wait_for_speech_onset", &wait_for_speech_onset,
+             py::arg("timeout_ms"),
+             "Wait for speech after warmup_idle_ms of silence; returns the first frame or None")
+        .def_property_readonly("speech_onsets", &AudioCapture::speech_onsets,
+             "Number of speech onsets in the current recording")
+        .def("set_mel_config", &AudioCapture::set_mel_config,
+             py::arg("config"),
+             "Configure the incremental log-mel front end (only while stopped)")
+        .def_property_readonly("mel_config", [](const AudioCapture& self) {
+                 return self.get_mel_config();
+             },
+             "Current log-mel configuration")
+        .def("set_noise_suppression_config", &AudioCapture::set_noise_suppression_config,
+             py::arg("config"),
+             "Denoise the audio the VAD, mel front end and utterances see (mono only; only while stopped)")
+        .def_property_readonly("noise_suppression_config", [](const AudioCapture& self) {
+                 return self.get_noise_suppression_config();
+             },
+             "Current noise suppression configuration")
+        .def("set_gain_control_config", &AudioCapture::set_gain_control_config,
+             py::arg("config"),
+             "Normalize the level of the audio the VAD, mel front end and utterances see (mono only; only while stopped)")
+        .def_property_readonly("gain_control_config", [](const AudioCapture& self) {
+                 return self.get_gain_control_config();
+             },
+             "Current gain control configuration")
+        .def_property_readonly("preprocessing_latency_frames", &AudioCapture::preprocessing_latency_frames,
+             "Frames of delay the noise suppressor adds before audio reaches the VAD")
+        .def("get_mel", &get_mel,
+             py::arg("start_frame") = 0,
+             py::arg("end_frame") = 0,
+             "Get log10 mel frames as a zero-copy (n_mels, frames) array; returns (mel, start_frame)")
+        .def_property_readonly("mel_frames_written", [](const AudioCapture& self) {
+                 return self.get_mel_spectrogram().frames_written();
+             },
+             "Number of mel frames computed since recording started")
+        .def("mel_is_intact", [](const AudioCapture& self, uint64_t start_frame) {
+                 return self.get_mel_spectrogram().is_intact(start_frame);
+             },
+             py::arg("start_frame"),
+             "Check that a view returned by get_mel() was not overwritten while in use")
+        .def_property_readonly("dropped_utterances", &AudioCapture::dropped_utterances,
+             "Number of utterances dropped because they were not consumed in time")
+        .def("set_chunk_queue", &AudioCapture::set_chunk_queue,
+             py::arg("chunks"),
+             "Queue every period as a pooled chunk for wait_for_chunk() (0 = off; only while stopped)")
+        .def("wait_for_chunk", &wait_for_chunk,
+             py::arg("timeout_ms"),
+             "Wait for the next pooled chunk; returns a PooledChunk or None")
+        .def_property_readonly("dropped_chunks", &AudioCapture::dropped_chunks,
+             "Number of periods not queued because every pooled chunk was in use")
         .def("save_buffer_to_file", &AudioCapture::save_buffer_to_file,
              py::arg("filename"),
              "Save the current audio buffer to a WAV file")
+        .def("start_file_recording", &AudioCapture::start_file_recording,
+             py::arg("config"),
+             "Stream the capture to a file on a background I/O thread")
+        .def("stop_file_recording", &AudioCapture::stop_file_recording,
+             py::call_guard<py::gil_scoped_release>(),
+             "Write out the remaining audio and close the recording file")
+        .def_property_readonly("is_file_recording", &AudioCapture::is_file_recording,
+             "Check whether a file recording is active or waiting to start")
+        .def_property_readonly("recorded_frames", [](const AudioCapture& self) {
+                 return self.get_recorder().frames_recorded();
+             },
+             "Frames written to files by the current (or last) file recording")
+        .def_property_readonly("recording_dropped_frames", [](const AudioCapture& self) {
+                 return self.get_recorder().dropped_frames();
+             },
+             "Frames replaced with silence because the disk fell behind")
+        .def_property_readonly("recording_file", [](const AudioCapture& self) {
+                 return self.get_recorder().current_file();
+             },
+             "Path of the file being recorded (or the last one)")
+        .def("get_stats", &AudioCapture::get_stats,
+             "Get pipeline counters and latency histograms for the current (or last) recording")
         .def("get_available_devices", &AudioCapture::get_available_devices,
              "Get a list of available audio input devices")
         .def_property_readonly("is_recording", &AudioCapture::is_recording,
              "Check if recording is active");
-}
\ No newline at end of file
+
+#if defined(KOELINGO_HAVE_WHISPER_CPP)
+    using koelingo::stt::FileTranscription;
+    using koelingo::stt::FileTranscriptionConfig;
+    using koelingo::stt::Transcript;
+    using koelingo::stt::WhisperConfig;
+    using koelingo::stt::WhisperTranscriber;
+
+    m.attr("HAS_WHISPER_CPP") = true;
+
+    py::class_<WhisperConfig>(m, "WhisperConfig")
+        .def(py::init<>())
+        .def_readwrite("model_path", &WhisperConfig::model_path)
+        .def_readwrite("language", &WhisperConfig::language)
+        .def_readwrite("use_gpu", &WhisperConfig::use_gpu)
+        .def_readwrite("flash_attention", &WhisperConfig::flash_attention)
+        .def_readwrite("workers", &WhisperConfig::workers)
+        .def_readwrite("threads_per_worker", &WhisperConfig::threads_per_worker)
+        .def_readwrite("beam_size", &WhisperConfig::beam_size)
+        .def_readwrite("queue_limit", &WhisperConfig::queue_limit)
+        .def_readwrite("warm_up_on_onset", &WhisperConfig::warm_up_on_onset)
+        .def_readwrite("worker_policy", &WhisperConfig::worker_policy);
+
+    py::class_<Transcript>(m, "Transcript")
+        .def_readonly("text", &Transcript::text)
+        .def_readonly("confidence", &Transcript::confidence)
+        .def_readonly("stream", &Transcript::stream)
+        .def_readonly("start_frame", &Transcript::start_frame)
+        .def_readonly("end_frame", &Transcript::end_frame)
+        .def_readonly("decode_ms", &Transcript::decode_ms);
+
+    py::class_<FileTranscriptionConfig>(m, "FileTranscriptionConfig")
+        .def(py::init<>())
+        .def_readwrite("segmenter", &FileTranscriptionConfig::segmenter)
+        .def_readwrite("workers", &FileTranscriptionConfig::workers);
+
+    py::class_<FileTranscription>(m, "FileTranscription")
+        .def_readonly("transcripts", &FileTranscription::transcripts)
+        .def_readonly("sample_rate", &FileTranscription::sample_rate)
+        .def_readonly("audio_seconds", &FileTranscription::audio_seconds)
+        .def_readonly("elapsed_seconds", &FileTranscription::elapsed_seconds)
+        .def_readonly("utterances", &FileTranscription::utterances)
+        .def_readonly("failed", &FileTranscription::failed);
+
+    py::class_<WhisperTranscriber, std::unique_ptr<WhisperTranscriber, ReleaseGilDeleter<WhisperTranscriber>>>(
+            m, "WhisperTranscriber")
+        .def(py::init<>())
+        .def("load", &WhisperTranscriber::load,
+             py::arg("config"),
+             py::call_guard<py::gil_scoped_release>(),
+             "Load a ggml model and start the decode workers")
+        .def_property_readonly("is_loaded", &WhisperTranscriber::is_loaded)
+        .def("set_callback", &WhisperTranscriber::set_callback,
+             py::arg("callback"),
+             "Receive each Transcript on a worker thread (set before attach)")
+        .def("set_event_bus", &WhisperTranscriber::set_event_bus,
+             py::arg("bus"),
+             "Publish partial and final transcripts on an EventBus (set before attach)")
+        .def("attach", &WhisperTranscriber::attach,
+             py::arg("capture"),
+             py::keep_alive<1, 2>(),
+             "Transcribe the VAD utterances of an AudioCaptureCpp; returns the stream index")
+        .def("detach", &WhisperTranscriber::detach,
+             py::arg("stream"),
+             py::call_guard<py::gil_scoped_release>(),
+             "Stop reading utterances from a stream")
+        .def("stop", &WhisperTranscriber::stop,
+             py::call_guard<py::gil_scoped_release>(),
+             "Detach every stream, finish queued utterances and stop the workers")
+        .def("transcribe", [](WhisperTranscriber& self,
+                              py::array_t<float, py::array::c_style | py::array::forcecast> samples) {
+                 Transcript result;
+                 bool ok;
+                 {
+                     py::gil_scoped_release release;
+                     ok = self.transcribe(samples.data(), static_cast<size_t>(samples.size()), result);
+                 }
+                 if (!ok) {
+                     throw py::value_error("whisper.cpp transcription failed (is a model loaded?)");
+                 }
+                 return result;
+             },
+             py::arg("samples"),
+             "Transcribe 16 kHz mono float32 samples synchronously")
+        .def("transcribe_file", [](WhisperTranscriber& self, const std::string& path,
+                                   const FileTranscriptionConfig& config,
+                                   std::function<void(size_t, size_t)> progress) {
+                 FileTranscription result;
+                 bool ok;
+                 {
+                     py::gil_scoped_release release;
+                     ok = self.transcribe_file(path, config, result, progress);
+                 }
+                 if (!ok) {
+                     throw py::value_error("Cannot transcribe " + path + " (is a model loaded?)");
+                 }
+                 return result;
+             },
+             py::arg("path"),
+             py::arg("config") = FileTranscriptionConfig(),
+             py::arg("progress") = nullptr,
+             "Transcribe a WAV file with parallel VAD and work-stealing decode workers")
+        .def_property_readonly("pending", &WhisperTranscriber::pending,
+             "Utterances waiting for a worker")
+        .def_property_readonly("worker_policy_result", &WhisperTranscriber::worker_policy_result,
+             "What WhisperConfig.worker_policy achieved on the decode workers")
+        .def_static("system_info", &WhisperTranscriber::system_info,
+             "Acceleration backends compiled into whisper.cpp");
+#else
+    m.attr("HAS_WHISPER_CPP") = false;
+#endif
+}
@@ -0,0 +1,281 @@
+"""
+Metrics export for KoeLingo audio capture.
+
+Publishes AudioCapture.get_stats() to Prometheus (text format served over
+HTTP) or to statsd (UDP datagrams), so xruns and dropped audio can be
+alerted on in production. Only the standard library is used.
+"""
+
+import socket
+import threading
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from typing import Any, Dict, List, Optional
+
+# (stats key, help text) for monotonically increasing values
+COUNTERS = (
+    ('callbacks', 'PortAudio callbacks received'),
+    ('frames_captured', 'Frames written to the ring buffer'),
+    ('input_overflows', 'Callbacks flagged with an input overflow (xrun)'),
+    ('input_underflows', 'Callbacks flagged with an input underflow'),
+    ('dropped_frames', 'Frames overwritten before processing reached them'),
+    ('dropped_utterances', 'Utterances dropped because nobody consumed them'),
+    ('dropped_chunks', 'Periods not queued because every pooled chunk was in use'),
+    ('recording_dropped_frames', 'Frames the file recorder replaced with silence'),
+    ('device_failures', 'Device reopens that failed after a period change'),
+)
+
+# (stats key, help text) for values that go up and down
+GAUGES = (
+    ('ring_capacity_frames', 'Ring buffer size in frames'),
+    ('ring_backlog_frames', 'Captured frames not yet processed'),
+    ('ring_peak_backlog_frames', 'Largest processing backlog this recording'),
+)
+
+# (stats key, help text) for latency histograms (C++ implementation only)
+HISTOGRAMS = (
+    ('callback_duration', 'Time spent inside the PortAudio callback'),
+    ('input_latency', 'Time from the ADC to the PortAudio callback'),
+    ('processing_latency', 'Time from the callback until analysis has seen the frames'),
+    ('level_time', 'Time level metering spent per processed block'),
+    ('denoise_time', 'Time noise suppression spent per processed block'),
+    ('agc_time', 'Time gain control spent per processed block'),
+    ('vad_time', 'Time voice activity detection spent per processed block'),
+    ('mel_time', 'Time the log-mel front end spent per processed block'),
+)
+
+
+def format_prometheus(captures: Dict[str, Dict[str, Any]], prefix: str = 'koelingo_audio') -> str:
+    """
+    Render capture statistics in the Prometheus text exposition format.
+
+    Args:
+        captures: get_stats() results keyed by capture name (the "capture" label)
+        prefix: Metric name prefix
+
+    Returns:
+        str: Exposition text; latencies are reported in seconds
+    """
+    lines: List[str] = []
+
+    def label(name: str, extra: str = '') -> str:
+        escaped = name.replace('\\', '\\\\').replace('"', '\\"').replace('\n', '\\n')
+        return f'{{capture="{escaped}"{extra}}}'
+
+    for key, text in COUNTERS:
+        metric = f'{prefix}_{key}_total'
+        lines += [f'# HELP {metric} {text}', f'# TYPE {metric} counter']
+        for name, stats in captures.items():
+            if key in stats:
+                lines.append(f'{metric}{label(name)} {stats[key]}')
+
+    for key, text in GAUGES:
+        metric = f'{prefix}_{key}'
+        lines += [f'# HELP {metric} {text}', f'# TYPE {metric} gauge']
+        for name, stats in captures.items():
+            if key in stats:
+                lines.append(f'{metric}{label(name)} {stats[key]}')
+
+    for key, text in HISTOGRAMS:
+        metric = f'{prefix}_{key}_seconds'
+        lines += [f'# HELP {metric} {text}', f'# TYPE {metric} histogram']
+        for name, stats in captures.items():
+            histogram = stats.get(key)
+            if not histogram:
+                continue
+            # Bucket i holds durations below 2**i microseconds
+            cumulative = 0
+            for i, count in enumerate(histogram['buckets']):
+                cumulative += count
+                bound = ',le="%g"' % ((2 ** i) / 1e6)
+                lines.append(f'{metric}_bucket{label(name, bound)} {cumulative}')
+            inf = ',le="+Inf"'
+            lines.append(f'{metric}_bucket{label(name, inf)} {histogram["count"]}')
+            lines.append(f'{metric}_sum{label(name)} {histogram["sum_us"] / 1e6:g}')
+            lines.append(f'{metric}_count{label(name)} {histogram["count"]}')
+
+    return '\n'.join(lines) + '\n'
+
+
+class _StatsSource:
+    """Registry of named captures whose statistics are exported."""
+
+    def __init__(self):
+        self._captures: Dict[str, Any] = {}
+        self._lock = threading.Lock()
+
+    def add(self, name: str, capture: Any) -> None:
+        """
+        Export the statistics of a capture.
+
+        Args:
+            name: Label identifying the capture, e.g. the booth or device
+            capture: Any object with a get_stats() method returning a dict
+        """
+        with self._lock:
+            self._captures[name] = capture
+
+    def remove(self, name: str) -> None:
+        """Stop exporting a capture."""
+        with self._lock:
+            self._captures.pop(name, None)
+
+    def collect(self) -> Dict[str, Dict[str, Any]]:
+        """Take a get_stats() snapshot of every capture."""
+        with self._lock:
+            captures = dict(self._captures)
+        return {name: capture.get_stats() for name, capture in captures.items()}
+
+
+class PrometheusExporter(_StatsSource):
+    """Serves capture statistics on an HTTP /metrics endpoint for Prometheus to scrape."""
+
+    def __init__(self, port: int = 9464, host: str = '127.0.0.1', prefix: str = 'koelingo_audio'):
+        """
+        Initialize the exporter.
+
+        Args:
+            port: TCP port to listen on (0 picks a free one)
+            host: Interface to bind
+            prefix: Metric name prefix
+        """
+        super().__init__()
+        self.host = host
+        self.prefix = prefix
+        self._requested_port = port
+        self._server: Optional[ThreadingHTTPServer] = None
+        self._thread: Optional[threading.Thread] = None
+
+    @property
+    def port(self) -> int:
+        """Port the server is listening on (the requested one until started)."""
+        return self._server.server_address[1] if self._server else self._requested_port
+
+    def start(self) -> None:
+        """Start serving in a background thread."""
+        if self._server:
+            return
+        exporter = self
+
+        class Handler(BaseHTTPRequestHandler):
+            def do_GET(self):
+                if self.path.split('?')[0] != '/metrics':
+                    self.send_error(404)
+                    return
+                body = format_prometheus(exporter.collect(), exporter.prefix).encode('utf-8')
+                self.send_response(200)
+                self.send_header('Content-Type', 'text/plain; version=0.0.4; charset=utf-8')
+                self.send_header('Content-Length', str(len(body)))
+                self.end_headers()
+                self.wfile.write(body)
+
+            def log_message(self, format, *args):
+                pass  # Scrapes are too frequent to log
+
+        self._server = ThreadingHTTPServer((self.host, self._requested_port), Handler)
+        self._thread = threading.Thread(target=self._server.serve_forever, daemon=True)
+        self._thread.start()
+
+    def stop(self) -> None:
+        """Stop the server."""
+        if not self._server:
+            return
+        self._server.shutdown()
+        self._server.server_close()
+        self._thread.join()
+        self._server = None
+        self._thread = None
+
+
+class StatsdExporter(_StatsSource):
+    """Pushes capture statistics to a statsd daemon at a fixed interval."""
+
+    def __init__(self, host: str = '127.0.0.1', port: int = 8125, interval: float = 10.0,
+                 prefix: str = 'koelingo.audio'):
+        """
+        Initialize the exporter.
+
+        Args:
+            host: statsd host
+            port: statsd UDP port
+            interval: Seconds between flushes
+            prefix: Metric name prefix
+        """
+        super().__init__()
+        self.address = (host, port)
+        self.interval = interval
+        self.prefix = prefix
+        self._socket = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self._last: Dict[str, Dict[str, int]] = {}
+        self._stop = threading.Event()
+        self._thread: Optional[threading.Thread] = None
+
+    def flush(self) -> List[str]:
+        """
+        Send one round of metrics now.
+
+        Counters are sent as the increase since the previous flush, gauges
+        as their current value, and latency histograms as p50/p99/max
+        gauges in milliseconds (statsd timers expect raw samples).
+
+        Returns:
+            list: The statsd lines that were sent
+        """
+        lines: List[str] = []
+        for name, stats in self.collect().items():
+            base = f'{self.prefix}.{name.replace(" ", "_")}'
+            previous = self._last.setdefault(name, {})
+            for key, _ in COUNTERS:
+                if key not in stats:
+                    continue
+                # A restarted recording resets its counters
+                delta = stats[key] - previous.get(key, 0)
+                if delta < 0:
+                    delta = stats[key]
+                previous[key] = stats[key]
+                if delta:
+                    lines.append(f'{base}.{key}:{delta}|c')
+            for key, _ in GAUGES:
+                if key in stats:
+                    lines.append(f'{base}.{key}:{stats[key]}|g')
+            for key, _ in HISTOGRAMS:
+                histogram = stats.get(key)
+                if not histogram or not histogram['count']:
+                    continue
+                for quantile in ('p50', 'p99', 'max'):
+                    lines.append(f'{base}.{key}.{quantile}_ms:{histogram[quantile + "_us"] / 1000:g}|g')
+
+        # Keep each datagram well under a typical MTU
+        packet: List[str] = []
+        for line in lines:
+            if packet and sum(len(p) + 1 for p in packet) + len(line) > 1400:
+                self._socket.sendto('\n'.join(packet).encode('utf-8'), self.address)
+                packet = []
+            packet.append(line)
+        if packet:
+            self._socket.sendto('\n'.join(packet).encode('utf-8'), self.address)
+        return lines
+
+    def start(self) -> None:
+        """Start flushing in a background thread."""
+        if self._thread:
+            return
+        self._stop.clear()
+        self._thread = threading.Thread(target=self._run, daemon=True)
+        self._thread.start()
+
+    def stop(self) -> None:
+        """Flush once more and stop the background thread."""
+        if not self._thread:
+            return
+        self._stop.set()
+        self._thread.join()
+        self._thread = None
+        self.flush()
+
+    def _run(self) -> None:
+        """Flush until stopped."""
+        while not self._stop.wait(self.interval):
+            try:
+                self.flush()
+            except OSError as e:
+                print(f"Error sending statsd metrics: {e}")
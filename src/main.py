@@ -15,8 +15,13 @@ from PySide6.QtCore import QObject, Signal, Slot, QTimer
 from PySide6.QtWidgets import QApplication
 
 from src.ui.main_window import MainWindow
-from src.audio.audio_capture import AudioCapture
+from src.ui.event_bridge import EventBridge
+from src.audio.pybind import AudioCapture, create_event_bus
 from src.stt import WhisperSTT
+from src.translation import NLLBTranslator, TranslationPipeline
+
+# CTranslate2 conversion of facebook/nllb-200-distilled-600M
+NLLB_MODEL_DIR = "models/nllb-200-distilled-600M"
 
 
 class AudioInputHandler(QObject):
@@ -41,6 +46,13 @@ class AudioInputHandler(QObject):
             channels=1
         )
 
+        # Levels and transcripts reach the GUI thread through the event bus
+        self.event_bus = create_event_bus()
+        self.audio_capture.set_event_bus(self.event_bus)
+        self.event_bridge = EventBridge(self.event_bus, parent=self)
+        self.event_bridge.level_changed.connect(self.audio_level_changed)
+        self.event_bridge.final_transcript.connect(self.speech_detected)
+
         # Initialize Whisper STT
         self.stt = WhisperSTT(
             model_size="tiny",  # Start with tiny model for speed
@@ -49,6 +61,17 @@ class AudioInputHandler(QObject):
             use_ctranslate2=True  # Use optimized CTranslate2 if available
         )
 
+        # On a GPU, utterances go straight from the capture's staging buffers to the device
+        if self.stt.set_pinned_staging() and self.audio_capture.set_utterance_staging(8):
+            self.stt.register_host_memory(*self.audio_capture.get_staging_arena())
+
+        # Translate with NLLB when the model is installed, otherwise simulate
+        self.translator = None
+        if NLLBTranslator.is_available(NLLB_MODEL_DIR):
+            self.translator = TranslationPipeline(NLLBTranslator(NLLB_MODEL_DIR),
+                                                  callback=self._on_translation_complete)
+            self.translator.start()
+
         self.is_recording = False
         self.translation_thread = None
         
@@ -69,17 +92,14 @@ class AudioInputHandler(QObject):
                 callback=self._on_transcription_complete
             )
             
-            # Start audio capture with level callback and continuous processing
+            # Start audio capture with continuous processing; levels come from the bus
             self.audio_capture.start_recording(
-                audio_level_callback=self._audio_level_callback,
                 chunk_processing_callback=self._on_audio_chunk_ready,
                 continuous_mode=True
             )
         else:
             # Start non-continuous mode (old behavior)
-            self.audio_capture.start_recording(
-                audio_level_callback=self._audio_level_callback
-            )
+            self.audio_capture.start_recording()
 
     def stop_recording(self):
         """Stop recording audio."""
@@ -98,10 +118,6 @@ class AudioInputHandler(QObject):
             # Process the captured audio for STT (non-continuous mode)
             self._process_captured_audio()
 
-    def _audio_level_callback(self, level):
-        """Callback for audio level updates."""
-        self.audio_level_changed.emit(level)
-        
     def _on_audio_chunk_ready(self, audio_chunk):
         """
         Callback when an audio chunk is ready for processing in continuous mode.
@@ -123,8 +139,8 @@ class AudioInputHandler(QObject):
 
     def _process_captured_audio(self):
         """Process the captured audio for speech recognition."""
-        # Get audio data as numpy array
-        audio_data = self.audio_capture.get_buffer_as_numpy()
+        # Get audio data as a float32 numpy array, ready for Whisper
+        audio_data = self.audio_capture.get_buffer_as_numpy(dtype=np.float32)
 
         if len(audio_data) == 0:
             print("No audio data captured")
@@ -156,17 +172,27 @@ class AudioInputHandler(QObject):
             self.is_processing = False
             self.processing_status_changed.emit(False)
 
-        # Emit signal with recognized Japanese text and confidence
-        self.speech_detected.emit(transcription, confidence)
+        # Subscribers, including the GUI (speech_detected), get the recognized Japanese text
+        self.event_bus.publish_transcript(transcription, confidence)
 
-        # Simulate translation for now (will be replaced with actual translation later)
-        self._simulate_translation(transcription)
+        if self.translator:
+            self.translator.on_transcription(transcription, confidence)
+        else:
+            self._simulate_translation(transcription)
 
-    def _simulate_translation(self, japanese_text):
+    def _on_translation_complete(self, result):
         """
-        Temporarily simulate translation until translation module is implemented.
+        Callback when a sentence is translated.
 
-        This will be replaced with actual translation in Phase 4.
+        Args:
+            result: TranslationResult from the translation pipeline
+        """
+        if result.is_final and result.text:
+            self.translation_completed.emit(result.source, result.text)
+
+    def _simulate_translation(self, japanese_text):
+        """
+        Simulate translation when no NLLB model is installed.
         """
         def process():
             # Simulate processing time
@@ -180,7 +206,7 @@ class AudioInputHandler(QObject):
             elif "ありがとう" in japanese_text:
                 english_text = "Thank you."
             else:
-                english_text = "This is a simulated translation. Real translation will be implemented in Phase 4."
+                english_text = "This is a simulated translation. Install an NLLB model for real translation."
 
             # Emit signal with original Japanese and translated English text
             self.translation_completed.emit(japanese_text, english_text)
@@ -193,6 +219,11 @@ class AudioInputHandler(QObject):
     def cleanup(self):
         """Clean up audio resources."""
         self.stop_recording()
+        self.event_bridge.close()
+
+        if self.translator:
+            self.translator.stop()
+            self.translator.translator.unload_model()
 
         # Unload STT model to free memory
         if hasattr(self, 'stt') and self.stt:
@@ -0,0 +1,10 @@
+"""
+Storage module for KoeLingo.
+
+This module keeps session transcripts in an append-only, memory-mapped
+log (TranscriptStore) linked to the capture timeline.
+"""
+
+from .transcript_store import SessionInfo, TranscriptEntry, TranscriptStore
+
+__all__ = ["TranscriptStore", "TranscriptEntry", "SessionInfo"]
@@ -0,0 +1,563 @@
+"""
+Append-only store of session transcripts.
+
+TranscriptStore keeps every session's transcript in a directory of log
+segments. Entries are binary records with the text, translation,
+confidence, wall-clock time and the utterance's frame range on the
+capture timeline (the start_frame/end_frame the C++ engine reports), so
+text can be found again in the session recording.
+
+Appends are queued and written by a background thread, which commits
+everything queued since its last write with one write and one fsync
+(group commit). Each commit adds one entry per session to the
+segment's small index file. Opening the store reads only the indexes;
+sessions and searches read records through read-only memory maps,
+batch by batch, so history is never loaded whole.
+
+A crash can at worst lose the commit in progress: records carry a
+CRC, and on open a torn tail is cut off and records the index missed
+are indexed again.
+"""
+
+import bisect
+import mmap
+import os
+import struct
+import threading
+import time
+import zlib
+from collections import deque
+from typing import Any, Deque, Dict, Iterator, List, Optional, Tuple
+
+# Record: length and CRC-32 of the body, then the body
+_HEADER = struct.Struct('<II')
+# Body: kind, stream, session, time (us), start/end frame, sample rate,
+# confidence, audio offset, text and translation lengths, then the UTF-8
+# text and translation. A session record stores its name as the text and
+# its audio path as the translation.
+_BODY = struct.Struct('<BxhQqQQIfqII')
+# Index entry: session, offset and length of a run of records, record
+# count, flags, time of the first record (us)
+_INDEX = struct.Struct('<QIIIIq')
+
+_SESSION = 1
+_ENTRY = 2
+_INDEX_HAS_SESSION = 1  # The run starts with the session record
+
+_LOG_SUFFIX = '.log'
+_INDEX_SUFFIX = '.idx'
+
+
+class TranscriptEntry:
+    """One stored utterance."""
+
+    __slots__ = ('session_id', 'timestamp', 'text', 'translation', 'confidence', 'stream',
+                 'start_frame', 'end_frame', 'sample_rate', 'audio_offset')
+
+    def __init__(self, session_id: int, timestamp: float, text: str, translation: str,
+                 confidence: float, stream: int, start_frame: int, end_frame: int,
+                 sample_rate: int, audio_offset: int):
+        self.session_id = session_id
+        self.timestamp = timestamp
+        self.text = text
+        self.translation = translation
+        self.confidence = confidence
+        self.stream = stream
+        self.start_frame = start_frame
+        self.end_frame = end_frame
+        self.sample_rate = sample_rate
+        self.audio_offset = audio_offset
+
+    @property
+    def start(self) -> float:
+        """Start on the capture timeline in seconds."""
+        return self.start_frame / self.sample_rate if self.sample_rate else 0.0
+
+    @property
+    def end(self) -> float:
+        """End on the capture timeline in seconds."""
+        return self.end_frame / self.sample_rate if self.sample_rate else 0.0
+
+    def __repr__(self) -> str:
+        return f'TranscriptEntry({self.session_id}, {self.start:.2f}-{self.end:.2f}, {self.text!r})'
+
+
+class SessionInfo:
+    """A stored session and where its records are."""
+
+    __slots__ = ('session_id', 'name', 'started', 'audio_path', 'sample_rate', 'entries', 'runs')
+
+    def __init__(self, session_id: int):
+        self.session_id = session_id
+        self.name = ''
+        self.started = 0.0
+        self.audio_path = ''
+        self.sample_rate = 0
+        self.entries = 0
+        self.runs: List[Tuple[int, int, int]] = []  # (segment, offset, length)
+
+    def __repr__(self) -> str:
+        return f'SessionInfo({self.session_id}, {self.name!r}, {self.entries} entries)'
+
+
+def _encode(kind: int, session_id: int, timestamp: float, text: str, translation: str,
+            confidence: float = 0.0, stream: int = 0, start_frame: int = 0, end_frame: int = 0,
+            sample_rate: int = 0, audio_offset: int = -1) -> bytes:
+    """Encode one record."""
+    text_bytes = text.encode('utf-8')
+    translation_bytes = translation.encode('utf-8')
+    body = _BODY.pack(kind, stream, session_id, int(timestamp * 1e6), start_frame, end_frame,
+                      sample_rate, confidence, audio_offset, len(text_bytes),
+                      len(translation_bytes)) + text_bytes + translation_bytes
+    return _HEADER.pack(len(body), zlib.crc32(body)) + body
+
+
+def _decode(data: Any, offset: int, limit: int) -> Optional[Tuple[int, tuple, str, str]]:
+    """
+    Decode the record at offset.
+
+    Returns:
+        tuple: (offset of the next record, body fields, text, translation),
+        or None if the record is torn or corrupt
+    """
+    if offset + _HEADER.size > limit:
+        return None
+    length, crc = _HEADER.unpack_from(data, offset)
+    start = offset + _HEADER.size
+    if length < _BODY.size or start + length > limit:
+        return None
+    body = data[start:start + length]
+    if zlib.crc32(body) != crc:
+        return None
+    fields = _BODY.unpack_from(body)
+    text_end = _BODY.size + fields[9]
+    if text_end + fields[10] != length:
+        return None
+    return (start + length, fields, body[_BODY.size:text_end].decode('utf-8', 'replace'),
+            body[text_end:].decode('utf-8', 'replace'))
+
+
+class TranscriptStore:
+    """Segmented, memory-mapped transcript log with group commit."""
+
+    def __init__(self, root: str, segment_bytes: int = 8 << 20, sync: bool = True):
+        """
+        Initialize the store; call open() before use.
+
+        Args:
+            root: Directory of the log segments (created if missing)
+            segment_bytes: Size at which a new segment is started
+            sync: fsync each commit (durable across power loss rather than
+                only process crashes)
+        """
+        self.root = root
+        self.segment_bytes = max(4096, segment_bytes)
+        self.sync = sync
+
+        self._sessions: Dict[int, SessionInfo] = {}
+        self._runs: Dict[int, List[Tuple[int, int, int]]] = {}  # segment -> (offset, length, session)
+        self._sizes: Dict[int, int] = {}  # Committed bytes per segment
+        self._maps: Dict[int, Tuple[int, mmap.mmap]] = {}
+        self._next_session = 1
+
+        self._queue: Deque[Tuple[int, int, bytes]] = deque()  # (sequence, session, record)
+        self._queued = 0  # Sequence of the last queued record
+        self._committed = 0
+        self._lock = threading.Condition()
+        self._map_lock = threading.Lock()
+        self._thread: Optional[threading.Thread] = None
+        self._active = False
+        self._segment = 0
+        self._log: Optional[Any] = None
+        self._index: Optional[Any] = None
+        self._stats = {'records': 0, 'commits': 0, 'bytes': 0}
+
+    def __enter__(self) -> 'TranscriptStore':
+        self.open()
+        return self
+
+    def __exit__(self, *exc: Any) -> None:
+        self.close()
+
+    def open(self) -> None:
+        """Load the indexes, repair a torn tail and start the writer."""
+        if self._active:
+            return
+        os.makedirs(self.root, exist_ok=True)
+        self._sessions, self._runs, self._sizes, self._maps = {}, {}, {}, {}
+        self._next_session = 1
+        segments = sorted(int(name[:-len(_LOG_SUFFIX)]) for name in os.listdir(self.root)
+                          if name.endswith(_LOG_SUFFIX) and name[:-len(_LOG_SUFFIX)].isdigit())
+        for segment in segments:
+            self._load_segment(segment)
+
+        self._segment = segments[-1] if segments else 0
+        self._open_segment(self._segment)
+        self._active = True
+        self._thread = threading.Thread(target=self._run, daemon=True)
+        self._thread.start()
+
+    def close(self) -> None:
+        """Commit what is queued and close the files."""
+        with self._lock:
+            if not self._active:
+                return
+            self._active = False
+            self._lock.notify_all()
+        self._thread.join()
+        self._thread = None
+        self._log.close()
+        self._index.close()
+        with self._map_lock:
+            for _, view in self._maps.values():
+                view.close()
+            self._maps.clear()
+
+    def begin_session(self, name: str = '', audio_path: str = '', sample_rate: int = 16000,
+                      started: Optional[float] = None) -> int:
+        """
+        Start a session.
+
+        Args:
+            name: Label shown in the history
+            audio_path: Recording of the session, e.g. from start_file_recording()
+            sample_rate: Rate of the capture timeline the entries' frames are on
+            started: Wall-clock start (default: now)
+
+        Returns:
+            int: Session id for append()
+        """
+        started = time.time() if started is None else started
+        with self._lock:
+            session_id = self._next_session
+            self._next_session += 1
+            info = SessionInfo(session_id)
+            info.name, info.started, info.audio_path = name, started, audio_path
+            info.sample_rate = sample_rate
+            self._sessions[session_id] = info
+            self._enqueue(session_id, _encode(_SESSION, session_id, started, name, audio_path,
+                                              sample_rate=sample_rate))
+        return session_id
+
+    def append(self, session_id: int, text: str, start_frame: int = 0, end_frame: int = 0,
+               confidence: float = 0.0, translation: str = '', stream: int = 0,
+               audio_offset: int = -1, timestamp: Optional[float] = None) -> int:
+        """
+        Queue an utterance; it is written by the next group commit.
+
+        Args:
+            session_id: Session from begin_session()
+            text: Recognized text
+            start_frame: First frame on the capture timeline
+            end_frame: One past the last frame
+            confidence: Recognition confidence
+            translation: Translated text
+            stream: Capture stream of the utterance
+            audio_offset: First frame of the utterance in the session
+                recording, or -1 if it was not recorded
+            timestamp: Wall-clock time (default: now)
+
+        Returns:
+            int: Sequence number to pass to flush()
+
+        Raises:
+            KeyError: If the session does not exist
+        """
+        timestamp = time.time() if timestamp is None else timestamp
+        with self._lock:
+            info = self._sessions[session_id]
+            info.entries += 1
+            return self._enqueue(session_id, _encode(
+                _ENTRY, session_id, timestamp, text, translation, confidence, stream,
+                start_frame, end_frame, info.sample_rate, audio_offset))
+
+    def append_transcript(self, session_id: int, transcript: Any, translation: str = '',
+                          audio_offset: int = -1) -> int:
+        """
+        Queue a transcript with text, confidence, stream, start_frame and
+        end_frame, e.g. a native whisper.cpp Transcript.
+        """
+        return self.append(session_id, transcript.text, transcript.start_frame,
+                           transcript.end_frame, transcript.confidence, translation,
+                           max(0, transcript.stream), audio_offset)
+
+    def flush(self, sequence: int = 0, timeout: Optional[float] = None) -> bool:
+        """
+        Wait until records are committed.
+
+        Args:
+            sequence: Record from append() to wait for (0 for everything queued)
+            timeout: Seconds to wait at most (None for no limit)
+
+        Returns:
+            bool: True if the records are committed
+        """
+        with self._lock:
+            target = sequence or self._queued
+            return self._lock.wait_for(lambda: self._committed >= target, timeout)
+
+    def sessions(self) -> List[SessionInfo]:
+        """Sessions in the order they were started."""
+        with self._lock:
+            return [self._sessions[key] for key in sorted(self._sessions)]
+
+    def entries(self, session_id: int) -> Iterator[TranscriptEntry]:
+        """
+        Iterate over a session's committed entries in order.
+
+        Raises:
+            KeyError: If the session does not exist
+        """
+        with self._lock:
+            runs = list(self._sessions[session_id].runs)
+        for segment, offset, length in runs:
+            yield from self._read_run(segment, offset, length)
+
+    def search(self, query: str, session_id: Optional[int] = None,
+               limit: int = 100) -> List[TranscriptEntry]:
+        """
+        Find entries whose text or translation contains query.
+
+        Each segment is scanned through its memory map, and only the
+        runs with a match are decoded.
+
+        Args:
+            query: Text to find (case-sensitive)
+            session_id: Only search this session
+            limit: Most entries returned
+
+        Returns:
+            list: Matching entries, oldest first
+        """
+        needle = query.encode('utf-8')
+        found: List[TranscriptEntry] = []
+        if not needle:
+            return found
+        with self._lock:
+            segments = {segment: list(runs) for segment, runs in self._runs.items()}
+
+        for segment in sorted(segments):
+            runs = segments[segment]
+            view = self._map(segment)
+            if view is None or not runs:
+                continue
+            starts = [run[0] for run in runs]
+            position = view.find(needle, 0, runs[-1][0] + runs[-1][1])
+            while position >= 0 and len(found) < limit:
+                run = runs[bisect.bisect_right(starts, position) - 1]
+                offset, length, session = run
+                if session_id is None or session == session_id:
+                    found.extend(entry for entry in self._read_run(segment, offset, length)
+                                 if query in entry.text or query in entry.translation)
+                position = view.find(needle, offset + length, runs[-1][0] + runs[-1][1])
+        return found[:limit]
+
+    def get_stats(self) -> Dict[str, Any]:
+        """
+        Get write statistics.
+
+        Returns:
+            dict: records, commits, bytes, records_per_commit, sessions and segments
+        """
+        with self._lock:
+            stats = dict(self._stats)
+            stats['sessions'] = len(self._sessions)
+            stats['segments'] = len(self._sizes)
+        stats['records_per_commit'] = stats['records'] / stats['commits'] if stats['commits'] else 0.0
+        return stats
+
+    def _path(self, segment: int, suffix: str) -> str:
+        return os.path.join(self.root, f'{segment:08d}{suffix}')
+
+    def _enqueue(self, session_id: int, record: bytes) -> int:
+        """Queue a record for the writer; lock held."""
+        self._queued += 1
+        self._queue.append((self._queued, session_id, record))
+        self._lock.notify_all()
+        return self._queued
+
+    def _load_segment(self, segment: int) -> None:
+        """Read a segment's index, then recover records written after it."""
+        size = os.path.getsize(self._path(segment, _LOG_SUFFIX))
+        runs: List[Tuple[int, int, int]] = []
+        indexed = 0
+        index_path = self._path(segment, _INDEX_SUFFIX)
+        if os.path.exists(index_path):
+            with open(index_path, 'rb') as f:
+                data = f.read()
+            for position in range(0, len(data) - _INDEX.size + 1, _INDEX.size):
+                session, offset, length, count, flags, _ = _INDEX.unpack_from(data, position)
+                if offset != indexed or offset + length > size:
+                    break  # Written after a data write that did not complete
+                runs.append((offset, length, session))
+                indexed = offset + length
+                self._add_run(segment, session, offset, length, count, flags)
+            if len(runs) * _INDEX.size != len(data):
+                with open(index_path, 'r+b') as f:
+                    f.truncate(len(runs) * _INDEX.size)
+        self._runs[segment] = runs
+        self._sizes[segment] = indexed
+
+        if indexed < size:
+            self._recover(segment, indexed, size)
+
+    def _recover(self, segment: int, offset: int, size: int) -> None:
+        """Index intact records past the index and cut off a torn tail."""
+        path = self._path(segment, _LOG_SUFFIX)
+        with open(path, 'rb') as f:
+            with mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ) as view:
+                entries = []
+                while True:
+                    record = _decode(view, offset, size)
+                    if record is None:
+                        break
+                    end, fields = record[0], record[1]
+                    entries.append((offset, end - offset, fields))
+                    offset = end
+
+        with open(self._path(segment, _INDEX_SUFFIX), 'ab') as index:
+            for start, length, fields in entries:
+                kind, session, timestamp = fields[0], fields[2], fields[3]
+                flags = _INDEX_HAS_SESSION if kind == _SESSION else 0
+                count = 0 if kind == _SESSION else 1
+                index.write(_INDEX.pack(session, start, length, count, flags, timestamp))
+                self._runs[segment].append((start, length, session))
+                self._add_run(segment, session, start, length, count, flags)
+        if offset < size:
+            with open(path, 'r+b') as f:
+                f.truncate(offset)
+        self._sizes[segment] = offset
+
+    def _add_run(self, segment: int, session_id: int, offset: int, length: int, count: int,
+                 flags: int) -> None:
+        """Account for an indexed run of a session's records."""
+        info = self._sessions.get(session_id)
+        if info is None:
+            info = self._sessions[session_id] = SessionInfo(session_id)
+            self._next_session = max(self._next_session, session_id + 1)
+        info.runs.append((segment, offset, length))
+        info.entries += count
+        if flags & _INDEX_HAS_SESSION:
+            with open(self._path(segment, _LOG_SUFFIX), 'rb') as f:
+                f.seek(offset)
+                data = f.read(min(length, 65536))
+            record = _decode(data, 0, len(data))
+            if record and record[1][0] == _SESSION:
+                fields = record[1]
+                info.name, info.audio_path = record[2], record[3]
+                info.started, info.sample_rate = fields[3] / 1e6, fields[6]
+
+    def _open_segment(self, segment: int) -> None:
+        """Open a segment for appending."""
+        self._log = open(self._path(segment, _LOG_SUFFIX), 'ab')
+        self._index = open(self._path(segment, _INDEX_SUFFIX), 'ab')
+        self._sizes.setdefault(segment, 0)
+        self._runs.setdefault(segment, [])
+
+    def _run(self) -> None:
+        """Commit whatever is queued, one group at a time."""
+        while True:
+            with self._lock:
+                self._lock.wait_for(lambda: self._queue or not self._active)
+                if not self._queue:
+                    return
+                batch = list(self._queue)
+                self._queue.clear()
+            try:
+                self._commit(batch)
+            except OSError as e:
+                print(f"Error writing transcripts: {e}")
+            with self._lock:
+                self._committed = batch[-1][0]
+                self._lock.notify_all()
+
+    def _commit(self, batch: List[Tuple[int, int, bytes]]) -> None:
+        """Write a group of records with one write and fsync per segment."""
+        # Each session's records stay in order and form one run per segment
+        by_session: Dict[int, List[bytes]] = {}
+        for _, session, record in batch:
+            by_session.setdefault(session, []).append(record)
+
+        data = bytearray()
+        pending: List[Tuple[int, int, int, int, int, int]] = []
+        for session, records in by_session.items():
+            run: Optional[List[int]] = None  # [start, count, flags, first time]
+            for record in records:
+                if data and self._sizes[self._segment] + len(data) + len(record) > self.segment_bytes:
+                    if run:
+                        pending.append((session, run[0], len(data) - run[0], run[1], run[2], run[3]))
+                    self._write(data, pending)
+                    self._roll()
+                    data, pending, run = bytearray(), [], None
+                kind = record[_HEADER.size]
+                if run is None:
+                    run = [len(data), 0, _INDEX_HAS_SESSION if kind == _SESSION else 0,
+                           _BODY.unpack_from(record, _HEADER.size)[3]]
+                if kind == _ENTRY:
+                    run[1] += 1
+                data += record
+            pending.append((session, run[0], len(data) - run[0], run[1], run[2], run[3]))
+        self._write(data, pending)
+
+    def _write(self, data: bytearray, pending: List[Tuple[int, int, int, int, int, int]]) -> None:
+        """Append records and their index entries to the current segment."""
+        if not data:
+            return
+        segment = self._segment
+        base = self._sizes[segment]
+        self._log.write(data)
+        self._log.flush()
+        if self.sync:
+            os.fsync(self._log.fileno())
+        # The index is rebuilt from the log if this write is lost
+        self._index.write(b''.join(_INDEX.pack(session, base + start, length, count, flags, first)
+                                   for session, start, length, count, flags, first in pending))
+        self._index.flush()
+
+        with self._lock:
+            self._sizes[segment] = base + len(data)
+            for session, start, length, count, flags, _ in pending:
+                self._runs[segment].append((base + start, length, session))
+                self._sessions[session].runs.append((segment, base + start, length))
+                self._stats['records'] += count + (1 if flags & _INDEX_HAS_SESSION else 0)
+            self._stats['commits'] += 1
+            self._stats['bytes'] += len(data)
+
+    def _roll(self) -> None:
+        """Start the next segment."""
+        self._log.close()
+        self._index.close()
+        self._segment += 1
+        self._open_segment(self._segment)
+
+    def _map(self, segment: int) -> Optional[mmap.mmap]:
+        """Map a segment, remapping when commits have grown it."""
+        with self._lock:
+            size = self._sizes.get(segment, 0)
+        if size == 0:
+            return None
+        with self._map_lock:
+            mapped = self._maps.get(segment)
+            if mapped and mapped[0] >= size:
+                return mapped[1]
+            # A reader may still iterate the old map; it closes when released
+            with open(self._path(segment, _LOG_SUFFIX), 'rb') as f:
+                view = mmap.mmap(f.fileno(), size, access=mmap.ACCESS_READ)
+            self._maps[segment] = (size, view)
+            return view
+
+    def _read_run(self, segment: int, offset: int, length: int) -> Iterator[TranscriptEntry]:
+        """Decode the entries of a run of records."""
+        view = self._map(segment)
+        end = offset + length
+        while view is not None and offset < end:
+            record = _decode(view, offset, end)
+            if record is None:
+                return
+            offset, fields, text, translation = record
+            if fields[0] != _ENTRY:
+                continue
+            (_, stream, session, timestamp, start_frame, end_frame, sample_rate, confidence,
+             audio_offset, _, _) = fields
+            yield TranscriptEntry(session, timestamp / 1e6, text, translation, confidence, stream,
+                                  start_frame, end_frame, sample_rate, audio_offset)
@@ -1,9 +1,20 @@
 """
 Speech-to-Text module for KoeLingo.
 
-This module handles Japanese speech recognition using Whisper.
+This module handles Japanese speech recognition using Whisper, either
+through openai-whisper/CTranslate2 (WhisperSTT) or natively through
+whisper.cpp (WhisperCppSTT).
 """
 
-from .whisper_stt import WhisperSTT
+from .file_transcriber import FileTranscriber
+from .streaming import StreamingResult, StreamingTranscriber
+from .whisper_cpp_stt import WhisperCppSTT
 
-__all__ = ["WhisperSTT"]
+# openai-whisper pulls in PyTorch; edge installs may only have whisper.cpp
+try:
+    from .whisper_stt import WhisperSTT
+except ImportError:
+    WhisperSTT = None
+
+__all__ = ["WhisperSTT", "WhisperCppSTT", "StreamingTranscriber", "StreamingResult",
+           "FileTranscriber"]
@@ -0,0 +1,250 @@
+"""
+Deadline-aware batching of utterances for Whisper inference.
+
+Whisper's encoder always runs on a padded 30 second window, so decoding
+eight short utterances in one batch costs little more than decoding one.
+BatchQueue collects utterances from any number of capture streams and
+hands them to the inference thread in batches sized so the oldest
+utterance still meets its latency budget, based on how long recent
+batches actually took.
+"""
+
+import threading
+import time
+from collections import deque
+from typing import Any, Callable, Deque, Dict, List, Optional, Tuple
+
+import numpy as np
+
+
+class TranscriptionRequest:
+    """One utterance waiting to be transcribed."""
+
+    __slots__ = ('stream_id', 'audio', 'callback', 'enqueued', 'deadline')
+
+    def __init__(self, stream_id: Any, audio: np.ndarray,
+                 callback: Optional[Callable[[str, float], None]], deadline: float):
+        self.stream_id = stream_id
+        self.audio = audio
+        self.callback = callback
+        self.enqueued = time.monotonic()
+        self.deadline = deadline
+
+
+class BatchCostModel:
+    """
+    Estimates how long a batch takes from recent measurements.
+
+    Fits time = fixed + per_item * batch_size over a sliding window, which
+    captures both the per-call overhead batching amortizes and the marginal
+    cost of each extra utterance.
+    """
+
+    def __init__(self, window: int = 64, initial_seconds: float = 0.5):
+        """
+        Initialize the model.
+
+        Args:
+            window: Number of recent batches to fit
+            initial_seconds: Assumed cost of a single-utterance batch until measured
+        """
+        self._samples: Deque[Tuple[int, float]] = deque(maxlen=window)
+        self._fixed = initial_seconds
+        self._per_item = 0.0
+        self._lock = threading.Lock()
+
+    def record(self, batch_size: int, seconds: float) -> None:
+        """Add the measured duration of a batch."""
+        with self._lock:
+            self._samples.append((batch_size, seconds))
+            sizes = np.array([s[0] for s in self._samples], dtype=np.float64)
+            times = np.array([s[1] for s in self._samples], dtype=np.float64)
+
+            # With a single batch size seen so far, assume the cost scales
+            # with it; otherwise least squares over the window
+            if np.ptp(sizes) == 0:
+                self._fixed = 0.0
+                self._per_item = float(times.mean() / sizes.mean())
+                return
+            per_item, fixed = np.polyfit(sizes, times, 1)
+            self._per_item = max(0.0, float(per_item))
+            self._fixed = max(0.0, float(fixed))
+
+    def estimate(self, batch_size: int) -> float:
+        """Predict the duration of a batch in seconds."""
+        with self._lock:
+            return self._fixed + self._per_item * batch_size
+
+
+class BatchQueue:
+    """
+    Bounded queue of utterances that releases them in deadline-sized batches.
+
+    Utterances are served earliest deadline first. The consumer calls
+    get_batch(), which takes the largest batch whose predicted run time
+    still meets the earliest deadline, and waits up to max_wait for more
+    utterances while there is slack for them.
+
+    When max_pending utterances are queued, put() blocks. Called from the
+    capture's utterance callback this stops draining the native VAD
+    queue, so overload shows up as dropped_utterances in the capture
+    statistics instead of unbounded latency.
+    """
+
+    def __init__(self, max_batch_size: int = 8, latency_budget: float = 2.0,
+                 max_wait: float = 0.05, max_pending: int = 32):
+        """
+        Initialize the queue.
+
+        Args:
+            max_batch_size: Largest batch handed to the model
+            latency_budget: Target seconds from put() until the transcription is delivered
+            max_wait: Longest time to hold a batch back waiting for more utterances
+            max_pending: Queued utterances at which put() blocks (backpressure)
+        """
+        self.max_batch_size = max(1, max_batch_size)
+        self.latency_budget = latency_budget
+        self.max_wait = max_wait
+        self.max_pending = max(1, max_pending)
+        self.cost = BatchCostModel()
+
+        self._pending: List[TranscriptionRequest] = []
+        self._condition = threading.Condition()
+        self._closed = False
+        self._interrupted = False
+        self._stats = {'batches': 0, 'utterances': 0, 'rejected': 0, 'deadline_misses': 0}
+
+    def put(self, audio: np.ndarray, stream_id: Any = None,
+            callback: Optional[Callable[[str, float], None]] = None,
+            timeout: Optional[float] = None) -> bool:
+        """
+        Queue an utterance.
+
+        Args:
+            audio: Utterance samples
+            stream_id: Identifies the capture stream the utterance came from
+            callback: Receives (text, confidence); None for the default callback
+            timeout: Seconds to wait for room when the queue is full (None waits forever)
+
+        Returns:
+            bool: False if the queue stayed full or is closed
+        """
+        with self._condition:
+            if not self._condition.wait_for(
+                    lambda: len(self._pending) < self.max_pending or self._closed, timeout):
+                self._stats['rejected'] += 1
+                return False
+            if self._closed:
+                return False
+            deadline = time.monotonic() + self.latency_budget
+            self._pending.append(TranscriptionRequest(stream_id, audio, callback, deadline))
+            self._condition.notify_all()
+            return True
+
+    def get_batch(self, timeout: float) -> List[TranscriptionRequest]:
+        """
+        Take the next batch to transcribe.
+
+        Args:
+            timeout: Seconds to wait for the first utterance
+
+        Returns:
+            list: Requests ordered by deadline; empty on timeout, interrupt() or when closed
+        """
+        with self._condition:
+            if not self._condition.wait_for(
+                    lambda: self._pending or self._closed or self._interrupted, timeout):
+                return []
+            self._interrupted = False
+            if not self._pending:
+                return []
+
+            # Hold the batch back for more utterances while the earliest
+            # deadline can absorb both the wait and the larger batch
+            hold_until = time.monotonic() + self.max_wait
+            while not self._closed and len(self._pending) < self.max_batch_size:
+                now = time.monotonic()
+                earliest = min(r.deadline for r in self._pending)
+                slack = earliest - now - self.cost.estimate(len(self._pending) + 1)
+                wait = min(hold_until - now, slack)
+                if wait <= 0:
+                    break
+                self._condition.wait(wait)
+
+            if not self._pending:
+                return []
+            self._pending.sort(key=lambda r: r.deadline)
+            size = self._batch_size(time.monotonic())
+            batch, self._pending = self._pending[:size], self._pending[size:]
+            self._condition.notify_all()  # Wake producers blocked on a full queue
+            return batch
+
+    def _batch_size(self, now: float) -> int:
+        """Largest batch that still finishes before the earliest deadline (at least 1)."""
+        earliest = self._pending[0].deadline
+        size = min(self.max_batch_size, len(self._pending))
+        while size > 1 and now + self.cost.estimate(size) > earliest:
+            size -= 1
+        return size
+
+    def complete(self, batch: List[TranscriptionRequest], seconds: float) -> None:
+        """
+        Report that a batch has been transcribed.
+
+        Args:
+            batch: The batch returned by get_batch()
+            seconds: Time the model took for it
+        """
+        self.cost.record(len(batch), seconds)
+        now = time.monotonic()
+        with self._condition:
+            self._stats['batches'] += 1
+            self._stats['utterances'] += len(batch)
+            self._stats['deadline_misses'] += sum(1 for r in batch if now > r.deadline)
+
+    def interrupt(self) -> None:
+        """Make a waiting get_batch() return at once, so its caller can do other work."""
+        with self._condition:
+            self._interrupted = True
+            self._condition.notify_all()
+
+    def clear(self) -> None:
+        """Drop every queued utterance."""
+        with self._condition:
+            self._pending = []
+            self._closed = False
+            self._condition.notify_all()
+
+    def close(self) -> None:
+        """Release blocked producers and consumers; put() fails until clear()."""
+        with self._condition:
+            self._closed = True
+            self._condition.notify_all()
+
+    def qsize(self) -> int:
+        """Number of queued utterances."""
+        with self._condition:
+            return len(self._pending)
+
+    def empty(self) -> bool:
+        """Check whether no utterance is queued."""
+        return self.qsize() == 0
+
+    @property
+    def saturated(self) -> bool:
+        """True while put() would block."""
+        return self.qsize() >= self.max_pending
+
+    def get_stats(self) -> Dict[str, Any]:
+        """
+        Get batching counters.
+
+        Returns:
+            dict: batches, utterances, rejected (put() timed out while full),
+            deadline_misses, mean_batch_size and pending
+        """
+        with self._condition:
+            stats = dict(self._stats)
+            stats['pending'] = len(self._pending)
+        stats['mean_batch_size'] = stats['utterances'] / stats['batches'] if stats['batches'] else 0.0
+        return stats
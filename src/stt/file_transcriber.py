@@ -0,0 +1,324 @@
+"""
+Offline transcription of recorded audio files.
+
+FileTranscriber turns archived WAVs into timestamped transcripts as fast
+as the hardware allows instead of at 1x real time. The file is
+memory-mapped, split into utterances by the native VAD in parallel
+regions (or an energy-based fallback without the C++ extension), and
+the utterances are spread over worker threads. Each worker owns a queue
+of utterances, longest first, and steals from the back of the fullest
+other queue once its own runs dry. Workers hand the model a batch of
+utterances at a time, so a GPU model decodes them in one padded call.
+"""
+
+import logging
+import os
+import struct
+import threading
+import time
+from collections import deque
+from typing import Any, Callable, Deque, Dict, List, Optional, Sequence, Tuple
+
+import numpy as np
+
+try:
+    try:
+        from src.audio.audio_capture_cc import FileSegmenterConfig, segment_wav_file
+    except ImportError:
+        from koelingo.audio.audio_capture_cc import FileSegmenterConfig, segment_wav_file
+    HAS_NATIVE_SEGMENTER = True
+except ImportError:
+    HAS_NATIVE_SEGMENTER = False
+
+WHISPER_RATE = 16000
+
+# WAV (format tag, bits) to the dtype of its samples; 24-bit PCM cannot be mapped
+_WAV_DTYPES = {(1, 8): np.uint8, (1, 16): '<i2', (1, 32): '<i4', (3, 32): '<f4'}
+
+# Decodes a batch of 16 kHz mono float32 utterances to (text, confidence)
+DecodeBatch = Callable[[List[np.ndarray]], List[Tuple[str, float]]]
+
+
+def map_wav(path: str) -> Tuple[np.ndarray, int]:
+    """
+    Memory-map the samples of a WAV file.
+
+    Args:
+        path: 8/16/32-bit PCM or 32-bit float WAV file
+
+    Returns:
+        tuple: (read-only array of shape (frames, channels), sample rate)
+
+    Raises:
+        ValueError: If the file is not a WAV file or its encoding is unsupported
+    """
+    with open(path, 'rb') as f:
+        header = f.read(12)
+        if len(header) < 12 or header[:4] != b'RIFF' or header[8:12] != b'WAVE':
+            raise ValueError(f"Not a WAV file: {path}")
+        fmt = None
+        while True:
+            chunk = f.read(8)
+            if len(chunk) < 8:
+                raise ValueError(f"No data chunk in {path}")
+            chunk_id, size = struct.unpack('<4sI', chunk)
+            if chunk_id == b'fmt ':
+                body = f.read(size + (size & 1))
+                tag, channels, rate = struct.unpack_from('<HHI', body)
+                bits = struct.unpack_from('<H', body, 14)[0]
+                if tag == 0xFFFE and size >= 40:
+                    tag = struct.unpack_from('<H', body, 24)[0]  # SubFormat GUID
+                fmt = (tag, channels, rate, bits)
+            elif chunk_id == b'data':
+                offset = f.tell()
+                break
+            else:
+                f.seek(size + (size & 1), os.SEEK_CUR)
+        available = os.fstat(f.fileno()).st_size - offset
+
+    dtype = _WAV_DTYPES.get(fmt[0::3]) if fmt else None
+    if dtype is None or fmt[1] <= 0 or fmt[2] <= 0:
+        raise ValueError(f"Unsupported WAV encoding: {path}")
+
+    # A recording that was not finalized has a zero or oversized length
+    length = size if 0 < size <= available else available
+    frames = length // (np.dtype(dtype).itemsize * fmt[1])
+    return np.memmap(path, dtype=dtype, mode='r', offset=offset, shape=(frames, fmt[1])), fmt[2]
+
+
+def to_whisper_input(frames: np.ndarray, sample_rate: int) -> np.ndarray:
+    """
+    Convert frames of a mapped WAV to the 16 kHz mono float32 Whisper expects.
+
+    Args:
+        frames: Array of shape (frames, channels) from map_wav()
+        sample_rate: Rate of the frames in Hz
+
+    Returns:
+        np.ndarray: Mono float32 samples in [-1, 1] at 16 kHz
+    """
+    if frames.dtype == np.uint8:
+        samples = (frames.astype(np.float32) - 128.0) / 128.0
+    elif frames.dtype.kind == 'i':
+        samples = frames.astype(np.float32) / float(2 ** (8 * frames.dtype.itemsize - 1))
+    else:
+        samples = np.asarray(frames, dtype=np.float32)
+    mono = samples.mean(axis=1) if samples.shape[1] > 1 else samples[:, 0]
+
+    if sample_rate != WHISPER_RATE:
+        # A box filter keeps the worst aliasing out, then linear interpolation
+        ratio = sample_rate / WHISPER_RATE
+        width = int(round(ratio))
+        if width > 1:
+            mono = np.convolve(mono, np.full(width, 1.0 / width, dtype=np.float32), mode='same')
+        positions = np.arange(int(len(mono) / ratio)) * ratio
+        mono = np.interp(positions, np.arange(len(mono)), mono)
+    return np.ascontiguousarray(mono, dtype=np.float32)
+
+
+def energy_segments(frames: np.ndarray, sample_rate: int, energy_threshold: float = 0.02,
+                    frame_ms: int = 30, min_speech_ms: int = 150, hangover_ms: int = 900,
+                    pre_roll_ms: int = 300, min_utterance_ms: int = 500,
+                    max_utterance_ms: int = 10000) -> List[Tuple[int, int]]:
+    """
+    Split audio into utterances by short-term energy.
+
+    Fallback for segment_wav(); the thresholds mirror the native VAD's
+    defaults, without its zero-crossing test for unvoiced speech.
+
+    Returns:
+        list: (start_frame, end_frame) per utterance, in order
+    """
+    def ms(value: int) -> int:
+        return sample_rate * value // 1000
+
+    window = max(1, ms(frame_ms))
+    windows = len(frames) // window
+    segments: List[Tuple[int, int]] = []
+    start: Optional[int] = None
+    speech_run = silence_run = last_end = 0
+
+    for first in range(0, windows, 4096):
+        count = min(4096, windows - first)
+        block = frames[first * window:(first + count) * window]
+        if block.dtype != np.float32 or block.shape[1] > 1:
+            block = to_whisper_input(block, WHISPER_RATE)  # Normalization and downmix only
+        levels = np.sqrt(np.mean(np.square(block.reshape(count, window)), axis=1))
+
+        for i, level in enumerate(levels):
+            end = (first + i + 1) * window
+            if level >= energy_threshold:
+                silence_run = 0
+                if start is None:
+                    speech_run += window
+                    if speech_run >= ms(min_speech_ms):
+                        start = max(last_end, end - speech_run - ms(pre_roll_ms))
+                elif end - start >= ms(max_utterance_ms):
+                    segments.append((start, end))
+                    start = last_end = end
+            else:
+                speech_run = 0
+                if start is not None:
+                    silence_run += window
+                    if silence_run >= ms(hangover_ms):
+                        if end - start >= ms(min_utterance_ms):
+                            segments.append((start, end))
+                        start, last_end, silence_run = None, end, 0
+
+    if start is not None and windows * window - start >= ms(min_utterance_ms):
+        segments.append((start, windows * window))
+    return segments
+
+
+def segment_wav(path: str, threads: int = 0, region_seconds: int = 300) -> List[Tuple[int, int]]:
+    """
+    Split a WAV file into utterances.
+
+    Uses the native VAD over parallel regions when the C++ extension is
+    available, and energy_segments() otherwise.
+
+    Returns:
+        list: (start_frame, end_frame) per utterance, in order
+    """
+    if HAS_NATIVE_SEGMENTER:
+        config = FileSegmenterConfig()
+        config.threads = threads
+        config.region_seconds = region_seconds
+        return segment_wav_file(path, config)[0]
+    frames, rate = map_wav(path)
+    return energy_segments(frames, rate)
+
+
+class _StealingQueues:
+    """Per-worker job queues; owners take from the front, thieves from the back."""
+
+    def __init__(self, workers: int):
+        self._queues: List[Deque[int]] = [deque() for _ in range(workers)]
+        self._locks = [threading.Lock() for _ in range(workers)]
+        self.steals = 0
+
+    def push(self, worker: int, job: int) -> None:
+        self._queues[worker].append(job)
+
+    def pop(self, worker: int, count: int) -> List[int]:
+        """Take up to count jobs, stealing half of the fullest queue if ours is empty."""
+        with self._locks[worker]:
+            own = self._queues[worker]
+            if own:
+                return [own.popleft() for _ in range(min(count, len(own)))]
+
+        victim = max(range(len(self._queues)), key=lambda i: len(self._queues[i]))
+        with self._locks[victim]:
+            jobs = self._queues[victim]
+            taken = [jobs.pop() for _ in range(min(count, (len(jobs) + 1) // 2))]
+        if taken:
+            with self._locks[worker]:
+                self.steals += 1
+        return taken
+
+
+class FileTranscriber:
+    """Transcribes recorded files with parallel segmentation and work-stealing decode."""
+
+    def __init__(self, decode_batch: DecodeBatch, workers: int = 2, batch_size: int = 8,
+                 vad_threads: int = 0, region_seconds: int = 300):
+        """
+        Initialize the transcriber.
+
+        Args:
+            decode_batch: Decodes a list of 16 kHz mono float32 utterances;
+                called from several workers at once
+            workers: Worker threads; each loads and resamples its own
+                utterances, so decoding never waits for the disk
+            batch_size: Utterances per decode_batch() call
+            vad_threads: Threads for native segmentation (0 = one per core)
+            region_seconds: Audio per native segmentation task
+        """
+        self._decode_batch = decode_batch
+        self.workers = max(1, workers)
+        self.batch_size = max(1, batch_size)
+        self.vad_threads = vad_threads
+        self.region_seconds = region_seconds
+        self.last_stats: Dict[str, Any] = {}
+
+    def transcribe(self, path: str,
+                   progress: Optional[Callable[[int, int], None]] = None) -> List[Dict[str, Any]]:
+        """
+        Transcribe a WAV file.
+
+        Args:
+            path: WAV file to transcribe
+            progress: Called with (decoded, total) utterances after each batch
+
+        Returns:
+            list: Dicts with start and end (seconds), text and confidence,
+            in file order; utterances decoded to empty text are left out
+        """
+        started = time.monotonic()
+        frames, rate = map_wav(path)
+        segments = segment_wav(path, self.vad_threads, self.region_seconds)
+        results = self.transcribe_segments(
+            segments, lambda start, end: to_whisper_input(frames[start:end], rate), rate, progress)
+        elapsed = time.monotonic() - started
+        self.last_stats['elapsed_seconds'] = elapsed
+        self.last_stats['audio_seconds'] = len(frames) / rate
+        self.last_stats['realtime_factor'] = len(frames) / rate / elapsed if elapsed > 0 else 0.0
+        return results
+
+    def transcribe_segments(self, segments: Sequence[Tuple[int, int]],
+                            load: Callable[[int, int], Any], sample_rate: int,
+                            progress: Optional[Callable[[int, int], None]] = None
+                            ) -> List[Dict[str, Any]]:
+        """
+        Decode already segmented audio.
+
+        Args:
+            segments: (start_frame, end_frame) per utterance, in order
+            load: Returns the decoder input for a frame range
+            sample_rate: Rate of the frame indices
+            progress: Called with (decoded, total) utterances after each batch
+
+        Returns:
+            list: As transcribe()
+        """
+        # Longest first, dealt round-robin, so what is left to steal is short
+        order = sorted(range(len(segments)), key=lambda i: segments[i][0] - segments[i][1])
+        workers = max(1, min(self.workers, len(segments)))
+        queues = _StealingQueues(workers)
+        for position, job in enumerate(order):
+            queues.push(position % workers, job)
+
+        decoded: List[Optional[Tuple[str, float]]] = [None] * len(segments)
+        state = {'done': 0, 'failed': 0}
+        lock = threading.Lock()
+
+        def run(worker: int) -> None:
+            while True:
+                batch = queues.pop(worker, self.batch_size)
+                if not batch:
+                    return
+                try:
+                    outputs = self._decode_batch([load(*segments[job]) for job in batch])
+                except Exception as e:
+                    logging.error(f"Failed to decode {len(batch)} utterances: {e}")
+                    outputs = [None] * len(batch)
+                for job, output in zip(batch, outputs):
+                    decoded[job] = output
+                with lock:
+                    state['done'] += len(batch)
+                    state['failed'] += outputs.count(None)
+                    if progress:
+                        progress(state['done'], len(segments))
+
+        threads = [threading.Thread(target=run, args=(i,), daemon=True) for i in range(1, workers)]
+        for thread in threads:
+            thread.start()
+        run(0)
+        for thread in threads:
+            thread.join()
+
+        self.last_stats = {'utterances': len(segments), 'failed': state['failed'],
+                           'steals': queues.steals}
+        return [{'start': start / sample_rate, 'end': end / sample_rate,
+                 'text': output[0], 'confidence': output[1]}
+                for (start, end), output in zip(segments, decoded) if output and output[0]]
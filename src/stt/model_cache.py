@@ -0,0 +1,244 @@
+"""
+Process-wide cache of resident Whisper models.
+
+Loading a model costs seconds, so models released by WhisperSTT stay
+resident here until the memory budget needs their space. Switching back
+to a recently used model (e.g. between small and medium) is then a
+dictionary lookup. Models still in use are never evicted.
+"""
+
+import gc
+import os
+import threading
+from collections import OrderedDict
+from typing import Any, Callable, Dict, Hashable, List, Optional
+
+# Approximate parameter counts, used when a model's size cannot be measured
+_MODEL_PARAMS = {
+    "tiny": 39e6,
+    "base": 74e6,
+    "small": 244e6,
+    "medium": 769e6,
+    "large": 1550e6,
+    "turbo": 809e6,
+}
+
+_BYTES_PER_PARAM = {
+    "float32": 4,
+    "float16": 2,
+    "bfloat16": 2,
+    "int8_float32": 1,
+    "int8_float16": 1,
+    "int8_bfloat16": 1,
+    "int8": 1,
+}
+
+
+def estimate_model_bytes(model_size: str, compute_type: str = "float32") -> int:
+    """
+    Estimate the resident size of a Whisper model.
+
+    Args:
+        model_size: Model name ('tiny' ... 'large-v3', 'turbo')
+        compute_type: Weight type ('float32', 'float16', 'int8', ...)
+
+    Returns:
+        int: Approximate bytes of weights
+    """
+    base = model_size.split(".")[0].split("-")[0]
+    params = _MODEL_PARAMS.get(base, _MODEL_PARAMS["small"])
+    return int(params * _BYTES_PER_PARAM.get(compute_type, 4))
+
+
+class _Entry:
+    __slots__ = ("model", "size", "users", "on_free")
+
+    def __init__(self, model: Any, size: int, on_free: Optional[Callable[[], None]]):
+        self.model = model
+        self.size = size
+        self.users = 0
+        self.on_free = on_free
+
+
+class ModelCache:
+    """
+    LRU cache of loaded models with a memory budget.
+
+    acquire() returns a resident model or loads it; release() hands it
+    back without freeing it. When a load would exceed the budget, the
+    least recently used models nobody holds are evicted first. A model
+    larger than the whole budget is still loaded, it just evicts
+    everything idle.
+    """
+
+    def __init__(self, memory_budget: int = 4 << 30):
+        """
+        Initialize the cache.
+
+        Args:
+            memory_budget: Bytes of idle and in-use models to keep resident (0 = keep none idle)
+        """
+        self.memory_budget = memory_budget
+        self._entries: "OrderedDict[Hashable, _Entry]" = OrderedDict()
+        self._loading: Dict[Hashable, threading.Event] = {}
+        self._lock = threading.Lock()
+        self._stats = {"hits": 0, "misses": 0, "evictions": 0}
+
+    def acquire(self, key: Hashable, loader: Callable[[], Any], size: int,
+                on_free: Optional[Callable[[], None]] = None) -> Any:
+        """
+        Get a model, loading it if it is not resident.
+
+        Concurrent acquires of the same key share one load.
+
+        Args:
+            key: Identifies the model (backend, name, device, weight type)
+            loader: Loads the model; if it raises, the exception propagates and
+                a concurrent caller waiting for the same key tries again
+            size: Bytes the model occupies (see estimate_model_bytes())
+            on_free: Called after the evicted model was collected, e.g. to empty the CUDA cache
+
+        Returns:
+            The model; pass the key to release() when done with it
+        """
+        while True:
+            with self._lock:
+                entry = self._entries.get(key)
+                if entry is not None:
+                    entry.users += 1
+                    self._entries.move_to_end(key)
+                    self._stats["hits"] += 1
+                    return entry.model
+                loading = self._loading.get(key)
+                if loading is None:
+                    self._loading[key] = threading.Event()
+                    self._stats["misses"] += 1
+                    evicted = self._make_room(size)
+                    break
+            loading.wait()  # Another thread is loading this model
+
+        self._finalize(evicted)
+        try:
+            model = loader()
+        except BaseException:
+            with self._lock:
+                self._loading.pop(key).set()
+            raise
+
+        with self._lock:
+            entry = _Entry(model, size, on_free)
+            entry.users = 1
+            self._entries[key] = entry
+            self._loading.pop(key).set()
+        return model
+
+    def release(self, key: Hashable) -> None:
+        """
+        Return a model obtained from acquire(); it stays resident while it fits the budget.
+
+        Args:
+            key: Key passed to acquire()
+        """
+        with self._lock:
+            entry = self._entries.get(key)
+            if entry is None or entry.users == 0:
+                return
+            entry.users -= 1
+            evicted = self._make_room(0)
+        self._finalize(evicted)
+
+    def evict(self, key: Hashable) -> bool:
+        """
+        Free an idle model now.
+
+        Returns:
+            bool: False if the model is not resident or still in use
+        """
+        with self._lock:
+            entry = self._entries.get(key)
+            if entry is None or entry.users:
+                return False
+            del self._entries[key]
+            self._stats["evictions"] += 1
+        self._finalize([entry])
+        return True
+
+    def clear(self) -> None:
+        """Free every idle model."""
+        with self._lock:
+            evicted = [e for e in self._entries.values() if not e.users]
+            for key in [k for k, e in self._entries.items() if not e.users]:
+                del self._entries[key]
+            self._stats["evictions"] += len(evicted)
+        self._finalize(evicted)
+
+    def _make_room(self, incoming: int) -> List[_Entry]:
+        """Unlink least recently used idle models until incoming bytes fit (lock held)."""
+        evicted = []
+        used = sum(e.size for e in self._entries.values())
+        for key in list(self._entries):
+            if used + incoming <= self.memory_budget:
+                break
+            entry = self._entries[key]
+            if entry.users:
+                continue
+            del self._entries[key]
+            used -= entry.size
+            evicted.append(entry)
+        self._stats["evictions"] += len(evicted)
+        return evicted
+
+    @staticmethod
+    def _finalize(evicted: List[_Entry]) -> None:
+        """Drop evicted models outside the lock (freeing them can take a while)."""
+        if not evicted:
+            return
+        callbacks = [e.on_free for e in evicted if e.on_free]
+        for entry in evicted:
+            entry.model = None
+        evicted.clear()
+        gc.collect()
+        for on_free in callbacks:
+            try:
+                on_free()
+            except Exception as e:
+                print(f"Error freeing cached model: {e}")
+
+    def resident(self) -> List[Hashable]:
+        """Keys of resident models, least recently used first."""
+        with self._lock:
+            return list(self._entries)
+
+    def get_stats(self) -> Dict[str, Any]:
+        """
+        Get cache counters.
+
+        Returns:
+            dict: hits, misses, evictions, resident (models), in_use and
+            resident_bytes
+        """
+        with self._lock:
+            stats = dict(self._stats)
+            stats["resident"] = len(self._entries)
+            stats["in_use"] = sum(1 for e in self._entries.values() if e.users)
+            stats["resident_bytes"] = sum(e.size for e in self._entries.values())
+        return stats
+
+
+_default_cache: Optional[ModelCache] = None
+_default_lock = threading.Lock()
+
+
+def get_model_cache() -> ModelCache:
+    """
+    Get the process-wide cache shared by WhisperSTT instances.
+
+    The budget defaults to 4 GiB and can be set with the
+    KOELINGO_MODEL_CACHE_MB environment variable.
+    """
+    global _default_cache
+    with _default_lock:
+        if _default_cache is None:
+            budget_mb = int(os.environ.get("KOELINGO_MODEL_CACHE_MB", "4096"))
+            _default_cache = ModelCache(memory_budget=budget_mb << 20)
+        return _default_cache
@@ -0,0 +1,184 @@
+"""
+Asynchronous host-to-device staging of utterances for GPU inference.
+
+The C++ capture can hand utterances over as float32 arrays in reusable,
+page-aligned staging buffers (AudioCapture.set_utterance_staging()).
+HostStager registers that memory with CUDA once, so copies out of it run
+as asynchronous DMA, and starts each utterance's copy on its own stream
+as soon as the utterance arrives. The inference thread only waits on the
+copy's event, so the transfer overlaps the decode in flight.
+
+Arrays outside registered memory (e.g. features computed in Python) are
+first copied into one of a few pinned bounce buffers, then uploaded the
+same way.
+"""
+
+import threading
+from typing import Any, List, Optional, Tuple
+
+import numpy as np
+
+try:
+    import torch
+    TORCH_CUDA_AVAILABLE = torch.cuda.is_available()
+except ImportError:
+    TORCH_CUDA_AVAILABLE = False
+
+
+class StagedTensor:
+    """An array on its way to the device."""
+
+    __slots__ = ('tensor', 'event', 'samples')
+
+    def __init__(self, tensor: Any, event: Any, samples: int):
+        self.tensor = tensor
+        self.event = event
+        self.samples = samples  # Audio samples the tensor was made from
+
+    def __len__(self) -> int:
+        return self.samples
+
+    def wait(self) -> Any:
+        """
+        Make the current stream wait for the copy.
+
+        Returns:
+            torch.Tensor: The device tensor, safe to use on the current stream
+        """
+        stream = torch.cuda.current_stream(self.tensor.device)
+        stream.wait_event(self.event)
+        # The tensor was allocated on the copy stream
+        self.tensor.record_stream(stream)
+        return self.tensor
+
+
+class HostStager:
+    """Uploads arrays to a CUDA device on a dedicated copy stream."""
+
+    def __init__(self, device: str = "cuda", bounce_buffers: int = 4):
+        """
+        Initialize the stager.
+
+        Args:
+            device: CUDA device to upload to
+            bounce_buffers: Pinned buffers kept for arrays outside registered memory
+        """
+        if not TORCH_CUDA_AVAILABLE:
+            raise RuntimeError("Pinned staging needs PyTorch with CUDA")
+        self.device = torch.device(device)
+        self._stream = torch.cuda.Stream(self.device)
+        self._registered: List[Tuple[int, int]] = []
+        self._free: List[Any] = []  # Idle bounce buffers
+        self._max_bounce = bounce_buffers
+        # Host memory of uploads still in flight: (event, tensor, is a bounce buffer)
+        self._in_flight: List[Tuple[Any, Any, bool]] = []
+        self._lock = threading.Lock()
+        self._stats = {'uploads': 0, 'direct': 0, 'bounced': 0}
+
+    def register(self, address: int, nbytes: int) -> bool:
+        """
+        Pin host memory for direct asynchronous copies.
+
+        Registering the same region again is a no-op.
+
+        Args:
+            address: Start of the region, e.g. from AudioCapture.get_staging_arena()
+            nbytes: Size of the region
+
+        Returns:
+            bool: False if CUDA refused to register it
+        """
+        with self._lock:
+            if (address, nbytes) in self._registered:
+                return True
+            try:
+                torch.cuda.check_error(torch.cuda.cudart().cudaHostRegister(address, nbytes, 0))
+            except Exception as e:
+                print(f"Could not pin staging memory: {e}")
+                return False
+            self._registered.append((address, nbytes))
+            return True
+
+    def close(self) -> None:
+        """Wait for pending copies and unregister pinned memory."""
+        self._stream.synchronize()
+        with self._lock:
+            self._in_flight.clear()
+            for address, _ in self._registered:
+                torch.cuda.cudart().cudaHostUnregister(address)
+            self._registered.clear()
+
+    def upload(self, array: np.ndarray, samples: Optional[int] = None) -> StagedTensor:
+        """
+        Start copying a float32 array to the device.
+
+        The array is kept alive until its copy completes, which for a
+        staging buffer also keeps it out of the capture's pool until then.
+
+        Args:
+            array: Contiguous float32 array
+            samples: Audio samples the array represents (default: its size)
+
+        Returns:
+            StagedTensor: The device tensor and the event marking the copy's end
+        """
+        array = np.ascontiguousarray(array, dtype=np.float32)
+        with self._lock:
+            self._retire()
+            direct = self._is_registered(array)
+            if direct:
+                host = keep = torch.from_numpy(array)
+            else:
+                keep = self._bounce(array.size)
+                host = keep[:array.size].view(array.shape)
+                host.copy_(torch.from_numpy(array))
+
+            with torch.cuda.stream(self._stream):
+                tensor = host.to(self.device, non_blocking=True)
+                event = torch.cuda.Event()
+                event.record(self._stream)
+
+            # Bounce buffers go back to the free list, staging arrays are just dropped
+            self._in_flight.append((event, keep, not direct))
+            self._stats['uploads'] += 1
+            self._stats['direct' if direct else 'bounced'] += 1
+        return StagedTensor(tensor, event, array.size if samples is None else samples)
+
+    def get_stats(self) -> dict:
+        """
+        Get upload statistics.
+
+        Returns:
+            dict: uploads, direct (from registered memory), bounced and in_flight
+        """
+        with self._lock:
+            self._retire()
+            stats = dict(self._stats)
+            stats['in_flight'] = len(self._in_flight)
+        return stats
+
+    def _is_registered(self, array: np.ndarray) -> bool:
+        """Check whether an array lies inside registered memory; lock held."""
+        start = array.__array_interface__['data'][0]
+        end = start + array.nbytes
+        return any(address <= start and end <= address + nbytes
+                   for address, nbytes in self._registered)
+
+    def _bounce(self, count: int) -> Any:
+        """Take a pinned buffer of at least count floats; lock held."""
+        for i, buffer in enumerate(self._free):
+            if buffer.numel() >= count:
+                return self._free.pop(i)
+        if len(self._free) >= self._max_bounce:
+            self._free.pop(0)  # Too small for this upload; make room for a bigger one
+        return torch.empty(count, dtype=torch.float32, pin_memory=True)
+
+    def _retire(self) -> None:
+        """Let go of host memory whose copies finished; lock held."""
+        pending = []
+        for event, host, bounced in self._in_flight:
+            if not event.query():
+                pending.append((event, host, bounced))
+            elif bounced and len(self._free) < self._max_bounce:
+                self._free.append(host)
+        self._in_flight = pending
@@ -0,0 +1,291 @@
+"""
+Streaming transcription with a local-agreement commit policy.
+
+Instead of transcribing independent blocks, StreamingTranscriber keeps a
+sliding window of recent audio and re-decodes it every min_chunk seconds.
+Words that two consecutive decodes agree on are committed (final); the
+rest is reported as a partial hypothesis. Committed text is passed back
+as the prompt, and audio up to the last committed word is dropped from
+the window, so only the unstable tail is decoded again.
+"""
+
+import threading
+import time
+from typing import Callable, List, Optional, Tuple
+
+import numpy as np
+
+# (start seconds, end seconds, text, probability) in stream time
+Word = Tuple[float, float, str, float]
+
+
+class StreamingResult:
+    """A partial or final hypothesis for a span of the stream."""
+
+    __slots__ = ('text', 'start', 'end', 'is_final', 'confidence', 'words')
+
+    def __init__(self, words: List[Word], is_final: bool):
+        self.words = words
+        self.text = ''.join(w[2] for w in words).strip()
+        self.start = words[0][0] if words else 0.0
+        self.end = words[-1][1] if words else 0.0
+        self.is_final = is_final
+        self.confidence = sum(w[3] for w in words) / len(words) if words else 0.0
+
+    def __repr__(self) -> str:
+        kind = 'final' if self.is_final else 'partial'
+        return f'StreamingResult({kind}, {self.start:.2f}-{self.end:.2f}, {self.text!r})'
+
+
+class HypothesisBuffer:
+    """
+    Local agreement between consecutive decodes (LocalAgreement-2).
+
+    Each decode of the window is compared with the previous one; their
+    longest common word prefix is committed. Words that end before the
+    committed point, or that repeat the tail of the committed text, are
+    ignored so re-decoded audio is never emitted twice.
+    """
+
+    def __init__(self, ngram: int = 5):
+        """
+        Initialize the buffer.
+
+        Args:
+            ngram: Longest run of committed words checked for repetition
+        """
+        self.ngram = ngram
+        self.committed: List[Word] = []
+        self.last_committed_end = 0.0
+        self._previous: List[Word] = []
+        self._current: List[Word] = []
+
+    @staticmethod
+    def _key(word: Word) -> str:
+        return word[2].strip()
+
+    def insert(self, words: List[Word]) -> None:
+        """Add the words of a new decode of the window."""
+        # A little tolerance for timestamps that move between decodes
+        words = [w for w in words if w[0] > self.last_committed_end - 0.1]
+
+        # Drop a prefix that repeats the end of the committed text
+        if words and self.committed and abs(words[0][0] - self.last_committed_end) < 1.0:
+            for n in range(min(self.ngram, len(self.committed), len(words)), 0, -1):
+                tail = [self._key(w) for w in self.committed[-n:]]
+                if tail == [self._key(w) for w in words[:n]]:
+                    words = words[n:]
+                    break
+        self._current = words
+
+    def flush(self) -> List[Word]:
+        """
+        Commit the prefix both decodes agree on.
+
+        Returns:
+            list: Newly committed words
+        """
+        agreed: List[Word] = []
+        for new, old in zip(self._current, self._previous):
+            if self._key(new) != self._key(old):
+                break
+            agreed.append(new)
+
+        if agreed:
+            self.committed.extend(agreed)
+            self.last_committed_end = agreed[-1][1]
+        self._previous = self._current[len(agreed):]
+        self._current = []
+        return agreed
+
+    @property
+    def unstable(self) -> List[Word]:
+        """Words of the latest decode that are not committed yet."""
+        return self._previous
+
+    def commit_unstable(self) -> List[Word]:
+        """
+        Commit the unstable words without waiting for agreement.
+
+        Returns:
+            list: The words that were committed
+        """
+        tail, self._previous = self._previous, []
+        if tail:
+            self.committed.extend(tail)
+            self.last_committed_end = tail[-1][1]
+        return tail
+
+    def trim_committed(self, keep: int) -> None:
+        """Forget all but the last keep committed words (they only feed the prompt)."""
+        if len(self.committed) > keep:
+            self.committed = self.committed[-keep:]
+
+
+class StreamingTranscriber:
+    """
+    Incremental transcription of one audio stream.
+
+    Feed audio with feed() from the capture (e.g. read_new() results); a
+    worker thread decodes the window as audio arrives and calls the
+    callback with StreamingResult objects: a final one for every newly
+    committed span, and a partial one for the current unstable tail.
+    """
+
+    def __init__(self, stt, callback: Callable[[StreamingResult], None],
+                 sample_rate: int = 16000, min_chunk: float = 0.5,
+                 max_window: float = 15.0, trim_after: float = 4.0,
+                 prompt_chars: int = 200):
+        """
+        Initialize the transcriber.
+
+        Args:
+            stt: Model wrapper with transcribe_words(audio, prompt), e.g. WhisperSTT
+            callback: Receives partial and final results
+            sample_rate: Sample rate of the fed audio
+            min_chunk: Seconds of new audio that trigger a decode (sets partial latency)
+            max_window: Longest window kept even without a commit
+            trim_after: Window length beyond which committed audio is dropped
+            prompt_chars: Characters of committed text passed as the prompt
+        """
+        self.stt = stt
+        self.callback = callback
+        self.sample_rate = sample_rate
+        self.min_chunk = min_chunk
+        self.max_window = max_window
+        self.trim_after = trim_after
+        self.prompt_chars = prompt_chars
+
+        self.hypothesis = HypothesisBuffer()
+        self._window = np.zeros(0, dtype=np.float32)
+        self._window_start = 0.0  # Stream time of the first sample in the window
+        self._new_samples = 0
+        self._prompt = ''
+
+        self._lock = threading.Condition()
+        self._thread: Optional[threading.Thread] = None
+        self._active = False
+        self._stats = {'decodes': 0, 'decoded_seconds': 0.0, 'fed_seconds': 0.0,
+                       'last_decode_time': 0.0}
+
+    def feed(self, audio: np.ndarray) -> None:
+        """
+        Append captured audio.
+
+        Args:
+            audio: Mono samples (int16, or float32 in [-1, 1])
+        """
+        if audio.dtype == np.int16:
+            audio = audio.astype(np.float32) / 32768.0
+        with self._lock:
+            self._window = np.concatenate([self._window, audio.astype(np.float32, copy=False)])
+            self._new_samples += len(audio)
+            self._stats['fed_seconds'] += len(audio) / self.sample_rate
+            self._lock.notify_all()
+
+    def start(self) -> None:
+        """Start decoding on a background thread."""
+        if self._active:
+            return
+        self._active = True
+        self._thread = threading.Thread(target=self._run, daemon=True)
+        self._thread.start()
+
+    def stop(self) -> None:
+        """Stop the worker and commit what is left as final."""
+        with self._lock:
+            self._active = False
+            self._lock.notify_all()
+        if self._thread:
+            self._thread.join()
+            self._thread = None
+        self.finish()
+
+    def _run(self) -> None:
+        """Decode whenever min_chunk seconds of new audio have arrived."""
+        needed = int(self.min_chunk * self.sample_rate)
+        while True:
+            with self._lock:
+                self._lock.wait_for(lambda: self._new_samples >= needed or not self._active)
+                if not self._active:
+                    return
+            try:
+                self.process_iter()
+            except Exception as e:
+                print(f"Error in streaming transcription: {e}")
+
+    def process_iter(self) -> None:
+        """Decode the window once and emit the results."""
+        with self._lock:
+            window = self._window
+            window_start = self._window_start
+            self._new_samples = 0
+
+        started = time.monotonic()
+        words = [(window_start + start, window_start + end, text, probability)
+                 for start, end, text, probability in self.stt.transcribe_words(window, self._prompt)]
+        self._stats['decodes'] += 1
+        self._stats['decoded_seconds'] += len(window) / self.sample_rate
+        self._stats['last_decode_time'] = time.monotonic() - started
+
+        self.hypothesis.insert(words)
+        committed = self.hypothesis.flush()
+        if committed:
+            self._prompt = (self._prompt + ''.join(w[2] for w in committed))[-self.prompt_chars:]
+            self.callback(StreamingResult(committed, True))
+        if self.hypothesis.unstable:
+            self.callback(StreamingResult(self.hypothesis.unstable, False))
+
+        self._trim(len(window))
+
+    def _trim(self, decoded_samples: int) -> None:
+        """Drop committed audio so the next decode only covers the unstable tail."""
+        with self._lock:
+            length = len(self._window) / self.sample_rate
+            if length <= self.trim_after:
+                return
+            cut = self.hypothesis.last_committed_end - self._window_start
+            if cut <= 0 and length > self.max_window:
+                # Nothing agreed for a long time: keep only the newest audio
+                cut = length - self.trim_after
+            if cut <= 0:
+                return
+            samples = min(int(cut * self.sample_rate), decoded_samples)
+            self._window = self._window[samples:]
+            self._window_start += samples / self.sample_rate
+            self.hypothesis.trim_committed(self.hypothesis.ngram)
+
+    def finish(self) -> Optional[StreamingResult]:
+        """
+        Commit the unstable tail, e.g. at the end of an utterance or stream.
+
+        Returns:
+            StreamingResult: The final result for the tail, or None if there was none
+        """
+        with self._lock:
+            tail = self.hypothesis.commit_unstable()
+            if tail:
+                self._prompt = (self._prompt + ''.join(w[2] for w in tail))[-self.prompt_chars:]
+
+            # The audio is fully accounted for; start the next span empty
+            self._window_start += len(self._window) / self.sample_rate
+            self._window = np.zeros(0, dtype=np.float32)
+            self._new_samples = 0
+        if not tail:
+            return None
+        result = StreamingResult(tail, True)
+        self.callback(result)
+        return result
+
+    def get_stats(self) -> dict:
+        """
+        Get decode statistics.
+
+        Returns:
+            dict: decodes, decoded_seconds, fed_seconds, last_decode_time and
+            decode_ratio (seconds of audio decoded per second fed)
+        """
+        stats = dict(self._stats)
+        fed = stats['fed_seconds']
+        stats['decode_ratio'] = stats['decoded_seconds'] / fed if fed else 0.0
+        return stats
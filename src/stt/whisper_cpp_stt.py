@@ -0,0 +1,189 @@
+"""
+Native whisper.cpp speech recognition.
+
+WhisperCppSTT wraps the C++ WhisperTranscriber built into the audio
+extension with -DKOELINGO_WITH_WHISPER_CPP=ON. Utterances go from the
+capture's VAD to whisper.cpp entirely in C++; Python only receives the
+finished text, so neither PyTorch nor the GIL sits on the audio path.
+"""
+
+import logging
+from typing import Any, Callable, Dict, List, Optional, Tuple
+
+import numpy as np
+
+try:
+    try:
+        from src.audio.audio_capture_cc import (HAS_WHISPER_CPP, FileTranscriptionConfig,
+                                                WhisperConfig, WhisperTranscriber)
+    except ImportError:
+        from koelingo.audio.audio_capture_cc import (HAS_WHISPER_CPP, FileTranscriptionConfig,
+                                                     WhisperConfig, WhisperTranscriber)
+except ImportError:
+    HAS_WHISPER_CPP = False
+
+
+class WhisperCppSTT:
+    """Speech-to-Text on whisper.cpp, fed directly by C++ audio captures."""
+
+    def __init__(self, model_path: str, language: str = "ja", workers: int = 1,
+                 threads_per_worker: int = 4, beam_size: int = 5, use_gpu: bool = True,
+                 queue_limit: int = 8, cpus: Optional[List[int]] = None):
+        """
+        Load a ggml model.
+
+        Args:
+            model_path: ggml model file (e.g. models/ggml-small.bin)
+            language: The language to recognize, or 'auto'
+            workers: Utterances decoded in parallel
+            threads_per_worker: CPU threads per decode
+            beam_size: Beam width (1 for greedy decoding)
+            use_gpu: Use Metal/CUDA when whisper.cpp was built with them
+            queue_limit: Pending utterances at which the VAD queue stops being drained
+            cpus: CPUs to pin the decode workers to, e.g. to keep them off the
+                capture cores (None for no pinning)
+
+        Raises:
+            RuntimeError: If whisper.cpp support is not built or the model cannot be loaded
+        """
+        if not HAS_WHISPER_CPP:
+            raise RuntimeError("The audio extension was built without whisper.cpp "
+                               "(configure with -DKOELINGO_WITH_WHISPER_CPP=ON)")
+
+        config = WhisperConfig()
+        config.model_path = model_path
+        config.language = language
+        config.workers = workers
+        config.threads_per_worker = threads_per_worker
+        config.beam_size = beam_size
+        config.use_gpu = use_gpu
+        config.queue_limit = queue_limit
+        config.worker_policy.cpus = list(cpus or [])
+
+        self._callback: Optional[Callable[[str, float, int], None]] = None
+        self._transcriber = WhisperTranscriber()
+        self._transcriber.set_callback(self._on_transcript)
+        if not self._transcriber.load(config):
+            raise RuntimeError(f"Failed to load whisper.cpp model: {model_path}")
+        logging.info(f"whisper.cpp loaded ({WhisperTranscriber.system_info()})")
+        result = self._transcriber.worker_policy_result
+        if cpus and not result.pinned:
+            logging.warning(f"Decode workers not pinned: {result.error}")
+
+    @staticmethod
+    def is_available() -> bool:
+        """Check whether the audio extension was built with whisper.cpp."""
+        return HAS_WHISPER_CPP
+
+    def set_callback(self, callback: Optional[Callable[[str, float, int], None]]) -> None:
+        """
+        Set the function receiving transcriptions.
+
+        Args:
+            callback: Called with (text, confidence, stream) on a decode thread
+        """
+        self._callback = callback
+
+    def set_event_bus(self, bus: Optional[Any]) -> None:
+        """
+        Publish partial and final transcripts on a bus.
+
+        Partial transcripts are published as each segment is decoded, so a
+        UI can show text before the utterance is done. Call before attach().
+
+        Args:
+            bus: Bus from koelingo.audio.pybind.create_event_bus(), or None
+        """
+        self._transcriber.set_event_bus(bus)
+
+    def _on_transcript(self, transcript: Any) -> None:
+        """Forward a native transcript to the callback."""
+        callback = self._callback
+        if callback:
+            try:
+                callback(transcript.text, transcript.confidence, transcript.stream)
+            except Exception as e:
+                logging.error(f"Error in transcription callback: {e}")
+
+    def attach(self, capture: Any) -> int:
+        """
+        Transcribe every utterance of a capture.
+
+        Call before start_recording(); the capture needs the C++ implementation.
+
+        Args:
+            capture: AudioCapture wrapper (or an AudioCaptureCpp)
+
+        Returns:
+            int: Stream index passed to the callback, or -1 on failure
+        """
+        if hasattr(capture, 'attach_native_transcriber'):
+            return capture.attach_native_transcriber(self._transcriber)
+        return self._transcriber.attach(capture)
+
+    def detach(self, stream: int) -> None:
+        """Stop transcribing a stream; utterances already queued are still decoded."""
+        self._transcriber.detach(stream)
+
+    def stop(self) -> None:
+        """Detach every stream and finish the queued utterances."""
+        self._transcriber.stop()
+
+    def transcribe_audio(self, audio_data: np.ndarray) -> Tuple[str, float]:
+        """
+        Transcribe audio synchronously.
+
+        Args:
+            audio_data: 16 kHz mono samples (int16, or float32 in [-1, 1])
+
+        Returns:
+            tuple: (text, confidence)
+        """
+        if audio_data.dtype == np.int16:
+            audio_data = audio_data.astype(np.float32) / 32768.0
+        result = self._transcriber.transcribe(audio_data.astype(np.float32, copy=False))
+        return result.text, result.confidence
+
+    def transcribe_file(self, path: str, workers: int = 0, vad_threads: int = 0,
+                        region_seconds: int = 300,
+                        progress: Optional[Callable[[int, int], None]] = None) -> List[Dict[str, Any]]:
+        """
+        Transcribe a recorded WAV file as fast as the hardware allows.
+
+        The file is memory-mapped and split by the VAD in parallel regions;
+        the utterances are decoded longest first by workers that steal from
+        each other, each with its own whisper.cpp state.
+
+        Args:
+            path: WAV file to transcribe
+            workers: Decode workers (0 = as configured in the constructor)
+            vad_threads: Segmentation threads (0 = one per core)
+            region_seconds: Audio per segmentation task
+            progress: Called with (decoded, total) utterances from a decode thread
+
+        Returns:
+            list: Dicts with start and end (seconds), text and confidence, in file order
+
+        Raises:
+            ValueError: If the file cannot be read
+        """
+        config = FileTranscriptionConfig()
+        config.workers = workers
+        config.segmenter.threads = vad_threads
+        config.segmenter.region_seconds = region_seconds
+        result = self._transcriber.transcribe_file(path, config, progress)
+
+        if result.elapsed_seconds > 0:
+            logging.info(f"Transcribed {result.audio_seconds:.0f}s of audio in "
+                         f"{result.elapsed_seconds:.1f}s "
+                         f"({result.audio_seconds / result.elapsed_seconds:.1f}x real time)")
+        if result.failed:
+            logging.warning(f"{result.failed} of {result.utterances} utterances failed to decode")
+        rate = result.sample_rate
+        return [{'start': t.start_frame / rate, 'end': t.end_frame / rate,
+                 'text': t.text, 'confidence': t.confidence} for t in result.transcripts]
+
+    @property
+    def pending(self) -> int:
+        """Utterances waiting for a decode worker."""
+        return self._transcriber.pending
@@ -8,7 +8,12 @@ import threading
 import numpy as np
 import whisper  # This is openai-whisper package
 from typing import Optional, Callable, List, Dict, Any, Tuple
-import queue
+
+from .batch_scheduler import BatchQueue
+from .file_transcriber import FileTranscriber
+from .model_cache import ModelCache, estimate_model_bytes, get_model_cache
+from .pinned_staging import HostStager, StagedTensor
+from .streaming import StreamingResult, StreamingTranscriber
 
 # Try to import CTranslate2 Whisper for better performance
 try:
@@ -23,6 +28,58 @@ except ImportError:
 if not hasattr(whisper, 'load_model'):
     raise ImportError("OpenAI Whisper model not found. Please install with: pip install git+https://github.com/openai/whisper.git")
 
+
+def _load_whisper_mmap(name: str, device: str):
+    """
+    Load an openai-whisper model with memory-mapped weights.
+
+    The checkpoint is mapped instead of read, and the weights are adopted
+    as they are instead of being copied into freshly initialized
+    parameters, so on CPU loading is mostly page faults served from the
+    page cache after the first run. Falls back to whisper.load_model() on
+    PyTorch versions without mmap support.
+
+    Args:
+        name: Model name ('tiny' ... 'large-v3') or checkpoint path
+        device: Device to run inference on
+    """
+    import torch
+    from whisper.model import ModelDimensions, Whisper
+
+    if os.path.isfile(name):
+        path = name
+    elif name in getattr(whisper, "_MODELS", {}):
+        root = os.path.join(os.getenv("XDG_CACHE_HOME", os.path.join(os.path.expanduser("~"), ".cache")),
+                            "whisper")
+        path = whisper._download(whisper._MODELS[name], root, False)
+    else:
+        return whisper.load_model(name, device=device)
+
+    try:
+        checkpoint = torch.load(path, map_location="cpu", mmap=True, weights_only=True)
+        dims = ModelDimensions(**checkpoint["dims"])
+        # Build the modules without allocating weights that are replaced anyway
+        with torch.device("meta"):
+            model = Whisper(dims)
+        model.load_state_dict(checkpoint["model_state_dict"], assign=True)
+
+        # Buffers that are not part of the checkpoint are rebuilt for real
+        mask = torch.empty(dims.n_text_ctx, dims.n_text_ctx).fill_(-np.inf).triu_(1)
+        model.decoder.register_buffer("mask", mask, persistent=False)
+        heads = torch.zeros(dims.n_text_layer, dims.n_text_head, dtype=torch.bool)
+        heads[dims.n_text_layer // 2:] = True
+        model.register_buffer("alignment_heads", heads.to_sparse(), persistent=False)
+        if any(t.is_meta for t in list(model.parameters()) + list(model.buffers())):
+            raise RuntimeError("checkpoint does not cover every tensor")
+    except Exception as e:  # E.g. PyTorch < 2.1 or a legacy (non-zip) checkpoint
+        print(f"Memory-mapped loading unavailable ({e}); loading normally")
+        return whisper.load_model(name, device=device)
+
+    if name in getattr(whisper, "_ALIGNMENT_HEADS", {}):
+        model.set_alignment_heads(whisper._ALIGNMENT_HEADS[name])
+    return model.to(device)
+
+
 class WhisperSTT:
     """Speech-to-Text implementation using Whisper for Japanese recognition."""
 
@@ -33,6 +90,10 @@ class WhisperSTT:
         compute_type: str = "float32",
         language: str = "ja",
         use_ctranslate2: bool = True,
+        max_batch_size: int = 8,
+        latency_budget: float = 2.0,
+        beam_size: int = 5,
+        model_cache: Optional[ModelCache] = None,
     ):
         """
         Initialize the Whisper speech recognition module.
@@ -40,27 +101,46 @@ class WhisperSTT:
         Args:
             model_size: Whisper model size ('tiny', 'base', 'small', 'medium', 'large')
             device: Device to run inference on ('cpu' or 'cuda')
-            compute_type: Computation type ('float32', 'float16', or 'int8')
+            compute_type: Computation type ('float32', 'float16', 'int8' or
+                'int8_float16'); int8 quantized weights need CTranslate2
             language: The language to recognize (default: 'ja' for Japanese)
             use_ctranslate2: Whether to use CTranslate2 optimized implementation if available
+            max_batch_size: Most utterances decoded together in continuous mode
+            latency_budget: Target seconds from process_audio_chunk() to the callback;
+                batches are sized to meet it
+            beam_size: Beam width for decoding
+            model_cache: Cache that keeps released models resident (default: the shared one)
         """
         self.model_size = model_size
         self.device = device
         self.compute_type = compute_type
         self.language = language
         self.use_ctranslate2 = use_ctranslate2 and CTRANSLATE2_AVAILABLE
+        self.beam_size = beam_size
 
         # Flag to track if the model is loaded
         self.is_loaded = False
         self.model = None
         self.ct_model = None  # CTranslate2 model
+        self._model_cache = model_cache or get_model_cache()
+        self._cache_key = None  # Key of the model held from the cache
 
         # Threading resources
         self._processing_thread = None
         self._is_processing = False
         self._continuous_thread = None
         self._continuous_active = False
-        self._audio_queue = queue.Queue()
+        # Utterances from every stream, released in deadline-sized batches
+        self._audio_queue = BatchQueue(max_batch_size=max_batch_size,
+                                       latency_budget=latency_budget)
+
+        # Speculative warm-up on speech onset (see warm_up())
+        self._warm_up_requested = False
+        self._warm_ups = 0
+        self._last_decode_time = 0.0
+
+        # Asynchronous uploads of queued utterances (see set_pinned_staging())
+        self._stager: Optional[HostStager] = None
 
         # Callback for when transcription is ready
         self.transcription_callback = None
@@ -72,58 +152,135 @@ class WhisperSTT:
         """
         Load the Whisper model.
 
+        Models come from the model cache, so loading a model that was used
+        recently (by this or another instance) does not touch the disk.
+
         Returns:
             bool: True if loaded successfully, False otherwise
         """
+        key = self._model_key()
+        if self.is_loaded and key == self._cache_key:
+            return True
         try:
             print(f"Loading Whisper model: {self.model_size} (CTranslate2: {self.use_ctranslate2})")
-            
-            if self.use_ctranslate2:
-                # Use CTranslate2 implementation for better performance
-                self.ct_model = faster_whisper.WhisperModel(
-                    model_size_or_path=self.model_size,
-                    device=self.device,
-                    compute_type=self.compute_type,
-                )
-                self.is_loaded = True
-                print("Whisper model loaded successfully with CTranslate2")
-            else:
-                # Use standard Whisper implementation
-                self.model = whisper.load_model(self.model_size, device=self.device)
-                self.is_loaded = True
-                print("Whisper model loaded successfully")
-                
-            return True
+            model = self._model_cache.acquire(
+                key, self._load_weights,
+                estimate_model_bytes(self.model_size, self.compute_type if self.use_ctranslate2 else "float32"),
+                on_free=self._empty_device_cache if self.device == "cuda" else None)
         except Exception as e:
             print(f"Error loading Whisper model: {e}")
-            self.is_loaded = False
             return False
 
-    def unload_model(self) -> None:
-        """Unload the model to free memory."""
+        # Swap only once the new model is ready so a switch never leaves a gap
+        previous = self._cache_key
+        if self.use_ctranslate2:
+            self.ct_model, self.model = model, None
+        else:
+            self.model, self.ct_model = model, None
+        self._cache_key = key
+        self.is_loaded = True
+        if previous is not None:
+            self._model_cache.release(previous)
+        print("Whisper model loaded successfully" + (" with CTranslate2" if self.use_ctranslate2 else ""))
+        return True
+
+    def switch_model(self, model_size: str, compute_type: Optional[str] = None) -> bool:
+        """
+        Change the model, keeping the current one resident in the cache.
+
+        Continuous processing keeps running and uses the new model from the
+        next batch on.
+
+        Args:
+            model_size: Whisper model size
+            compute_type: New computation type (default: unchanged)
+
+        Returns:
+            bool: False if the model cannot be loaded; the current one stays active
+        """
+        previous = (self.model_size, self.compute_type)
+        self.model_size = model_size
+        self.compute_type = compute_type or self.compute_type
+        if self.load_model():
+            return True
+        self.model_size, self.compute_type = previous
+        return False
+
+    def preload_model(self, model_size: str, compute_type: Optional[str] = None) -> threading.Thread:
+        """
+        Load a model into the cache in the background, e.g. the one the user
+        is likely to switch to, so that switch_model() returns at once.
+
+        Args:
+            model_size: Whisper model size
+            compute_type: Computation type (default: this instance's)
+
+        Returns:
+            threading.Thread: The loading thread
+        """
+        compute_type = compute_type or self.compute_type
+
+        def load():
+            key = self._model_key(model_size, compute_type)
+            try:
+                self._model_cache.acquire(
+                    key, lambda: self._load_weights(model_size, compute_type),
+                    estimate_model_bytes(model_size, compute_type if self.use_ctranslate2 else "float32"),
+                    on_free=self._empty_device_cache if self.device == "cuda" else None)
+                self._model_cache.release(key)
+            except Exception as e:
+                print(f"Error preloading Whisper model {model_size}: {e}")
+
+        thread = threading.Thread(target=load, daemon=True)
+        thread.start()
+        return thread
+
+    def _model_key(self, model_size: Optional[str] = None,
+                   compute_type: Optional[str] = None) -> Tuple[str, str, str, str]:
+        """Cache key of a model for this instance's backend and device."""
+        backend = "ctranslate2" if self.use_ctranslate2 else "whisper"
+        compute_type = (compute_type or self.compute_type) if self.use_ctranslate2 else "float32"
+        return (backend, model_size or self.model_size, self.device, compute_type)
+
+    def _load_weights(self, model_size: Optional[str] = None, compute_type: Optional[str] = None) -> Any:
+        """Load a model from disk (called by the cache on a miss)."""
+        model_size = model_size or self.model_size
+        if self.use_ctranslate2:
+            options = dict(model_size_or_path=model_size, device=self.device,
+                           compute_type=compute_type or self.compute_type)
+            try:
+                # Skip the Hugging Face Hub round trip when the model is already downloaded
+                return faster_whisper.WhisperModel(local_files_only=True, **options)
+            except Exception:
+                return faster_whisper.WhisperModel(**options)
+        return _load_whisper_mmap(model_size, self.device)
+
+    @staticmethod
+    def _empty_device_cache() -> None:
+        """Return freed CUDA memory to the device after a model is evicted."""
+        import torch
+        torch.cuda.empty_cache()
+
+    def unload_model(self, evict: bool = False) -> None:
+        """
+        Release the model.
+
+        The model stays resident in the model cache, so loading it again is
+        instant, until the cache needs the memory for another model.
+
+        Args:
+            evict: Free the model now instead of keeping it cached
+        """
         self.stop_continuous_processing()
-        
-        if self.model:
-            # In PyTorch-based models like Whisper, we can help free memory by
-            # explicitly removing references and running garbage collection
-            import gc
-
-            del self.model
-            self.model = None
-            gc.collect()
-
-            if self.device == "cuda":
-                import torch
-                torch.cuda.empty_cache()
-        
-        if self.ct_model:
-            del self.ct_model
-            self.ct_model = None
-            
-            import gc
-            gc.collect()
 
+        self.model = None
+        self.ct_model = None
         self.is_loaded = False
+        if self._cache_key is not None:
+            key, self._cache_key = self._cache_key, None
+            self._model_cache.release(key)
+            if evict:
+                self._model_cache.evict(key)
 
     def transcribe_audio(
         self,
@@ -148,6 +305,41 @@ class WhisperSTT:
         self._processing_thread.daemon = True
         self._processing_thread.start()
 
+    def transcribe_features(
+        self,
+        log_mel: np.ndarray,
+        callback: Optional[Callable[[str, float], None]] = None
+    ) -> bool:
+        """
+        Transcribe precomputed log-mel features asynchronously.
+
+        log_mel is the raw log10 mel spectrogram as produced by the C++
+        capture (AudioCapture.get_mel()), so Whisper does not have to
+        recompute the STFT of audio that was already analysed. Only the
+        standard Whisper backend accepts features; faster-whisper computes
+        its own from audio.
+
+        Args:
+            log_mel: Array of shape (n_mels, frames) with log10 mel energies
+            callback: Callback function to receive transcription results and confidence
+
+        Returns:
+            bool: True if transcription was started, False if the backend needs audio
+        """
+        if self.use_ctranslate2:
+            return False
+
+        if callback:
+            self.transcription_callback = callback
+
+        self._processing_thread = threading.Thread(
+            target=self._process_features,
+            args=(log_mel,)
+        )
+        self._processing_thread.daemon = True
+        self._processing_thread.start()
+        return True
+
     def start_continuous_processing(
         self,
         callback: Optional[Callable[[str, float], None]] = None
@@ -168,12 +360,8 @@ class WhisperSTT:
             self.transcription_callback = callback
             
         # Clear any existing audio queue
-        while not self._audio_queue.empty():
-            try:
-                self._audio_queue.get_nowait()
-            except queue.Empty:
-                break
-                
+        self._audio_queue.clear()
+
         self._continuous_active = True
         
         # Start continuous processing thread
@@ -188,101 +376,460 @@ class WhisperSTT:
     def stop_continuous_processing(self) -> None:
         """Stop continuous audio processing."""
         self._continuous_active = False
-        
+        self._audio_queue.close()
+
         if self._continuous_thread and self._continuous_thread.is_alive():
             # Wait for thread to finish
             self._continuous_thread.join(timeout=2.0)
             
-    def process_audio_chunk(self, audio_chunk: np.ndarray) -> None:
+    def process_audio_chunk(
+        self,
+        audio_chunk: np.ndarray,
+        stream_id: Any = None,
+        callback: Optional[Callable[[str, float], None]] = None,
+        timeout: Optional[float] = None
+    ) -> bool:
         """
         Process an audio chunk in continuous mode.
-        
+
+        Chunks from several capture streams can share one model; they are
+        batched together and each result goes to the callback given here
+        (or the one from start_continuous_processing()). While the queue is
+        full this blocks, which holds back the capture's utterance delivery
+        so overload surfaces as dropped utterances rather than growing delay.
+
         Args:
             audio_chunk: Audio data chunk as numpy array
+            stream_id: Identifies the capture stream in get_batch_stats()
+            callback: Callback for this chunk's transcription and confidence
+            timeout: Seconds to wait for room in a full queue (None waits as long as needed)
+
+        Returns:
+            bool: False if the chunk was not queued
         """
         if not self._continuous_active:
             self.start_continuous_processing()
-            
+
+        if self._stager is not None:
+            audio_chunk = self._stage(audio_chunk)
+
         # Add to processing queue
-        self._audio_queue.put(audio_chunk)
-        
+        return self._audio_queue.put(audio_chunk, stream_id, callback, timeout)
+
+    def _stage(self, audio_chunk: np.ndarray) -> Any:
+        """
+        Start uploading an utterance for the inference thread.
+
+        Returns:
+            StagedTensor with the audio (PyTorch) or padded log-mel features
+            (CTranslate2), or the audio itself if it cannot be staged
+        """
+        try:
+            audio_chunk = self._prepare_audio(audio_chunk)
+            if not (self.use_ctranslate2 and self.ct_model):
+                return self._stager.upload(audio_chunk)
+            # Longer utterances need faster-whisper's sliding window, which takes audio
+            if len(audio_chunk) > whisper.audio.N_SAMPLES:
+                return audio_chunk
+            return self._stager.upload(self._ctranslate2_features(audio_chunk), len(audio_chunk))
+        except Exception as e:
+            print(f"Error staging audio chunk: {e}")
+            return audio_chunk
+
+    def set_pinned_staging(self, enabled: bool = True) -> bool:
+        """
+        Upload continuous-mode utterances to the GPU as soon as they are queued.
+
+        process_audio_chunk() then starts each utterance's host-to-device
+        copy on a separate CUDA stream, so it overlaps the decode in flight
+        and the inference thread finds the data already on the device. The
+        PyTorch backend uploads the audio; CTranslate2 computes its log-mel
+        features first (off the inference thread) and uploads those.
+        Register the capture's staging buffers with register_host_memory()
+        so uploads copy straight out of them.
+
+        Args:
+            enabled: True to stage uploads
+
+        Returns:
+            bool: False if the model does not run on CUDA
+        """
+        if not enabled:
+            if self._stager:
+                self._stager.close()
+            self._stager = None
+            return True
+        if not self.device.startswith("cuda"):
+            return False
+        if self._stager is None:
+            try:
+                self._stager = HostStager(self.device)
+            except RuntimeError as e:
+                print(f"Pinned staging unavailable: {e}")
+                return False
+        return True
+
+    def register_host_memory(self, address: int, nbytes: int) -> bool:
+        """
+        Pin memory that queued audio lives in, e.g. the capture's staging buffers.
+
+        Args:
+            address: Start of the region (AudioCapture.get_staging_arena())
+            nbytes: Size of the region
+
+        Returns:
+            bool: False if pinned staging is off or CUDA refused the region
+        """
+        return self._stager is not None and self._stager.register(address, nbytes)
+
+    def get_batch_stats(self) -> Dict[str, Any]:
+        """
+        Get continuous-mode batching statistics.
+
+        Returns:
+            dict: batches, utterances, mean_batch_size, deadline_misses
+            (results later than latency_budget), rejected, pending and
+            warm_ups (silent decodes run by warm_up())
+        """
+        stats = self._audio_queue.get_stats()
+        stats['warm_ups'] = self._warm_ups
+        return stats
+
+    def warm_up(self, idle_seconds: float = 2.0) -> None:
+        """
+        Prepare the model for an utterance that is about to arrive.
+
+        Meant for the capture's speech_onset_callback: the onset arrives
+        while the user is still talking, so a short silent decode can run
+        first and the real utterance does not pay for cold GPU kernels and
+        allocator pools. In continuous mode the decode runs on the
+        inference thread between batches; otherwise on a background thread.
+
+        Args:
+            idle_seconds: Skip the warm-up if the model decoded more recently than this
+        """
+        if not self.is_loaded or time.monotonic() - self._last_decode_time < idle_seconds:
+            return
+        if self._continuous_active:
+            self._warm_up_requested = True
+            self._audio_queue.interrupt()
+            return
+        thread = threading.Thread(target=self._run_warm_up, daemon=True)
+        thread.start()
+
+    def _run_warm_up(self) -> None:
+        """Decode half a second of silence unless utterances are waiting."""
+        if not self.is_loaded or not self._audio_queue.empty():
+            return
+        try:
+            self._transcribe_single(np.zeros(8000, dtype=np.float32))
+            self._last_decode_time = time.monotonic()
+            self._warm_ups += 1
+        except Exception as e:
+            print(f"Error warming up Whisper model: {e}")
+
+    def start_streaming(
+        self,
+        callback: Callable[[StreamingResult], None],
+        min_chunk: float = 0.5,
+        sample_rate: int = 16000
+    ) -> StreamingTranscriber:
+        """
+        Start incremental transcription of one stream.
+
+        Feed captured audio to the returned transcriber (e.g. from
+        AudioCapture.read_new()); the callback receives partial results
+        for the unstable tail about every min_chunk seconds and final
+        results once consecutive decodes agree. Call stop() on it to
+        commit the rest.
+
+        Args:
+            callback: Receives StreamingResult objects with text, start, end and is_final
+            min_chunk: Seconds of new audio between decodes
+            sample_rate: Sample rate of the fed audio
+
+        Returns:
+            StreamingTranscriber: The running transcriber
+        """
+        transcriber = StreamingTranscriber(self, callback, sample_rate=sample_rate,
+                                           min_chunk=min_chunk)
+        transcriber.start()
+        return transcriber
+
+    def transcribe_words(self, audio_data: np.ndarray, prompt: str = "") -> List[Tuple[float, float, str, float]]:
+        """
+        Transcribe audio synchronously with word timestamps.
+
+        Args:
+            audio_data: Audio data as numpy array (16kHz, mono)
+            prompt: Preceding text to condition the decoder on
+
+        Returns:
+            list: (start, end, word, probability) tuples, times in seconds from
+            the start of audio_data
+        """
+        audio_data = self._prepare_audio(audio_data)
+        if len(audio_data) == 0:
+            return []
+
+        if self.use_ctranslate2 and self.ct_model:
+            segments, info = self.ct_model.transcribe(
+                audio_data,
+                language=self.language,
+                task="transcribe",
+                beam_size=self.beam_size,
+                initial_prompt=prompt or None,
+                word_timestamps=True,
+                condition_on_previous_text=False
+            )
+            return [(w.start, w.end, w.word, w.probability)
+                    for segment in segments for w in (segment.words or [])]
+
+        result = self.model.transcribe(
+            audio_data,
+            language=self.language,
+            task="transcribe",
+            initial_prompt=prompt or None,
+            word_timestamps=True,
+            condition_on_previous_text=False,
+            fp16=self.device == "cuda"
+        )
+        return [(w["start"], w["end"], w["word"], w.get("probability", 1.0))
+                for segment in result["segments"] for w in segment.get("words", [])]
+
+    def transcribe_file(self, path: str, workers: int = 2, batch_size: int = 8,
+                        progress: Optional[Callable[[int, int], None]] = None) -> List[Dict[str, Any]]:
+        """
+        Transcribe a recorded WAV file as fast as the hardware allows.
+
+        The file is memory-mapped and split into utterances in parallel;
+        workers load and resample their own utterances and hand the model
+        batch_size of them per padded call. PyTorch decodes one batch at a
+        time (its kv-cache hooks live on the shared model), so extra workers
+        there only overlap audio preparation with decoding.
+
+        Args:
+            path: WAV file to transcribe
+            workers: Worker threads
+            batch_size: Utterances per model call
+            progress: Called with (decoded, total) utterances from a worker thread
+
+        Returns:
+            list: Dicts with start and end (seconds), text and confidence, in file order
+        """
+        if not self.model and not self.ct_model and not self.load_model():
+            return []
+
+        decode = self._transcribe_batch
+        if not (self.use_ctranslate2 and self.ct_model):
+            lock = threading.Lock()
+
+            def decode(chunks: List[np.ndarray]) -> List[Tuple[str, float]]:
+                with lock:
+                    return self._transcribe_batch(chunks)
+
+        transcriber = FileTranscriber(decode, workers=workers, batch_size=batch_size)
+        results = transcriber.transcribe(path, progress)
+        stats = transcriber.last_stats
+        print(f"Transcribed {stats['audio_seconds']:.0f}s of audio in {stats['elapsed_seconds']:.1f}s "
+              f"({stats['realtime_factor']:.1f}x real time)")
+        return results
+
     def _continuous_processing_loop(self) -> None:
         """Main loop for continuous audio processing."""
         print("Starting continuous processing loop")
-        
+
         while self._continuous_active:
+            batch = self._audio_queue.get_batch(timeout=0.5)
+            if not batch:
+                if self._warm_up_requested:
+                    self._warm_up_requested = False
+                    self._run_warm_up()
+                continue
+
+            self._is_processing = True
             try:
-                # Get audio chunk from queue, with timeout
-                audio_chunk = self._audio_queue.get(timeout=0.5)
-                
-                # Process the chunk
-                self._is_processing = True
-                
-                try:
-                    # Prepare audio data
-                    if audio_chunk.dtype != np.float32:
-                        if audio_chunk.dtype == np.int16:
-                            audio_chunk = audio_chunk.astype(np.float32) / 32768.0
-                        else:
-                            audio_chunk = audio_chunk.astype(np.float32)
-                            max_value = max(np.max(np.abs(audio_chunk)), 1e-10)
-                            audio_chunk /= max_value
-                    
-                    # Set options for Japanese recognition
-                    if self.use_ctranslate2 and self.ct_model:
-                        # Process with CTranslate2 
-                        segments, info = self.ct_model.transcribe(
-                            audio_chunk,
-                            language=self.language,
-                            task="transcribe",
-                            beam_size=5
-                        )
-                        
-                        # Extract text from segments
-                        transcription = ""
-                        segment_list = list(segments)  # Convert generator to list
-                        for segment in segment_list:
-                            transcription += segment.text
-                        
-                        # Estimate confidence
-                        if segment_list:
-                            avg_prob = sum(s.avg_logprob for s in segment_list) / len(segment_list)
-                            # Convert log probability to confidence score (0-1)
-                            confidence = min(1.0, max(0.0, 1.0 + avg_prob/10))
-                        else:
-                            confidence = 0.7  # Default confidence
-                    else:
-                        # Process with standard Whisper
-                        options = {
-                            "language": self.language,
-                            "task": "transcribe"
-                        }
-                        
-                        result = self.model.transcribe(audio_chunk, **options)
-                        transcription = result["text"].strip()
-                        confidence = self._estimate_confidence(result)
-                    
-                    if transcription:
-                        # Call the callback with the transcription result
-                        if self.transcription_callback:
-                            self.transcription_callback(transcription, confidence)
-                            
-                except Exception as e:
-                    print(f"Error processing audio chunk: {e}")
-                
-                finally:
-                    self._is_processing = False
-                    self._audio_queue.task_done()
-                    
-            except queue.Empty:
-                # No data in queue, just continue
-                pass
-                
+                start_time = time.monotonic()
+                results = self._transcribe_batch([r.audio for r in batch])
+                self._last_decode_time = time.monotonic()
+                self._audio_queue.complete(batch, self._last_decode_time - start_time)
+
+                for request, (transcription, confidence) in zip(batch, results):
+                    callback = request.callback or self.transcription_callback
+                    if transcription and callback:
+                        callback(transcription, confidence)
+
             except Exception as e:
-                print(f"Error in continuous processing loop: {e}")
-                
+                print(f"Error processing audio chunk: {e}")
+
+            finally:
+                self._is_processing = False
+
         print("Continuous processing loop stopped")
 
+    def _transcribe_batch(self, audio_chunks: List[np.ndarray]) -> List[Tuple[str, float]]:
+        """
+        Transcribe several utterances with one padded model call.
+
+        Utterances longer than Whisper's 30 second window need the
+        sliding-window transcribe() and are decoded on their own.
+
+        Args:
+            audio_chunks: Audio data as numpy arrays
+
+        Returns:
+            list: (transcription, confidence) per chunk, in order
+        """
+        audio_chunks = [chunk if isinstance(chunk, StagedTensor) else self._prepare_audio(chunk)
+                        for chunk in audio_chunks]
+        results: List[Optional[Tuple[str, float]]] = [None] * len(audio_chunks)
+
+        # Staged CTranslate2 features can only go through the batch decode
+        features = self.use_ctranslate2 and self.ct_model
+        window = whisper.audio.N_SAMPLES
+        batched = [i for i, chunk in enumerate(audio_chunks) if len(chunk) <= window]
+        for i in range(len(audio_chunks)):
+            staged_features = features and isinstance(audio_chunks[i], StagedTensor)
+            if i not in batched or (len(batched) == 1 and not staged_features):
+                results[i] = self._transcribe_single(audio_chunks[i])
+        if len(batched) > 1 or (batched and results[batched[0]] is None):
+            decode = (self._decode_batch_ctranslate2 if self.use_ctranslate2 and self.ct_model
+                      else self._decode_batch_whisper)
+            for i, result in zip(batched, decode([audio_chunks[i] for i in batched])):
+                results[i] = result
+        return results
+
+    def _transcribe_single(self, audio_chunk: np.ndarray) -> Tuple[str, float]:
+        """
+        Transcribe one utterance.
+
+        Args:
+            audio_chunk: Audio data as float32 numpy array, or staged on the device
+
+        Returns:
+            tuple: (transcription, confidence)
+        """
+        if isinstance(audio_chunk, StagedTensor):
+            audio_chunk = audio_chunk.wait()
+
+        if self.use_ctranslate2 and self.ct_model:
+            # Process with CTranslate2
+            segments, info = self.ct_model.transcribe(
+                audio_chunk,
+                language=self.language,
+                task="transcribe",
+                beam_size=self.beam_size
+            )
+
+            # Extract text from segments
+            transcription = ""
+            segment_list = list(segments)  # Convert generator to list
+            for segment in segment_list:
+                transcription += segment.text
+
+            # Estimate confidence
+            if segment_list:
+                avg_prob = sum(s.avg_logprob for s in segment_list) / len(segment_list)
+                # Convert log probability to confidence score (0-1)
+                confidence = min(1.0, max(0.0, 1.0 + avg_prob/10))
+            else:
+                confidence = 0.7  # Default confidence
+            return transcription, confidence
+
+        # Process with standard Whisper
+        options = {
+            "language": self.language,
+            "task": "transcribe"
+        }
+
+        result = self.model.transcribe(audio_chunk, **options)
+        return result["text"].strip(), self._estimate_confidence(result)
+
+    def _decode_batch_ctranslate2(self, audio_chunks: List[np.ndarray]) -> List[Tuple[str, float]]:
+        """
+        Decode utterances of up to 30 seconds in one CTranslate2 generate() call.
+
+        Args:
+            audio_chunks: Audio data as float32 numpy arrays, or features staged on the device
+
+        Returns:
+            list: (transcription, confidence) per chunk
+        """
+        if any(isinstance(chunk, StagedTensor) for chunk in audio_chunks):
+            import torch
+
+            device = next(c for c in audio_chunks if isinstance(c, StagedTensor)).tensor.device
+            stacked = torch.stack([
+                chunk.wait() if isinstance(chunk, StagedTensor)
+                else torch.from_numpy(self._ctranslate2_features(chunk)).to(device)
+                for chunk in audio_chunks
+            ])
+            # CTranslate2 reads the features on its own stream
+            torch.cuda.current_stream(device).synchronize()
+            features = ctranslate2.StorageView.from_array(stacked)
+        else:
+            features = ctranslate2.StorageView.from_array(
+                np.stack([self._ctranslate2_features(chunk) for chunk in audio_chunks]))
+
+        tokenizer = faster_whisper.tokenizer.Tokenizer(
+            self.ct_model.hf_tokenizer,
+            self.ct_model.model.is_multilingual,
+            task="transcribe",
+            language=self.language,
+        )
+        prompt = list(tokenizer.sot_sequence) + [tokenizer.no_timestamps]
+
+        outputs = self.ct_model.model.generate(
+            features,
+            [prompt] * len(audio_chunks),
+            beam_size=self.beam_size,
+            return_scores=True,
+        )
+
+        # Scores are length-normalized log probabilities, like avg_logprob
+        return [(tokenizer.decode(output.sequences_ids[0]).strip(),
+                 min(1.0, max(0.0, 1.0 + output.scores[0] / 10)))
+                for output in outputs]
+
+    def _ctranslate2_features(self, audio_chunk: np.ndarray) -> np.ndarray:
+        """Log-mel features of up to 30 seconds of audio, padded to Whisper's window."""
+        frames = whisper.audio.N_FRAMES
+        mel = self.ct_model.feature_extractor(audio_chunk)[:, :frames]
+        return np.ascontiguousarray(np.pad(mel, ((0, 0), (0, frames - mel.shape[1]))),
+                                    dtype=np.float32)
+
+    def _decode_batch_whisper(self, audio_chunks: List[np.ndarray]) -> List[Tuple[str, float]]:
+        """
+        Decode utterances of up to 30 seconds as one batch with standard Whisper.
+
+        Audio staged on the device is turned into features there.
+
+        Args:
+            audio_chunks: Audio data as float32 numpy arrays, or staged on the device
+
+        Returns:
+            list: (transcription, confidence) per chunk
+        """
+        import torch
+
+        mel = torch.stack([
+            whisper.pad_or_trim(whisper.log_mel_spectrogram(
+                chunk.wait() if isinstance(chunk, StagedTensor) else chunk, self.model.dims.n_mels),
+                whisper.audio.N_FRAMES).to(self.model.device)
+            for chunk in audio_chunks
+        ])
+        options = whisper.DecodingOptions(
+            language=self.language,
+            task="transcribe",
+            beam_size=self.beam_size,
+            fp16=self.device == "cuda"
+        )
+        results = whisper.decode(self.model, mel.to(self.model.device), options)
+
+        # Same log probability to confidence mapping as the CTranslate2 path
+        return [(result.text.strip(), min(1.0, max(0.0, 1.0 + result.avg_logprob / 10)))
+                for result in results]
+
     def _process_audio(self, audio_data: np.ndarray) -> None:
         """
         Process audio data in a background thread.
@@ -298,15 +845,7 @@ class WhisperSTT:
 
         try:
             # Normalize audio if needed (ensuring range is between -1 and 1)
-            if audio_data.dtype != np.float32:
-                if audio_data.dtype == np.int16:
-                    # Convert 16-bit PCM to float32 in range [-1, 1]
-                    audio_data = audio_data.astype(np.float32) / 32768.0
-                else:
-                    # Generic normalization for other types
-                    audio_data = audio_data.astype(np.float32)
-                    max_value = max(np.max(np.abs(audio_data)), 1e-10)
-                    audio_data /= max_value
+            audio_data = self._prepare_audio(audio_data)
 
             # Perform transcription
             start_time = time.time()
@@ -361,6 +900,80 @@ class WhisperSTT:
         finally:
             self._is_processing = False
 
+    def _process_features(self, log_mel: np.ndarray) -> None:
+        """
+        Decode precomputed log-mel features in a background thread.
+
+        Args:
+            log_mel: Array of shape (n_mels, frames) with log10 mel energies
+        """
+        if not self.is_loaded:
+            if not self.load_model():
+                return
+
+        self._is_processing = True
+
+        try:
+            import torch
+
+            start_time = time.time()
+
+            # Whisper's per-segment normalization; this also copies the
+            # read-only view out of the capture buffer
+            mel = np.maximum(log_mel, log_mel.max() - 8.0)
+            mel = (mel + 4.0) / 4.0
+            mel = whisper.pad_or_trim(torch.from_numpy(mel.astype(np.float32)),
+                                      whisper.audio.N_FRAMES)
+
+            options = whisper.DecodingOptions(
+                language=self.language,
+                task="transcribe",
+                fp16=self.device == "cuda"
+            )
+            result = whisper.decode(self.model, mel.to(self.model.device), options)
+
+            transcription = result.text.strip()
+            # Same log probability to confidence mapping as the CTranslate2 path
+            confidence = min(1.0, max(0.0, 1.0 + result.avg_logprob / 10))
+
+            processing_time = time.time() - start_time
+            print(f"Features processed in {processing_time:.2f} seconds, confidence: {confidence:.2f}")
+
+            if self.transcription_callback:
+                self.transcription_callback(transcription, confidence)
+
+        except Exception as e:
+            print(f"Error during transcription: {e}")
+        finally:
+            self._is_processing = False
+
+    @staticmethod
+    def _prepare_audio(audio_data: np.ndarray) -> np.ndarray:
+        """
+        Convert audio to the float32 [-1, 1] layout Whisper expects.
+
+        float32 input (e.g. from the C++ capture's get_buffer_as_numpy) is
+        passed through without copying.
+
+        Args:
+            audio_data: Audio data as numpy array
+
+        Returns:
+            np.ndarray: Audio data as float32 in the range [-1, 1]
+        """
+        if audio_data.dtype == np.float32:
+            return audio_data
+
+        if audio_data.dtype == np.int16:
+            # Convert 16-bit PCM to float32 in range [-1, 1]
+            return audio_data.astype(np.float32) / 32768.0
+
+        # Generic normalization for other types
+        audio_data = audio_data.astype(np.float32)
+        max_value = max(np.max(np.abs(audio_data)), 1e-10)
+        audio_data /= max_value
+        return audio_data
+
     def _estimate_confidence(self, result: Dict[str, Any]) -> float:
         """
         Estimate confidence score from Whisper result.
@@ -1 +1,12 @@
+"""
+Translation module for KoeLingo.
 
+This module translates recognized Japanese into English with NLLB on
+CTranslate2 (NLLBTranslator), batched and cached across streams by
+TranslationPipeline.
+"""
+
+from .nllb_translator import NLLBTranslator
+from .pipeline import TranslationCache, TranslationPipeline, TranslationResult
+
+__all__ = ["NLLBTranslator", "TranslationPipeline", "TranslationResult", "TranslationCache"]
@@ -0,0 +1,128 @@
+"""
+NLLB Japanese-to-English translation on CTranslate2.
+
+NLLBTranslator runs a CTranslate2 conversion of an NLLB-200 model (e.g.
+`ct2-transformers-converter --model facebook/nllb-200-distilled-600M`)
+and translates a list of sentences in one translate_batch() call, so a
+batch costs little more than its longest sentence.
+"""
+
+import os
+import threading
+from typing import List, Optional, Tuple
+
+try:
+    import ctranslate2
+    import transformers
+    NLLB_AVAILABLE = True
+except ImportError:
+    NLLB_AVAILABLE = False
+
+
+class NLLBTranslator:
+    """Batched sentence translation with an NLLB model."""
+
+    def __init__(self, model_dir: str, source_lang: str = "jpn_Jpan", target_lang: str = "eng_Latn",
+                 device: str = "cpu", compute_type: str = "int8", beam_size: int = 2,
+                 threads: int = 0, tokenizer: Optional[str] = None):
+        """
+        Initialize the translator; the model is loaded on first use.
+
+        Args:
+            model_dir: CTranslate2 model directory
+            source_lang: NLLB code of the source language
+            target_lang: NLLB code of the target language
+            device: 'cpu', 'cuda' or 'auto'
+            compute_type: Weight type ('int8', 'float16', ...)
+            beam_size: Beam width (1 for greedy decoding)
+            threads: CPU threads per translation (0 = CTranslate2's default)
+            tokenizer: Hugging Face tokenizer name or directory (default: model_dir)
+        """
+        self.model_dir = model_dir
+        self.source_lang = source_lang
+        self.target_lang = target_lang
+        self.device = device
+        self.compute_type = compute_type
+        self.beam_size = beam_size
+        self.threads = threads
+        self.tokenizer_name = tokenizer or model_dir
+
+        self._translator = None
+        self._tokenizer = None
+        self._lock = threading.Lock()
+
+    @staticmethod
+    def is_available(model_dir: Optional[str] = None) -> bool:
+        """
+        Check whether CTranslate2 and the tokenizer are installed.
+
+        Args:
+            model_dir: Also require this model directory to exist
+        """
+        return NLLB_AVAILABLE and (model_dir is None or os.path.isdir(model_dir))
+
+    def load_model(self) -> bool:
+        """
+        Load the model and tokenizer.
+
+        Returns:
+            bool: True if the model is ready
+        """
+        with self._lock:
+            if self._translator:
+                return True
+            if not NLLB_AVAILABLE:
+                print("CTranslate2/transformers not available. Cannot translate.")
+                return False
+            try:
+                print(f"Loading NLLB model: {self.model_dir} ({self.device}, {self.compute_type})")
+                self._translator = ctranslate2.Translator(
+                    self.model_dir, device=self.device, compute_type=self.compute_type,
+                    intra_threads=self.threads)
+                self._tokenizer = transformers.AutoTokenizer.from_pretrained(
+                    self.tokenizer_name, src_lang=self.source_lang)
+                return True
+            except Exception as e:
+                print(f"Error loading NLLB model: {e}")
+                self._translator = None
+                return False
+
+    def unload_model(self) -> None:
+        """Release the model."""
+        with self._lock:
+            self._translator = None
+            self._tokenizer = None
+
+    def translate_batch(self, texts: List[str]) -> List[Tuple[str, float]]:
+        """
+        Translate sentences in one model call.
+
+        Args:
+            texts: Source sentences
+
+        Returns:
+            list: (translation, confidence) per sentence, in order
+
+        Raises:
+            RuntimeError: If the model cannot be loaded
+        """
+        if not texts:
+            return []
+        if not self._translator and not self.load_model():
+            raise RuntimeError(f"NLLB model not loaded: {self.model_dir}")
+
+        tokenizer = self._tokenizer
+        sources = [tokenizer.convert_ids_to_tokens(tokenizer.encode(text)) for text in texts]
+        outputs = self._translator.translate_batch(
+            sources,
+            target_prefix=[[self.target_lang]] * len(texts),
+            beam_size=self.beam_size,
+            return_scores=True,
+        )
+
+        # Drop the target language token; scores are length-normalized log
+        # probabilities, mapped to confidence like the STT's
+        return [(tokenizer.decode(tokenizer.convert_tokens_to_ids(output.hypotheses[0][1:]),
+                                  skip_special_tokens=True).strip(),
+                 min(1.0, max(0.0, 1.0 + output.scores[0] / 10)))
+                for output in outputs]
@@ -0,0 +1,375 @@
+"""
+Translation stage fed by transcription results.
+
+TranslationPipeline sits between the recognizers and the UI. Sentences
+from any number of streams are queued and translated by one worker in
+batches: everything that is pending when the worker becomes free goes
+into the next model call, so a sentence waits for at most the batch in
+flight and batching never holds one back to fill up. Final sentences go
+first and are delivered in order per stream.
+
+Partial hypotheses are translated too, but only the newest one per
+stream is kept: a newer partial or the final sentence replaces it in the
+queue, and the result of one already being translated is discarded.
+Translations are cached by normalized text, so repeated phrases and the
+unchanged partials of streaming decodes cost a dictionary lookup.
+"""
+
+import re
+import threading
+import time
+import unicodedata
+from collections import OrderedDict, deque
+from typing import Any, Callable, Deque, Dict, List, Optional, Tuple
+
+# Sentence ends; a period only when it is not a decimal point
+_SENTENCE_END = re.compile(r'[。！？!?]+|\.(?!\d)')
+
+
+def normalize_text(text: str) -> str:
+    """
+    Normalize text for cache lookups.
+
+    NFKC folds full-width Latin and half-width kana, so the same phrase
+    from different decodes maps to the same key.
+    """
+    return ' '.join(unicodedata.normalize('NFKC', text).split())
+
+
+def split_sentences(text: str) -> Tuple[List[str], str]:
+    """
+    Split off the complete sentences of a text.
+
+    Returns:
+        tuple: (complete sentences, unfinished remainder)
+    """
+    sentences = []
+    start = 0
+    for match in _SENTENCE_END.finditer(text):
+        sentence = text[start:match.end()].strip()
+        if sentence:
+            sentences.append(sentence)
+        start = match.end()
+    return sentences, text[start:].strip()
+
+
+class TranslationResult:
+    """A translated partial or final sentence."""
+
+    __slots__ = ('stream_id', 'source', 'text', 'is_final', 'confidence', 'cached', 'latency')
+
+    def __init__(self, stream_id: Any, source: str, text: str, is_final: bool,
+                 confidence: float, cached: bool, latency: float):
+        self.stream_id = stream_id
+        self.source = source
+        self.text = text
+        self.is_final = is_final
+        self.confidence = confidence
+        self.cached = cached
+        self.latency = latency
+
+    def __repr__(self) -> str:
+        kind = 'final' if self.is_final else 'partial'
+        return f'TranslationResult({kind}, {self.stream_id!r}, {self.source!r} -> {self.text!r})'
+
+
+class TranslationCache:
+    """Thread-safe LRU of translations keyed on normalized source text."""
+
+    def __init__(self, capacity: int = 1024):
+        """
+        Initialize the cache.
+
+        Args:
+            capacity: Translations kept (0 disables caching)
+        """
+        self.capacity = capacity
+        self._entries: 'OrderedDict[str, Tuple[str, float]]' = OrderedDict()
+        self._lock = threading.Lock()
+
+    def get(self, key: str) -> Optional[Tuple[str, float]]:
+        """Look up a translation and mark it recently used."""
+        with self._lock:
+            entry = self._entries.get(key)
+            if entry is not None:
+                self._entries.move_to_end(key)
+            return entry
+
+    def put(self, key: str, translation: Tuple[str, float]) -> None:
+        """Store a translation, evicting the least recently used beyond capacity."""
+        if self.capacity <= 0:
+            return
+        with self._lock:
+            self._entries[key] = translation
+            self._entries.move_to_end(key)
+            while len(self._entries) > self.capacity:
+                self._entries.popitem(last=False)
+
+    def clear(self) -> None:
+        """Drop every translation."""
+        with self._lock:
+            self._entries.clear()
+
+    def __len__(self) -> int:
+        return len(self._entries)
+
+
+class _Request:
+    __slots__ = ('stream_id', 'source', 'key', 'is_final', 'generation', 'enqueued')
+
+    def __init__(self, stream_id: Any, source: str, is_final: bool, generation: int):
+        self.stream_id = stream_id
+        self.source = source
+        self.key = normalize_text(source)
+        self.is_final = is_final
+        self.generation = generation
+        self.enqueued = time.monotonic()
+
+
+class TranslationPipeline:
+    """Batched, cached translation of partial and final transcription results."""
+
+    def __init__(self, translator, callback: Callable[[TranslationResult], None],
+                 max_batch_size: int = 8, cache_size: int = 1024, translate_partials: bool = True):
+        """
+        Initialize the pipeline.
+
+        Args:
+            translator: Model wrapper with translate_batch(texts) returning
+                (translation, confidence) per text, e.g. NLLBTranslator
+            callback: Receives results, on the worker thread or for cache
+                hits on the submitting thread
+            max_batch_size: Most sentences per model call
+            cache_size: Translations kept in the LRU cache
+            translate_partials: Also translate partial hypotheses
+        """
+        self.translator = translator
+        self.callback = callback
+        self.max_batch_size = max(1, max_batch_size)
+        self.translate_partials = translate_partials
+        self.cache = TranslationCache(cache_size)
+
+        self._finals: Deque[_Request] = deque()
+        self._partials: 'OrderedDict[Any, _Request]' = OrderedDict()  # Newest per stream
+        self._generation: Dict[Any, int] = {}  # Bumped whenever a stream's partial goes stale
+        self._outstanding: Dict[Any, int] = {}  # Finals queued or in flight per stream
+        self._sentences: Dict[Any, str] = {}  # Committed text not yet ending a sentence
+
+        # Delivery is serialized so a cache hit cannot overtake a batch being delivered
+        self._lock = threading.Condition()
+        self._deliver_lock = threading.RLock()
+        self._thread: Optional[threading.Thread] = None
+        self._active = False
+        self._stats = {'submitted': 0, 'translated': 0, 'batches': 0, 'cancelled': 0,
+                       'failed': 0, 'final_latency_total': 0.0, 'final_latency_max': 0.0,
+                       'cache_hits': 0, 'finals': 0}
+
+    def start(self) -> None:
+        """Start translating on a background thread."""
+        with self._lock:
+            if self._active:
+                return
+            self._active = True
+        self._thread = threading.Thread(target=self._run, daemon=True)
+        self._thread.start()
+
+    def stop(self) -> None:
+        """Translate the queued final sentences, drop partials and stop the worker."""
+        with self._lock:
+            self._active = False
+            self._stats['cancelled'] += len(self._partials)
+            self._partials.clear()
+            self._lock.notify_all()
+        if self._thread:
+            self._thread.join()
+            self._thread = None
+
+    def submit(self, text: str, is_final: bool = True, stream_id: Any = 0) -> bool:
+        """
+        Queue a sentence for translation.
+
+        A partial replaces the stream's previous partial; a final sentence
+        supersedes the stream's partial.
+
+        Args:
+            text: Source sentence
+            is_final: Whether the sentence is final or a partial hypothesis
+            stream_id: Stream the sentence belongs to
+
+        Returns:
+            bool: False if the text is empty or partials are not translated
+        """
+        text = text.strip()
+        if not text or (not is_final and not self.translate_partials):
+            return False
+
+        with self._lock:
+            self._stats['submitted'] += 1
+            request = self._supersede(stream_id, text, is_final)
+        hit = self.cache.get(request.key)
+        if hit is not None:
+            with self._deliver_lock:
+                with self._lock:
+                    # Finals stay behind the stream's earlier ones
+                    inline = (not is_final or not self._outstanding.get(stream_id)) and \
+                        request.generation == self._generation.get(stream_id)
+                if inline:
+                    self._deliver(request, hit, cached=True)
+                    return True
+
+        with self._lock:
+            if is_final:
+                self._finals.append(request)
+                self._outstanding[stream_id] = self._outstanding.get(stream_id, 0) + 1
+            elif request.generation == self._generation.get(stream_id):
+                self._partials[stream_id] = request
+            self._lock.notify_all()
+        return True
+
+    def on_result(self, result: Any, stream_id: Any = 0) -> None:
+        """
+        Translate a StreamingTranscriber result.
+
+        Committed spans are joined until they end a sentence; each complete
+        sentence is translated as final. The unfinished sentence plus a
+        partial result's text is translated as a partial.
+
+        Args:
+            result: StreamingResult (text and is_final)
+            stream_id: Stream the result belongs to
+        """
+        with self._lock:
+            text = self._sentences.get(stream_id, '') + result.text
+            if result.is_final:
+                sentences, rest = split_sentences(text)
+                self._sentences[stream_id] = rest
+            else:
+                sentences, rest = [], text
+        for sentence in sentences:
+            self.submit(sentence, True, stream_id)
+        if rest:
+            self.submit(rest, False, stream_id)
+
+    def on_transcription(self, text: str, confidence: float = 0.0, stream_id: Any = 0) -> None:
+        """
+        Translate a complete utterance.
+
+        Matches the callbacks of WhisperSTT (text, confidence) and
+        WhisperCppSTT (text, confidence, stream).
+        """
+        self.submit(text, True, stream_id)
+
+    def flush(self, stream_id: Any = 0) -> None:
+        """Translate the stream's unfinished sentence as final, e.g. at the end of speech."""
+        with self._lock:
+            rest = self._sentences.pop(stream_id, '')
+        if rest:
+            self.submit(rest, True, stream_id)
+
+    def pending(self) -> int:
+        """Sentences waiting for the worker."""
+        with self._lock:
+            return len(self._finals) + len(self._partials)
+
+    def get_stats(self) -> Dict[str, Any]:
+        """
+        Get translation statistics.
+
+        Returns:
+            dict: submitted, translated (by the model), cache_hits, batches,
+            cancelled, failed, mean_batch_size and the mean and maximum
+            latency of final sentences in seconds
+        """
+        with self._lock:
+            stats = dict(self._stats)
+        finals = stats.pop('finals')
+        stats['final_latency_mean'] = stats.pop('final_latency_total') / finals if finals else 0.0
+        stats['mean_batch_size'] = stats['translated'] / stats['batches'] if stats['batches'] else 0.0
+        return stats
+
+    def _supersede(self, stream_id: Any, text: str, is_final: bool) -> _Request:
+        """Make a request current for its stream; lock held."""
+        generation = self._generation.get(stream_id, 0) + 1
+        self._generation[stream_id] = generation
+        if self._partials.pop(stream_id, None) is not None:
+            self._stats['cancelled'] += 1
+        return _Request(stream_id, text, is_final, generation)
+
+    def _take_batch(self) -> List[_Request]:
+        """Take finals oldest first, then partials; lock held."""
+        batch: List[_Request] = []
+        while self._finals and len(batch) < self.max_batch_size:
+            batch.append(self._finals.popleft())
+        while self._partials and len(batch) < self.max_batch_size:
+            batch.append(self._partials.popitem(last=False)[1])
+        return batch
+
+    def _run(self) -> None:
+        """Translate whatever is pending, one batch at a time."""
+        while True:
+            with self._lock:
+                self._lock.wait_for(lambda: self._finals or self._partials or not self._active)
+                if not self._active and not self._finals:
+                    return
+                batch = self._take_batch()
+            self._translate(batch)
+
+    def _translate(self, batch: List[_Request]) -> None:
+        """Translate a batch, answering repeats from the cache, and deliver it."""
+        translations: Dict[str, Tuple[str, float]] = {}
+        cached = set()
+        missing: List[str] = []
+        for request in batch:
+            if request.key in translations or request.key in missing:
+                continue
+            hit = self.cache.get(request.key)
+            if hit is not None:
+                translations[request.key] = hit
+                cached.add(request.key)
+            else:
+                missing.append(request.key)
+
+        failed = False
+        if missing:
+            try:
+                outputs = self.translator.translate_batch(missing)
+                for key, output in zip(missing, outputs):
+                    translations[key] = output
+                    self.cache.put(key, output)
+            except Exception as e:
+                print(f"Error translating batch of {len(missing)}: {e}")
+                failed = True
+
+        with self._deliver_lock:
+            deliver = []
+            with self._lock:
+                if missing:
+                    self._stats['batches'] += 1
+                    self._stats['translated'] += 0 if failed else len(missing)
+                for request in batch:
+                    if request.is_final:
+                        self._outstanding[request.stream_id] -= 1
+                    elif request.generation != self._generation.get(request.stream_id):
+                        self._stats['cancelled'] += 1  # Superseded while translating
+                        continue
+                    if request.key in translations:
+                        deliver.append(request)
+                    else:
+                        self._stats['failed'] += 1
+            for request in deliver:
+                self._deliver(request, translations[request.key], request.key in cached)
+
+    def _deliver(self, request: _Request, translation: Tuple[str, float], cached: bool) -> None:
+        """Pass a translation to the callback."""
+        latency = time.monotonic() - request.enqueued
+        with self._lock:
+            self._stats['cache_hits'] += 1 if cached else 0
+            if request.is_final:
+                self._stats['finals'] += 1
+                self._stats['final_latency_total'] += latency
+                self._stats['final_latency_max'] = max(self._stats['final_latency_max'], latency)
+        try:
+            self.callback(TranslationResult(request.stream_id, request.source, translation[0],
+                                            request.is_final, translation[1], cached, latency))
+        except Exception as e:
+            print(f"Error in translation callback: {e}")
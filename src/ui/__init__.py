@@ -4,3 +4,4 @@ UI components for the KoeBridge Translator application.
 
 from .main_window import MainWindow
 from .audio_visualizer import AudioVisualizer
+from .event_bridge import EventBridge
@@ -0,0 +1,88 @@
+"""
+Delivers event bus events to the Qt event loop as signals.
+"""
+
+from typing import Any, Optional
+
+from PySide6.QtCore import QObject, QSocketNotifier, QTimer, Signal, Slot
+
+from src.audio.pybind import EventType
+
+
+class EventBridge(QObject):
+    """
+    Subscribes to an event bus and re-emits its events on the GUI thread.
+
+    The subscription's descriptor is watched with a QSocketNotifier, so
+    the GUI thread wakes only when events are queued and takes them in
+    batches; no Python runs on the audio or decode threads. Where the
+    subscription has no descriptor (Windows), it is polled on a timer.
+    """
+
+    # Meter level of the capture (0.0-1.0)
+    level_changed = Signal(float)
+    # First frame of speech after an idle spell
+    speech_onset = Signal(int)
+    # Frames of an utterance queued for recognition (start, end)
+    utterance_ready = Signal(int, int)
+    # Text decoded so far for the current utterance
+    partial_transcript = Signal(str)
+    # Finished text of an utterance and its confidence
+    final_transcript = Signal(str, float)
+
+    def __init__(self, bus: Any, capacity: int = 256, poll_interval_ms: int = 30,
+                 parent: Optional[QObject] = None):
+        """
+        Subscribe to every event type of a bus.
+
+        Args:
+            bus: Bus from koelingo.audio.pybind.create_event_bus()
+            capacity: Events queued before further ones are dropped
+            poll_interval_ms: Poll interval where no descriptor is available
+            parent: Owning QObject
+        """
+        super().__init__(parent)
+        self._bus = bus
+        self._subscription = bus.subscribe(None, capacity)
+        self._notifier = None
+        self._timer = None
+
+        fd = self._subscription.fileno()
+        if fd >= 0:
+            self._notifier = QSocketNotifier(fd, QSocketNotifier.Type.Read, self)
+            self._notifier.activated.connect(self._dispatch)
+        else:
+            self._timer = QTimer(self)
+            self._timer.timeout.connect(self._dispatch)
+            self._timer.start(poll_interval_ms)
+
+    @property
+    def dropped(self) -> int:
+        """Events lost because the GUI thread fell behind."""
+        return self._subscription.dropped
+
+    def close(self) -> None:
+        """Stop watching and unsubscribe."""
+        if self._notifier:
+            self._notifier.setEnabled(False)
+        if self._timer:
+            self._timer.stop()
+        self._bus.unsubscribe(self._subscription)
+
+    @Slot()
+    def _dispatch(self) -> None:
+        """Emit the queued events; only the newest level of a batch is reported."""
+        level = None
+        for event in self._subscription.poll(256):
+            if event.type == EventType.LEVEL:
+                level = event.value
+            elif event.type == EventType.SPEECH_ONSET:
+                self.speech_onset.emit(event.start_frame)
+            elif event.type == EventType.UTTERANCE:
+                self.utterance_ready.emit(event.start_frame, event.end_frame)
+            elif event.type == EventType.PARTIAL_TRANSCRIPT:
+                self.partial_transcript.emit(event.text)
+            elif event.type == EventType.FINAL_TRANSCRIPT:
+                self.final_transcript.emit(event.text, event.value)
+        if level is not None:
+            self.level_changed.emit(level)
@@ -0,0 +1,73 @@
+"""
+Tests for the shared PortAudio backend and its cached device list.
+"""
+
+import unittest
+import numpy as np
+
+# Only device enumeration is exercised, which works without any input devices
+try:
+    try:
+        from src.audio.audio_capture_cc import AudioCaptureCpp, ReplaySource, notify_devices_changed
+    except ImportError:
+        from koelingo.audio.audio_capture_cc import (AudioCaptureCpp, ReplaySource,
+                                                     notify_devices_changed)
+    HAS_CPP_IMPL = True
+except ImportError:
+    HAS_CPP_IMPL = False
+
+RATE = 16000
+
+
+@unittest.skipUnless(HAS_CPP_IMPL, "needs the C++ extension")
+class AudioBackendTest(unittest.TestCase):
+    """Test cases for the backend shared by every AudioCaptureCpp."""
+
+    def setUp(self):
+        """Set up test fixtures."""
+        self.devices = AudioCaptureCpp(RATE, 512, 1).get_available_devices()
+        print(f"Running audio backend tests ({len(self.devices)} input devices)...")
+
+    def test_CapturesCanBeCreatedRepeatedly(self):
+        """Creating and destroying captures keeps one backend and the same device list."""
+        for _ in range(50):
+            audio = AudioCaptureCpp(RATE, 512, 1)
+            self.assertEqual(audio.get_available_devices(), self.devices)
+            del audio
+
+        # Several captures alive at once share it too
+        captures = [AudioCaptureCpp(RATE, 512, 1) for _ in range(8)]
+        for audio in captures:
+            self.assertEqual(audio.get_available_devices(), self.devices)
+        del captures
+        self.assertEqual(AudioCaptureCpp(RATE, 512, 1).get_available_devices(), self.devices)
+
+    def test_RescanAfterDevicesChanged(self):
+        """A hotplug notification with no stream open rescans on the next request."""
+        audio = AudioCaptureCpp(RATE, 512, 1)
+        for _ in range(5):
+            notify_devices_changed()
+            devices = audio.get_available_devices()
+            # Nothing was plugged in, so the rescan finds the same devices
+            self.assertEqual(devices, self.devices)
+            for device in devices:
+                self.assertIn('index', device)
+                self.assertIn('name', device)
+
+    def test_ListingDevicesWhileReplaying(self):
+        """A notification while a replay capture records (no device stream) is handled."""
+        audio = AudioCaptureCpp(RATE, 512, 1)
+        source = ReplaySource(np.zeros(RATE, dtype=np.float32), RATE)
+        source.set_speed(1)
+        self.assertTrue(audio.set_input_source(source))
+        self.assertTrue(audio.start_recording())
+        try:
+            notify_devices_changed()
+            self.assertEqual(AudioCaptureCpp(RATE, 512, 1).get_available_devices(), self.devices)
+        finally:
+            audio.stop_recording()
+        self.assertEqual(audio.get_available_devices(), self.devices)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,95 @@
+"""
+Tests for the pooled chunk queue of the Python implementation.
+"""
+
+import time
+import unittest
+import numpy as np
+
+# Exercise the Python implementation directly so no audio hardware is needed
+from src.audio.audio_capture import AudioCapture
+from src.audio.chunk_pool import ChunkPool
+
+
+class ChunkPoolTest(unittest.TestCase):
+    """Test cases for ChunkPool, set_chunk_queue() and read_chunk()."""
+
+    def setUp(self):
+        """Set up test fixtures."""
+        self.chunk_size = 256
+        self.audio = AudioCapture(sample_rate=16000, chunk_size=self.chunk_size)
+        self.samples = (np.arange(20 * self.chunk_size) % 1000).astype(np.int16)
+        print("Running chunk pool tests...")
+
+    def tearDown(self):
+        """Tear down test fixtures."""
+        self.audio.stop_recording()
+
+    def _wait_for_replay(self):
+        """Wait until the replay source has been delivered."""
+        deadline = time.monotonic() + 5.0
+        while not self.audio.replay_finished and time.monotonic() < deadline:
+            time.sleep(0.01)
+
+    def test_ReleasedBuffersAreReused(self):
+        """A released buffer is handed out again and an exhausted pool returns None."""
+        pool = ChunkPool(2, 16)
+        first = pool.acquire(b'\x01' * 16, start_frame=5)
+        second = pool.acquire()
+        self.assertIsNone(pool.acquire())
+        self.assertEqual(bytes(first.data), b'\x01' * 16)
+        self.assertEqual(first.start_frame, 5)
+
+        first.release()
+        self.assertEqual(pool.available, 1)
+        with pool.acquire(b'\x02' * 8) as third:
+            self.assertEqual(bytes(third.data), b'\x02' * 8)
+            self.assertEqual(pool.available, 0)
+        self.assertEqual(pool.available, 1)
+        second.release()
+        self.assertEqual(pool.available, pool.capacity)
+
+    def test_ChunksCarryTheReplayInOrder(self):
+        """Chunks read while recording reassemble the captured audio."""
+        self.assertTrue(self.audio.set_chunk_queue(4))
+        self.assertTrue(self.audio.set_replay_source(self.samples, speed=1.0))
+        self.assertTrue(self.audio.start_recording())
+        self.assertFalse(self.audio.set_chunk_queue(8))
+
+        parts = []
+        expected_frame = 0
+        while True:
+            chunk = self.audio.read_chunk(timeout_ms=500)
+            if chunk is None:
+                if self.audio.replay_finished:
+                    break
+                continue
+            with chunk:
+                self.assertEqual(chunk.start_frame, expected_frame)
+                parts.append(np.frombuffer(chunk.data, dtype=np.int16).copy())
+                expected_frame += chunk.nbytes // 2
+            if expected_frame >= len(self.samples):
+                break
+
+        self.assertTrue(np.array_equal(np.concatenate(parts), self.samples))
+        self.assertEqual(self.audio.get_stats()['dropped_chunks'], 0)
+
+    def test_ExhaustedPoolCountsDroppedChunks(self):
+        """Periods arriving while every chunk is held are counted, not queued."""
+        self.assertTrue(self.audio.set_chunk_queue(4))
+        self.assertTrue(self.audio.set_replay_source(self.samples, speed=0))
+        self.assertTrue(self.audio.start_recording())
+        self._wait_for_replay()
+        time.sleep(0.1)
+
+        self.assertEqual(self.audio.get_queue_size(), 4)
+        self.assertEqual(self.audio.get_stats()['dropped_chunks'], 20 - 4)
+
+        # The oldest periods are the ones kept
+        chunk = self.audio.read_chunk(timeout_ms=100)
+        self.assertEqual(chunk.start_frame, 0)
+        chunk.release()
+
+
+if __name__ == '__main__':
+    unittest.main()
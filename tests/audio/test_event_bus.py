@@ -0,0 +1,132 @@
+"""
+Tests for the event bus and the events published by the capture.
+"""
+
+import os
+import select
+import time
+import unittest
+import numpy as np
+
+# Exercise the Python implementation directly so no audio hardware is needed
+from src.audio.audio_capture import AudioCapture
+from src.audio.event_bus import Event, EventBus, EventType
+
+
+def _readable(fd):
+    """Check whether a descriptor is readable without blocking."""
+    return bool(select.select([fd], [], [], 0)[0])
+
+
+class EventBusTest(unittest.TestCase):
+    """Test cases for EventBus and EventSubscription."""
+
+    def setUp(self):
+        """Set up test fixtures."""
+        self.bus = EventBus()
+        print("Running event bus tests...")
+
+    def test_SubscriptionsOnlyGetTheirTypes(self):
+        """Each subscription receives the types it asked for, in order."""
+        levels = self.bus.subscribe([EventType.LEVEL])
+        everything = self.bus.subscribe()
+        self.bus.publish(Event(EventType.LEVEL, value=0.5))
+        self.bus.publish_transcript("こんにちは", 0.9)
+        self.bus.publish(Event(EventType.LEVEL, value=0.25))
+
+        self.assertEqual([e.value for e in levels.poll()], [0.5, 0.25])
+        events = everything.poll()
+        self.assertEqual([e.type for e in events],
+                         [EventType.LEVEL, EventType.FINAL_TRANSCRIPT, EventType.LEVEL])
+        self.assertEqual(events[1].text, "こんにちは")
+        self.assertGreater(events[0].timestamp_ns, 0)
+        self.assertEqual(self.bus.published, 3)
+
+    def test_PollTakesBatches(self):
+        """poll() returns at most max_events, oldest first."""
+        subscription = self.bus.subscribe()
+        for i in range(10):
+            self.bus.publish(Event(EventType.SPEECH_ONSET, start_frame=i))
+        self.assertEqual([e.start_frame for e in subscription.poll(4)], [0, 1, 2, 3])
+        self.assertEqual(subscription.pending, 6)
+        self.assertEqual([e.start_frame for e in subscription.poll()], [4, 5, 6, 7, 8, 9])
+
+    @unittest.skipIf(os.name == 'nt', "subscriptions have no descriptor on Windows")
+    def test_DescriptorIsReadableWhileEventsAreQueued(self):
+        """The descriptor wakes an event loop and is cleared once the queue is empty."""
+        subscription = self.bus.subscribe()
+        fd = subscription.fileno()
+        self.assertFalse(_readable(fd))
+        self.bus.publish(Event(EventType.LEVEL))
+        self.bus.publish(Event(EventType.LEVEL))
+        self.assertTrue(_readable(fd))
+        subscription.poll(1)
+        self.assertTrue(_readable(fd))
+        subscription.poll()
+        self.assertFalse(_readable(fd))
+
+    def test_OverflowIsCountedNotBlocking(self):
+        """Events that do not fit a full queue are dropped and counted."""
+        subscription = self.bus.subscribe(capacity=4)
+        delivered = [self.bus.publish(Event(EventType.LEVEL)) for _ in range(6)]
+        self.assertEqual(delivered, [1, 1, 1, 1, 0, 0])
+        self.assertEqual(subscription.dropped, 2)
+        self.assertEqual(len(subscription.poll()), 4)
+
+    def test_UnsubscribedQueuesGetNothing(self):
+        """Nothing is delivered after unsubscribe(), and unused types are not wanted."""
+        subscription = self.bus.subscribe([EventType.UTTERANCE])
+        self.assertTrue(self.bus.wants(EventType.UTTERANCE))
+        self.assertFalse(self.bus.wants(EventType.LEVEL))
+        self.bus.unsubscribe(subscription)
+        self.assertFalse(self.bus.wants(EventType.UTTERANCE))
+        self.assertEqual(self.bus.publish(Event(EventType.UTTERANCE)), 0)
+        self.assertFalse(subscription.wait(10))
+
+
+class CaptureEventsTest(unittest.TestCase):
+    """Test cases for the events the Python AudioCapture publishes."""
+
+    def setUp(self):
+        """Set up test fixtures."""
+        self.rate = 16000
+        self.audio = AudioCapture(sample_rate=self.rate, chunk_size=512)
+        self.bus = EventBus()
+        self.subscription = self.bus.subscribe(
+            [EventType.SPEECH_ONSET, EventType.UTTERANCE], capacity=64)
+        self.assertTrue(self.audio.set_event_bus(self.bus, source=3))
+
+        # Silence, speech at 2.0-3.5 s, silence
+        tone = (8000 * np.sin(2 * np.pi * 440 * np.arange(int(1.5 * self.rate)) / self.rate))
+        self.samples = np.concatenate([
+            np.zeros(2 * self.rate), tone, np.zeros(2 * self.rate)]).astype(np.int16)
+        print("Running capture event tests...")
+
+    def tearDown(self):
+        """Tear down test fixtures."""
+        self.audio.stop_recording()
+
+    def test_ReplayPublishesOnsetAndUtterance(self):
+        """Speech raises an onset at its first frame, then an utterance covering it."""
+        utterances = []
+        self.assertTrue(self.audio.set_replay_source(self.samples, speed=0))
+        self.assertTrue(self.audio.start_recording(
+            chunk_processing_callback=utterances.append, continuous_mode=True))
+        self.assertFalse(self.audio.set_event_bus(None))
+        deadline = time.monotonic() + 10.0
+        while not self.audio.replay_finished and time.monotonic() < deadline:
+            time.sleep(0.01)
+        time.sleep(0.2)
+        self.audio.stop_recording()
+
+        events = self.subscription.poll()
+        self.assertEqual([e.type for e in events], [EventType.SPEECH_ONSET, EventType.UTTERANCE])
+        onset, utterance = events
+        self.assertEqual((onset.source, utterance.source), (3, 3))
+        self.assertAlmostEqual(onset.start_frame / self.rate, 2.0, delta=0.05)
+        self.assertEqual(utterance.end_frame - utterance.start_frame, len(utterances[0]))
+        self.assertLessEqual(utterance.start_frame, onset.start_frame)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,60 @@
+"""
+Tests for latency profiles in the Python implementation.
+"""
+
+import time
+import unittest
+import numpy as np
+
+# Exercise the Python implementation directly so no audio hardware is needed
+from src.audio.audio_capture import AudioCapture
+
+
+class LatencyProfileTest(unittest.TestCase):
+    """Test cases for set_latency_profile() and get_latency()."""
+
+    def setUp(self):
+        """Set up test fixtures."""
+        self.audio = AudioCapture(sample_rate=16000, chunk_size=1024)
+        print("Running latency profile tests...")
+
+    def tearDown(self):
+        """Tear down test fixtures."""
+        self.audio.stop_recording()
+
+    def test_ProfilesChoosePeriodAndWakeCadence(self):
+        """Each profile reports its period and processing cadence."""
+        self.assertEqual(self.audio.get_latency()['period_frames'], 1024)
+
+        self.assertTrue(self.audio.set_latency_profile("ultra-low"))
+        latency = self.audio.get_latency()
+        self.assertEqual(latency['period_frames'], 128)
+        self.assertAlmostEqual(latency['period_ms'], 8.0)
+
+        self.assertTrue(self.audio.set_latency_profile("power-save"))
+        latency = self.audio.get_latency()
+        self.assertEqual((latency['period_frames'], latency['wake_periods']), (2048, 2))
+        self.assertAlmostEqual(latency['total_ms'], 256.0)
+
+    def test_RejectsUnsupportedRequests(self):
+        """Unknown profiles and adaptive mode are refused; settings stay unchanged."""
+        self.assertFalse(self.audio.set_latency_profile("turbo"))
+        self.assertFalse(self.audio.set_latency_profile("balanced", adaptive=True))
+        self.assertEqual(self.audio.get_latency()['period_frames'], 1024)
+
+    def test_ReplayRunsAtTheProfilePeriod(self):
+        """Input periods follow the profile while processing keeps its chunk size."""
+        self.assertTrue(self.audio.set_latency_profile("ultra-low"))
+        self.assertTrue(self.audio.set_replay_source(np.zeros(16 * 128).astype(np.int16), speed=0))
+        self.assertTrue(self.audio.start_recording())
+        deadline = time.monotonic() + 5.0
+        while not self.audio.replay_finished and time.monotonic() < deadline:
+            time.sleep(0.01)
+        self.audio.stop_recording()
+
+        self.assertEqual(self.audio.get_frame_count(), 16)
+        self.assertEqual(self.audio.frames_written, 16 * 128)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,102 @@
+"""
+Tests for the vectorized level meter.
+"""
+
+import unittest
+import numpy as np
+
+# measure_levels() runs the same kernels as the capture, without audio hardware
+try:
+    try:
+        from src.audio.audio_capture_cc import level_kernel_name, measure_levels
+    except ImportError:
+        from koelingo.audio.audio_capture_cc import level_kernel_name, measure_levels
+    HAS_CPP_IMPL = True
+except ImportError:
+    HAS_CPP_IMPL = False
+
+
+def _reference(samples):
+    """Per-channel (rms, peak, clipped) computed the way the meter defines them."""
+    if samples.dtype == np.int16:
+        normalized = samples.astype(np.float64) / 32768
+        clipped = np.abs(normalized) >= 32767 / 32768
+    elif samples.dtype == np.int32:
+        # Full scale is reached once the sample rounds to 1.0 in float32
+        normalized = samples.astype(np.float32).astype(np.float64) / 2 ** 31
+        clipped = np.abs(normalized) >= 1.0
+    else:
+        normalized = samples.astype(np.float64)
+        clipped = np.abs(normalized) >= 1.0
+    normalized = normalized.reshape(len(samples), -1)
+    clipped = clipped.reshape(len(samples), -1)
+    return (np.sqrt(np.mean(normalized ** 2, axis=0)), np.max(np.abs(normalized), axis=0),
+            np.sum(clipped, axis=0))
+
+
+@unittest.skipUnless(HAS_CPP_IMPL, "needs the C++ extension")
+class LevelMeterTest(unittest.TestCase):
+    """Test cases for measure_levels()."""
+
+    def setUp(self):
+        """Set up test fixtures."""
+        self.rng = np.random.default_rng(11)
+        print(f"Running level meter tests ({level_kernel_name()} kernel)...")
+
+    def _signal(self, dtype, frames, channels):
+        """Noise at a different level per channel, with a few full-scale samples."""
+        gains = np.linspace(0.05, 0.9, channels)
+        signal = self.rng.uniform(-1, 1, (frames, channels)) * gains
+        for channel in range(channels):
+            hits = self.rng.choice(frames, channel + 1, replace=False)
+            signal[hits, channel] = np.where(self.rng.random(channel + 1) < 0.5, -1.0, 1.0)
+        if dtype == np.int16:
+            return np.clip(np.round(signal * 32768), -32768, 32767).astype(np.int16)
+        if dtype == np.int32:
+            return np.clip(np.round(signal * 2 ** 31), -2 ** 31, 2 ** 31 - 1).astype(np.int32)
+        return signal.astype(np.float32)
+
+    def _assert_levels(self, samples):
+        """Compare measure_levels() with the NumPy reference."""
+        levels = measure_levels(samples)
+        rms, peak, clipped = _reference(samples)
+        self.assertEqual(len(levels), len(rms))
+        np.testing.assert_allclose([level.rms for level in levels], rms, rtol=1e-4)
+        np.testing.assert_allclose([level.peak for level in levels], peak, rtol=1e-6)
+        self.assertEqual([level.clipped for level in levels], list(clipped))
+
+    def test_FormatsMatchNumpyReference(self):
+        """int16, int32 and float32 blocks give the reference RMS, peak and clip count."""
+        for dtype in (np.int16, np.int32, np.float32):
+            for channels in (1, 2, 4, 8):
+                with self.subTest(dtype=dtype.__name__, channels=channels):
+                    # An odd frame count also leaves a scalar tail after the vectors
+                    self._assert_levels(self._signal(dtype, 4099, channels))
+
+    def test_OddChannelCountsUseScalarFallback(self):
+        """Channel counts that do not divide the vector width are still measured per channel."""
+        for dtype in (np.int16, np.int32, np.float32):
+            for channels in (3, 5, 6):
+                with self.subTest(dtype=dtype.__name__, channels=channels):
+                    self._assert_levels(self._signal(dtype, 1001, channels))
+
+    def test_ClipThresholds(self):
+        """Only samples at full scale count as clipped."""
+        int16 = np.array([32767, -32768, 32766, -32767, 0], dtype=np.int16)
+        self.assertEqual(measure_levels(int16)[0].clipped, 3)
+        int32 = np.array([2 ** 31 - 1, -2 ** 31, 2 ** 30, 0], dtype=np.int32)
+        self.assertEqual(measure_levels(int32)[0].clipped, 2)
+        float32 = np.array([1.0, -1.5, 0.999, 0.0], dtype=np.float32)
+        self.assertEqual(measure_levels(float32)[0].clipped, 2)
+
+    def test_EmptyAndUnsupportedInput(self):
+        """An empty block reads as silence; other dtypes are rejected."""
+        levels = measure_levels(np.zeros((0, 2), dtype=np.int16))
+        self.assertEqual([(level.rms, level.peak, level.clipped) for level in levels],
+                         [(0.0, 0.0, 0), (0.0, 0.0, 0)])
+        with self.assertRaises(ValueError):
+            measure_levels(np.zeros(16, dtype=np.float64))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,134 @@
+"""
+Tests for level callback delivery on the notifier thread.
+"""
+
+import threading
+import time
+import unittest
+import numpy as np
+
+# The C++ extension is driven through a ReplaySource, so no audio hardware is needed
+try:
+    try:
+        from src.audio.audio_capture_cc import AudioCaptureCpp, ReplaySource
+    except ImportError:
+        from koelingo.audio.audio_capture_cc import AudioCaptureCpp, ReplaySource
+    HAS_CPP_IMPL = True
+except ImportError:
+    HAS_CPP_IMPL = False
+
+RATE = 16000
+UPDATE_HZ = 10
+
+
+def _tone_then_silence(tone_seconds, silence_seconds):
+    """A loud sine followed by digital silence."""
+    t = np.arange(int(tone_seconds * RATE)) / RATE
+    tone = 0.5 * np.sin(2 * np.pi * 440 * t)
+    return np.concatenate([tone, np.zeros(int(silence_seconds * RATE))]).astype(np.float32)
+
+
+@unittest.skipUnless(HAS_CPP_IMPL, "needs the C++ extension")
+class LevelNotifierTest(unittest.TestCase):
+    """Test cases for rate-limited level callbacks in AudioCaptureCpp."""
+
+    def setUp(self):
+        """Set up test fixtures."""
+        self.audio = AudioCaptureCpp(RATE, 512, 1)
+        self.assertTrue(self.audio.set_level_update_rate(UPDATE_HZ))
+        self.lock = threading.Lock()
+        self.levels = []
+        self.threads = set()
+        print("Running level notifier tests...")
+
+    def tearDown(self):
+        """Tear down test fixtures."""
+        self.audio.stop_recording()
+
+    def _on_level(self, level):
+        """Record each delivered level and the thread it arrived on."""
+        with self.lock:
+            self.levels.append(level)
+            self.threads.add(threading.get_ident())
+
+    def _start(self, samples, loop=False, callback=None):
+        """Replay samples as fast as the pipeline keeps up."""
+        source = ReplaySource(samples, RATE)
+        source.set_speed(0)
+        source.set_loop(loop)
+        self.assertTrue(self.audio.set_input_source(source))
+        self.assertTrue(self.audio.start_recording(callback or self._on_level))
+
+    def _wait_finished(self, timeout=10.0):
+        """Wait until the replay has delivered every frame."""
+        deadline = time.monotonic() + timeout
+        while not self.audio.input_finished and time.monotonic() < deadline:
+            time.sleep(0.01)
+        return self.audio.input_finished
+
+    def test_CallbacksFollowUpdateRate(self):
+        """A replay far faster than real time still gets at most UPDATE_HZ callbacks per second."""
+        self._start(_tone_then_silence(3.0, 0.0), loop=True)
+        started = time.monotonic()
+        time.sleep(1.5)
+        self.audio.stop_recording()
+        elapsed = time.monotonic() - started
+
+        # Many seconds of audio went through, but updates were coalesced;
+        # one extra is allowed for the first delivery and one for the final one
+        self.assertGreater(self.audio.frames_written, 2 * RATE)
+        with self.lock:
+            count = len(self.levels)
+            threads = set(self.threads)
+        self.assertGreater(count, 1)
+        self.assertLessEqual(count, UPDATE_HZ * elapsed + 2)
+
+        # Every callback came from the single notifier thread
+        self.assertEqual(len(threads), 1)
+        self.assertNotIn(threading.get_ident(), threads)
+
+    def test_FinalLevelIsDeliveredByStop(self):
+        """The level of the last block processed has been delivered when stop_recording() returns."""
+        self._start(_tone_then_silence(3.0, 1.0))
+        self.assertTrue(self._wait_finished())
+        self.audio.stop_recording()
+
+        with self.lock:
+            levels = list(self.levels)
+        self.assertTrue(any(level > 0.5 for level in levels))
+        # The replay ends in a second of silence, which meters as 0.0
+        self.assertEqual(levels[-1], 0.0)
+
+        # Nothing is delivered once stop_recording() has returned
+        time.sleep(0.2)
+        with self.lock:
+            self.assertEqual(len(self.levels), len(levels))
+
+    def test_SlowCallbackDoesNotStallInput(self):
+        """A blocked level callback holds up neither on_input() nor the processing behind it."""
+        release = threading.Event()
+        entered = threading.Event()
+
+        def blocking(level):
+            self._on_level(level)
+            entered.set()
+            # If this ran on the thread calling on_input(), the replay would stop here
+            release.wait(timeout=15.0)
+
+        self._start(_tone_then_silence(3.0, 1.0), callback=blocking)
+        try:
+            self.assertTrue(entered.wait(timeout=5.0))
+            self.assertTrue(self._wait_finished())
+            self.assertEqual(self.audio.frames_written, 4 * RATE)
+        finally:
+            release.set()
+        self.audio.stop_recording()
+
+        with self.lock:
+            threads = set(self.threads)
+        self.assertEqual(len(threads), 1)
+        self.assertNotIn(threading.get_ident(), threads)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,164 @@
+"""
+Tests for the native log-mel front end and its FFT.
+"""
+
+import time
+import unittest
+import numpy as np
+
+# The C++ extension is driven through a ReplaySource, so no audio hardware is needed
+try:
+    try:
+        from src.audio.audio_capture_cc import AudioCaptureCpp, RealFft, ReplaySource
+    except ImportError:
+        from koelingo.audio.audio_capture_cc import AudioCaptureCpp, RealFft, ReplaySource
+    HAS_CPP_IMPL = True
+except ImportError:
+    HAS_CPP_IMPL = False
+
+RATE = 16000
+
+
+def _hz_to_mel(hz):
+    """Slaney mel scale: linear below 1 kHz, logarithmic above."""
+    hz = np.asarray(hz, dtype=np.float64)
+    f_sp = 200.0 / 3
+    log_step = np.log(6.4) / 27.0
+    return np.where(hz < 1000.0, hz / f_sp,
+                    1000.0 / f_sp + np.log(np.maximum(hz, 1000.0) / 1000.0) / log_step)
+
+
+def _mel_to_hz(mel):
+    """Inverse of _hz_to_mel()."""
+    mel = np.asarray(mel, dtype=np.float64)
+    f_sp = 200.0 / 3
+    log_step = np.log(6.4) / 27.0
+    min_log_mel = 1000.0 / f_sp
+    return np.where(mel < min_log_mel, mel * f_sp,
+                    1000.0 * np.exp(log_step * (mel - min_log_mel)))
+
+
+def _mel_filters(n_fft, n_mels):
+    """Slaney-normalized triangular filters, as librosa.filters.mel(htk=False)."""
+    edges = _mel_to_hz(np.linspace(0.0, _hz_to_mel(RATE / 2), n_mels + 2))
+    bins = np.arange(n_fft // 2 + 1) * RATE / n_fft
+    rising = (bins[None, :] - edges[:-2, None]) / np.diff(edges)[:-1, None]
+    falling = (edges[2:, None] - bins[None, :]) / np.diff(edges)[1:, None]
+    weights = np.maximum(0.0, np.minimum(rising, falling))
+    return weights * (2.0 / (edges[2:] - edges[:-2]))[:, None]
+
+
+def _reference_log_mel(samples, n_fft, hop, n_mels):
+    """
+    Log-mel frames whose window lies inside the signal, before Whisper's normalization.
+
+    Frame t is centred on sample t * hop with the start reflect-padded.
+    """
+    padded = np.pad(samples.astype(np.float64), (n_fft // 2, 0), mode='reflect')
+    window = 0.5 - 0.5 * np.cos(2 * np.pi * np.arange(n_fft) / n_fft)
+    frames = (len(padded) - n_fft) // hop + 1
+    stft = np.stack([np.fft.rfft(padded[t * hop:t * hop + n_fft] * window)
+                     for t in range(frames)], axis=1)
+    energy = _mel_filters(n_fft, n_mels) @ (np.abs(stft) ** 2)
+    return np.log10(np.maximum(energy, 1e-10))
+
+
+@unittest.skipUnless(HAS_CPP_IMPL, "needs the C++ extension")
+class RealFftTest(unittest.TestCase):
+    """Test cases for RealFft."""
+
+    def setUp(self):
+        """Set up test fixtures."""
+        self.rng = np.random.default_rng(7)
+        print("Running RealFft tests...")
+
+    def test_ForwardMatchesNumpy(self):
+        """forward() gives the same bins as numpy.fft.rfft for mixed-radix sizes."""
+        for size in (400, 480, 512, 2 * 3 * 5 * 7, 2 * 13):
+            with self.subTest(size=size):
+                samples = self.rng.uniform(-1, 1, size).astype(np.float32)
+                spectrum = RealFft(size).forward(samples)
+                self.assertEqual(spectrum.shape, (size // 2 + 1,))
+                np.testing.assert_allclose(spectrum, np.fft.rfft(samples.astype(np.float64)),
+                                           rtol=0, atol=1e-4 * np.sqrt(size))
+
+    def test_InverseRestoresTheFrame(self):
+        """inverse(forward(x)) == x, including the 1 / size scaling."""
+        for size in (400, 480, 512, 2 * 3 * 5 * 7):
+            with self.subTest(size=size):
+                fft = RealFft(size)
+                samples = self.rng.uniform(-1, 1, size).astype(np.float32)
+                np.testing.assert_allclose(fft.inverse(fft.forward(samples)), samples,
+                                           rtol=0, atol=1e-5)
+
+    def test_OddSizesAreRejected(self):
+        """Only even sizes can be planned."""
+        with self.assertRaises(ValueError):
+            RealFft(401)
+        with self.assertRaises(ValueError):
+            RealFft(400).forward(np.zeros(512, dtype=np.float32))
+
+
+@unittest.skipUnless(HAS_CPP_IMPL, "needs the C++ extension")
+class MelSpectrogramTest(unittest.TestCase):
+    """Test cases for the log-mel frames of AudioCaptureCpp."""
+
+    def setUp(self):
+        """Set up test fixtures."""
+        self.audio = AudioCaptureCpp(RATE, 512, 1)
+        # Two tones over a low noise floor, so every mel bin has energy
+        t = np.arange(2 * RATE) / RATE
+        noise = np.random.default_rng(3).normal(0, 0.01, len(t))
+        self.samples = (0.3 * np.sin(2 * np.pi * 440 * t) + 0.1 * np.sin(2 * np.pi * 2500 * t)
+                        + noise).astype(np.float32)
+        print("Running mel spectrogram tests...")
+
+    def tearDown(self):
+        """Tear down test fixtures."""
+        self.audio.stop_recording()
+
+    def _replay(self, **mel):
+        """Replay the samples with mel frames enabled; returns the (n_mels, frames) array and the config."""
+        config = self.audio.mel_config
+        config.enabled = True
+        for name, value in mel.items():
+            setattr(config, name, value)
+        self.assertTrue(self.audio.set_mel_config(config))
+        source = ReplaySource(self.samples, RATE)
+        source.set_speed(0)
+        self.assertTrue(self.audio.set_input_source(source))
+        self.assertTrue(self.audio.start_recording())
+
+        # Every frame whose window lies inside the signal
+        expected = (len(self.samples) - config.n_fft // 2) // config.hop_length + 1
+        deadline = time.monotonic() + 10.0
+        while self.audio.mel_frames_written < expected and time.monotonic() < deadline:
+            time.sleep(0.01)
+        self.audio.stop_recording()
+
+        frames, start = self.audio.get_mel(0, expected)
+        self.assertEqual(start, 0)
+        self.assertEqual(frames.shape, (config.n_mels, expected))
+        return np.array(frames), config
+
+    def test_FramesMatchNumpyReference(self):
+        """Log-mel frames match a NumPy STFT and Slaney filterbank (n_fft = 400)."""
+        frames, config = self._replay()
+        self.assertEqual((config.n_fft, config.hop_length, config.n_mels), (400, 160, 80))
+        # The capture quantizes to int16, so compare against the samples it actually saw
+        quantized = np.round(self.samples * 32768) / 32768
+        reference = _reference_log_mel(quantized, 400, 160, 80)[:, :frames.shape[1]]
+        np.testing.assert_allclose(frames, reference, rtol=0, atol=0.01)
+
+    def test_OtherSizesMatchNumpyReference(self):
+        """Other window sizes, hops and mel counts follow the same reference."""
+        for n_fft, hop, n_mels in ((480, 160, 128), (512, 256, 80)):
+            with self.subTest(n_fft=n_fft):
+                frames, _ = self._replay(n_fft=n_fft, hop_length=hop, n_mels=n_mels)
+                quantized = np.round(self.samples * 32768) / 32768
+                reference = _reference_log_mel(quantized, n_fft, hop, n_mels)[:, :frames.shape[1]]
+                np.testing.assert_allclose(frames, reference, rtol=0, atol=0.01)
+
+
+if __name__ == "__main__":
+    unittest.main()
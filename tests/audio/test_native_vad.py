@@ -0,0 +1,125 @@
+"""
+Tests for the native voice activity detector and utterance segmentation.
+"""
+
+import time
+import unittest
+import numpy as np
+
+# The C++ extension is driven through a ReplaySource, so no audio hardware is needed
+try:
+    try:
+        from src.audio.audio_capture_cc import AudioCaptureCpp, ReplaySource
+    except ImportError:
+        from koelingo.audio.audio_capture_cc import AudioCaptureCpp, ReplaySource
+    HAS_CPP_IMPL = True
+except ImportError:
+    HAS_CPP_IMPL = False
+
+RATE = 16000
+WINDOW = RATE * 30 // 1000  # Default frame_ms
+
+
+def _signal(*parts):
+    """Build float samples from (seconds, amplitude) parts of silence (0) or a 440 Hz tone."""
+    pieces = []
+    for seconds, amplitude in parts:
+        t = np.arange(int(round(seconds * RATE))) / RATE
+        pieces.append(amplitude * np.sin(2 * np.pi * 440 * t))
+    return np.concatenate(pieces).astype(np.float32)
+
+
+@unittest.skipUnless(HAS_CPP_IMPL, "needs the C++ extension")
+class NativeVadTest(unittest.TestCase):
+    """Test cases for the VAD of AudioCaptureCpp."""
+
+    def setUp(self):
+        """Set up test fixtures."""
+        self.audio = AudioCaptureCpp(RATE, 512, 1)
+        print("Running native VAD tests...")
+
+    def tearDown(self):
+        """Tear down test fixtures."""
+        self.audio.stop_recording()
+
+    def _segment(self, samples, **vad):
+        """Replay samples through the VAD; returns the (samples, start, end, truncated) utterances."""
+        config = self.audio.vad_config
+        config.enabled = True
+        for name, value in vad.items():
+            setattr(config, name, value)
+        self.assertTrue(self.audio.set_vad_config(config))
+        source = ReplaySource(samples, RATE)
+        source.set_speed(0)
+        self.assertTrue(self.audio.set_input_source(source))
+        self.assertTrue(self.audio.start_recording())
+
+        utterances = []
+        deadline = time.monotonic() + 10.0
+        while time.monotonic() < deadline:
+            utterance = self.audio.wait_for_utterance(timeout_ms=500)
+            if utterance is not None:
+                utterances.append(utterance)
+            elif self.audio.input_finished:
+                break
+        self.audio.stop_recording()
+        return utterances
+
+    def test_UtterancesIncludePreRollAndHangover(self):
+        """Each tone becomes one utterance from pre_roll_ms before it to hangover_ms after it."""
+        # Tones start and end on 30 ms window boundaries
+        samples = _signal((2.4, 0), (1.5, 0.25), (3.0, 0), (1.5, 0.25), (2.0, 0))
+        utterances = self._segment(samples)
+
+        self.assertEqual(len(utterances), 2)
+        pre_roll = RATE * 300 // 1000
+        hangover = RATE * 900 // 1000
+        for (data, start, end, truncated), tone_start in zip(utterances, (2.4, 6.9)):
+            tone_start = int(tone_start * RATE)
+            tone_end = tone_start + int(1.5 * RATE)
+            self.assertEqual(start, tone_start - pre_roll)
+            self.assertAlmostEqual(end, tone_end + hangover, delta=WINDOW)
+            self.assertFalse(truncated)
+            self.assertEqual(len(data), end - start)
+            # The samples are the replayed audio at those frames
+            np.testing.assert_allclose(data, samples[start:end], atol=1.0 / 16384)
+
+    def test_ShortBlipsAreNotSpeech(self):
+        """Sound shorter than min_speech_ms never starts an utterance."""
+        samples = _signal((2.4, 0), (0.09, 0.25), (2.0, 0))
+        self.assertEqual(self._segment(samples, min_speech_ms=150), [])
+
+    def test_HangoverBridgesShortPauses(self):
+        """A pause shorter than hangover_ms stays inside the utterance, a longer one splits it."""
+        samples = _signal((2.4, 0), (0.6, 0.25), (0.6, 0), (0.6, 0.25), (2.0, 0))
+
+        merged = self._segment(samples, hangover_ms=900)
+        self.assertEqual(len(merged), 1)
+        self.assertEqual(merged[0][1], int(2.4 * RATE) - RATE * 300 // 1000)
+        self.assertAlmostEqual(merged[0][2], int(4.2 * RATE) + RATE * 900 // 1000, delta=WINDOW)
+
+        split = self._segment(samples, hangover_ms=300)
+        self.assertEqual(len(split), 2)
+        self.assertAlmostEqual(split[0][2], int(3.0 * RATE) + RATE * 300 // 1000, delta=WINDOW)
+        # The second pre-roll does not reach back into the first utterance
+        self.assertGreaterEqual(split[1][1], split[0][2])
+
+    def test_LongUtterancesAreSplit(self):
+        """Speech longer than max_utterance_ms comes out as contiguous truncated pieces."""
+        samples = _signal((2.4, 0), (4.0, 0.25), (2.0, 0))
+        max_frames = 2 * RATE
+        utterances = self._segment(samples, max_utterance_ms=2000)
+
+        self.assertEqual(len(utterances), 3)
+        self.assertEqual(utterances[0][1], int(2.4 * RATE) - RATE * 300 // 1000)
+        self.assertAlmostEqual(utterances[-1][2], int(6.4 * RATE) + RATE * 900 // 1000, delta=WINDOW)
+        self.assertEqual([u[3] for u in utterances], [True, True, False])
+        for previous, following in zip(utterances, utterances[1:]):
+            self.assertEqual(following[1], previous[2])
+        for data, start, end, _ in utterances:
+            self.assertLessEqual(end - start, max_frames + WINDOW)
+            self.assertEqual(len(data), end - start)
+
+
+if __name__ == "__main__":
+    unittest.main()
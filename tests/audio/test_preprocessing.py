@@ -0,0 +1,150 @@
+"""
+Tests for the native noise suppression and gain control ahead of the VAD.
+"""
+
+import time
+import unittest
+import numpy as np
+
+# The C++ extension is driven through a ReplaySource, so no audio hardware is needed
+try:
+    try:
+        from src.audio.audio_capture_cc import AudioCaptureCpp, ReplaySource
+    except ImportError:
+        from koelingo.audio.audio_capture_cc import AudioCaptureCpp, ReplaySource
+    HAS_CPP_IMPL = True
+except ImportError:
+    HAS_CPP_IMPL = False
+
+RATE = 16000
+
+
+def _tone(seconds, amplitude, frequency=440):
+    """Sine of the given amplitude."""
+    t = np.arange(int(seconds * RATE)) / RATE
+    return amplitude * np.sin(2 * np.pi * frequency * t)
+
+
+def _db(value):
+    """Amplitude ratio in dB."""
+    return 20 * np.log10(value)
+
+
+def _rms(samples):
+    """Root mean square of a block."""
+    return np.sqrt(np.mean(np.asarray(samples, dtype=np.float64) ** 2))
+
+
+def _tone_amplitude(samples, start, frequency=440):
+    """Amplitude of a sine at frequency, by least squares; start is the frame index of samples[0]."""
+    t = (start + np.arange(len(samples))) / RATE
+    basis = np.stack([np.sin(2 * np.pi * frequency * t), np.cos(2 * np.pi * frequency * t)], axis=1)
+    coefficients, _, _, _ = np.linalg.lstsq(basis, np.asarray(samples, dtype=np.float64), rcond=None)
+    return np.hypot(*coefficients)
+
+
+@unittest.skipUnless(HAS_CPP_IMPL, "needs the C++ extension")
+class PreprocessingTest(unittest.TestCase):
+    """Test cases for NoiseSuppressor and AutomaticGainControl in AudioCaptureCpp."""
+
+    def setUp(self):
+        """Set up test fixtures."""
+        self.audio = AudioCaptureCpp(RATE, 512, 1)
+        print("Running preprocessing tests...")
+
+    def tearDown(self):
+        """Tear down test fixtures."""
+        self.audio.stop_recording()
+
+    def _process(self, samples, denoise=False, gain=False):
+        """
+        Replay samples and return the preprocessed audio the VAD and STT see.
+
+        A VAD that treats everything as speech turns the whole replay into a
+        single utterance, which is read from the processed ring.
+        """
+        vad = self.audio.vad_config
+        vad.enabled = True
+        vad.energy_threshold = 0.001
+        vad.max_utterance_ms = 20000
+        self.assertTrue(self.audio.set_vad_config(vad))
+        noise = self.audio.noise_suppression_config
+        noise.enabled = denoise
+        self.assertTrue(self.audio.set_noise_suppression_config(noise))
+        control = self.audio.gain_control_config
+        control.enabled = gain
+        self.assertTrue(self.audio.set_gain_control_config(control))
+
+        source = ReplaySource(samples.astype(np.float32), RATE)
+        source.set_speed(0)
+        self.assertTrue(self.audio.set_input_source(source))
+        self.assertTrue(self.audio.start_recording())
+        deadline = time.monotonic() + 10.0
+        while not self.audio.input_finished and time.monotonic() < deadline:
+            time.sleep(0.01)
+        # Stopping flushes the utterance in progress
+        self.audio.stop_recording()
+
+        utterance = self.audio.wait_for_utterance(timeout_ms=500, dtype='float32')
+        self.assertIsNotNone(utterance)
+        data, start, end, _ = utterance
+        self.assertIsNone(self.audio.wait_for_utterance(timeout_ms=0))
+        self.assertEqual(len(data), end - start)
+        # The whole replay, less the frames still inside the suppressor
+        self.assertLessEqual(start, RATE // 10)
+        self.assertGreaterEqual(end, len(samples) - self.audio.preprocessing_latency_frames - RATE // 10)
+        return data, start
+
+    def test_NoiseFloorIsAttenuatedAndToneSurvives(self):
+        """Once the estimate has settled, steady noise is reduced while a tone over it passes."""
+        noise = np.random.default_rng(5).uniform(-0.05, 0.05, 6 * RATE)
+        samples = noise.copy()
+        samples[3 * RATE:] += _tone(3.0, 0.2)[:3 * RATE]
+        data, start = self._process(samples, denoise=True)
+
+        # Frame indices are kept, so output frame i is the denoised input frame i
+        settled = slice(int(1.5 * RATE) - start, 3 * RATE - start)
+        self.assertLess(_db(_rms(data[settled]) / _rms(noise[int(1.5 * RATE):3 * RATE])), -4.0)
+
+        steady = slice(int(3.5 * RATE) - start, int(5.5 * RATE) - start)
+        self.assertAlmostEqual(_tone_amplitude(data[steady], int(3.5 * RATE)), 0.2, delta=0.01)
+
+        self.assertGreater(self.audio.get_stats().denoise_time.count, 0)
+
+    def test_QuietSpeechIsRaisedTowardsTarget(self):
+        """A quiet tone is brought to target_db when max_gain_db allows it."""
+        config = self.audio.gain_control_config
+        samples = _tone(4.0, 0.05)  # -29 dBFS RMS
+        data, start = self._process(samples, gain=True)
+
+        settled = data[2 * RATE - start:]
+        self.assertAlmostEqual(_db(_rms(settled)), config.target_db, delta=1.0)
+        self.assertLess(np.max(np.abs(data)), 10 ** (config.limit_db / 20))
+
+        self.assertGreater(self.audio.get_stats().agc_time.count, 0)
+
+    def test_GainStopsAtMaxGain(self):
+        """A signal too quiet for the target gets at most max_gain_db."""
+        config = self.audio.gain_control_config
+        samples = _tone(4.0, 0.02)  # -37 dBFS RMS
+        data, start = self._process(samples, gain=True)
+
+        settled = data[2 * RATE - start:]
+        gain_db = _db(_rms(settled) / _rms(samples[2 * RATE:]))
+        self.assertLessEqual(gain_db, config.max_gain_db + 0.2)
+        self.assertGreater(gain_db, config.max_gain_db - 1.0)
+        self.assertLess(_db(_rms(settled)), config.target_db)
+
+    def test_LoudSignalsAreNotClipped(self):
+        """A near full-scale tone is turned down and stays under limit_db."""
+        config = self.audio.gain_control_config
+        samples = _tone(4.0, 0.9)
+        data, start = self._process(samples, gain=True)
+
+        self.assertLess(np.max(np.abs(data)), 10 ** (config.limit_db / 20))
+        settled = data[2 * RATE - start:]
+        self.assertLess(_db(_rms(settled)), _db(_rms(samples)) - 6.0)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,95 @@
+"""
+Tests for real-time scheduling requests on the capture threads.
+"""
+
+import time
+import unittest
+import numpy as np
+
+from src.audio.pybind import AudioCapture
+
+# The replay runs through the C++ extension, so no audio hardware is needed
+try:
+    try:
+        from src.audio.audio_capture_cc import ThreadPolicy
+    except ImportError:
+        from koelingo.audio.audio_capture_cc import ThreadPolicy
+    HAS_CPP_IMPL = True
+except ImportError:
+    HAS_CPP_IMPL = False
+
+RATE = 16000
+
+
+@unittest.skipUnless(HAS_CPP_IMPL, "needs the C++ extension")
+class RealtimeTest(unittest.TestCase):
+    """Test cases for AudioCapture.set_realtime() and get_realtime_report()."""
+
+    def setUp(self):
+        """Set up test fixtures."""
+        self.audio = AudioCapture(sample_rate=RATE, chunk_size=512)
+        self.samples = (np.arange(2 * RATE) % 2000 - 1000).astype(np.int16)
+        print("Running realtime tests...")
+
+    def tearDown(self):
+        """Tear down test fixtures."""
+        self.audio.stop_recording()
+
+    def _assert_policy_result(self, result):
+        """A policy result has the documented keys, and says why realtime was not applied."""
+        self.assertEqual(set(result), {'realtime', 'pinned', 'error'})
+        self.assertIsInstance(result['realtime'], bool)
+        self.assertIsInstance(result['pinned'], bool)
+        self.assertIsInstance(result['error'], str)
+        if not result['realtime']:
+            self.assertNotEqual(result['error'], '')
+
+    def test_RecordingWorksWhateverThePrivileges(self):
+        """Frames still arrive when real-time scheduling is refused, and the report says why."""
+        self.assertTrue(self.audio.set_realtime(True, processing_cpus=[0]))
+        self.assertTrue(self.audio.set_replay_source(self.samples, speed=0))
+        self.assertTrue(self.audio.start_recording())
+
+        deadline = time.monotonic() + 10.0
+        while not self.audio.replay_finished and time.monotonic() < deadline:
+            time.sleep(0.01)
+        self.audio.stop_recording()
+
+        self.assertTrue(self.audio.replay_finished)
+        data, start, next_cursor = self.audio.read_new(0)
+        self.assertEqual((start, next_cursor), (0, len(self.samples)))
+        np.testing.assert_array_equal(data, self.samples)
+
+        report = self.audio.get_realtime_report()
+        print(f"Realtime report: {report}")
+        self.assertEqual(set(report), {'processing', 'capture', 'memory_locked', 'memory_error'})
+        # The replay thread takes on the capture policy with its first period
+        self._assert_policy_result(report['processing'])
+        self._assert_policy_result(report['capture'])
+        self.assertIsInstance(report['memory_locked'], bool)
+        self.assertIsInstance(report['memory_error'], str)
+
+        # Only the processing thread was asked to pin
+        if not report['processing']['pinned']:
+            self.assertNotEqual(report['processing']['error'], '')
+        self.assertFalse(report['capture']['pinned'])
+
+    def test_SettingsAreRefusedWhileRecording(self):
+        """set_realtime() only takes effect between recordings."""
+        self.assertTrue(self.audio.set_replay_source(self.samples, speed=0))
+        self.assertTrue(self.audio.start_recording())
+        try:
+            self.assertFalse(self.audio.set_realtime(True, processing_cpus=[0]))
+        finally:
+            self.audio.stop_recording()
+        self.assertTrue(self.audio.set_realtime(False))
+
+    def test_ThreadPolicyDefaultsToNoChange(self):
+        """A default ThreadPolicy asks for neither realtime nor pinning."""
+        policy = ThreadPolicy()
+        self.assertFalse(policy.realtime)
+        self.assertEqual(list(policy.cpus), [])
+
+
+if __name__ == "__main__":
+    unittest.main()
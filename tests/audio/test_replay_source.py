@@ -0,0 +1,136 @@
+"""
+Tests for replaying recorded audio through the capture pipeline.
+"""
+
+import gc
+import os
+import tempfile
+import time
+import unittest
+import wave
+import numpy as np
+
+# Exercise the Python implementation directly so no audio hardware is needed
+from src.audio.audio_capture import AudioCapture
+from src.audio.pybind import AudioCapture as WrappedAudioCapture
+
+# The native arrays are checked through the wrapper when the extension is built
+try:
+    try:
+        from src.audio.audio_capture_cc import AudioCaptureCpp
+    except ImportError:
+        from koelingo.audio.audio_capture_cc import AudioCaptureCpp
+    HAS_CPP_IMPL = True
+except ImportError:
+    HAS_CPP_IMPL = False
+
+
+class ReplaySourceTest(unittest.TestCase):
+    """Test cases for AudioCapture.set_replay_source() in the Python implementation."""
+
+    def setUp(self):
+        """Set up test fixtures."""
+        self.audio = AudioCapture(sample_rate=16000, chunk_size=256)
+        self.samples = (np.arange(16000 * 3) % 2000 - 1000).astype(np.int16)
+        print("Running replay source tests...")
+
+    def tearDown(self):
+        """Tear down test fixtures."""
+        self.audio.stop_recording()
+
+    def _replay_to_end(self):
+        """Start recording and wait until the replay has finished."""
+        self.assertTrue(self.audio.start_recording())
+        deadline = time.monotonic() + 10.0
+        while not self.audio.replay_finished and time.monotonic() < deadline:
+            time.sleep(0.01)
+        self.assertTrue(self.audio.replay_finished)
+
+    def test_ReplaysWavFileAsFastAsPossible(self):
+        """Every frame of a WAV file arrives, in order, without pacing."""
+        with tempfile.TemporaryDirectory() as directory:
+            path = os.path.join(directory, 'speech.wav')
+            with wave.open(path, 'wb') as wav:
+                wav.setnchannels(1)
+                wav.setsampwidth(2)
+                wav.setframerate(16000)
+                wav.writeframes(self.samples.tobytes())
+
+            self.assertTrue(self.audio.set_replay_source(path, speed=0))
+            started = time.monotonic()
+            self._replay_to_end()
+
+        self.assertLess(time.monotonic() - started, 3.0)
+        self.assertEqual(self.audio.frames_written, len(self.samples))
+        np.testing.assert_array_equal(self.audio.get_buffer_as_numpy(), self.samples)
+
+    def test_ReplaysArrayFasterThanRealTime(self):
+        """A float array replayed at 20x takes about a twentieth of its length."""
+        self.assertTrue(self.audio.set_replay_source(self.samples / 32768.0, speed=20))
+        started = time.monotonic()
+        self._replay_to_end()
+
+        self.assertGreater(time.monotonic() - started, 0.1)
+        self.assertEqual(self.audio.frames_written, len(self.samples))
+
+    def test_RejectsMismatchedFormat(self):
+        """Audio at another rate or channel count is rejected."""
+        self.assertFalse(self.audio.set_replay_source(self.samples, sample_rate=48000))
+        self.assertFalse(self.audio.set_replay_source(np.zeros((100, 2), dtype=np.int16)))
+        self.assertFalse(self.audio.set_replay_source(self.samples, speed=-1))
+
+    def test_Float32BufferIsNormalizedInt16(self):
+        """The float32 buffer is the int16 buffer scaled by 1/32768."""
+        self.assertTrue(self.audio.set_replay_source(self.samples, speed=0))
+        self._replay_to_end()
+
+        int16 = self.audio.get_buffer_as_numpy()
+        float32 = self.audio.get_buffer_as_numpy(dtype=np.float32)
+        self.assertEqual(float32.dtype, np.float32)
+        np.testing.assert_array_equal(float32, int16 / 32768.0)
+
+
+@unittest.skipUnless(HAS_CPP_IMPL, "needs the C++ extension")
+class NativeReplayBufferTest(unittest.TestCase):
+    """Test cases for the NumPy buffers of a replayed AudioCaptureCpp."""
+
+    def setUp(self):
+        """Set up test fixtures."""
+        self.audio = WrappedAudioCapture(sample_rate=16000, chunk_size=256)
+        self.samples = (np.arange(16000 * 3) % 2000 - 1000).astype(np.int16)
+        print("Running native replay buffer tests...")
+
+    def tearDown(self):
+        """Tear down test fixtures."""
+        if self.audio is not None:
+            self.audio.stop_recording()
+
+    def test_BuffersOutliveTheCapture(self):
+        """int16 and float32 arrays agree and stay valid once the capture is gone."""
+        self.assertTrue(self.audio.using_cpp_implementation)
+        self.assertIsInstance(self.audio._impl, AudioCaptureCpp)
+        self.assertTrue(self.audio.set_replay_source(self.samples, speed=0))
+        self.assertTrue(self.audio.start_recording())
+        deadline = time.monotonic() + 10.0
+        while not self.audio.replay_finished and time.monotonic() < deadline:
+            time.sleep(0.01)
+        self.audio.stop_recording()
+        self.assertTrue(self.audio.replay_finished)
+
+        int16 = self.audio.get_buffer_as_numpy()
+        float32 = self.audio.get_buffer_as_numpy(dtype=np.float32)
+        np.testing.assert_array_equal(int16, self.samples)
+        self.assertEqual(float32.dtype, np.float32)
+        np.testing.assert_array_equal(float32, int16 / 32768.0)
+
+        # The capsules own the memory, not the capture
+        self.audio = None
+        gc.collect()
+        churn = [np.full(len(self.samples), 12345, dtype=np.int16) for _ in range(8)]
+        np.testing.assert_array_equal(int16, self.samples)
+        np.testing.assert_array_equal(float32, self.samples / 32768.0)
+        del churn
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,101 @@
+"""
+Tests for in-engine resampling of sources at another rate or channel count.
+"""
+
+import time
+import unittest
+import numpy as np
+
+# The C++ extension is driven through a ReplaySource, so no audio hardware is needed
+try:
+    try:
+        from src.audio.audio_capture_cc import AudioCaptureCpp, ReplaySource
+    except ImportError:
+        from koelingo.audio.audio_capture_cc import AudioCaptureCpp, ReplaySource
+    HAS_CPP_IMPL = True
+except ImportError:
+    HAS_CPP_IMPL = False
+
+RATE = 16000
+
+
+def _tone(rate, seconds, amplitude, frequency=1000):
+    """Sine of the given amplitude sampled at rate."""
+    t = np.arange(int(seconds * rate)) / rate
+    return (amplitude * np.sin(2 * np.pi * frequency * t)).astype(np.float32)
+
+
+@unittest.skipUnless(HAS_CPP_IMPL, "needs the C++ extension")
+class ResamplingTest(unittest.TestCase):
+    """Test cases for the Resampler behind a 16 kHz mono AudioCaptureCpp."""
+
+    def setUp(self):
+        """Set up test fixtures."""
+        self.audio = AudioCaptureCpp(RATE, 512, 1)
+        print("Running resampling tests...")
+
+    def tearDown(self):
+        """Tear down test fixtures."""
+        self.audio.stop_recording()
+
+    def _capture(self, samples, rate):
+        """Replay samples at rate; returns the 16 kHz float32 frames and the resampler latency."""
+        source = ReplaySource(samples, rate)
+        source.set_speed(0)
+        self.assertTrue(self.audio.set_input_source(source))
+        self.assertTrue(self.audio.start_recording())
+        deadline = time.monotonic() + 10.0
+        while not self.audio.input_finished and time.monotonic() < deadline:
+            time.sleep(0.01)
+        self.audio.stop_recording()
+        self.assertTrue(self.audio.input_finished)
+        self.assertEqual(self.audio.device_sample_rate, rate)
+
+        frames, start, _ = self.audio.read_new(0, 0, dtype='float32')
+        self.assertEqual(start, 0)
+        return frames, self.audio.resampler_latency_frames
+
+    def _assert_tone(self, frames, latency, amplitude, frequency=1000):
+        """Check that frames after the filter delay hold one tone of that frequency and amplitude."""
+        steady = frames[latency + 64:latency + 64 + RATE].astype(np.float64)
+        self.assertEqual(len(steady), RATE)
+
+        spectrum = np.abs(np.fft.rfft(steady * np.hanning(len(steady))))
+        self.assertAlmostEqual(np.argmax(spectrum) * RATE / len(steady), frequency, delta=1.0)
+
+        # Least-squares fit of a sine at that frequency
+        t = np.arange(len(steady)) / RATE
+        basis = np.stack([np.sin(2 * np.pi * frequency * t), np.cos(2 * np.pi * frequency * t)], axis=1)
+        coefficients, _, _, _ = np.linalg.lstsq(basis, steady, rcond=None)
+        self.assertAlmostEqual(np.hypot(*coefficients), amplitude, delta=0.01)
+        self.assertLess(np.max(np.abs(steady - basis @ coefficients)), 0.01)
+
+    def test_FrameCountFollowsTheRateRatio(self):
+        """Two seconds at 48 kHz or 44.1 kHz become two seconds at 16 kHz."""
+        for rate in (48000, 44100):
+            with self.subTest(rate=rate):
+                frames, latency = self._capture(_tone(rate, 2.0, 0.5), rate)
+                self.assertGreater(latency, 0)
+                self.assertAlmostEqual(len(frames), 2 * RATE, delta=2)
+                self.assertEqual(self.audio.frames_written, len(frames))
+
+    def test_ToneKeepsFrequencyAndAmplitude(self):
+        """A 1 kHz tone comes out at 1 kHz and the same level once the filter has settled."""
+        for rate in (48000, 44100):
+            with self.subTest(rate=rate):
+                frames, latency = self._capture(_tone(rate, 2.0, 0.5), rate)
+                self._assert_tone(frames, latency, 0.5)
+
+    def test_StereoIsDownmixedToMono(self):
+        """Channels are averaged, so opposite channels cancel and unequal ones meet halfway."""
+        tone = _tone(48000, 2.0, 1.0)
+        frames, latency = self._capture(np.stack([0.8 * tone, 0.2 * tone], axis=1), 48000)
+        self.assertAlmostEqual(len(frames), 2 * RATE, delta=2)
+        self._assert_tone(frames, latency, 0.5)
+
+        frames, latency = self._capture(np.stack([0.5 * tone, -0.5 * tone], axis=1), 48000)
+        self.assertLess(np.max(np.abs(frames)), 1.0 / 8192)
+
+
+if __name__ == "__main__":
+    unittest.main()
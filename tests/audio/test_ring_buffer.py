@@ -0,0 +1,104 @@
+"""
+Tests for reading the native ring buffer after it has wrapped.
+"""
+
+import time
+import unittest
+import numpy as np
+
+# The C++ extension is driven through a ReplaySource, so no audio hardware is needed
+try:
+    try:
+        from src.audio.audio_capture_cc import AudioCaptureCpp, ReplaySource
+    except ImportError:
+        from koelingo.audio.audio_capture_cc import AudioCaptureCpp, ReplaySource
+    HAS_CPP_IMPL = True
+except ImportError:
+    HAS_CPP_IMPL = False
+
+RATE = 16000
+
+
+def _ramp(frames):
+    """int16 samples that identify their frame index modulo 65536."""
+    return (np.arange(frames) % 65536 - 32768).astype(np.int16)
+
+
+@unittest.skipUnless(HAS_CPP_IMPL, "needs the C++ extension")
+class RingBufferTest(unittest.TestCase):
+    """Test cases for read_new() on a ring that has been overwritten."""
+
+    def setUp(self):
+        """Set up test fixtures."""
+        self.audio = AudioCaptureCpp(RATE, 512, 1)
+        print("Running ring buffer tests...")
+
+    def tearDown(self):
+        """Tear down test fixtures."""
+        self.audio.stop_recording()
+
+    def _replay_past_capacity(self, extra_seconds):
+        """Replay a ramp extra_seconds longer than the ring; returns (samples, capacity)."""
+        capacity = self.audio.get_stats().ring_capacity_frames
+        self.assertGreater(capacity, 0)
+        samples = _ramp(capacity + int(extra_seconds * RATE))
+
+        # Every ramp value is exactly representable, so the capture stores it unchanged
+        source = ReplaySource(samples.astype(np.float32) / 32768, RATE)
+        source.set_speed(0)
+        self.assertTrue(self.audio.set_input_source(source))
+        self.assertTrue(self.audio.start_recording())
+        deadline = time.monotonic() + 30.0
+        while not self.audio.input_finished and time.monotonic() < deadline:
+            time.sleep(0.01)
+        self.audio.stop_recording()
+        self.assertTrue(self.audio.input_finished)
+        self.assertEqual(self.audio.frames_written, len(samples))
+        return samples, capacity
+
+    def test_StaleCursorResumesAtOldestFrame(self):
+        """A cursor the ring has moved past resumes at the oldest retained frame."""
+        samples, capacity = self._replay_past_capacity(10.0)
+        oldest = len(samples) - capacity
+
+        for cursor in (0, oldest // 2, oldest - 1):
+            with self.subTest(cursor=cursor):
+                data, start, next_cursor = self.audio.read_new(cursor)
+                self.assertEqual(start, oldest)
+                self.assertEqual(next_cursor, len(samples))
+                np.testing.assert_array_equal(data, samples[oldest:])
+
+        # A cursor that is still retained is honoured
+        data, start, next_cursor = self.audio.read_new(oldest + 5, max_frames=3)
+        self.assertEqual((start, next_cursor), (oldest + 5, oldest + 8))
+        np.testing.assert_array_equal(data, samples[oldest + 5:oldest + 8])
+
+    def test_SamplesAreContinuousAcrossTheWrap(self):
+        """Reads that straddle the physical end of the ring come back in order."""
+        samples, capacity = self._replay_past_capacity(10.5)
+        oldest = len(samples) - capacity
+
+        # Odd block sizes so one of the reads spans the wrap point
+        pieces = []
+        cursor = oldest
+        while cursor < len(samples):
+            data, start, next_cursor = self.audio.read_new(cursor, max_frames=7919)
+            self.assertEqual(start, cursor)
+            self.assertEqual(len(data), next_cursor - cursor)
+            pieces.append(data)
+            cursor = next_cursor
+        data = np.concatenate(pieces)
+
+        self.assertEqual(len(data), capacity)
+        np.testing.assert_array_equal(data, samples[oldest:])
+        steps = np.diff(data.astype(np.int32)) % 65536
+        self.assertTrue(np.all(steps == 1))
+
+        # float32 reads follow the same frames
+        floats, start, _ = self.audio.read_new(0, dtype='float32')
+        self.assertEqual(start, oldest)
+        np.testing.assert_array_equal(floats, samples[oldest:].astype(np.float32) / 32768)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,65 @@
+"""
+Tests for the speech onset signal and pre-roll in continuous mode.
+"""
+
+import time
+import unittest
+import numpy as np
+
+# Exercise the Python implementation directly so no audio hardware is needed
+from src.audio.audio_capture import AudioCapture
+
+
+class SpeechOnsetTest(unittest.TestCase):
+    """Test cases for speech_onset_callback and pre_roll_ms in the Python implementation."""
+
+    def setUp(self):
+        """Set up test fixtures."""
+        self.rate = 16000
+        self.audio = AudioCapture(sample_rate=self.rate, chunk_size=512)
+        self.onsets = []
+        self.utterances = []
+
+        # Silence, speech at 3.0-4.5 s, silence, speech at 8.0-9.5 s, silence
+        tone = (8000 * np.sin(2 * np.pi * 440 * np.arange(int(1.5 * self.rate)) / self.rate))
+        self.samples = np.concatenate([
+            np.zeros(3 * self.rate), tone, np.zeros(int(3.5 * self.rate)), tone,
+            np.zeros(int(2.5 * self.rate))]).astype(np.int16)
+        print("Running speech onset tests...")
+
+    def tearDown(self):
+        """Tear down test fixtures."""
+        self.audio.stop_recording()
+
+    def _replay(self):
+        """Replay the test signal in continuous mode and wait for the end."""
+        self.assertTrue(self.audio.set_replay_source(self.samples, speed=0))
+        self.assertTrue(self.audio.start_recording(
+            chunk_processing_callback=self.utterances.append,
+            continuous_mode=True,
+            speech_onset_callback=self.onsets.append))
+        deadline = time.monotonic() + 10.0
+        while not self.audio.replay_finished and time.monotonic() < deadline:
+            time.sleep(0.01)
+        time.sleep(0.2)
+        self.audio.stop_recording()
+
+    def test_OnsetFiresOncePerSpeechAfterIdle(self):
+        """Each utterance that follows silence raises one onset at its first frame."""
+        self._replay()
+        self.assertEqual(len(self.onsets), 2)
+        self.assertAlmostEqual(self.onsets[0] / self.rate, 3.0, delta=0.05)
+        self.assertAlmostEqual(self.onsets[1] / self.rate, 8.0, delta=0.05)
+
+    def test_UtteranceKeepsOnlyThePreRoll(self):
+        """Leading silence is trimmed to pre_roll_ms instead of being transcribed."""
+        self._replay()
+        self.assertGreaterEqual(len(self.utterances), 1)
+        speech = int(1.5 * self.rate)
+        first = len(self.utterances[0])
+        self.assertGreaterEqual(first, speech)
+        self.assertLess(first, speech + int(0.4 * self.rate) + self.audio.silence_chunks * 512 + 512)
+
+
+if __name__ == "__main__":
+    unittest.main()
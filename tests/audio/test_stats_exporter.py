@@ -0,0 +1,120 @@
+"""
+Tests for capture pipeline statistics and their Prometheus/statsd export.
+"""
+
+import socket
+import unittest
+import urllib.request
+import numpy as np
+import pyaudio
+
+# Exercise the Python implementation directly so chunks can be injected
+# through the stream callback without audio hardware
+from src.audio.audio_capture import AudioCapture
+from src.audio.stats_exporter import PrometheusExporter, StatsdExporter, format_prometheus
+
+
+def _histogram(*values_us):
+    """Build a get_stats() histogram entry from raw durations."""
+    buckets = [0] * 32
+    for value in values_us:
+        buckets[value.bit_length()] += 1
+    return {'count': len(values_us), 'sum_us': sum(values_us), 'max_us': max(values_us),
+            'p50_us': 0, 'p99_us': 0, 'buckets': buckets}
+
+
+class _FakeCapture:
+    """Stands in for an AudioCapture with fixed statistics."""
+
+    def __init__(self, stats):
+        self.stats = stats
+
+    def get_stats(self):
+        return self.stats
+
+
+class CaptureStatsTest(unittest.TestCase):
+    """Test cases for AudioCapture.get_stats() in the Python implementation."""
+
+    def setUp(self):
+        """Set up test fixtures."""
+        self.audio = AudioCapture(sample_rate=8, chunk_size=4)
+        self.audio.is_recording = True
+        print("Running capture statistics tests...")
+
+    def tearDown(self):
+        """Tear down test fixtures."""
+        self.audio.is_recording = False
+
+    def _push(self, status=0):
+        """Feed one chunk through the stream callback."""
+        data = np.zeros(4, dtype=np.int16).tobytes()
+        self.audio._audio_callback(data, 4, None, status)
+
+    def test_CountsCallbacksAndXruns(self):
+        """Callbacks and overflow/underflow flags are counted."""
+        self._push()
+        self._push(pyaudio.paInputOverflow)
+        self._push(pyaudio.paInputUnderflow | pyaudio.paInputOverflow)
+
+        stats = self.audio.get_stats()
+        self.assertEqual(stats['callbacks'], 3)
+        self.assertEqual(stats['input_overflows'], 2)
+        self.assertEqual(stats['input_underflows'], 1)
+        self.assertEqual(stats['frames_captured'], 12)
+        self.assertEqual(stats['ring_backlog_frames'], 12)
+
+
+class StatsExporterTest(unittest.TestCase):
+    """Test cases for the Prometheus and statsd exporters."""
+
+    def setUp(self):
+        """Set up test fixtures."""
+        self.stats = {'callbacks': 10, 'input_overflows': 2, 'ring_backlog_frames': 256,
+                      'callback_duration': _histogram(3, 20, 20)}
+
+    def test_FormatsPrometheus(self):
+        """Counters, gauges and cumulative histogram buckets are rendered."""
+        text = format_prometheus({'booth "a"': self.stats})
+        self.assertIn('koelingo_audio_input_overflows_total{capture="booth \\"a\\""} 2', text)
+        self.assertIn('koelingo_audio_ring_backlog_frames{capture="booth \\"a\\""} 256', text)
+        self.assertIn('# TYPE koelingo_audio_callback_duration_seconds histogram', text)
+        # 3 us falls below 4 us, and both 20 us values below 32 us
+        self.assertIn('callback_duration_seconds_bucket{capture="booth \\"a\\"",le="4e-06"} 1', text)
+        self.assertIn('callback_duration_seconds_bucket{capture="booth \\"a\\"",le="3.2e-05"} 3', text)
+        self.assertIn('callback_duration_seconds_count{capture="booth \\"a\\""} 3', text)
+        self.assertNotIn('input_latency_seconds_count', text)
+
+    def test_ServesMetrics(self):
+        """The HTTP endpoint serves the exposition text."""
+        exporter = PrometheusExporter(port=0)
+        exporter.add('booth', _FakeCapture(self.stats))
+        exporter.start()
+        try:
+            with urllib.request.urlopen(f'http://127.0.0.1:{exporter.port}/metrics') as response:
+                body = response.read().decode('utf-8')
+        finally:
+            exporter.stop()
+        self.assertIn('koelingo_audio_callbacks_total{capture="booth"} 10', body)
+
+    def test_SendsStatsdDeltas(self):
+        """Counters are sent as increases since the previous flush."""
+        receiver = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        receiver.bind(('127.0.0.1', 0))
+        receiver.settimeout(2.0)
+        capture = _FakeCapture(dict(self.stats))
+        exporter = StatsdExporter(port=receiver.getsockname()[1])
+        exporter.add('booth', capture)
+        try:
+            exporter.flush()
+            first = receiver.recv(65536).decode('utf-8').split('\n')
+            capture.stats['callbacks'] = 15
+            self.assertIn('koelingo.audio.booth.callbacks:5|c', exporter.flush())
+        finally:
+            receiver.close()
+        self.assertIn('koelingo.audio.booth.callbacks:10|c', first)
+        self.assertIn('koelingo.audio.booth.ring_backlog_frames:256|g', first)
+
+
+if __name__ == '__main__':
+    unittest.main()
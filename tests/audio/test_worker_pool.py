@@ -0,0 +1,87 @@
+"""
+Tests for sharing one processing pool between several captures.
+"""
+
+import time
+import unittest
+import numpy as np
+
+from src.audio.pybind import AudioCapture, create_worker_pool
+
+# Both captures replay arrays through the C++ extension, so no audio hardware is needed
+try:
+    try:
+        from src.audio.audio_capture_cc import WorkerPool
+    except ImportError:
+        from koelingo.audio.audio_capture_cc import WorkerPool
+    HAS_CPP_IMPL = True
+except ImportError:
+    HAS_CPP_IMPL = False
+
+RATE = 16000
+
+
+@unittest.skipUnless(HAS_CPP_IMPL, "needs the C++ extension")
+class WorkerPoolTest(unittest.TestCase):
+    """Test cases for AudioCapture.set_worker_pool()."""
+
+    def setUp(self):
+        """Set up test fixtures."""
+        self.pool = create_worker_pool(1)
+        self.captures = [AudioCapture(sample_rate=RATE, chunk_size=512) for _ in range(2)]
+        rng = np.random.default_rng(3)
+        self.samples = [rng.integers(-20000, 20000, 3 * RATE).astype(np.int16)
+                        for _ in self.captures]
+        print("Running worker pool tests...")
+
+    def tearDown(self):
+        """Tear down test fixtures."""
+        for audio in self.captures:
+            audio.stop_recording()
+
+    def test_TwoCapturesShareOneThread(self):
+        """Two replays on a single pool thread both keep every frame."""
+        self.assertIsInstance(self.pool, WorkerPool)
+        self.assertEqual(self.pool.thread_count, 1)
+
+        for audio, samples in zip(self.captures, self.samples):
+            self.assertTrue(audio.set_worker_pool(self.pool))
+            self.assertTrue(audio.set_replay_source(samples, speed=0))
+        for audio in self.captures:
+            # Levels give the pool thread some work for every block
+            self.assertTrue(audio.start_recording(lambda level: None))
+
+        deadline = time.monotonic() + 10.0
+        while (not all(audio.replay_finished for audio in self.captures)
+               and time.monotonic() < deadline):
+            time.sleep(0.01)
+        for audio in self.captures:
+            audio.stop_recording()
+
+        for index, (audio, samples) in enumerate(zip(self.captures, self.samples)):
+            with self.subTest(capture=index):
+                self.assertTrue(audio.replay_finished)
+                data, start, next_cursor = audio.read_new(0)
+                self.assertEqual((start, next_cursor), (0, len(samples)))
+                np.testing.assert_array_equal(data, samples)
+
+                stats = audio.get_stats()
+                self.assertEqual(stats['dropped_frames'], 0)
+                self.assertGreater(stats['processing_latency']['count'], 0)
+
+    def test_PoolCannotChangeWhileRecording(self):
+        """set_worker_pool() is refused until the capture has stopped."""
+        audio = self.captures[0]
+        self.assertTrue(audio.set_replay_source(self.samples[0], speed=0))
+        self.assertTrue(audio.start_recording())
+        try:
+            self.assertFalse(audio.set_worker_pool(self.pool))
+            self.assertFalse(audio.set_worker_pool(None))
+        finally:
+            audio.stop_recording()
+        self.assertTrue(audio.set_worker_pool(self.pool))
+        self.assertTrue(audio.set_worker_pool(None))
+
+
+if __name__ == "__main__":
+    unittest.main()
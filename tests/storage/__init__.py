@@ -0,0 +1,5 @@
+"""
+Tests for the Storage module.
+
+This module contains test cases for the append-only transcript store.
+"""
@@ -0,0 +1,100 @@
+"""
+Tests for the append-only transcript store.
+"""
+
+import os
+import shutil
+import tempfile
+import unittest
+
+from src.storage.transcript_store import TranscriptStore
+
+
+class TranscriptStoreTest(unittest.TestCase):
+    """Test cases for TranscriptStore."""
+
+    def setUp(self):
+        """Create an empty store directory."""
+        self.root = tempfile.mkdtemp()
+        print("Running transcript store tests...")
+
+    def tearDown(self):
+        """Remove the store directory."""
+        shutil.rmtree(self.root)
+
+    def fill(self, store, session, count):
+        for i in range(count):
+            store.append(session, f"発話{i}", start_frame=i * 16000, end_frame=i * 16000 + 8000,
+                         confidence=0.5, translation=f"utterance {i}", audio_offset=i * 16000)
+        self.assertTrue(store.flush(timeout=5))
+
+    def test_PersistsAcrossReopen(self):
+        """Sessions and entries, with their frame ranges, survive a reopen."""
+        with TranscriptStore(self.root) as store:
+            session = store.begin_session("meeting", audio_path="meeting.wav", sample_rate=16000)
+            self.fill(store, session, 5)
+
+        with TranscriptStore(self.root) as store:
+            (info,) = store.sessions()
+            self.assertEqual((info.name, info.audio_path, info.entries), ("meeting", "meeting.wav", 5))
+            entries = list(store.entries(info.session_id))
+            self.assertEqual([e.text for e in entries], [f"発話{i}" for i in range(5)])
+            self.assertEqual((entries[2].start, entries[2].end), (2.0, 2.5))
+            self.assertEqual(entries[2].audio_offset, 32000)
+            self.assertAlmostEqual(entries[2].confidence, 0.5)
+            self.assertEqual(store.begin_session(), info.session_id + 1)
+
+    def test_GroupsCommitsAndRollsSegments(self):
+        """Queued appends share commits, and full segments roll over."""
+        with TranscriptStore(self.root, segment_bytes=4096, sync=False) as store:
+            first = store.begin_session("a")
+            second = store.begin_session("b")
+            for i in range(100):
+                store.append(first, f"a{i}")
+                store.append(second, f"b{i}")
+            self.assertTrue(store.flush(timeout=5))
+            stats = store.get_stats()
+
+        self.assertEqual(stats['records'], 202)
+        self.assertLess(stats['commits'], 202)
+        self.assertGreater(stats['segments'], 1)
+        with TranscriptStore(self.root) as store:
+            self.assertEqual([e.text for e in store.entries(first)], [f"a{i}" for i in range(100)])
+            self.assertEqual([e.text for e in store.entries(second)], [f"b{i}" for i in range(100)])
+
+    def test_SearchesTextAndTranslation(self):
+        """Search finds matches in either language, optionally in one session."""
+        with TranscriptStore(self.root) as store:
+            first = store.begin_session()
+            second = store.begin_session()
+            store.append(first, "今日はいい天気です", translation="Nice weather today")
+            store.append(second, "天気予報", translation="Weather forecast")
+            store.append(second, "こんにちは", translation="Hello")
+            store.flush(timeout=5)
+
+            self.assertEqual(len(store.search("天気")), 2)
+            self.assertEqual([e.text for e in store.search("Weather", session_id=second)], ["天気予報"])
+            self.assertEqual(store.search("missing"), [])
+
+    def test_RecoversTornTailAndLostIndex(self):
+        """Records the index missed are recovered; a torn record is cut off."""
+        with TranscriptStore(self.root) as store:
+            session = store.begin_session()
+            self.fill(store, session, 3)
+        log = os.path.join(self.root, "00000000.log")
+        index = os.path.join(self.root, "00000000.idx")
+        with open(index, "r+b") as f:
+            f.truncate(os.path.getsize(index) - 10)  # Lose part of the last index entry
+        with open(log, "ab") as f:
+            f.write(b"\x40\x00\x00\x00torn")
+
+        with TranscriptStore(self.root) as store:
+            self.assertEqual(len(list(store.entries(session))), 3)
+            store.append(session, "after")
+            store.flush(timeout=5)
+        with TranscriptStore(self.root) as store:
+            self.assertEqual([e.text for e in store.entries(session)][-2:], ["発話2", "after"])
+
+
+if __name__ == "__main__":
+    unittest.main()
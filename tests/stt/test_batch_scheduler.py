@@ -0,0 +1,95 @@
+"""
+Tests for the deadline-aware batch scheduler used in continuous transcription.
+"""
+
+import threading
+import time
+import unittest
+import numpy as np
+
+from src.stt.batch_scheduler import BatchCostModel, BatchQueue
+
+
+class BatchCostModelTest(unittest.TestCase):
+    """Test cases for BatchCostModel."""
+
+    def test_FitsFixedAndPerItemCost(self):
+        """A linear cost is recovered from measured batches."""
+        model = BatchCostModel()
+        for size in (1, 2, 4, 8):
+            model.record(size, 0.2 + 0.05 * size)
+        self.assertAlmostEqual(model.estimate(6), 0.5, places=3)
+
+
+class BatchQueueTest(unittest.TestCase):
+    """Test cases for BatchQueue."""
+
+    def setUp(self):
+        """Set up test fixtures."""
+        self.queue = BatchQueue(max_batch_size=4, latency_budget=1.0, max_wait=0.0, max_pending=6)
+        self.audio = np.zeros(160, dtype=np.float32)
+        print("Running batch scheduler tests...")
+
+    def test_BatchesAcrossStreams(self):
+        """Utterances from several streams are served together, oldest first."""
+        for stream in ('a', 'b', 'c', 'a', 'b'):
+            self.assertTrue(self.queue.put(self.audio, stream_id=stream))
+
+        batch = self.queue.get_batch(timeout=0.1)
+        self.assertEqual([r.stream_id for r in batch], ['a', 'b', 'c', 'a'])
+        self.assertEqual(len(self.queue.get_batch(timeout=0.1)), 1)
+
+    def test_ShrinksBatchToMeetDeadline(self):
+        """A batch predicted to overrun the earliest deadline is made smaller."""
+        for size in (1, 2, 3, 4):
+            self.queue.cost.record(size, 0.3 * size)
+        for _ in range(4):
+            self.queue.put(self.audio)
+
+        # 0.9 s for three utterances fits the 1 s budget, 1.2 s for four does not
+        self.assertEqual(len(self.queue.get_batch(timeout=0.1)), 3)
+
+    def test_BlocksWhenFull(self):
+        """put() applies backpressure until the consumer takes a batch."""
+        for _ in range(6):
+            self.queue.put(self.audio)
+        self.assertTrue(self.queue.saturated)
+        self.assertFalse(self.queue.put(self.audio, timeout=0.05))
+
+        timer = threading.Timer(0.05, lambda: self.queue.get_batch(timeout=0.1))
+        timer.start()
+        started = time.monotonic()
+        self.assertTrue(self.queue.put(self.audio, timeout=2.0))
+        self.assertLess(time.monotonic() - started, 1.0)
+        timer.join()
+        self.assertEqual(self.queue.get_stats()['rejected'], 1)
+
+    def test_CountsDeadlineMisses(self):
+        """Completed batches update the counters."""
+        queue = BatchQueue(latency_budget=0.0, max_wait=0.0)
+        queue.put(self.audio)
+        queue.put(self.audio)
+        batch = queue.get_batch(timeout=0.1)
+        queue.complete(batch, 0.01)
+
+        stats = queue.get_stats()
+        self.assertEqual(stats['batches'], 1)
+        self.assertEqual(stats['mean_batch_size'], len(batch))
+        self.assertEqual(stats['deadline_misses'], len(batch))
+
+
+    def test_InterruptReleasesWaitingConsumer(self):
+        """interrupt() ends a get_batch() wait early with an empty batch."""
+        timer = threading.Timer(0.05, self.queue.interrupt)
+        timer.start()
+        started = time.monotonic()
+        self.assertEqual(self.queue.get_batch(timeout=2.0), [])
+        self.assertLess(time.monotonic() - started, 1.0)
+        timer.join()
+
+        # The interrupt is consumed; queued audio is still served normally
+        self.queue.put(self.audio)
+        self.assertEqual(len(self.queue.get_batch(timeout=0.1)), 1)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,118 @@
+"""
+Tests for offline file transcription with work-stealing decode workers.
+"""
+
+import os
+import tempfile
+import threading
+import time
+import unittest
+import wave
+
+import numpy as np
+
+from src.stt.file_transcriber import FileTranscriber, energy_segments, map_wav, to_whisper_input
+
+
+class FileTranscriberTest(unittest.TestCase):
+    """Test cases for FileTranscriber."""
+
+    def setUp(self):
+        """Set up test fixtures."""
+        # Ten utterances of growing length at 16 kHz
+        self.segments = [(i * 32000, i * 32000 + 1600 * (i + 1)) for i in range(10)]
+        self.decoded_by = {}
+        self.lock = threading.Lock()
+        print("Running file transcriber tests...")
+
+    def decode(self, chunks):
+        """Fake model: the text names the utterance, the first worker is slow."""
+        worker = threading.current_thread().name
+        if worker == threading.main_thread().name:
+            time.sleep(0.05)
+        with self.lock:
+            for start, _ in chunks:
+                self.decoded_by[start] = worker
+        return [(f"u{start // 32000}", 0.9) for start, _ in chunks]
+
+    def test_KeepsFileOrderAndTimestamps(self):
+        """Results come back in file order with times in seconds."""
+        transcriber = FileTranscriber(self.decode, workers=3, batch_size=2)
+        results = transcriber.transcribe_segments(self.segments, lambda s, e: (s, e), 16000)
+
+        self.assertEqual([r['text'] for r in results], [f"u{i}" for i in range(10)])
+        self.assertAlmostEqual(results[3]['start'], 6.0)
+        self.assertAlmostEqual(results[3]['end'], 6.4)
+        self.assertEqual(transcriber.last_stats['utterances'], 10)
+
+    def test_IdleWorkersSteal(self):
+        """Workers that finish early take utterances queued for a slow one."""
+        transcriber = FileTranscriber(self.decode, workers=2, batch_size=1)
+        transcriber.transcribe_segments(self.segments, lambda s, e: (s, e), 16000)
+
+        self.assertGreater(transcriber.last_stats['steals'], 0)
+        self.assertEqual(len(self.decoded_by), 10)
+        slow = sum(1 for worker in self.decoded_by.values()
+                   if worker == threading.main_thread().name)
+        self.assertLess(slow, 5)
+
+    def test_ReportsProgressAndFailures(self):
+        """Progress reaches the total; failed and empty utterances are dropped."""
+        def decode(chunks):
+            if any(start == 0 for start, _ in chunks):
+                raise RuntimeError("decoder failed")
+            return [("" if start == 32000 else "text", 0.5) for start, _ in chunks]
+
+        progress = []
+        transcriber = FileTranscriber(decode, workers=2, batch_size=1)
+        results = transcriber.transcribe_segments(
+            self.segments, lambda s, e: (s, e), 16000, lambda done, total: progress.append((done, total)))
+
+        self.assertEqual(len(results), 8)
+        self.assertEqual(progress[-1], (10, 10))
+        self.assertEqual(transcriber.last_stats['failed'], 1)
+
+
+class WavInputTest(unittest.TestCase):
+    """Test cases for mapping and segmenting WAV files."""
+
+    def setUp(self):
+        """Write a 48 kHz stereo file with two bursts of tone."""
+        rate = 48000
+        t = np.arange(rate * 6) / rate
+        level = ((t > 1.0) & (t < 2.0)) | ((t > 4.0) & (t < 5.0))
+        tone = (np.sin(2 * np.pi * 220 * t) * 0.3 * level * 32767).astype(np.int16)
+        fd, self.path = tempfile.mkstemp(suffix='.wav')
+        os.close(fd)
+        with wave.open(self.path, 'wb') as f:
+            f.setnchannels(2)
+            f.setsampwidth(2)
+            f.setframerate(rate)
+            f.writeframes(np.repeat(tone, 2).tobytes())
+        print("Running WAV input tests...")
+
+    def tearDown(self):
+        """Remove the test file."""
+        os.remove(self.path)
+
+    def test_MapsAndConverts(self):
+        """The mapped file converts to 16 kHz mono float32."""
+        frames, rate = map_wav(self.path)
+        self.assertEqual((frames.shape, rate), ((48000 * 6, 2), 48000))
+
+        audio = to_whisper_input(frames[48000:96000], rate)
+        self.assertEqual((len(audio), audio.dtype), (16000, np.float32))
+        self.assertAlmostEqual(float(np.max(np.abs(audio))), 0.3, places=1)
+
+    def test_SegmentsByEnergy(self):
+        """The energy fallback finds both bursts."""
+        frames, rate = map_wav(self.path)
+        segments = energy_segments(frames, rate)
+
+        self.assertEqual(len(segments), 2)
+        self.assertLess(abs(segments[0][0] / rate - 0.7), 0.1)
+        self.assertLess(abs(segments[1][0] / rate - 3.7), 0.1)
+
+
+if __name__ == "__main__":
+    unittest.main()
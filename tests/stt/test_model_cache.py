@@ -0,0 +1,84 @@
+"""
+Tests for the LRU model cache used by WhisperSTT.
+"""
+
+import threading
+import time
+import unittest
+
+from src.stt.model_cache import ModelCache, estimate_model_bytes
+
+
+class ModelCacheTest(unittest.TestCase):
+    """Test cases for ModelCache."""
+
+    def setUp(self):
+        """Set up test fixtures."""
+        self.cache = ModelCache(memory_budget=300)
+        self.loads = []
+        print("Running model cache tests...")
+
+    def loader(self, name):
+        def load():
+            self.loads.append(name)
+            return {"name": name}
+        return load
+
+    def test_ReleasedModelStaysResident(self):
+        """Acquiring a released model again does not reload it."""
+        model = self.cache.acquire("small", self.loader("small"), 100)
+        self.cache.release("small")
+        self.assertIs(self.cache.acquire("small", self.loader("small"), 100), model)
+        self.assertEqual(self.loads, ["small"])
+        self.assertEqual(self.cache.get_stats()["hits"], 1)
+
+    def test_EvictsLeastRecentlyUsedIdleModel(self):
+        """The budget is kept by evicting idle models, oldest use first."""
+        for name in ("tiny", "base", "small"):
+            self.cache.acquire(name, self.loader(name), 100)
+            self.cache.release(name)
+        self.cache.acquire("tiny", self.loader("tiny"), 100)  # Now most recent
+        self.cache.release("tiny")
+
+        self.cache.acquire("medium", self.loader("medium"), 100)
+        self.assertEqual(self.cache.resident(), ["small", "tiny", "medium"])
+        self.assertEqual(self.cache.get_stats()["evictions"], 1)
+
+    def test_ModelInUseIsNeverEvicted(self):
+        """A model still held survives loads that exceed the budget."""
+        held = self.cache.acquire("medium", self.loader("medium"), 250)
+        self.cache.acquire("small", self.loader("small"), 100)
+        self.assertIn("medium", self.cache.resident())
+        self.assertFalse(self.cache.evict("medium"))
+        self.assertEqual(held["name"], "medium")
+
+        self.cache.release("small")
+        self.assertEqual(self.cache.resident(), ["medium"])
+
+    def test_ConcurrentAcquiresShareOneLoad(self):
+        """Threads asking for the same model wait for a single load."""
+        def slow():
+            time.sleep(0.1)
+            self.loads.append("large")
+            return object()
+
+        results = []
+        threads = [threading.Thread(target=lambda: results.append(self.cache.acquire("large", slow, 100)))
+                   for _ in range(4)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+
+        self.assertEqual(self.loads, ["large"])
+        self.assertEqual(len(set(map(id, results))), 1)
+
+    def test_EstimateScalesWithWeightType(self):
+        """int8 weights are a quarter of float32."""
+        self.assertEqual(estimate_model_bytes("small", "float32"),
+                         4 * estimate_model_bytes("small", "int8"))
+        self.assertGreater(estimate_model_bytes("large-v3"), estimate_model_bytes("medium"))
+
+
+if __name__ == "__main__":
+    unittest.main()
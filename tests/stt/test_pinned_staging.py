@@ -0,0 +1,65 @@
+"""
+Tests for asynchronous host-to-device staging.
+"""
+
+import unittest
+
+import numpy as np
+
+from src.stt.pinned_staging import TORCH_CUDA_AVAILABLE, HostStager
+
+
+@unittest.skipUnless(TORCH_CUDA_AVAILABLE, "needs PyTorch with CUDA")
+class HostStagerTest(unittest.TestCase):
+    """Test cases for HostStager."""
+
+    def setUp(self):
+        """Set up test fixtures."""
+        self.stager = HostStager("cuda", bounce_buffers=2)
+        print("Running pinned staging tests...")
+
+    def tearDown(self):
+        """Tear down test fixtures."""
+        self.stager.close()
+
+    def test_UnregisteredArraysAreBounced(self):
+        """Arrays outside registered memory arrive intact through a bounce buffer."""
+        audio = np.linspace(-1.0, 1.0, 16000, dtype=np.float32)
+        staged = self.stager.upload(audio)
+        self.assertEqual(len(staged), 16000)
+        np.testing.assert_array_equal(staged.wait().cpu().numpy(), audio)
+        self.assertEqual(self.stager.get_stats()['bounced'], 1)
+
+    def test_RegisteredMemoryIsCopiedDirectly(self):
+        """Arrays inside a registered region are uploaded without a bounce buffer."""
+        # Page-aligned like the capture's staging arena
+        arena = np.zeros(4096 * 4 + 1024, dtype=np.float32)
+        offset = (-arena.ctypes.data % 4096) // 4
+        region = arena[offset:offset + 4096 * 4]
+        self.assertTrue(self.stager.register(region.ctypes.data, region.nbytes))
+        self.assertTrue(self.stager.register(region.ctypes.data, region.nbytes))
+
+        region[:8000] = 0.5
+        staged = self.stager.upload(region[:8000])
+        np.testing.assert_array_equal(staged.wait().cpu().numpy(), region[:8000])
+        stats = self.stager.get_stats()
+        self.assertEqual((stats['direct'], stats['bounced']), (1, 0))
+
+    def test_FeaturesKeepTheirShapeAndAudioLength(self):
+        """Multi-dimensional features are uploaded with the audio length they stand for."""
+        features = np.random.rand(80, 3000).astype(np.float32)
+        staged = self.stager.upload(features, samples=48000)
+        self.assertEqual(len(staged), 48000)
+        self.assertEqual(tuple(staged.wait().shape), (80, 3000))
+
+    def test_BounceBuffersAreReused(self):
+        """Finished uploads give their bounce buffer back."""
+        for _ in range(5):
+            self.stager.upload(np.ones(1000, dtype=np.float32)).wait()
+            self.stager.get_stats()  # Retires finished copies
+        self.assertEqual(self.stager.get_stats()['in_flight'], 0)
+        self.assertLessEqual(len(self.stager._free), 2)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,97 @@
+"""
+Tests for streaming transcription with local agreement.
+"""
+
+import unittest
+import numpy as np
+
+from src.stt.streaming import HypothesisBuffer, StreamingTranscriber
+
+# Words of a sentence spoken at one word per 0.4 s
+SENTENCE = [(i * 0.4, i * 0.4 + 0.3, word, 0.9)
+            for i, word in enumerate(['今日', 'は', '良い', '天気', 'です', 'ね'])]
+
+
+class _FakeModel:
+    """Returns the words of SENTENCE heard so far, with the last one misrecognized."""
+
+    def __init__(self):
+        self.stream_time = 0.0  # Stream time of the window start, set by the test
+        self.prompts = []
+        self.window_seconds = []
+
+    def transcribe_words(self, audio, prompt):
+        self.prompts.append(prompt)
+        self.window_seconds.append(len(audio) / 16000)
+        end = self.stream_time + len(audio) / 16000
+        heard = [w for w in SENTENCE if w[1] <= end and w[0] >= self.stream_time - 0.05]
+        words = [(s - self.stream_time, e - self.stream_time, t, p) for s, e, t, p in heard]
+        if words:  # The newest word is still unstable
+            s, e, t, p = words[-1]
+            words[-1] = (s, e, t + '?', p)
+        return words
+
+
+class HypothesisBufferTest(unittest.TestCase):
+    """Test cases for HypothesisBuffer."""
+
+    def test_CommitsAgreedPrefix(self):
+        """Only words two decodes agree on are committed."""
+        buffer = HypothesisBuffer()
+        buffer.insert(SENTENCE[:3])
+        self.assertEqual(buffer.flush(), [])
+        buffer.insert(SENTENCE[:2] + [(0.8, 1.1, '要り', 0.5)])
+        self.assertEqual([w[2] for w in buffer.flush()], ['今日', 'は'])
+        self.assertEqual([w[2] for w in buffer.unstable], ['要り'])
+
+    def test_SkipsRepeatedCommittedWords(self):
+        """Re-decoded words before the committed point are not emitted again."""
+        buffer = HypothesisBuffer()
+        buffer.insert(SENTENCE[:3])
+        buffer.flush()
+        buffer.insert(SENTENCE[:3])
+        buffer.flush()
+        buffer.insert(SENTENCE[:4])
+        self.assertEqual(buffer.flush(), [])
+        self.assertEqual([w[2] for w in buffer.unstable], ['天気'])
+
+
+class StreamingTranscriberTest(unittest.TestCase):
+    """Test cases for StreamingTranscriber."""
+
+    def setUp(self):
+        """Set up test fixtures."""
+        self.model = _FakeModel()
+        self.results = []
+        self.transcriber = StreamingTranscriber(self.model, self.results.append,
+                                                min_chunk=0.5, trim_after=1.0)
+        print("Running streaming transcription tests...")
+
+    def _feed_and_decode(self, seconds):
+        self.transcriber.feed(np.zeros(int(seconds * 16000), dtype=np.int16))
+        self.model.stream_time = self.transcriber._window_start
+        self.transcriber.process_iter()
+
+    def test_EmitsPartialsThenFinals(self):
+        """Every word becomes final exactly once, in order, with stream timestamps."""
+        for _ in range(6):
+            self._feed_and_decode(0.5)
+        self.transcriber.finish()
+
+        finals = [w for r in self.results if r.is_final for w in r.words]
+        self.assertEqual([w[2].rstrip('?') for w in finals], [w[2] for w in SENTENCE])
+        self.assertEqual([w[0] for w in finals], [w[0] for w in SENTENCE])
+        self.assertTrue(any(not r.is_final for r in self.results))
+
+    def test_OnlyDecodesTheUnstableTail(self):
+        """Committed audio leaves the window and its text becomes the prompt."""
+        for _ in range(6):
+            self._feed_and_decode(0.5)
+
+        self.assertLess(max(self.model.window_seconds), 2.0)
+        self.assertTrue(self.model.prompts[-1].startswith('今日は'))
+        self.assertLess(self.transcriber.get_stats()['decode_ratio'], 3.0)
+
+
+if __name__ == '__main__':
+    unittest.main()
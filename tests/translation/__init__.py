@@ -0,0 +1,5 @@
+"""
+Tests for the Translation module.
+
+This module contains test cases for the batched translation pipeline.
+"""
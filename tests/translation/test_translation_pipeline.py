@@ -0,0 +1,161 @@
+"""
+Tests for the batched, cached translation pipeline.
+"""
+
+import threading
+import time
+import unittest
+
+from src.translation.pipeline import (TranslationCache, TranslationPipeline, normalize_text,
+                                      split_sentences)
+
+
+class FakeTranslator:
+    """Uppercases text; blocks each batch until released when gated."""
+
+    def __init__(self, gated: bool = False):
+        self.batches = []
+        self.gate = threading.Semaphore(0)
+        self.started = threading.Semaphore(0)
+        self.gated = gated
+
+    def translate_batch(self, texts):
+        self.batches.append(list(texts))
+        self.started.release()
+        if self.gated:
+            self.gate.acquire(timeout=5)
+        return [(text.upper(), 0.9) for text in texts]
+
+
+class TranslationCacheTest(unittest.TestCase):
+    """Test cases for TranslationCache."""
+
+    def test_EvictsLeastRecentlyUsed(self):
+        """Looking an entry up keeps it over older ones."""
+        cache = TranslationCache(capacity=2)
+        cache.put('a', ('A', 1.0))
+        cache.put('b', ('B', 1.0))
+        cache.get('a')
+        cache.put('c', ('C', 1.0))
+
+        self.assertEqual(cache.get('a'), ('A', 1.0))
+        self.assertIsNone(cache.get('b'))
+        self.assertEqual(len(cache), 2)
+
+    def test_NormalizesAndSplits(self):
+        """Width variants share a key; sentences split on their endings."""
+        self.assertEqual(normalize_text('ＡＢＣ  ﾃｽﾄ '), 'ABC テスト')
+        self.assertEqual(split_sentences('はい。そうです！まだ'), (['はい。', 'そうです！'], 'まだ'))
+        self.assertEqual(split_sentences('3.5 kg'), ([], '3.5 kg'))
+
+
+class TranslationPipelineTest(unittest.TestCase):
+    """Test cases for TranslationPipeline."""
+
+    def setUp(self):
+        """Set up test fixtures."""
+        self.results = []
+        self.delivered = threading.Condition()
+        print("Running translation pipeline tests...")
+
+    def collect(self, result):
+        with self.delivered:
+            self.results.append(result)
+            self.delivered.notify_all()
+
+    def wait_for(self, count):
+        with self.delivered:
+            self.assertTrue(self.delivered.wait_for(lambda: len(self.results) >= count, timeout=5))
+
+    def test_BatchesAcrossStreams(self):
+        """Sentences queued behind a batch in flight go into one model call."""
+        translator = FakeTranslator(gated=True)
+        pipeline = TranslationPipeline(translator, self.collect)
+        pipeline.start()
+        pipeline.submit('first', stream_id='a')
+        translator.started.acquire(timeout=5)
+        for stream, text in (('a', 'two'), ('b', 'three'), ('c', 'four')):
+            pipeline.submit(text, stream_id=stream)
+        translator.gate.release()
+        translator.gate.release()
+        self.wait_for(4)
+        pipeline.stop()
+
+        self.assertEqual(translator.batches, [['first'], ['two', 'three', 'four']])
+        self.assertEqual([r.text for r in self.results], ['FIRST', 'TWO', 'THREE', 'FOUR'])
+        self.assertEqual(pipeline.get_stats()['mean_batch_size'], 2.0)
+
+    def test_CachesRepeatedText(self):
+        """A repeated sentence is answered from the cache without a model call."""
+        translator = FakeTranslator()
+        pipeline = TranslationPipeline(translator, self.collect)
+        pipeline.start()
+        pipeline.submit('hello')
+        self.wait_for(1)
+        pipeline.submit(' hello ')
+        self.wait_for(2)
+        pipeline.stop()
+
+        self.assertEqual(len(translator.batches), 1)
+        self.assertTrue(self.results[1].cached)
+        self.assertEqual(pipeline.get_stats()['cache_hits'], 1)
+
+    def test_CancelsSupersededPartials(self):
+        """Only the newest partial is translated, and a stale one is dropped."""
+        translator = FakeTranslator(gated=True)
+        pipeline = TranslationPipeline(translator, self.collect)
+        pipeline.start()
+        pipeline.submit('partial one', is_final=False)
+        translator.started.acquire(timeout=5)
+        pipeline.submit('partial two', is_final=False)
+        pipeline.submit('partial three', is_final=False)
+        pipeline.submit('the final', is_final=True)
+        translator.gate.release()
+        translator.gate.release()
+        self.wait_for(1)
+        time.sleep(0.1)
+        pipeline.stop()
+
+        self.assertEqual(translator.batches, [['partial one'], ['the final']])
+        self.assertEqual([(r.text, r.is_final) for r in self.results], [('THE FINAL', True)])
+        self.assertEqual(pipeline.get_stats()['cancelled'], 3)
+
+    def test_KeepsFinalOrderPerStream(self):
+        """A cached final does not overtake an earlier final still being translated."""
+        translator = FakeTranslator(gated=True)
+        pipeline = TranslationPipeline(translator, self.collect)
+        pipeline.cache.put('cached', ('CACHED', 1.0))
+        pipeline.start()
+        pipeline.submit('slow')
+        translator.started.acquire(timeout=5)
+        pipeline.submit('cached')
+        pipeline.submit('cached', stream_id='other')
+        self.wait_for(1)
+        translator.gate.release()
+        self.wait_for(3)
+        pipeline.stop()
+
+        self.assertEqual([(r.stream_id, r.text) for r in self.results],
+                         [('other', 'CACHED'), (0, 'SLOW'), (0, 'CACHED')])
+
+    def test_JoinsStreamingResultsIntoSentences(self):
+        """Committed spans are translated once they complete a sentence."""
+        class Result:
+            def __init__(self, text, is_final):
+                self.text, self.is_final = text, is_final
+
+        translator = FakeTranslator()
+        pipeline = TranslationPipeline(translator, self.collect, translate_partials=False)
+        pipeline.start()
+        pipeline.on_result(Result('今日は', True))
+        pipeline.on_result(Result('いい天', False))
+        pipeline.on_result(Result('いい天気です。明日', True))
+        pipeline.flush()
+        self.wait_for(2)
+        pipeline.stop()
+
+        self.assertEqual([r.source for r in self.results], ['今日はいい天気です。', '明日'])
+
+
+if __name__ == "__main__":
+    unittest.main()